@@ -134,6 +134,43 @@ TEST (block_store, add_item)
 	ASSERT_EQ (nullptr, latest3);
 }
 
+TEST (block_store, block_serialized_get)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	oslo::keypair key;
+	oslo::open_block open (1, 2, key.pub, key.prv, key.pub, 3);
+	open.sideband_set ({});
+	oslo::send_block send (open.hash (), 4, 5, key.prv, key.pub, 6);
+	send.sideband_set ({});
+	oslo::state_block state (key.pub, send.hash (), 7, 8, 9, key.prv, key.pub, 10);
+	state.sideband_set ({});
+	auto transaction (store->tx_begin_write ());
+	store->block_put (transaction, open.hash (), open);
+	store->block_put (transaction, send.hash (), send);
+	store->block_put (transaction, state.hash (), state);
+	for (oslo::block const * block : std::vector<oslo::block const *>{ &open, &send, &state })
+	{
+		std::vector<uint8_t> expected;
+		{
+			oslo::vectorstream stream (expected);
+			oslo::serialize_block (stream, *block);
+		}
+		// Appends to existing contents
+		std::vector<uint8_t> buffer{ 0xff };
+		oslo::block_hash previous;
+		ASSERT_FALSE (store->block_serialized_get (transaction, block->hash (), buffer, previous));
+		ASSERT_EQ (block->previous (), previous);
+		ASSERT_EQ (expected.size () + 1, buffer.size ());
+		ASSERT_TRUE (std::equal (expected.begin (), expected.end (), buffer.begin () + 1));
+	}
+	std::vector<uint8_t> buffer;
+	oslo::block_hash previous;
+	ASSERT_TRUE (store->block_serialized_get (transaction, 12, buffer, previous));
+	ASSERT_TRUE (buffer.empty ());
+}
+
 TEST (block_store, clear_successor)
 {
 	oslo::logger_mt logger;
@@ -521,6 +558,53 @@ TEST (block_store, unchecked_begin_search)
 	oslo::send_block block2 (5, 6, 7, key0.prv, key0.pub, 8);
 }
 
+TEST (block_store, unchecked_modified)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	auto block1 (std::make_shared<oslo::send_block> (1, 2, 3, oslo::keypair ().prv, 4, 5));
+	auto block2 (std::make_shared<oslo::send_block> (6, 7, 8, oslo::keypair ().prv, 9, 10));
+	oslo::unchecked_key key1 (block1->previous (), block1->hash ());
+	oslo::unchecked_key key2 (block2->previous (), block2->hash ());
+	auto transaction (store->tx_begin_write ());
+	store->unchecked_put (transaction, key1, oslo::unchecked_info (block1, 0, 300));
+	store->unchecked_put (transaction, key2, oslo::unchecked_info (block2, 0, 200));
+	{
+		// Ordered by modified time, not by key
+		auto i (store->unchecked_modified_begin (transaction));
+		ASSERT_NE (store->unchecked_modified_end (), i);
+		ASSERT_EQ (200, i->first.modified ());
+		ASSERT_EQ (key2, i->first.key ());
+		++i;
+		ASSERT_NE (store->unchecked_modified_end (), i);
+		ASSERT_EQ (300, i->first.modified ());
+		ASSERT_EQ (key1, i->first.key ());
+		++i;
+		ASSERT_EQ (store->unchecked_modified_end (), i);
+	}
+	// Replacing an entry moves its position
+	store->unchecked_put (transaction, key1, oslo::unchecked_info (block1, 0, 100));
+	{
+		auto i (store->unchecked_modified_begin (transaction));
+		ASSERT_EQ (100, i->first.modified ());
+		ASSERT_EQ (key1, i->first.key ());
+		++i;
+		ASSERT_EQ (key2, i->first.key ());
+		++i;
+		ASSERT_EQ (store->unchecked_modified_end (), i);
+	}
+	store->unchecked_del (transaction, key1);
+	{
+		auto i (store->unchecked_modified_begin (transaction));
+		ASSERT_EQ (key2, i->first.key ());
+		++i;
+		ASSERT_EQ (store->unchecked_modified_end (), i);
+	}
+	store->unchecked_clear (transaction);
+	ASSERT_EQ (store->unchecked_modified_end (), store->unchecked_modified_begin (transaction));
+}
+
 TEST (block_store, frontier_retrieval)
 {
 	oslo::logger_mt logger;
@@ -849,6 +933,67 @@ TEST (block_store, sequence_increment)
 	ASSERT_EQ (31, vote6->sequence);
 }
 
+TEST (block_store, vote_sequence_reserve)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	oslo::keypair key1;
+	auto transaction (store->tx_begin_write ());
+	auto vote1 (store->vote_generate (transaction, key1.pub, key1.prv, std::vector<oslo::block_hash>{ oslo::genesis_hash }));
+	ASSERT_EQ (1, vote1->sequence);
+	ASSERT_EQ (2, store->vote_sequence_reserve (transaction, key1.pub, 3));
+	// Sequence numbers 2 to 4 are reserved even before any of them are signed
+	auto vote2 (store->vote_generate (transaction, key1.pub, key1.prv, std::vector<oslo::block_hash>{ oslo::genesis_hash }));
+	ASSERT_EQ (5, vote2->sequence);
+	auto vote3 (std::make_shared<oslo::vote> (key1.pub, key1.prv, 4, std::vector<oslo::block_hash>{ oslo::genesis_hash }));
+	ASSERT_EQ (*vote2, *store->vote_max (transaction, vote3));
+	ASSERT_EQ (6, store->vote_sequence_reserve (transaction, key1.pub, 1));
+	auto vote4 (std::make_shared<oslo::vote> (key1.pub, key1.prv, 6, std::vector<oslo::block_hash>{ oslo::genesis_hash }));
+	store->vote_max (transaction, vote4);
+	ASSERT_EQ (*vote4, *store->vote_current (transaction, key1.pub));
+	store->flush (transaction);
+	ASSERT_EQ (*vote4, *store->vote_get (transaction, key1.pub));
+}
+
+// Votes signed in batches outside the store never expose an unsigned vote for the account
+TEST (block_store, vote_sequence_reserve_signed)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	oslo::keypair key1;
+	auto transaction (store->tx_begin_write ());
+	ASSERT_EQ (nullptr, store->vote_current (transaction, key1.pub));
+	auto vote1 (store->vote_generate (transaction, key1.pub, key1.prv, std::vector<oslo::block_hash>{ oslo::genesis_hash }));
+	uint64_t const batch_size (4);
+	for (auto round (0); round < 3; ++round)
+	{
+		auto first (store->vote_sequence_reserve (transaction, key1.pub, batch_size));
+		// Until the batch is signed the latest signed vote is still current
+		auto current (store->vote_current (transaction, key1.pub));
+		ASSERT_NE (nullptr, current);
+		ASSERT_FALSE (current->validate ());
+		ASSERT_LT (current->sequence, first);
+		store->flush (transaction);
+		auto stored (store->vote_get (transaction, key1.pub));
+		ASSERT_NE (nullptr, stored);
+		ASSERT_FALSE (stored->validate ());
+		std::vector<std::shared_ptr<oslo::vote>> votes;
+		for (uint64_t i (0); i < batch_size; ++i)
+		{
+			votes.push_back (std::make_shared<oslo::vote> (key1.pub, key1.prv, first + i, std::vector<oslo::block_hash>{ oslo::genesis_hash }));
+		}
+		// A lower vote from the batch does not release the reservation
+		ASSERT_FALSE (store->vote_max (transaction, votes.front ())->validate ());
+		ASSERT_EQ (first + batch_size, store->vote_generate (transaction, key1.pub, key1.prv, std::vector<oslo::block_hash>{ oslo::genesis_hash })->sequence);
+		auto max (store->vote_max (transaction, votes.back ()));
+		ASSERT_FALSE (max->validate ());
+		ASSERT_EQ (first + batch_size, max->sequence);
+		ASSERT_FALSE (store->vote_current (transaction, key1.pub)->validate ());
+	}
+}
+
 TEST (mdb_block_store, upgrade_v2_v3)
 {
 	oslo::keypair key1;
@@ -1544,6 +1689,39 @@ TEST (block_store, peers)
 	}
 }
 
+TEST (block_store, bootstrap_peers)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+
+	oslo::endpoint_key endpoint (boost::asio::ip::address_v6::any ().to_bytes (), 100);
+	oslo::bootstrap_peer_info info (1000.0, 0.25, 40.0, 3);
+	{
+		auto transaction (store->tx_begin_write ());
+		ASSERT_EQ (store->bootstrap_peer_count (transaction), 0);
+		store->bootstrap_peer_put (transaction, endpoint, info);
+		ASSERT_EQ (store->bootstrap_peer_count (transaction), 1);
+	}
+
+	{
+		auto transaction (store->tx_begin_read ());
+		auto i (store->bootstrap_peers_begin (transaction));
+		ASSERT_NE (i, store->bootstrap_peers_end ());
+		ASSERT_EQ (i->first.port (), 100);
+		ASSERT_EQ (i->second.throughput, info.throughput);
+		ASSERT_EQ (i->second.error_rate, info.error_rate);
+		ASSERT_EQ (i->second.rtt, info.rtt);
+		ASSERT_EQ (i->second.samples, info.samples);
+	}
+
+	{
+		auto transaction (store->tx_begin_write ());
+		store->bootstrap_peer_clear (transaction);
+		ASSERT_EQ (store->bootstrap_peer_count (transaction), 0);
+	}
+}
+
 TEST (block_store, endpoint_key_byte_order)
 {
 	boost::asio::ip::address_v6 address (boost::asio::ip::make_address_v6 ("::ffff:127.0.0.1"));
@@ -2035,6 +2213,118 @@ TEST (mdb_block_store, upgrade_v17_v18)
 	ASSERT_LT (17, store.version_get (transaction));
 }
 
+TEST (mdb_block_store, upgrade_v18_v19)
+{
+	auto path (oslo::unique_path ());
+	oslo::genesis genesis;
+	{
+		oslo::logger_mt logger;
+		oslo::mdb_store store (logger, path);
+		oslo::stat stats;
+		oslo::ledger ledger (store, stats);
+		auto transaction (store.tx_begin_write ());
+		store.initialize (transaction, genesis, ledger.cache);
+		// Downgrade the store, v18 stores have no bootstrap_peers table
+		store.version_put (transaction, 18);
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.bootstrap_peers, 1));
+	}
+
+	// Now do the upgrade
+	oslo::logger_mt logger;
+	oslo::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_write ());
+	ASSERT_EQ (0, store.bootstrap_peer_count (transaction));
+	oslo::endpoint_key endpoint (boost::asio::ip::address_v6::any ().to_bytes (), 100);
+	store.bootstrap_peer_put (transaction, endpoint, oslo::bootstrap_peer_info (100.0, 0.5, 20.0, 1));
+	ASSERT_EQ (1, store.bootstrap_peer_count (transaction));
+
+	// Version should be correct
+	ASSERT_LT (18, store.version_get (transaction));
+}
+
+TEST (mdb_block_store, upgrade_v19_v20)
+{
+	auto path (oslo::unique_path ());
+	oslo::genesis genesis;
+	auto block1 (std::make_shared<oslo::send_block> (1, 2, 3, oslo::keypair ().prv, 4, 5));
+	auto block2 (std::make_shared<oslo::send_block> (6, 7, 8, oslo::keypair ().prv, 9, 10));
+	oslo::unchecked_key key1 (block1->previous (), block1->hash ());
+	oslo::unchecked_key key2 (block2->previous (), block2->hash ());
+	{
+		oslo::logger_mt logger;
+		oslo::mdb_store store (logger, path);
+		oslo::stat stats;
+		oslo::ledger ledger (store, stats);
+		auto transaction (store.tx_begin_write ());
+		store.initialize (transaction, genesis, ledger.cache);
+		store.unchecked_put (transaction, key1, oslo::unchecked_info (block1, 0, 300));
+		store.unchecked_put (transaction, key2, oslo::unchecked_info (block2, 0, 200));
+		// Downgrade the store, unchecked entries of v19 stores have no unchecked_modified keys
+		store.version_put (transaction, 19);
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.unchecked_modified, 0));
+	}
+
+	// Now do the upgrade
+	oslo::logger_mt logger;
+	oslo::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	auto i (store.unchecked_modified_begin (transaction));
+	ASSERT_NE (store.unchecked_modified_end (), i);
+	ASSERT_EQ (200, i->first.modified ());
+	ASSERT_EQ (key2, i->first.key ());
+	++i;
+	ASSERT_NE (store.unchecked_modified_end (), i);
+	ASSERT_EQ (300, i->first.modified ());
+	ASSERT_EQ (key1, i->first.key ());
+	++i;
+	ASSERT_EQ (store.unchecked_modified_end (), i);
+
+	// Version should be correct
+	ASSERT_LT (19, store.version_get (transaction));
+}
+
+TEST (block_store, rocksdb_upgrade_unchecked_modified)
+{
+#if OSLO_ROCKSDB
+	auto path (oslo::unique_path ());
+	auto block1 (std::make_shared<oslo::send_block> (1, 2, 3, oslo::keypair ().prv, 4, 5));
+	auto block2 (std::make_shared<oslo::send_block> (6, 7, 8, oslo::keypair ().prv, 9, 10));
+	oslo::unchecked_key key1 (block1->previous (), block1->hash ());
+	oslo::unchecked_key key2 (block2->previous (), block2->hash ());
+	{
+		oslo::logger_mt logger;
+		oslo::rocksdb_store store (logger, path);
+		ASSERT_FALSE (store.init_error ());
+		auto transaction (store.tx_begin_write ());
+		store.unchecked_put (transaction, key1, oslo::unchecked_info (block1, 0, 300));
+		store.unchecked_put (transaction, key2, oslo::unchecked_info (block2, 0, 200));
+		// Ledgers written before the version was stored have no unchecked_modified keys
+		ASSERT_EQ (0, store.del (transaction, oslo::tables::unchecked_modified, oslo::unchecked_modified_key (300, key1)));
+		ASSERT_EQ (0, store.del (transaction, oslo::tables::unchecked_modified, oslo::unchecked_modified_key (200, key2)));
+		ASSERT_EQ (0, store.del (transaction, oslo::tables::meta, oslo::uint256_union (1)));
+	}
+
+	// Now do the upgrade
+	oslo::logger_mt logger;
+	oslo::rocksdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	auto i (store.unchecked_modified_begin (transaction));
+	ASSERT_NE (store.unchecked_modified_end (), i);
+	ASSERT_EQ (200, i->first.modified ());
+	ASSERT_EQ (key2, i->first.key ());
+	++i;
+	ASSERT_NE (store.unchecked_modified_end (), i);
+	ASSERT_EQ (300, i->first.modified ());
+	ASSERT_EQ (key1, i->first.key ());
+	++i;
+	ASSERT_EQ (store.unchecked_modified_end (), i);
+	ASSERT_EQ (store.version, store.version_get (transaction));
+#endif
+}
+
 TEST (mdb_block_store, upgrade_backup)
 {
 	auto dir (oslo::unique_path ());
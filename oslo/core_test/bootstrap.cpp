@@ -5,6 +5,8 @@
 
 #include <gtest/gtest.h>
 
+#include <boost/filesystem/fstream.hpp>
+
 using namespace std::chrono_literals;
 
 // If the account doesn't exist, current == end so there's no iteration
@@ -170,6 +172,94 @@ TEST (bulk_pull, count_limit)
 	ASSERT_EQ (nullptr, block);
 }
 
+TEST (bulk_pull, serialize_next)
+{
+	oslo::system system (1);
+	auto & node (*system.nodes[0]);
+	oslo::genesis genesis;
+	auto send1 (std::make_shared<oslo::send_block> (genesis.hash (), oslo::test_genesis_key.pub, 1, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	ASSERT_EQ (oslo::process_result::progress, node.process (*send1).code);
+	auto receive1 (std::make_shared<oslo::receive_block> (send1->hash (), send1->hash (), oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (send1->hash ())));
+	ASSERT_EQ (oslo::process_result::progress, node.process (*receive1).code);
+
+	auto connection (std::make_shared<oslo::bootstrap_server> (nullptr, system.nodes[0]));
+	auto req = std::make_unique<oslo::bulk_pull> ();
+	req->start = oslo::test_genesis_key.pub;
+	req->end.clear ();
+	connection->requests.push (std::unique_ptr<oslo::message>{});
+	auto request (std::make_shared<oslo::bulk_pull_server> (connection, std::move (req)));
+
+	// The whole chain is read ahead into one buffer
+	std::vector<uint8_t> expected;
+	{
+		oslo::vectorstream stream (expected);
+		oslo::serialize_block (stream, *receive1);
+		oslo::serialize_block (stream, *send1);
+		oslo::serialize_block (stream, *genesis.open);
+	}
+	auto transaction (node.store.tx_begin_read ());
+	ASSERT_TRUE (request->serialize_next (transaction));
+	ASSERT_TRUE (request->serialize_next (transaction));
+	ASSERT_TRUE (request->serialize_next (transaction));
+	ASSERT_FALSE (request->serialize_next (transaction));
+	ASSERT_EQ (expected, *request->send_buffer);
+	ASSERT_EQ (3, request->sent_count);
+}
+
+// State blocks of a chain are sent as compact records which decode to the original blocks
+TEST (bulk_pull, compact)
+{
+	oslo::system system (1);
+	auto & node (*system.nodes[0]);
+	oslo::genesis genesis;
+	oslo::keypair key;
+	oslo::state_block send1 (oslo::test_genesis_key.pub, genesis.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - 100, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (genesis.hash ()));
+	ASSERT_EQ (oslo::process_result::progress, node.process (send1).code);
+	oslo::state_block send2 (oslo::test_genesis_key.pub, send1.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - 200, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (send1.hash ()));
+	ASSERT_EQ (oslo::process_result::progress, node.process (send2).code);
+	oslo::state_block change (oslo::test_genesis_key.pub, send2.hash (), key.pub, oslo::genesis_amount - 200, 0, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (send2.hash ()));
+	ASSERT_EQ (oslo::process_result::progress, node.process (change).code);
+
+	auto connection (std::make_shared<oslo::bootstrap_server> (nullptr, system.nodes[0]));
+	auto req = std::make_unique<oslo::bulk_pull> ();
+	req->start = oslo::test_genesis_key.pub;
+	req->end = genesis.hash ();
+	req->set_compact (true);
+	connection->requests.push (std::unique_ptr<oslo::message>{});
+	auto request (std::make_shared<oslo::bulk_pull_server> (connection, std::move (req)));
+	auto transaction (node.store.tx_begin_read ());
+	while (request->serialize_next (transaction))
+	{
+	}
+	ASSERT_EQ (3, request->sent_count);
+	ASSERT_LT (request->send_buffer->size (), 3 * (1 + oslo::state_block::size));
+
+	auto data (request->send_buffer->data ());
+	oslo::bulk_pull_compact::raw_block reference;
+	std::vector<std::shared_ptr<oslo::block>> blocks;
+	for (auto i (0); i < 3; ++i)
+	{
+		ASSERT_EQ (oslo::bulk_pull_compact::type, data[0]);
+		auto flags (data[1]);
+		auto balance_size (data[2]);
+		ASSERT_TRUE (oslo::bulk_pull_compact::valid_header (flags, balance_size));
+		oslo::bulk_pull_compact::raw_block raw;
+		ASSERT_FALSE (oslo::bulk_pull_compact::decode (flags, balance_size, data + 1 + oslo::bulk_pull_compact::header_size, i == 0 ? nullptr : &reference, raw));
+		data += 1 + oslo::bulk_pull_compact::header_size + oslo::bulk_pull_compact::body_size (flags, balance_size);
+		reference = raw;
+		oslo::bufferstream stream (raw.data (), raw.size ());
+		blocks.push_back (oslo::deserialize_block (stream, oslo::block_type::state));
+		ASSERT_NE (nullptr, blocks.back ());
+	}
+	ASSERT_EQ (request->send_buffer->data () + request->send_buffer->size (), data);
+	ASSERT_EQ (change, *blocks[0]);
+	ASSERT_EQ (send2, *blocks[1]);
+	ASSERT_EQ (send1, *blocks[2]);
+	// A delta needs a reference block
+	oslo::bulk_pull_compact::raw_block raw;
+	ASSERT_TRUE (oslo::bulk_pull_compact::decode (oslo::bulk_pull_compact::balance_delta, 0, reference.data (), nullptr, raw));
+}
+
 TEST (bootstrap_processor, DISABLED_process_none)
 {
 	oslo::system system (1);
@@ -243,6 +333,251 @@ TEST (bootstrap_processor, process_two)
 	node1->stop ();
 }
 
+// Several pulls are kept outstanding on one connection to an up to date peer
+TEST (bootstrap_processor, pipelined_pulls)
+{
+	oslo::system system;
+	oslo::node_config config (oslo::get_available_port (), system.logging);
+	config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
+	oslo::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	auto node0 (system.add_node (config, node_flags));
+	oslo::genesis genesis;
+	auto latest (genesis.hash ());
+	auto balance (oslo::genesis_amount);
+	std::vector<oslo::keypair> keys (20);
+	for (auto & key : keys)
+	{
+		balance -= oslo::Gxrb_ratio;
+		oslo::state_block send (oslo::test_genesis_key.pub, latest, oslo::test_genesis_key.pub, balance, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (latest));
+		latest = send.hash ();
+		oslo::state_block open (key.pub, 0, key.pub, oslo::Gxrb_ratio, send.hash (), key.prv, key.pub, *system.work.generate (key.pub));
+		ASSERT_EQ (oslo::process_result::progress, node0->process (send).code);
+		ASSERT_EQ (oslo::process_result::progress, node0->process (open).code);
+	}
+	config.peering_port = oslo::get_available_port ();
+	auto node1 (system.add_node (config, node_flags));
+	auto channel (node1->network.find_channel (node0->network.endpoint ()));
+	ASSERT_NE (nullptr, channel);
+	ASSERT_GE (channel->get_network_version (), node1->network_params.protocol.bulk_pull_pipelining_version_min);
+	node1->bootstrap_initiator.bootstrap (node0->network.endpoint ());
+	system.deadline_set (10s);
+	while (node1->ledger.cache.block_count != node0->ledger.cache.block_count)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	for (auto & key : keys)
+	{
+		ASSERT_EQ (node0->latest (key.pub), node1->latest (key.pub));
+	}
+	ASSERT_GT (node1->stats.count (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_pipelined, oslo::stat::dir::out), 0);
+}
+
+// Pulls assigned to a connection whose pipeline was aborted before they were pushed are not sent on it
+TEST (bootstrap_processor, pipeline_push_after_abort)
+{
+	oslo::system system (1);
+	auto node (system.nodes[0]);
+	auto socket (std::make_shared<oslo::socket> (node));
+	auto channel (std::make_shared<oslo::transport::channel_tcp> (*node, socket));
+	auto connection (std::make_shared<oslo::bootstrap_client> (node, node->bootstrap_initiator.connections, channel, socket));
+	auto attempt (std::make_shared<oslo::bootstrap_attempt_legacy> (node, 0));
+	oslo::pull_info pull (oslo::test_genesis_key.pub, oslo::genesis_hash, 0, attempt->incremental_id);
+	// Assigned by fill_pipeline, the push is deferred to a background thread
+	connection->pipeline_pending = 2;
+	auto client1 (std::make_shared<oslo::bulk_pull_client> (connection, attempt, pull));
+	auto client2 (std::make_shared<oslo::bulk_pull_client> (connection, attempt, pull));
+	connection->pipeline_abort (*client1);
+	ASSERT_TRUE (connection->pending_stop);
+	connection->pipeline_push ({ client1, client2 });
+	ASSERT_EQ (0, connection->pipeline_pending);
+	ASSERT_TRUE (client1->network_error);
+	ASSERT_TRUE (client2->network_error);
+	ASSERT_EQ (nullptr, connection->pipeline_pop (*client1));
+}
+
+TEST (bootstrap_peer_scores, score)
+{
+	oslo::system system (1);
+	auto node (system.nodes[0]);
+	auto & scores (node->bootstrap_initiator.peer_scores);
+	oslo::tcp_endpoint fast (boost::asio::ip::address_v6::loopback (), 10000);
+	oslo::tcp_endpoint slow (boost::asio::ip::address_v6::loopback (), 10001);
+	oslo::tcp_endpoint unknown (boost::asio::ip::address_v6::loopback (), 10002);
+	scores.throughput (fast, 1000.0);
+	scores.rtt (fast, std::chrono::milliseconds (10));
+	scores.pull_result (fast, false);
+	scores.throughput (slow, 1000.0);
+	scores.rtt (slow, std::chrono::milliseconds (10));
+	scores.pull_result (slow, true);
+	scores.pull_result (slow, true);
+	ASSERT_GT (scores.score (fast), scores.score (slow));
+	// Peers without samples get the average score
+	ASSERT_DOUBLE_EQ ((scores.score (fast) + scores.score (slow)) / 2, scores.score (unknown));
+	// Samples are moving averages
+	scores.throughput (fast, 0.0);
+	auto info (scores.get (fast));
+	ASSERT_TRUE (info.is_initialized ());
+	ASSERT_DOUBLE_EQ (1000.0 * (1.0 - oslo::bootstrap_peer_scores::ewma_weight), info->throughput);
+	ASSERT_EQ (2, info->samples);
+	ASSERT_EQ (0, scores.select ({ fast }));
+	ASSERT_LT (scores.select ({ fast, slow, unknown }), 3);
+	// Scores survive a restart
+	scores.store ();
+	oslo::bootstrap_peer_scores loaded (*node);
+	loaded.load ();
+	ASSERT_EQ (2, loaded.size ());
+	ASSERT_DOUBLE_EQ (scores.score (slow), loaded.score (slow));
+}
+
+// Blocks linked to a checkpoint frontier skip signature checks, are cemented and validated afterwards
+TEST (bootstrap_processor, checkpoint)
+{
+	oslo::system system;
+	oslo::node_config config (oslo::get_available_port (), system.logging);
+	config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
+	oslo::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	auto node0 (system.add_node (config, node_flags));
+	oslo::genesis genesis;
+	oslo::keypair key;
+	oslo::state_block send1 (oslo::test_genesis_key.pub, genesis.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - 100, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (genesis.hash ()));
+	oslo::state_block send2 (oslo::test_genesis_key.pub, send1.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - 200, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (send1.hash ()));
+	oslo::state_block send3 (oslo::test_genesis_key.pub, send2.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - 300, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (send2.hash ()));
+	ASSERT_EQ (oslo::process_result::progress, node0->process (send1).code);
+	ASSERT_EQ (oslo::process_result::progress, node0->process (send2).code);
+	ASSERT_EQ (oslo::process_result::progress, node0->process (send3).code);
+	auto path (oslo::unique_path ());
+	{
+		boost::filesystem::ofstream file (path);
+		file << "# account frontier height\n";
+		file << oslo::test_genesis_key.pub.to_account () << " " << send2.hash ().to_string () << " 3\n";
+	}
+	config.peering_port = oslo::get_available_port ();
+	node_flags.bootstrap_checkpoint = path.string ();
+	auto node1 (system.add_node (config, node_flags));
+	ASSERT_NE (nullptr, node1->bootstrap_initiator.checkpoint);
+	ASSERT_EQ (1, node1->bootstrap_initiator.checkpoint->size ());
+	node1->bootstrap_initiator.bootstrap (node0->network.endpoint ());
+	system.deadline_set (10s);
+	while (node1->latest (oslo::test_genesis_key.pub) != send3.hash ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	// send3 is above the checkpoint and is checked as usual
+	ASSERT_EQ (2, node1->stats.count (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_trusted));
+	ASSERT_EQ (1, node1->stats.count (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_cemented));
+	ASSERT_EQ (0, node1->bootstrap_initiator.checkpoint->size ());
+	system.deadline_set (10s);
+	while (!node1->ledger.block_confirmed (node1->store.tx_begin_read (), send2.hash ()) || node1->stats.count (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_validated) < 3)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_FALSE (node1->ledger.block_confirmed (node1->store.tx_begin_read (), send3.hash ()));
+	ASSERT_EQ (0, node1->stats.count (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_invalid));
+}
+
+// A checkpointed block with a corrupted signature has the same hash, it is never left in the ledger
+TEST (bootstrap_processor, checkpoint_invalid_signature)
+{
+	oslo::system system;
+	oslo::node_config config (oslo::get_available_port (), system.logging);
+	config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
+	oslo::genesis genesis;
+	oslo::keypair key;
+	auto send1 (std::make_shared<oslo::state_block> (oslo::test_genesis_key.pub, genesis.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - 100, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto send2 (std::make_shared<oslo::state_block> (oslo::test_genesis_key.pub, send1->hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - 200, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (send1->hash ())));
+	send2->signature.bytes[0] ^= 1;
+	auto path (oslo::unique_path ());
+	{
+		boost::filesystem::ofstream file (path);
+		file << oslo::test_genesis_key.pub.to_account () << " " << send2->hash ().to_string () << " 3\n";
+	}
+	oslo::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	node_flags.bootstrap_checkpoint = path.string ();
+	auto node1 (system.add_node (config, node_flags));
+	ASSERT_NE (nullptr, node1->bootstrap_initiator.checkpoint);
+	// Realtime blocks are always checked
+	node1->process_active (send2);
+	node1->block_processor.flush ();
+	ASSERT_EQ (0, node1->stats.count (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_trusted));
+	// Pulled in bulk pull order, from the frontier down
+	auto attempt (std::make_shared<oslo::bootstrap_attempt_legacy> (node1, 0));
+	attempt->process_block (send2, oslo::test_genesis_key.pub, 0, 0, false, 0);
+	attempt->process_block (send1, oslo::test_genesis_key.pub, 0, 0, false, 0);
+	node1->block_processor.flush ();
+	ASSERT_TIMELY (10s, node1->ledger.block_exists (send1->hash ()) && !node1->ledger.block_exists (send2->hash ()) && !node1->bootstrap_initiator.checkpoint->validating);
+	// Release builds trust the block and roll it back after validation, debug builds check its signature up front
+	auto transaction (node1->store.tx_begin_read ());
+	ASSERT_FALSE (node1->ledger.block_exists (send2->hash ()));
+	ASSERT_EQ (send1->hash (), node1->latest (oslo::test_genesis_key.pub));
+	oslo::confirmation_height_info confirmation_height;
+	ASSERT_FALSE (node1->store.confirmation_height_get (transaction, oslo::test_genesis_key.pub, confirmation_height));
+	ASSERT_LE (confirmation_height.height, 2);
+	ASSERT_EQ (node1->stats.count (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_invalid), node1->stats.count (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_rollback));
+}
+
+// The local account cursor of a range starts right at its first account, including the range starting at zero
+TEST (bootstrap_processor, frontier_range_start)
+{
+	oslo::system system (1);
+	auto node (system.nodes[0]);
+	auto socket (std::make_shared<oslo::socket> (node));
+	auto channel (std::make_shared<oslo::transport::channel_tcp> (*node, socket));
+	auto connection (std::make_shared<oslo::bootstrap_client> (node, node->bootstrap_initiator.connections, channel, socket));
+	auto attempt (std::make_shared<oslo::bootstrap_attempt_legacy> (node, 0));
+	auto client1 (std::make_shared<oslo::frontier_req_client> (connection, attempt, 0, 0));
+	ASSERT_EQ (oslo::test_genesis_key.pub, client1->current);
+	ASSERT_EQ (oslo::genesis_hash, client1->frontier);
+	auto client2 (std::make_shared<oslo::frontier_req_client> (connection, attempt, oslo::test_genesis_key.pub, 0));
+	ASSERT_EQ (oslo::test_genesis_key.pub, client2->current);
+	auto client3 (std::make_shared<oslo::frontier_req_client> (connection, attempt, oslo::test_genesis_key.pub.number () + 1, 0));
+	ASSERT_TRUE (client3->current.is_zero ());
+}
+
+// Frontiers are requested in account ranges from several peers
+TEST (bootstrap_processor, frontier_ranges)
+{
+	oslo::system system;
+	oslo::node_config config (oslo::get_available_port (), system.logging);
+	config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
+	oslo::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	auto node0 (system.add_node (config, node_flags));
+	config.peering_port = oslo::get_available_port ();
+	auto node1 (system.add_node (config, node_flags));
+	oslo::genesis genesis;
+	auto latest (genesis.hash ());
+	auto balance (oslo::genesis_amount);
+	std::vector<oslo::keypair> keys (16);
+	for (auto & key : keys)
+	{
+		balance -= oslo::Gxrb_ratio;
+		oslo::state_block send (oslo::test_genesis_key.pub, latest, oslo::test_genesis_key.pub, balance, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (latest));
+		latest = send.hash ();
+		oslo::state_block open (key.pub, 0, key.pub, oslo::Gxrb_ratio, send.hash (), key.prv, key.pub, *system.work.generate (key.pub));
+		for (auto & node : system.nodes)
+		{
+			ASSERT_EQ (oslo::process_result::progress, node->process (send).code);
+			ASSERT_EQ (oslo::process_result::progress, node->process (open).code);
+		}
+	}
+	config.peering_port = oslo::get_available_port ();
+	auto node2 (system.add_node (config, node_flags));
+	ASSERT_EQ (2, node2->network.size ());
+	node2->bootstrap_initiator.bootstrap ();
+	system.deadline_set (10s);
+	while (node2->ledger.cache.block_count != node0->ledger.cache.block_count)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	for (auto & key : keys)
+	{
+		ASSERT_EQ (node0->latest (key.pub), node2->latest (key.pub));
+	}
+}
+
 // Bootstrap can pull universal blocks
 TEST (bootstrap_processor, process_state)
 {
@@ -724,7 +1059,7 @@ TEST (bootstrap_processor, lazy_max_pull_count)
 	}
 
 	auto transaction = node1->store.tx_begin_read ();
-	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->store.unchecked_count (transaction));
+	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->unchecked.count (transaction));
 	node1->stop ();
 }
 
@@ -1042,6 +1377,8 @@ TEST (frontier_req, count)
 	auto request (std::make_shared<oslo::frontier_req_server> (connection, std::move (req)));
 	ASSERT_EQ (oslo::test_genesis_key.pub, request->current);
 	ASSERT_EQ (send1.hash (), request->frontier);
+	// Accounts past the requested count are not read
+	ASSERT_TRUE (request->accounts.empty ());
 }
 
 TEST (frontier_req, time_bound)
@@ -1219,3 +1556,48 @@ TEST (bulk_pull_account, basics)
 		ASSERT_EQ (nullptr, block_data.second.get ());
 	}
 }
+
+TEST (fingerprint_table, insert_erase)
+{
+	oslo::fingerprint_table<oslo::uint128_t> table;
+	ASSERT_TRUE (table.empty ());
+	ASSERT_EQ (0, table.memory ());
+	std::vector<oslo::block_hash> hashes;
+	for (auto i (0); i < 1000; ++i)
+	{
+		hashes.push_back (oslo::block_hash (i + 1));
+		ASSERT_TRUE (table.insert (hashes.back (), i));
+	}
+	ASSERT_FALSE (table.insert (hashes[0], 5));
+	ASSERT_EQ (0, *table.find (hashes[0]));
+	ASSERT_EQ (1000, table.size ());
+	ASSERT_GE (table.memory (), 1000 * (sizeof (uint64_t) + sizeof (oslo::uint128_t)));
+	// Erasing leaves every other entry reachable through its probe sequence
+	for (auto i (0); i < 1000; i += 2)
+	{
+		ASSERT_TRUE (table.erase (hashes[i]));
+	}
+	ASSERT_FALSE (table.erase (hashes[0]));
+	ASSERT_EQ (500, table.size ());
+	for (auto i (0); i < 1000; ++i)
+	{
+		auto existing (table.find (hashes[i]));
+		ASSERT_EQ (i % 2 == 1, existing != nullptr);
+		if (existing != nullptr)
+		{
+			ASSERT_EQ (i, *existing);
+		}
+	}
+	size_t visited (0);
+	table.erase_if ([&visited](oslo::uint128_t const & value_a) {
+		++visited;
+		return value_a < 500;
+	});
+	ASSERT_EQ (500, visited);
+	ASSERT_EQ (250, table.size ());
+	ASSERT_FALSE (table.contains (hashes[1]));
+	ASSERT_TRUE (table.contains (hashes[999]));
+	table.clear ();
+	ASSERT_TRUE (table.empty ());
+	ASSERT_FALSE (table.contains (hashes[999]));
+}
@@ -266,7 +266,7 @@ TEST (confirmation_height, gap_bootstrap)
 		// Confirmation heights should not be updated
 		{
 			auto transaction (node1.store.tx_begin_read ());
-			auto unchecked_count (node1.store.unchecked_count (transaction));
+			auto unchecked_count (node1.unchecked.count (transaction));
 			ASSERT_EQ (unchecked_count, 2);
 
 			oslo::confirmation_height_info confirmation_height_info;
@@ -282,7 +282,7 @@ TEST (confirmation_height, gap_bootstrap)
 		// Confirmation height should be unchanged and unchecked should now be 0
 		{
 			auto transaction (node1.store.tx_begin_read ());
-			auto unchecked_count (node1.store.unchecked_count (transaction));
+			auto unchecked_count (node1.unchecked.count (transaction));
 			ASSERT_EQ (unchecked_count, 0);
 
 			oslo::confirmation_height_info confirmation_height_info;
@@ -375,7 +375,7 @@ TEST (confirmation_height, gap_live)
 
 		// This should confirm the open block and the source of the receive blocks
 		auto transaction (node->store.tx_begin_read ());
-		auto unchecked_count (node->store.unchecked_count (transaction));
+		auto unchecked_count (node->unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 
 		oslo::confirmation_height_info confirmation_height_info;
@@ -1668,3 +1668,71 @@ TEST (confirmation_height, election_winner_details_clearing_node_process_confirm
 	node->process_confirmed (election, 1000000);
 	ASSERT_EQ (0, node->active.election_winner_details_size ());
 }
+
+TEST (confirmation_height, parallel_independent_chains)
+{
+	oslo::system system;
+	oslo::node_flags node_flags;
+	node_flags.confirmation_height_processor_mode = oslo::confirmation_height_mode::parallel;
+	oslo::node_config node_config (oslo::get_available_port (), system.logging);
+	node_config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
+	node_config.confirmation_height_threads = 4;
+	auto node = system.add_node (node_config, node_flags);
+
+	std::vector<oslo::keypair> keys (4);
+	std::vector<std::shared_ptr<oslo::state_block>> sends;
+	std::vector<std::shared_ptr<oslo::state_block>> opens;
+	oslo::block_hash latest (oslo::genesis_hash);
+	auto balance (oslo::genesis_amount);
+	for (auto const & key : keys)
+	{
+		balance -= oslo::Gxrb_ratio;
+		sends.push_back (std::make_shared<oslo::state_block> (oslo::test_genesis_key.pub, latest, oslo::test_genesis_key.pub, balance, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (latest)));
+		latest = sends.back ()->hash ();
+		opens.push_back (std::make_shared<oslo::state_block> (key.pub, 0, key.pub, oslo::Gxrb_ratio, latest, key.prv, key.pub, *system.work.generate (key.pub)));
+	}
+	// The last account receives from the third one, so their chains depend on each other
+	auto send (std::make_shared<oslo::state_block> (keys[2].pub, opens[2]->hash (), keys[2].pub, 0, keys[3].pub, keys[2].prv, keys[2].pub, *system.work.generate (opens[2]->hash ())));
+	auto receive (std::make_shared<oslo::state_block> (keys[3].pub, opens[3]->hash (), keys[3].pub, oslo::Gxrb_ratio * 2, send->hash (), keys[3].prv, keys[3].pub, *system.work.generate (opens[3]->hash ())));
+	{
+		auto transaction = node->store.tx_begin_write ();
+		for (auto const & block : sends)
+		{
+			ASSERT_EQ (oslo::process_result::progress, node->ledger.process (transaction, *block).code);
+		}
+		for (auto const & block : opens)
+		{
+			ASSERT_EQ (oslo::process_result::progress, node->ledger.process (transaction, *block).code);
+		}
+		ASSERT_EQ (oslo::process_result::progress, node->ledger.process (transaction, *send).code);
+		ASSERT_EQ (oslo::process_result::progress, node->ledger.process (transaction, *receive).code);
+	}
+
+	add_callback_stats (*node);
+
+	// Cement the genesis chain all the opens depend on
+	node->confirmation_height_processor.add (sends.back ()->hash ());
+	ASSERT_TIMELY (10s, node->ledger.cache.cemented_count == 5);
+
+	// Three independent groups: the first two opens, then the third open and the receive which both depend on the third account
+	node->confirmation_height_processor.pause ();
+	for (auto const & block : opens)
+	{
+		node->confirmation_height_processor.add (block->hash ());
+	}
+	node->confirmation_height_processor.add (receive->hash ());
+	node->confirmation_height_processor.unpause ();
+	ASSERT_TIMELY (10s, node->ledger.cache.cemented_count == 11);
+
+	ASSERT_TIMELY (10s, node->stats.count (oslo::stat::type::http_callback, oslo::stat::detail::http_callback, oslo::stat::dir::out) == 10);
+	ASSERT_EQ (10, node->stats.count (oslo::stat::type::confirmation_height, oslo::stat::detail::blocks_confirmed, oslo::stat::dir::in));
+	ASSERT_EQ (2, node->stats.count (oslo::stat::type::confirmation_height, oslo::stat::detail::parallel_batch, oslo::stat::dir::in));
+	ASSERT_EQ (1 + 3, node->stats.count (oslo::stat::type::confirmation_height, oslo::stat::detail::parallel_groups, oslo::stat::dir::in));
+	ASSERT_EQ (1 + 3, node->stats.count (oslo::stat::type::confirmation_height, oslo::stat::detail::parallel_workers, oslo::stat::dir::in));
+	auto transaction (node->store.tx_begin_read ());
+	for (auto const & block : opens)
+	{
+		ASSERT_TRUE (node->ledger.block_confirmed (transaction, block->hash ()));
+	}
+	ASSERT_TRUE (node->ledger.block_confirmed (transaction, receive->hash ()));
+}
@@ -2,10 +2,13 @@
 #include <oslo/lib/stats.hpp>
 #include <oslo/lib/threading.hpp>
 #include <oslo/node/election.hpp>
+#include <oslo/node/ledger_snapshot.hpp>
 #include <oslo/node/testing.hpp>
 
 #include <gtest/gtest.h>
 
+#include <boost/filesystem/fstream.hpp>
+
 using namespace std::chrono_literals;
 
 // Init returns an error if it can't open files at the path
@@ -2765,10 +2768,10 @@ TEST (ledger, unchecked_epoch)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, epoch1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, epoch1->previous ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, oslo::signature_verification::valid_epoch);
 	}
@@ -2778,7 +2781,7 @@ TEST (ledger, unchecked_epoch)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, epoch1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 		oslo::account_info info;
@@ -2810,10 +2813,10 @@ TEST (ledger, unchecked_epoch_invalid)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 2);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, epoch1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, epoch1->previous ()));
 		ASSERT_EQ (blocks.size (), 2);
 		ASSERT_EQ (blocks[0].verified, oslo::signature_verification::valid);
 		ASSERT_EQ (blocks[1].verified, oslo::signature_verification::valid);
@@ -2826,7 +2829,7 @@ TEST (ledger, unchecked_epoch_invalid)
 		ASSERT_FALSE (node1.store.block_exists (transaction, epoch1->hash ()));
 		ASSERT_TRUE (node1.store.block_exists (transaction, epoch2->hash ()));
 		ASSERT_TRUE (node1.active.empty ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 		oslo::account_info info;
@@ -2860,10 +2863,10 @@ TEST (ledger, unchecked_open)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, open1->source ()));
+		auto blocks (node1.unchecked.get (transaction, open1->source ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, oslo::signature_verification::valid);
 	}
@@ -2872,7 +2875,7 @@ TEST (ledger, unchecked_open)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, open1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 	}
@@ -2898,10 +2901,10 @@ TEST (ledger, unchecked_receive)
 	// Previous block for receive1 is unknown, signature cannot be validated
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, receive1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, receive1->previous ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, oslo::signature_verification::unknown);
 	}
@@ -2910,10 +2913,10 @@ TEST (ledger, unchecked_receive)
 	// Previous block for receive1 is known, signature was validated
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, receive1->source ()));
+		auto blocks (node1.unchecked.get (transaction, receive1->source ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, oslo::signature_verification::valid);
 	}
@@ -2922,7 +2925,7 @@ TEST (ledger, unchecked_receive)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, receive1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 	}
@@ -3258,3 +3261,137 @@ TEST (ledger, backtrack)
 	ASSERT_EQ (nullptr, ledger.backtrack (transaction, nullptr, 0));
 	ASSERT_EQ (nullptr, ledger.backtrack (transaction, nullptr, 10));
 }
+
+// A ledger exported to a snapshot is imported unchanged into an empty store, corrupted snapshots are rejected
+TEST (ledger_snapshot, export_import)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	oslo::stat stats;
+	oslo::ledger ledger (*store, stats);
+	oslo::genesis genesis;
+	oslo::network_params params;
+	oslo::work_pool pool (std::numeric_limits<unsigned>::max ());
+	oslo::keypair key1;
+	oslo::keypair key2;
+	oslo::send_block send1 (genesis.hash (), key1.pub, oslo::genesis_amount - 100, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	oslo::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), key1.prv, key1.pub, *pool.generate (key1.pub));
+	oslo::state_block send2 (key1.pub, open1.hash (), key1.pub, 40, key2.pub, key1.prv, key1.pub, *pool.generate (open1.hash ()));
+	{
+		auto transaction (store->tx_begin_write ());
+		store->initialize (transaction, genesis, ledger.cache);
+		ASSERT_EQ (oslo::process_result::progress, ledger.process (transaction, send1).code);
+		ASSERT_EQ (oslo::process_result::progress, ledger.process (transaction, open1).code);
+		ASSERT_EQ (oslo::process_result::progress, ledger.process (transaction, send2).code);
+		store->confirmation_height_put (transaction, key1.pub, { 1, open1.hash () });
+	}
+	auto path (oslo::unique_path ());
+	oslo::ledger_snapshot snapshot (*store, params);
+	ASSERT_FALSE (snapshot.export_ledger (path));
+	ASSERT_EQ (2, snapshot.accounts);
+	ASSERT_EQ (4, snapshot.blocks);
+	ASSERT_EQ (1, snapshot.pending);
+	ASSERT_FALSE (snapshot.verify (path));
+
+	auto store2 = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store2->init_error ());
+	oslo::ledger ledger2 (*store2, stats);
+	{
+		auto transaction (store2->tx_begin_write ());
+		store2->initialize (transaction, genesis, ledger2.cache);
+	}
+	oslo::ledger_snapshot snapshot2 (*store2, params);
+	ASSERT_FALSE (snapshot2.import_ledger (path, 2));
+	ASSERT_EQ (4, snapshot2.blocks);
+	auto transaction1 (store->tx_begin_read ());
+	auto transaction2 (store2->tx_begin_read ());
+	for (auto account : { oslo::test_genesis_key.pub, key1.pub })
+	{
+		oslo::account_info info1;
+		oslo::account_info info2;
+		ASSERT_FALSE (store->account_get (transaction1, account, info1));
+		ASSERT_FALSE (store2->account_get (transaction2, account, info2));
+		ASSERT_EQ (info1, info2);
+		oslo::confirmation_height_info confirmation_height1;
+		oslo::confirmation_height_info confirmation_height2;
+		ASSERT_FALSE (store->confirmation_height_get (transaction1, account, confirmation_height1));
+		ASSERT_FALSE (store2->confirmation_height_get (transaction2, account, confirmation_height2));
+		ASSERT_EQ (confirmation_height1.height, confirmation_height2.height);
+		ASSERT_EQ (confirmation_height1.frontier, confirmation_height2.frontier);
+	}
+	for (auto hash : { genesis.hash (), send1.hash (), open1.hash (), send2.hash () })
+	{
+		auto block1 (store->block_get (transaction1, hash));
+		auto block2 (store2->block_get (transaction2, hash));
+		ASSERT_NE (nullptr, block2);
+		ASSERT_EQ (*block1, *block2);
+		ASSERT_EQ (block1->sideband ().successor, block2->sideband ().successor);
+		ASSERT_EQ (block1->sideband ().height, block2->sideband ().height);
+	}
+	ASSERT_TRUE (store2->pending_exists (transaction2, oslo::pending_key (key2.pub, send2.hash ())));
+	ASSERT_EQ (oslo::test_genesis_key.pub, store2->frontier_get (transaction2, send1.hash ()));
+	// The genesis open block is no longer a head
+	ASSERT_TRUE (store2->frontier_get (transaction2, genesis.hash ()).is_zero ());
+	ASSERT_EQ (4, store2->block_count (transaction2).sum ());
+
+	// The ledger has to be empty apart from genesis
+	ASSERT_TRUE (snapshot2.import_ledger (path, 2));
+
+	// Flip a byte of the first account record
+	{
+		boost::filesystem::fstream file (path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp (60);
+		file.put (0x55);
+	}
+	ASSERT_TRUE (snapshot.verify (path));
+	ASSERT_FALSE (snapshot.error_message.empty ());
+}
+
+// A snapshot with a valid checksum but a chain not matching its account info is rejected before anything is written
+TEST (ledger_snapshot, import_invalid_chain)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	oslo::stat stats;
+	oslo::ledger ledger (*store, stats);
+	oslo::genesis genesis;
+	oslo::network_params params;
+	oslo::work_pool pool (std::numeric_limits<unsigned>::max ());
+	oslo::keypair key1;
+	oslo::send_block send1 (genesis.hash (), key1.pub, oslo::genesis_amount - 100, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	oslo::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), key1.prv, key1.pub, *pool.generate (key1.pub));
+	oslo::state_block send2 (key1.pub, open1.hash (), key1.pub, 40, key1.pub, key1.prv, key1.pub, *pool.generate (open1.hash ()));
+	{
+		auto transaction (store->tx_begin_write ());
+		store->initialize (transaction, genesis, ledger.cache);
+		ASSERT_EQ (oslo::process_result::progress, ledger.process (transaction, send1).code);
+		ASSERT_EQ (oslo::process_result::progress, ledger.process (transaction, open1).code);
+		ASSERT_EQ (oslo::process_result::progress, ledger.process (transaction, send2).code);
+		// The chain is still walked from the open block, but the head does not match
+		oslo::account_info info;
+		ASSERT_FALSE (store->account_get (transaction, key1.pub, info));
+		info.head = open1.hash ();
+		store->account_put (transaction, key1.pub, info);
+	}
+	auto path (oslo::unique_path ());
+	oslo::ledger_snapshot snapshot (*store, params);
+	ASSERT_FALSE (snapshot.export_ledger (path));
+	ASSERT_TRUE (snapshot.verify (path));
+
+	auto store2 = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store2->init_error ());
+	oslo::ledger ledger2 (*store2, stats);
+	{
+		auto transaction (store2->tx_begin_write ());
+		store2->initialize (transaction, genesis, ledger2.cache);
+	}
+	oslo::ledger_snapshot snapshot2 (*store2, params);
+	ASSERT_TRUE (snapshot2.import_ledger (path, 2));
+	ASSERT_EQ (snapshot2.error_message.find ("changed"), std::string::npos);
+	auto transaction2 (store2->tx_begin_read ());
+	ASSERT_EQ (1, store2->account_count (transaction2));
+	ASSERT_EQ (1, store2->block_count (transaction2).sum ());
+	ASSERT_EQ (oslo::test_genesis_key.pub, store2->frontier_get (transaction2, genesis.hash ()));
+}
@@ -71,6 +71,30 @@ TEST (message, publish_serialization)
 	ASSERT_EQ (oslo::message_type::publish, header.type);
 }
 
+TEST (message, publish_batch_serialization)
+{
+	oslo::keypair key;
+	std::vector<std::shared_ptr<oslo::block>> blocks;
+	for (auto i (0); i < oslo::publish_batch::max_blocks; ++i)
+	{
+		blocks.push_back (std::make_shared<oslo::state_block> (key.pub, i, key.pub, i, 0, key.prv, key.pub, 0));
+	}
+	oslo::publish_batch message1 (blocks);
+	ASSERT_EQ (oslo::block_type::state, message1.header.block_type ());
+	ASSERT_EQ (oslo::publish_batch::max_blocks, message1.header.count_get ());
+	auto bytes (message1.to_bytes (false));
+	ASSERT_EQ (oslo::message_header::size + oslo::publish_batch::max_blocks * oslo::state_block::size, bytes->size ());
+	oslo::bufferstream stream (bytes->data (), bytes->size ());
+	auto error (false);
+	oslo::message_header header (error, stream);
+	ASSERT_FALSE (error);
+	ASSERT_EQ (oslo::message_type::publish_batch, header.type);
+	oslo::publish_batch message2 (error, stream, header);
+	ASSERT_FALSE (error);
+	ASSERT_EQ (message1, message2);
+	ASSERT_EQ (0, message2.duplicates);
+}
+
 TEST (message, confirm_ack_serialization)
 {
 	oslo::keypair key1;
@@ -51,11 +51,18 @@ public:
 	{
 		ASSERT_FALSE (true);
 	}
+	void publish_batch (oslo::publish_batch const & message_a) override
+	{
+		++publish_batch_count;
+		publish_batch_blocks += message_a.blocks.size ();
+	}
 
 	uint64_t keepalive_count{ 0 };
 	uint64_t publish_count{ 0 };
 	uint64_t confirm_req_count{ 0 };
 	uint64_t confirm_ack_count{ 0 };
+	uint64_t publish_batch_count{ 0 };
+	uint64_t publish_batch_blocks{ 0 };
 };
 }
 
@@ -192,6 +199,94 @@ TEST (message_parser, exact_publish_size)
 	ASSERT_NE (parser.status, oslo::message_parser::parse_status::success);
 }
 
+TEST (message_parser, publish_batch)
+{
+	oslo::system system (1);
+	test_visitor visitor;
+	oslo::network_filter filter (256);
+	oslo::block_uniquer block_uniquer;
+	oslo::vote_uniquer vote_uniquer (block_uniquer);
+	oslo::message_parser parser (filter, block_uniquer, vote_uniquer, visitor, system.work, true);
+	auto block1 (std::make_shared<oslo::send_block> (1, 1, 2, oslo::keypair ().prv, 4, *system.work.generate (oslo::root (1))));
+	auto block2 (std::make_shared<oslo::send_block> (2, 1, 2, oslo::keypair ().prv, 4, *system.work.generate (oslo::root (2))));
+	auto block3 (std::make_shared<oslo::send_block> (3, 1, 2, oslo::keypair ().prv, 4, *system.work.generate (oslo::root (3))));
+	oslo::publish_batch message1 ({ block1, block2 });
+	ASSERT_EQ (oslo::block_type::send, message1.header.block_type ());
+	ASSERT_EQ (2, message1.header.count_get ());
+	auto bytes1 (message1.to_bytes (false));
+	ASSERT_EQ (oslo::message_header::size + message1.header.payload_length_bytes (), bytes1->size ());
+	parser.deserialize_buffer (bytes1->data (), bytes1->size ());
+	ASSERT_EQ (parser.status, oslo::message_parser::parse_status::success);
+	ASSERT_EQ (1, visitor.publish_batch_count);
+	ASSERT_EQ (2, visitor.publish_batch_blocks);
+	// Every block is already in the filter
+	parser.deserialize_buffer (bytes1->data (), bytes1->size ());
+	ASSERT_EQ (parser.status, oslo::message_parser::parse_status::duplicate_publish_message);
+	ASSERT_EQ (1, visitor.publish_batch_count);
+	// Only the new block is passed on, with the digest a publish of it has
+	oslo::publish_batch message2 ({ block2, block3 });
+	auto bytes2 (message2.to_bytes (false));
+	parser.deserialize_buffer (bytes2->data (), bytes2->size ());
+	ASSERT_EQ (parser.status, oslo::message_parser::parse_status::success);
+	ASSERT_EQ (2, visitor.publish_batch_count);
+	ASSERT_EQ (3, visitor.publish_batch_blocks);
+	oslo::publish publish (block3);
+	auto publish_bytes (publish.to_bytes (false));
+	ASSERT_TRUE (filter.apply (publish_bytes->data () + oslo::message_header::size, publish_bytes->size () - oslo::message_header::size));
+	// Trailing bytes are rejected
+	auto block4 (std::make_shared<oslo::send_block> (4, 1, 2, oslo::keypair ().prv, 4, *system.work.generate (oslo::root (4))));
+	oslo::publish_batch message3 ({ block4 });
+	auto bytes3 (message3.to_bytes (false));
+	bytes3->push_back (0);
+	parser.deserialize_buffer (bytes3->data (), bytes3->size ());
+	ASSERT_NE (parser.status, oslo::message_parser::parse_status::success);
+	ASSERT_EQ (2, visitor.publish_batch_count);
+}
+
+// A block with insufficient work does not keep the other blocks of the batch out of the filter or from being processed
+TEST (message_parser, publish_batch_insufficient_work)
+{
+	oslo::system system (1);
+	test_visitor visitor;
+	oslo::network_filter filter (256);
+	oslo::block_uniquer block_uniquer;
+	oslo::vote_uniquer vote_uniquer (block_uniquer);
+	oslo::message_parser parser (filter, block_uniquer, vote_uniquer, visitor, system.work, true);
+	auto block1 (std::make_shared<oslo::send_block> (1, 1, 2, oslo::keypair ().prv, 4, *system.work.generate (oslo::root (1))));
+	auto block2 (std::make_shared<oslo::send_block> (2, 1, 2, oslo::keypair ().prv, 4, 0));
+	ASSERT_TRUE (oslo::work_validate_entry (*block2));
+	auto block3 (std::make_shared<oslo::send_block> (3, 1, 2, oslo::keypair ().prv, 4, *system.work.generate (oslo::root (3))));
+	oslo::publish_batch message1 ({ block1, block2, block3 });
+	auto bytes1 (message1.to_bytes (false));
+	parser.deserialize_buffer (bytes1->data (), bytes1->size ());
+	ASSERT_EQ (parser.status, oslo::message_parser::parse_status::insufficient_work);
+	ASSERT_EQ (1, visitor.publish_batch_count);
+	ASSERT_EQ (2, visitor.publish_batch_blocks);
+	// The good blocks are in the filter, the low work block is not
+	auto in_filter = [&filter](std::shared_ptr<oslo::block> const & block_a) {
+		oslo::publish publish (block_a);
+		auto bytes (publish.to_bytes (false));
+		oslo::uint128_t digest;
+		auto existed (filter.apply (bytes->data () + oslo::message_header::size, bytes->size () - oslo::message_header::size, &digest));
+		if (!existed)
+		{
+			filter.clear (digest);
+		}
+		return existed;
+	};
+	ASSERT_TRUE (in_filter (block1));
+	ASSERT_FALSE (in_filter (block2));
+	ASSERT_TRUE (in_filter (block3));
+	// A malformed batch leaves none of its blocks in the filter
+	auto block4 (std::make_shared<oslo::send_block> (4, 1, 2, oslo::keypair ().prv, 4, *system.work.generate (oslo::root (4))));
+	oslo::publish_batch message2 ({ block4 });
+	auto bytes2 (message2.to_bytes (false));
+	bytes2->push_back (0);
+	parser.deserialize_buffer (bytes2->data (), bytes2->size ());
+	ASSERT_EQ (parser.status, oslo::message_parser::parse_status::invalid_publish_message);
+	ASSERT_FALSE (in_filter (block4));
+}
+
 TEST (message_parser, exact_keepalive_size)
 {
 	oslo::system system (1);
@@ -236,6 +236,86 @@ TEST (network, multi_keepalive)
 	node2->stop ();
 }
 
+TEST (network, udp_batching)
+{
+	oslo::system system;
+	oslo::node_flags node_flags;
+	node_flags.disable_udp = false;
+	auto node0 = system.add_node (node_flags);
+	node_flags.disable_udp_batching = true;
+	auto node1 = system.add_node (node_flags);
+	auto channel0 (std::make_shared<oslo::transport::channel_udp> (node1->network.udp_channels, node0->network.endpoint (), node1->network_params.protocol.protocol_version));
+	auto channel1 (std::make_shared<oslo::transport::channel_udp> (node0->network.udp_channels, node1->network.endpoint (), node0->network_params.protocol.protocol_version));
+	auto keepalives0 (node0->stats.count (oslo::stat::type::message, oslo::stat::detail::keepalive, oslo::stat::dir::in));
+	auto keepalives1 (node1->stats.count (oslo::stat::type::message, oslo::stat::detail::keepalive, oslo::stat::dir::in));
+	for (auto i (0); i < 16; ++i)
+	{
+		node1->network.send_keepalive (channel0);
+		node0->network.send_keepalive (channel1);
+	}
+	system.deadline_set (10s);
+	while (node0->stats.count (oslo::stat::type::message, oslo::stat::detail::keepalive, oslo::stat::dir::in) < keepalives0 + 16 || node1->stats.count (oslo::stat::type::message, oslo::stat::detail::keepalive, oslo::stat::dir::in) < keepalives1 + 16)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (0, node1->stats.count (oslo::stat::type::udp, oslo::stat::detail::batch_syscall, oslo::stat::dir::in));
+	ASSERT_EQ (0, node1->stats.count (oslo::stat::type::udp, oslo::stat::detail::batch_syscall, oslo::stat::dir::out));
+#ifdef __linux__
+	// Every datagram went through recvmmsg and sendmmsg, with at least one per call
+	auto syscalls_in (node0->stats.count (oslo::stat::type::udp, oslo::stat::detail::batch_syscall, oslo::stat::dir::in));
+	auto syscalls_out (node0->stats.count (oslo::stat::type::udp, oslo::stat::detail::batch_syscall, oslo::stat::dir::out));
+	ASSERT_GT (syscalls_in, 0);
+	ASSERT_GT (syscalls_out, 0);
+	ASSERT_GE (node0->stats.count (oslo::stat::type::udp, oslo::stat::detail::batch_packet, oslo::stat::dir::in), 16);
+	ASSERT_GE (node0->stats.count (oslo::stat::type::udp, oslo::stat::detail::batch_packet, oslo::stat::dir::out), std::max<uint64_t> (16, syscalls_out));
+#endif
+}
+
+TEST (channel_snapshot, sample)
+{
+	oslo::system system;
+	oslo::node_flags node_flags;
+	node_flags.disable_udp = false;
+	auto & node = *system.add_node (node_flags);
+	auto version (node.network_params.protocol.protocol_version);
+	auto channel1 (std::make_shared<oslo::transport::channel_udp> (node.network.udp_channels, oslo::endpoint (boost::asio::ip::address_v6::loopback (), 10000), version));
+	auto channel2 (std::make_shared<oslo::transport::channel_udp> (node.network.udp_channels, oslo::endpoint (boost::asio::ip::address_v6::loopback (), 10001), version));
+	auto channel3 (std::make_shared<oslo::transport::channel_udp> (node.network.udp_channels, oslo::endpoint (boost::asio::ip::address_v6::loopback (), 10002), version - 1));
+	oslo::channel_snapshot snapshot ({ { channel1, nullptr } }, { { channel2, nullptr }, { channel3, nullptr } });
+	ASSERT_EQ (3, snapshot.size ());
+	auto all (snapshot.sample (10, 0, true, true));
+	ASSERT_EQ (3, all.size ());
+	ASSERT_EQ (3, std::unordered_set<std::shared_ptr<oslo::transport::channel>> (all.begin (), all.end ()).size ());
+	ASSERT_EQ (2, snapshot.sample (2, 0, true, true).size ());
+	auto non_representatives (snapshot.sample (10, 0, true, false));
+	ASSERT_EQ (2, non_representatives.size ());
+	ASSERT_EQ (non_representatives.end (), std::find (non_representatives.begin (), non_representatives.end (), channel1));
+	// The version filter reads the channel, not the snapshot
+	ASSERT_EQ (2, snapshot.sample (10, version, true, true).size ());
+	channel3->set_network_version (version);
+	ASSERT_EQ (3, snapshot.sample (10, version, true, true).size ());
+}
+
+TEST (channel_snapshot, republish)
+{
+	oslo::system system;
+	oslo::node_flags node_flags;
+	node_flags.disable_udp = false;
+	auto & node = *system.add_node (node_flags);
+	auto snapshot1 (node.network.snapshot ());
+	ASSERT_EQ (0, snapshot1->size ());
+	oslo::endpoint endpoint (boost::asio::ip::address_v6::loopback (), 10000);
+	ASSERT_NE (nullptr, node.network.udp_channels.insert (endpoint, node.network_params.protocol.protocol_version));
+	auto snapshot2 (node.network.snapshot ());
+	ASSERT_EQ (1, snapshot2->size ());
+	// Earlier snapshots are left untouched
+	ASSERT_EQ (0, snapshot1->size ());
+	ASSERT_EQ (1, node.network.list (10).size ());
+	node.network.udp_channels.erase (endpoint);
+	ASSERT_EQ (0, node.network.snapshot ()->size ());
+	ASSERT_EQ (1, snapshot2->size ());
+}
+
 TEST (network, send_discarded_publish)
 {
 	oslo::system system (2);
@@ -355,6 +435,39 @@ TEST (network, send_valid_publish)
 	}
 }
 
+TEST (network, flood_block_many_batch)
+{
+	std::vector<oslo::transport::transport_type> types{ oslo::transport::transport_type::tcp, oslo::transport::transport_type::udp };
+	for (auto & type : types)
+	{
+		oslo::node_flags node_flags;
+		if (type == oslo::transport::transport_type::udp)
+		{
+			node_flags.disable_tcp_realtime = true;
+			node_flags.disable_bootstrap_listener = true;
+			node_flags.disable_udp = false;
+		}
+		oslo::system system (2, type, node_flags);
+		auto & node1 (*system.nodes[0]);
+		auto & node2 (*system.nodes[1]);
+		oslo::genesis genesis;
+		oslo::keypair key;
+		std::deque<std::shared_ptr<oslo::block>> blocks;
+		auto previous (genesis.hash ());
+		for (auto i (1); i <= 3; ++i)
+		{
+			auto send (std::make_shared<oslo::state_block> (oslo::test_genesis_key.pub, previous, oslo::test_genesis_key.pub, oslo::genesis_amount - i, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (previous)));
+			previous = send->hash ();
+			blocks.push_back (send);
+		}
+		// Three state blocks fit in one TCP message and need two UDP datagrams
+		node1.network.flood_block_many (blocks, nullptr, 1);
+		ASSERT_TIMELY (10s, node2.latest (oslo::test_genesis_key.pub) == previous);
+		ASSERT_EQ (type == oslo::transport::transport_type::tcp ? 1 : 2, node1.stats.count (oslo::stat::type::message, oslo::stat::detail::publish_batch, oslo::stat::dir::out));
+		ASSERT_LE (1, node2.stats.count (oslo::stat::type::message, oslo::stat::detail::publish_batch, oslo::stat::dir::in));
+	}
+}
+
 TEST (network, send_insufficient_work)
 {
 	oslo::system system;
@@ -777,6 +890,159 @@ TEST (message_buffer_manager, stats)
 	ASSERT_EQ (1, stats.count (oslo::stat::type::udp, oslo::stat::detail::overflow));
 }
 
+TEST (message_buffer_ring, fifo)
+{
+	std::array<oslo::message_buffer, 4> entries;
+	oslo::message_buffer_ring ring (3);
+	ASSERT_EQ (nullptr, ring.pop ());
+	for (auto & entry : entries)
+	{
+		ASSERT_TRUE (ring.push (&entry));
+	}
+	// Capacity is rounded up to 4
+	oslo::message_buffer extra;
+	ASSERT_FALSE (ring.push (&extra));
+	ASSERT_EQ (&entries[0], ring.pop ());
+	ASSERT_TRUE (ring.push (&extra));
+	for (auto i (1); i < entries.size (); ++i)
+	{
+		ASSERT_EQ (&entries[i], ring.pop ());
+	}
+	ASSERT_EQ (&extra, ring.pop ());
+	ASSERT_EQ (nullptr, ring.pop ());
+}
+
+TEST (message_buffer_ring, multithreaded)
+{
+	auto const per_thread (10000);
+	std::vector<oslo::message_buffer> entries (4 * per_thread);
+	oslo::message_buffer_ring ring (entries.size ());
+	std::vector<boost::thread> threads;
+	for (auto i (0); i < 4; ++i)
+	{
+		threads.emplace_back ([&ring, &entries, i, per_thread]() {
+			for (auto j (i * per_thread), n ((i + 1) * per_thread); j < n; ++j)
+			{
+				ASSERT_TRUE (ring.push (&entries[j]));
+			}
+		});
+	}
+	std::atomic<size_t> popped (0);
+	std::vector<std::atomic<int>> seen (entries.size ());
+	for (auto i (0); i < 4; ++i)
+	{
+		threads.emplace_back ([&ring, &entries, &popped, &seen]() {
+			while (popped < entries.size ())
+			{
+				if (auto item = ring.pop ())
+				{
+					++seen[item - entries.data ()];
+					++popped;
+				}
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	// Every buffer is popped exactly once
+	for (auto const & count : seen)
+	{
+		ASSERT_EQ (1, count);
+	}
+}
+
+TEST (message_buffer_ring, cycle)
+{
+	// As many cells as items, a push must not fail while a consumer is still handing back the cell from one lap ago
+	std::array<oslo::message_buffer, 8> entries;
+	oslo::message_buffer_ring ring (entries.size ());
+	for (auto & entry : entries)
+	{
+		ASSERT_TRUE (ring.push (&entry));
+	}
+	std::atomic<bool> failed (false);
+	std::vector<boost::thread> threads;
+	for (auto i (0); i < 8; ++i)
+	{
+		threads.emplace_back ([&ring, &failed]() {
+			for (auto j (0); j < 100000 && !failed; ++j)
+			{
+				if (auto item = ring.pop ())
+				{
+					if (!ring.push (item))
+					{
+						failed = true;
+					}
+				}
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	ASSERT_FALSE (failed);
+	std::unordered_set<oslo::message_buffer *> remaining;
+	while (auto item = ring.pop ())
+	{
+		remaining.insert (item);
+	}
+	ASSERT_EQ (entries.size (), remaining.size ());
+}
+
+TEST (message_buffer_manager, cycle_multithreaded)
+{
+	oslo::stat stats;
+	auto const count (8);
+	oslo::message_buffer_manager buffer (stats, 512, count);
+	std::atomic<size_t> enqueued (0);
+	std::atomic<size_t> released (0);
+	std::vector<boost::thread> consumers;
+	for (auto i (0); i < 4; ++i)
+	{
+		consumers.emplace_back ([&buffer, &released]() {
+			while (auto item = buffer.dequeue ())
+			{
+				buffer.release (item);
+				++released;
+			}
+		});
+	}
+	std::vector<boost::thread> producers;
+	for (auto i (0); i < 4; ++i)
+	{
+		producers.emplace_back ([&buffer, &enqueued]() {
+			for (auto j (0); j < 50000; ++j)
+			{
+				// Only take free buffers so every buffer goes free, full and back to free
+				if (auto item = buffer.try_allocate ())
+				{
+					buffer.enqueue (item);
+					++enqueued;
+				}
+			}
+		});
+	}
+	for (auto & producer : producers)
+	{
+		producer.join ();
+	}
+	oslo::timer<std::chrono::milliseconds> timer (oslo::timer_state::started);
+	while (released != enqueued)
+	{
+		ASSERT_LT (timer.since_start (), 10s);
+		std::this_thread::yield ();
+	}
+	buffer.stop ();
+	for (auto & consumer : consumers)
+	{
+		consumer.join ();
+	}
+	ASSERT_GT (enqueued, 0);
+}
+
 TEST (tcp_listener, tcp_node_id_handshake)
 {
 	oslo::system system (1);
@@ -880,6 +1146,119 @@ TEST (tcp_listener, tcp_listener_timeout_node_id_handshake)
 	}
 }
 
+TEST (tcp_listener, realtime_buffered_parse)
+{
+	oslo::system system (1);
+	auto node0 (system.nodes[0]);
+	auto server (std::make_shared<oslo::bootstrap_server> (std::make_shared<oslo::socket> (node0), node0));
+	server->type = oslo::bootstrap_server_type::realtime_response_server;
+	server->read_buffer = std::make_shared<std::vector<uint8_t>> (oslo::bootstrap_server::read_buffer_size);
+	oslo::keepalive keepalive;
+	oslo::genesis genesis;
+	oslo::publish publish (genesis.open);
+	std::vector<uint8_t> bytes;
+	{
+		oslo::vectorstream stream (bytes);
+		keepalive.serialize (stream, false);
+		publish.serialize (stream, false);
+		keepalive.serialize (stream, false);
+	}
+	// All but the last byte of the second keepalive
+	std::copy (bytes.begin (), bytes.end () - 1, server->read_buffer->begin ());
+	server->read_end = bytes.size () - 1;
+	std::vector<oslo::tcp_message_item> items;
+	ASSERT_FALSE (server->parse_buffered (items));
+	ASSERT_EQ (2, items.size ());
+	ASSERT_EQ (oslo::message_type::keepalive, items[0].message->header.type);
+	ASSERT_EQ (oslo::message_type::publish, items[1].message->header.type);
+	ASSERT_EQ (bytes.size () - (oslo::message_header::size + oslo::keepalive::size), server->read_begin);
+	// The last byte completes the partial message
+	(*server->read_buffer)[server->read_end++] = bytes.back ();
+	items.clear ();
+	ASSERT_FALSE (server->parse_buffered (items));
+	ASSERT_EQ (1, items.size ());
+	ASSERT_EQ (oslo::message_type::keepalive, items[0].message->header.type);
+	ASSERT_EQ (0, server->read_begin);
+	ASSERT_EQ (0, server->read_end);
+	// Duplicate publishes are filtered before deserializing
+	std::copy (bytes.begin (), bytes.end (), server->read_buffer->begin ());
+	server->read_end = bytes.size ();
+	items.clear ();
+	ASSERT_FALSE (server->parse_buffered (items));
+	ASSERT_EQ (2, items.size ());
+	ASSERT_EQ (1, node0->stats.count (oslo::stat::type::filter, oslo::stat::detail::duplicate_publish));
+	// Invalid header
+	std::fill (server->read_buffer->begin (), server->read_buffer->begin () + oslo::message_header::size, 0);
+	server->read_end = oslo::message_header::size;
+	ASSERT_TRUE (server->parse_buffered (items));
+}
+
+TEST (network, tcp_buffered_keepalives)
+{
+	oslo::system system (2);
+	auto & node0 (*system.nodes[0]);
+	auto & node1 (*system.nodes[1]);
+	auto channel (node0.network.tcp_channels.find_channel (oslo::transport::map_endpoint_to_tcp (node1.network.endpoint ())));
+	ASSERT_NE (nullptr, channel);
+	auto initial (node1.stats.count (oslo::stat::type::message, oslo::stat::detail::keepalive, oslo::stat::dir::in));
+	oslo::keepalive keepalive;
+	// Sent back to back so that reads on the receiving side contain several messages
+	for (auto i (0); i < 100; ++i)
+	{
+		channel->send (keepalive, nullptr, oslo::buffer_drop_policy::no_limiter_drop);
+	}
+	system.deadline_set (10s);
+	while (node1.stats.count (oslo::stat::type::message, oslo::stat::detail::keepalive, oslo::stat::dir::in) < initial + 100)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+}
+
+TEST (tcp_message_manager, fair_queueing)
+{
+	oslo::stat stats;
+	oslo::tcp_endpoint flooding (boost::asio::ip::address_v6::loopback (), 1000);
+	oslo::tcp_endpoint honest (boost::asio::ip::address_v6::loopback (), 1001);
+	oslo::tcp_endpoint representative (boost::asio::ip::address_v6::loopback (), 1002);
+	oslo::tcp_message_manager manager (stats, 1, [&representative](oslo::tcp_message_item const & item_a) {
+		return item_a.endpoint == representative;
+	});
+	auto item = [](oslo::tcp_endpoint const & endpoint_a) {
+		return oslo::tcp_message_item{ std::make_shared<oslo::keepalive> (), endpoint_a, 0, nullptr, oslo::bootstrap_server_type::realtime };
+	};
+	std::vector<oslo::tcp_message_item> items;
+	for (auto i (0); i < 200; ++i)
+	{
+		items.push_back (item (flooding));
+	}
+	manager.put_messages (items);
+	ASSERT_TRUE (items.empty ());
+	// Only the flooding peer loses messages
+	ASSERT_EQ (oslo::tcp_message_manager::max_entries_per_peer, manager.size ());
+	ASSERT_EQ (200 - oslo::tcp_message_manager::max_entries_per_peer, manager.dropped (flooding));
+	ASSERT_EQ (200 - oslo::tcp_message_manager::max_entries_per_peer, stats.count (oslo::stat::type::tcp, oslo::stat::detail::tcp_message_drop, oslo::stat::dir::in));
+	manager.put_message (item (honest));
+	manager.put_message (item (honest));
+	manager.put_message (item (representative));
+	ASSERT_EQ (0, manager.dropped (honest));
+	// Principal representatives are served first
+	ASSERT_EQ (representative, manager.get_message ().endpoint);
+	// The honest peer is served within a round instead of after the whole backlog
+	size_t honest_position (0);
+	size_t honest_count (0);
+	for (size_t i (0); honest_count < 2; ++i)
+	{
+		if (manager.get_message ().endpoint == honest)
+		{
+			++honest_count;
+			honest_position = i;
+		}
+	}
+	auto per_quantum (oslo::tcp_message_manager::quantum / (oslo::message_header::size + oslo::keepalive::size) + 1);
+	ASSERT_LT (honest_position, 2 * per_quantum + 2);
+	ASSERT_EQ (oslo::tcp_message_manager::max_entries_per_peer - (honest_position + 1 - honest_count), manager.size ());
+}
+
 TEST (network, replace_port)
 {
 	oslo::system system;
@@ -1042,6 +1421,64 @@ TEST (network, bandwidth_limiter)
 	node.stop ();
 }
 
+TEST (bandwidth_limiter, classes)
+{
+	// 100 bytes/sec split evenly between vote and publish, the other classes have no share
+	oslo::bandwidth_limiter limiter (1.0, 100, { 1, 1, 0, 0, 0, 0 }, 0);
+	oslo::endpoint endpoint (boost::asio::ip::address_v6::loopback (), 1000);
+	// A class uses its own share first, then borrows all tokens of idle classes
+	ASSERT_FALSE (limiter.should_drop (50, oslo::bandwidth_class::vote, endpoint));
+	ASSERT_FALSE (limiter.should_drop (40, oslo::bandwidth_class::vote, endpoint));
+	ASSERT_TRUE (limiter.should_drop (20, oslo::bandwidth_class::vote, endpoint));
+	ASSERT_FALSE (limiter.should_drop (10, oslo::bandwidth_class::publish, endpoint));
+	ASSERT_TRUE (limiter.should_drop (10, oslo::bandwidth_class::publish, endpoint));
+}
+
+TEST (bandwidth_limiter, classes_reserved)
+{
+	oslo::bandwidth_limiter limiter (1.0, 100, { 1, 1, 0, 0, 0, 0 }, 0);
+	oslo::endpoint endpoint (boost::asio::ip::address_v6::loopback (), 1000);
+	// Publish is sending, half of its share is kept for itself
+	ASSERT_FALSE (limiter.should_drop (10, oslo::bandwidth_class::publish, endpoint));
+	ASSERT_FALSE (limiter.should_drop (50, oslo::bandwidth_class::vote, endpoint));
+	ASSERT_TRUE (limiter.should_drop (20, oslo::bandwidth_class::vote, endpoint));
+	ASSERT_FALSE (limiter.should_drop (15, oslo::bandwidth_class::vote, endpoint));
+	ASSERT_TRUE (limiter.should_drop (10, oslo::bandwidth_class::vote, endpoint));
+	ASSERT_FALSE (limiter.should_drop (25, oslo::bandwidth_class::publish, endpoint));
+	ASSERT_TRUE (limiter.should_drop (10, oslo::bandwidth_class::publish, endpoint));
+}
+
+TEST (bandwidth_limiter, classes_unshared)
+{
+	// Classes without a share only send with borrowed tokens
+	oslo::bandwidth_limiter limiter (1.0, 100, { 1, 1, 0, 0, 0, 0 }, 0);
+	oslo::endpoint endpoint (boost::asio::ip::address_v6::loopback (), 1000);
+	ASSERT_TRUE (limiter.should_drop (110, oslo::bandwidth_class::telemetry, endpoint));
+	ASSERT_FALSE (limiter.should_drop (100, oslo::bandwidth_class::telemetry, endpoint));
+	ASSERT_TRUE (limiter.should_drop (10, oslo::bandwidth_class::telemetry, endpoint));
+}
+
+TEST (bandwidth_limiter, per_peer)
+{
+	oslo::bandwidth_limiter limiter (1.0, 1000, { 1, 1, 1, 1, 1, 1 }, 100);
+	oslo::endpoint endpoint1 (boost::asio::ip::address_v6::loopback (), 1000);
+	oslo::endpoint endpoint2 (boost::asio::ip::address_v6::loopback (), 1001);
+	ASSERT_FALSE (limiter.should_drop (100, oslo::bandwidth_class::publish, endpoint1));
+	ASSERT_TRUE (limiter.should_drop (10, oslo::bandwidth_class::publish, endpoint1));
+	// The cap of one peer does not affect another
+	ASSERT_FALSE (limiter.should_drop (100, oslo::bandwidth_class::publish, endpoint2));
+}
+
+TEST (bandwidth_limiter, unbounded)
+{
+	oslo::bandwidth_limiter limiter (1.0, 0);
+	oslo::endpoint endpoint (boost::asio::ip::address_v6::loopback (), 1000);
+	for (auto i (0); i < 100; ++i)
+	{
+		ASSERT_FALSE (limiter.should_drop (1024 * 1024, oslo::bandwidth_class::vote, endpoint));
+	}
+}
+
 namespace oslo
 {
 TEST (peer_exclusion, validate)
@@ -109,3 +109,53 @@ TEST (network_filter, optional_digest)
 	filter.clear (digest);
 	ASSERT_FALSE (filter.apply (bytes1.data (), bytes1.size ()));
 }
+
+TEST (network_filter, shards)
+{
+	ASSERT_EQ (1, oslo::network_filter (1).shard_count ());
+	ASSERT_EQ (4, oslo::network_filter (4).shard_count ());
+	ASSERT_EQ (oslo::network_filter::default_shards, oslo::network_filter (256 * 1024).shard_count ());
+	oslo::network_filter filter (1024, 16);
+	ASSERT_EQ (16, filter.shard_count ());
+	std::vector<std::vector<uint8_t>> items;
+	for (uint8_t i = 0; i < 32; ++i)
+	{
+		items.push_back ({ i });
+	}
+	for (auto const & item : items)
+	{
+		filter.apply (item.data (), item.size ());
+	}
+	// Elements are spread over many shards, some may have been replaced by a collision
+	size_t duplicates (0);
+	for (auto const & item : items)
+	{
+		duplicates += filter.apply (item.data (), item.size ()) ? 1 : 0;
+	}
+	ASSERT_GT (duplicates, 24);
+	filter.clear ();
+	for (auto const & item : items)
+	{
+		ASSERT_FALSE (filter.apply (item.data (), item.size ()));
+	}
+}
+
+TEST (network_filter, apply_many)
+{
+	oslo::network_filter filter (1024, 16);
+	std::vector<uint8_t> bytes1{ 1, 2, 3 };
+	std::vector<uint8_t> bytes2{ 1 };
+	std::vector<uint8_t> bytes3{ 4, 5 };
+	auto digest1 (filter.hash (bytes1.data (), bytes1.size ()));
+	auto digest2 (filter.hash (bytes2.data (), bytes2.size ()));
+	auto digest3 (filter.hash (bytes3.data (), bytes3.size ()));
+	ASSERT_FALSE (filter.apply (bytes1.data (), bytes1.size ()));
+	// Duplicates within the batch are detected in order
+	auto existed (filter.apply (std::vector<oslo::uint128_t>{ digest1, digest2, digest3, digest2 }));
+	ASSERT_EQ (std::vector<bool> ({ true, false, false, true }), existed);
+	ASSERT_TRUE (filter.apply (bytes2.data (), bytes2.size ()));
+	ASSERT_TRUE (filter.apply (bytes3.data (), bytes3.size ()));
+	filter.clear (std::vector<oslo::uint128_t>{ digest1, digest3 });
+	existed = filter.apply (std::vector<oslo::uint128_t>{ digest1, digest2, digest3 });
+	ASSERT_EQ (std::vector<bool> ({ false, true, false }), existed);
+}
@@ -312,7 +312,7 @@ TEST (node, auto_bootstrap)
 	}
 
 	auto transaction = node1->store.tx_begin_read ();
-	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->store.unchecked_count (transaction));
+	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->unchecked.count (transaction));
 
 	node1->stop ();
 }
@@ -2555,6 +2555,31 @@ TEST (node, online_reps)
 	ASSERT_EQ (node1.config.online_weight_minimum, node1.online_reps.online_stake ());
 }
 
+// Online weight follows weight changes of observed representatives without resampling
+TEST (node, online_reps_weight_change)
+{
+	oslo::system system (1);
+	auto & node1 (*system.nodes[0]);
+	oslo::genesis genesis;
+	oslo::keypair key;
+	node1.online_reps.observe (oslo::test_genesis_key.pub);
+	ASSERT_EQ (oslo::genesis_amount, node1.online_reps.online ());
+	ASSERT_EQ (1, node1.online_reps.list ().size ());
+	auto send (std::make_shared<oslo::state_block> (oslo::test_genesis_key.pub, genesis.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - oslo::Gxrb_ratio, key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	{
+		auto transaction (node1.store.tx_begin_write ());
+		ASSERT_EQ (oslo::process_result::progress, node1.ledger.process (transaction, *send).code);
+	}
+	// Sent amount is pending and no longer counted, unweighted accounts are not observed
+	ASSERT_EQ (oslo::genesis_amount - oslo::Gxrb_ratio, node1.online_reps.online ());
+	node1.online_reps.observe (key.pub);
+	ASSERT_EQ (oslo::genesis_amount - oslo::Gxrb_ratio, node1.online_reps.online ());
+	node1.online_reps.sample ();
+	ASSERT_EQ (0, node1.online_reps.online ());
+	ASSERT_TRUE (node1.online_reps.list ().empty ());
+	ASSERT_EQ (oslo::genesis_amount - oslo::Gxrb_ratio, node1.online_reps.online_stake ());
+}
+
 TEST (node, block_confirm)
 {
 	std::vector<oslo::transport::transport_type> types{ oslo::transport::transport_type::tcp, oslo::transport::transport_type::udp };
@@ -2684,6 +2709,7 @@ TEST (node, local_votes_cache)
 	oslo::node_config node_config (oslo::get_available_port (), system.logging);
 	node_config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
 	node_config.receive_minimum = oslo::genesis_amount;
+	node_config.votes_cache_max_bytes = 2 * oslo::votes_cache::entry_bytes_estimate ();
 	auto & node (*system.add_node (node_config));
 	oslo::genesis genesis;
 	auto send1 (std::make_shared<oslo::state_block> (oslo::test_genesis_key.pub, genesis.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - oslo::Gxrb_ratio, oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *node.work_generate_blocking (genesis.hash ())));
@@ -2765,7 +2791,7 @@ TEST (node, local_votes_cache_batch)
 	oslo::node_config node_config (oslo::get_available_port (), system.logging);
 	node_config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
 	auto & node (*system.add_node (node_config));
-	ASSERT_GE (node.network_params.voting.max_cache, 2);
+	ASSERT_GE (node.config.votes_cache_max_bytes, 2 * oslo::votes_cache::entry_bytes_estimate ());
 	oslo::genesis genesis;
 	system.wallet (0)->insert_adhoc (oslo::test_genesis_key.prv);
 	auto send1 (std::make_shared<oslo::state_block> (oslo::test_genesis_key.pub, genesis.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - oslo::Gxrb_ratio, oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *node.work_generate_blocking (genesis.hash ())));
@@ -2877,7 +2903,7 @@ TEST (node, local_votes_cache_generate_new_vote)
 	ASSERT_EQ (3, node.stats.count (oslo::stat::type::message, oslo::stat::detail::confirm_ack, oslo::stat::dir::out));
 }
 
-// Tests that the max cache size is inversely proportional to the number of voting accounts
+// Tests that the cache budget covers the votes of all voting accounts, more of them do not shrink it further
 TEST (node, local_votes_cache_size)
 {
 	oslo::system system;
@@ -2885,22 +2911,71 @@ TEST (node, local_votes_cache_size)
 	node_config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
 	node_config.vote_minimum = 0; // wallet will pick up the second account as voting even if unopened
 	auto & node (*system.add_node (node_config));
-	ASSERT_EQ (node.network_params.voting.max_cache, 2); // effective cache size is 1 with 2 voting accounts
 	oslo::keypair key;
 	auto & wallet (*system.wallet (0));
 	wallet.insert_adhoc (oslo::test_genesis_key.prv);
-	wallet.insert_adhoc (oslo::keypair ().prv);
+	wallet.insert_adhoc (key.prv);
 	ASSERT_EQ (2, node.wallets.reps ().voting);
-	auto transaction (node.store.tx_begin_read ());
-	auto vote1 (node.store.vote_generate (transaction, oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, { oslo::genesis_hash }));
-	oslo::block_hash hash (1);
-	auto vote2 (node.store.vote_generate (transaction, oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, { hash }));
+	auto add = [&key](oslo::votes_cache & cache_a, oslo::block_hash const & hash_a) {
+		cache_a.add (std::make_shared<oslo::vote> (oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, 1, std::vector<oslo::block_hash>{ hash_a }));
+		cache_a.add (std::make_shared<oslo::vote> (key.pub, key.prv, 1, std::vector<oslo::block_hash>{ hash_a }));
+	};
+	// Cost of a hash voted by both accounts
+	oslo::votes_cache unbounded (node.wallets, std::numeric_limits<size_t>::max ());
+	add (unbounded, 1);
+	auto const hash_bytes (unbounded.bytes ());
+	oslo::votes_cache cache (node.wallets, 2 * hash_bytes);
+	add (cache, 1);
+	add (cache, 2);
+	ASSERT_EQ (2, cache.size ());
+	ASSERT_EQ (2, cache.find (1).size ());
+	ASSERT_EQ (2, cache.find (2).size ());
+	add (cache, 3);
+	ASSERT_EQ (2, cache.size ());
+	ASSERT_EQ (4, cache.votes_size ());
+	ASSERT_EQ (2, cache.find (3).size ());
+	ASSERT_LE (cache.bytes (), 2 * hash_bytes);
+}
+
+// Tests that a vote covering several hashes is stored once and released when all of its hashes are evicted
+TEST (node, local_votes_cache_shared_votes)
+{
+	oslo::system system;
+	oslo::node_config node_config (oslo::get_available_port (), system.logging);
+	node_config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
+	node_config.votes_cache_max_bytes = 2 * oslo::votes_cache::entry_bytes_estimate ();
+	auto & node (*system.add_node (node_config));
+	system.wallet (0)->insert_adhoc (oslo::test_genesis_key.prv);
+	ASSERT_EQ (1, node.wallets.reps ().voting);
+	std::vector<oslo::block_hash> hashes{ 1, 2 };
+	auto vote1 (std::make_shared<oslo::vote> (oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, 1, hashes));
 	node.votes_cache.add (vote1);
-	node.votes_cache.add (vote2);
-	auto existing2 (node.votes_cache.find (hash));
-	ASSERT_EQ (1, existing2.size ());
-	ASSERT_EQ (vote2, existing2.front ());
-	ASSERT_EQ (0, node.votes_cache.find (oslo::genesis_hash).size ());
+	ASSERT_EQ (2, node.votes_cache.size ());
+	ASSERT_EQ (1, node.votes_cache.votes_size ());
+	ASSERT_EQ (vote1, node.votes_cache.find (1).front ());
+	ASSERT_EQ (vote1, node.votes_cache.find (2).front ());
+	ASSERT_LE (node.votes_cache.bytes (), 2 * oslo::votes_cache::entry_bytes_estimate ());
+	// The vote is kept until no hash references it
+	node.votes_cache.remove (1);
+	ASSERT_EQ (1, node.votes_cache.size ());
+	ASSERT_EQ (1, node.votes_cache.votes_size ());
+	node.votes_cache.remove (2);
+	ASSERT_EQ (0, node.votes_cache.size ());
+	ASSERT_EQ (0, node.votes_cache.votes_size ());
+	ASSERT_EQ (0, node.votes_cache.bytes ());
+	// Byte budget holds two single-hash entries, the entry not referenced since insertion is evicted
+	auto vote3 (std::make_shared<oslo::vote> (oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, 3, std::vector<oslo::block_hash>{ 3 }));
+	auto vote4 (std::make_shared<oslo::vote> (oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, 4, std::vector<oslo::block_hash>{ 4 }));
+	auto vote5 (std::make_shared<oslo::vote> (oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, 5, std::vector<oslo::block_hash>{ 5 }));
+	node.votes_cache.add (vote3);
+	node.votes_cache.add (vote4);
+	ASSERT_FALSE (node.votes_cache.find (3).empty ());
+	node.votes_cache.add (vote5);
+	ASSERT_EQ (2, node.votes_cache.size ());
+	ASSERT_FALSE (node.votes_cache.find (3).empty ());
+	ASSERT_TRUE (node.votes_cache.find (4).empty ());
+	ASSERT_FALSE (node.votes_cache.find (5).empty ());
+	ASSERT_LE (node.votes_cache.bytes (), 2 * oslo::votes_cache::entry_bytes_estimate ());
 }
 
 TEST (node, vote_republish)
@@ -3262,8 +3337,7 @@ TEST (node, block_processor_signatures)
 	// Invalid signature to unchecked
 	{
 		auto transaction (node1.store.tx_begin_write ());
-		node1.store.unchecked_put (transaction, send5->previous (), send5);
-		++node1.ledger.cache.unchecked_count;
+		node1.unchecked.put (transaction, oslo::unchecked_key (send5->previous (), send5->hash ()), oslo::unchecked_info (send5, send5->account (), oslo::seconds_since_epoch (), oslo::signature_verification::unknown));
 	}
 	auto receive1 (std::make_shared<oslo::state_block> (key1.pub, 0, oslo::test_genesis_key.pub, oslo::Gxrb_ratio, send1->hash (), key1.prv, key1.pub, 0));
 	node1.work_generate_blocking (*receive1);
@@ -3539,7 +3613,7 @@ TEST (node, unchecked_cleanup)
 	node.config.unchecked_cutoff_time = std::chrono::seconds (2);
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
@@ -3548,7 +3622,7 @@ TEST (node, unchecked_cleanup)
 	ASSERT_TRUE (node.network.publish_filter.apply (bytes.data (), bytes.size ()));
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
@@ -3557,12 +3631,95 @@ TEST (node, unchecked_cleanup)
 	ASSERT_FALSE (node.network.publish_filter.apply (bytes.data (), bytes.size ()));
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
 }
 
+TEST (node, unchecked_map)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	oslo::ledger_cache cache;
+	oslo::unchecked_map unchecked (*store, cache, 2, false);
+	std::vector<std::shared_ptr<oslo::state_block>> blocks;
+	for (auto i (0); i < 3; ++i)
+	{
+		blocks.push_back (std::make_shared<oslo::state_block> (oslo::keypair ().pub, i + 1, 0, 0, 0, oslo::keypair ().prv, 0, 0));
+	}
+	auto key = [](std::shared_ptr<oslo::state_block> const & block_a) { return oslo::unchecked_key (block_a->previous (), block_a->hash ()); };
+	{
+		auto transaction (store->tx_begin_write ());
+		for (auto i (0); i < 3; ++i)
+		{
+			unchecked.put (transaction, key (blocks[i]), oslo::unchecked_info (blocks[i], 0, i + 1, oslo::signature_verification::unknown));
+		}
+		// The entry modified first is moved to the table once the memory budget is exceeded
+		ASSERT_EQ (3, unchecked.count (transaction));
+		ASSERT_EQ (2, unchecked.memory_size ());
+		ASSERT_EQ (1, unchecked.table_size ());
+		ASSERT_EQ (1, store->unchecked_count (transaction));
+		ASSERT_EQ (3, cache.unchecked_count);
+		ASSERT_TRUE (store->unchecked_exists (transaction, key (blocks[0])));
+		for (auto const & block : blocks)
+		{
+			auto infos (unchecked.get (transaction, block->previous ()));
+			ASSERT_EQ (1, infos.size ());
+			ASSERT_EQ (*block, *infos[0].block);
+		}
+		size_t visited (0);
+		unchecked.for_each (transaction, oslo::unchecked_key (0, 0), [&visited](oslo::unchecked_key const &, oslo::unchecked_info const &) {
+			++visited;
+			return true;
+		});
+		ASSERT_EQ (3, visited);
+		unchecked.del (transaction, key (blocks[0]));
+		ASSERT_EQ (0, unchecked.table_size ());
+		ASSERT_EQ (0, store->unchecked_count (transaction));
+		ASSERT_EQ (2, cache.unchecked_count);
+	}
+	// Only memory entries modified before the cutoff are expired
+	auto expired (unchecked.erase_expired (3));
+	ASSERT_EQ (1, expired.size ());
+	ASSERT_EQ (*blocks[1], *expired[0]);
+	ASSERT_EQ (1, cache.unchecked_count);
+	{
+		auto transaction (store->tx_begin_write ());
+		unchecked.flush (transaction);
+		ASSERT_EQ (0, unchecked.memory_size ());
+		ASSERT_EQ (1, store->unchecked_count (transaction));
+		ASSERT_EQ (1, unchecked.get (transaction, blocks[2]->previous ()).size ());
+		unchecked.clear (transaction);
+		ASSERT_EQ (0, unchecked.count (transaction));
+		ASSERT_EQ (0, store->unchecked_count (transaction));
+		ASSERT_EQ (0, cache.unchecked_count);
+	}
+}
+
+TEST (node, unchecked_map_memory_only)
+{
+	oslo::logger_mt logger;
+	auto store = oslo::make_store (logger, oslo::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	oslo::ledger_cache cache;
+	oslo::unchecked_map unchecked (*store, cache, 1, true);
+	auto block1 (std::make_shared<oslo::state_block> (1, 1, 0, 0, 0, oslo::keypair ().prv, 0, 0));
+	auto block2 (std::make_shared<oslo::state_block> (2, 2, 0, 0, 0, oslo::keypair ().prv, 0, 0));
+	auto transaction (store->tx_begin_write ());
+	unchecked.put (transaction, oslo::unchecked_key (block1->previous (), block1->hash ()), oslo::unchecked_info (block1, 0, 1, oslo::signature_verification::unknown));
+	unchecked.put (transaction, oslo::unchecked_key (block2->previous (), block2->hash ()), oslo::unchecked_info (block2, 0, 2, oslo::signature_verification::unknown));
+	// The oldest entry is dropped instead of being written to the table
+	ASSERT_EQ (1, unchecked.count (transaction));
+	ASSERT_EQ (1, cache.unchecked_count);
+	ASSERT_EQ (0, store->unchecked_count (transaction));
+	ASSERT_TRUE (unchecked.get (transaction, block1->previous ()).empty ());
+	ASSERT_EQ (1, unchecked.get (transaction, block2->previous ()).size ());
+	unchecked.flush (transaction);
+	ASSERT_EQ (0, store->unchecked_count (transaction));
+}
+
 /** This checks that a node can be opened (without being blocked) when a write lock is held elsewhere */
 TEST (node, dont_write_lock_node)
 {
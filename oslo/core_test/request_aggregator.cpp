@@ -122,6 +122,8 @@ TEST (request_aggregator, two_endpoints)
 	oslo::system system;
 	oslo::node_config node_config (oslo::get_available_port (), system.logging);
 	node_config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
+	// The second request relies on the vote generated for the first one
+	node_config.request_aggregator_threads = 1;
 	oslo::node_flags node_flags;
 	node_flags.disable_rep_crawler = true;
 	auto & node1 (*system.add_node (node_config, node_flags));
@@ -152,6 +154,33 @@ TEST (request_aggregator, two_endpoints)
 	ASSERT_TIMELY (3s, 0 == node1.stats.count (oslo::stat::type::requests, oslo::stat::detail::requests_cannot_vote));
 }
 
+TEST (request_aggregator, multiple_workers)
+{
+	oslo::system system;
+	oslo::node_config node_config (oslo::get_available_port (), system.logging);
+	node_config.frontiers_confirmation = oslo::frontiers_confirmation_mode::disabled;
+	node_config.request_aggregator_threads = 4;
+	auto & node (*system.add_node (node_config));
+	oslo::genesis genesis;
+	system.wallet (0)->insert_adhoc (oslo::test_genesis_key.prv);
+	auto send1 (std::make_shared<oslo::state_block> (oslo::test_genesis_key.pub, genesis.hash (), oslo::test_genesis_key.pub, oslo::genesis_amount - oslo::Gxrb_ratio, oslo::test_genesis_key.pub, oslo::test_genesis_key.prv, oslo::test_genesis_key.pub, *node.work_generate_blocking (genesis.hash ())));
+	ASSERT_EQ (oslo::process_result::progress, node.ledger.process (node.store.tx_begin_write (), *send1).code);
+	std::vector<std::pair<oslo::block_hash, oslo::root>> request;
+	request.emplace_back (send1->hash (), send1->root ());
+	size_t const channels_count (8);
+	for (size_t i (0); i < channels_count; ++i)
+	{
+		auto channel (node.network.udp_channels.create (oslo::endpoint (boost::asio::ip::address_v6::loopback (), oslo::get_available_port ())));
+		node.aggregator.add (channel, request);
+	}
+	ASSERT_TIMELY (3s, node.aggregator.empty ());
+	ASSERT_EQ (channels_count, node.stats.count (oslo::stat::type::aggregator, oslo::stat::detail::aggregator_accepted));
+	ASSERT_EQ (0, node.stats.count (oslo::stat::type::aggregator, oslo::stat::detail::aggregator_dropped));
+	// Every request is answered, either from the cache or with a generated vote
+	ASSERT_TIMELY (3s, channels_count == node.stats.count (oslo::stat::type::requests, oslo::stat::detail::requests_generated_hashes) + node.stats.count (oslo::stat::type::requests, oslo::stat::detail::requests_cached_hashes));
+	ASSERT_EQ (0, node.stats.count (oslo::stat::type::requests, oslo::stat::detail::requests_unknown));
+}
+
 TEST (request_aggregator, split)
 {
 	constexpr size_t max_vbh = oslo::network::confirm_ack_hashes_max;
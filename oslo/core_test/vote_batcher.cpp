@@ -0,0 +1,79 @@
+#include <oslo/core_test/testutil.hpp>
+#include <oslo/node/testing.hpp>
+#include <oslo/node/vote_batcher.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+std::shared_ptr<oslo::vote> make_vote (oslo::keypair const & key_a, uint64_t sequence_a)
+{
+	return std::make_shared<oslo::vote> (key_a.pub, key_a.prv, sequence_a, std::vector<oslo::block_hash>{ oslo::block_hash (sequence_a) });
+}
+}
+
+TEST (vote_batcher, deadline)
+{
+	oslo::system system (2);
+	auto & node1 (*system.nodes[0]);
+	auto & node2 (*system.nodes[1]);
+	auto channel (node1.network.tcp_channels.find_channel (oslo::transport::map_endpoint_to_tcp (node2.network.endpoint ())));
+	ASSERT_NE (nullptr, channel);
+	oslo::keypair key;
+	for (auto i (1); i <= 3; ++i)
+	{
+		node1.vote_batcher.add (channel, make_vote (key, i));
+	}
+	ASSERT_TIMELY (5s, 1 == node1.stats.count (oslo::stat::type::vote_batcher, oslo::stat::detail::batch_deadline, oslo::stat::dir::out));
+	ASSERT_EQ (3, node1.stats.count (oslo::stat::type::vote_batcher, oslo::stat::detail::batch_votes, oslo::stat::dir::out));
+	ASSERT_EQ (0, node1.vote_batcher.size ());
+	// All three arrive from the single write
+	ASSERT_TIMELY (5s, 3 <= node2.stats.count (oslo::stat::type::message, oslo::stat::detail::confirm_ack, oslo::stat::dir::in));
+}
+
+TEST (vote_batcher, full)
+{
+	oslo::system system;
+	oslo::node_config node_config (oslo::get_available_port (), system.logging);
+	// Only the size cap flushes
+	node_config.vote_batch_delay = 1h;
+	auto & node1 (*system.add_node (node_config));
+	node_config.peering_port = oslo::get_available_port ();
+	auto & node2 (*system.add_node (node_config));
+	auto channel (node1.network.tcp_channels.find_channel (oslo::transport::map_endpoint_to_tcp (node2.network.endpoint ())));
+	ASSERT_NE (nullptr, channel);
+	oslo::keypair key;
+	for (auto i (1); i < oslo::vote_batcher::max_votes; ++i)
+	{
+		node1.vote_batcher.add (channel, make_vote (key, i));
+	}
+	ASSERT_EQ (1, node1.vote_batcher.size ());
+	ASSERT_EQ (0, node1.stats.count (oslo::stat::type::vote_batcher, oslo::stat::detail::batch_full, oslo::stat::dir::out));
+	node1.vote_batcher.add (channel, make_vote (key, oslo::vote_batcher::max_votes));
+	ASSERT_EQ (0, node1.vote_batcher.size ());
+	ASSERT_EQ (1, node1.stats.count (oslo::stat::type::vote_batcher, oslo::stat::detail::batch_full, oslo::stat::dir::out));
+	ASSERT_EQ (oslo::vote_batcher::max_votes, node1.stats.count (oslo::stat::type::vote_batcher, oslo::stat::detail::batch_votes, oslo::stat::dir::out));
+	ASSERT_TIMELY (5s, oslo::vote_batcher::max_votes <= node2.stats.count (oslo::stat::type::message, oslo::stat::detail::confirm_ack, oslo::stat::dir::in));
+}
+
+TEST (vote_batcher, direct)
+{
+	oslo::system system;
+	oslo::node_config node_config (oslo::get_available_port (), system.logging);
+	node_config.vote_batch_delay = 0ms;
+	auto & node1 (*system.add_node (node_config));
+	node_config.peering_port = oslo::get_available_port ();
+	auto & node2 (*system.add_node (node_config));
+	auto channel (node1.network.tcp_channels.find_channel (oslo::transport::map_endpoint_to_tcp (node2.network.endpoint ())));
+	ASSERT_NE (nullptr, channel);
+	oslo::keypair key;
+	node1.vote_batcher.add (channel, make_vote (key, 1));
+	// UDP channels are never batched
+	auto channel_udp (node1.network.udp_channels.create (node2.network.endpoint ()));
+	node1.vote_batcher.add (channel_udp, make_vote (key, 2));
+	ASSERT_EQ (0, node1.vote_batcher.size ());
+	ASSERT_EQ (0, node1.stats.count (oslo::stat::type::vote_batcher, oslo::stat::detail::batch_votes, oslo::stat::dir::out));
+	ASSERT_EQ (2, node1.stats.count (oslo::stat::type::message, oslo::stat::detail::confirm_ack, oslo::stat::dir::out));
+}
@@ -188,8 +188,12 @@ TEST (vote_processor, no_broadcast_local)
 	oslo::system system;
 	oslo::node_flags flags;
 	flags.disable_request_loop = true;
-	auto & node (*system.add_node (flags));
-	system.add_node (flags);
+	oslo::node_config node_config (oslo::get_available_port (), system.logging);
+	// Votes are counted as sent when they are written, not when batched for the peer
+	node_config.vote_batch_delay = 0ms;
+	auto & node (*system.add_node (node_config, flags));
+	node_config.peering_port = oslo::get_available_port ();
+	system.add_node (node_config, flags);
 	oslo::block_builder builder;
 	std::error_code ec;
 	// Reduce the weight of genesis to 2x default min voting weight
@@ -197,6 +197,41 @@ TEST (wallets, vote_minimum)
 	ASSERT_EQ (2, wallet->representatives.size ());
 }
 
+TEST (wallets, voting_keys_cache)
+{
+	oslo::system system (1);
+	auto & node (*system.nodes[0]);
+	auto wallet (system.wallet (0));
+	wallet->insert_adhoc (oslo::test_genesis_key.prv);
+	auto count_representatives = [&node]() {
+		size_t result (0);
+		node.wallets.foreach_representative ([&result](oslo::public_key const & pub_a, oslo::raw_key const & prv_a) {
+			ASSERT_EQ (oslo::test_genesis_key.pub, pub_a);
+			ASSERT_EQ (oslo::test_genesis_key.prv, prv_a);
+			++result;
+		});
+		return result;
+	};
+	ASSERT_EQ (1, count_representatives ());
+	// Locking the wallet must drop the cached keys
+	oslo::raw_key empty;
+	empty.data.clear ();
+	wallet->store.password.value_set (empty);
+	ASSERT_EQ (0, count_representatives ());
+	{
+		auto transaction (node.wallets.tx_begin_write ());
+		ASSERT_FALSE (wallet->enter_password (transaction, ""));
+	}
+	ASSERT_EQ (1, count_representatives ());
+	// Removing the account must drop its cached key
+	{
+		auto transaction (node.wallets.tx_begin_write ());
+		wallet->erase (transaction, oslo::test_genesis_key.pub);
+	}
+	ASSERT_EQ (0, wallet->representatives.count (oslo::test_genesis_key.pub));
+	ASSERT_EQ (0, count_representatives ());
+}
+
 TEST (wallets, exists)
 {
 	oslo::system system (1);
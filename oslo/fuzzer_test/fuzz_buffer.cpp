@@ -53,6 +53,9 @@ public:
 	virtual void telemetry_ack (oslo::telemetry_ack const &) override
 	{
 	}
+	virtual void publish_batch (oslo::publish_batch const &) override
+	{
+	}
 };
 }
 
@@ -42,6 +42,15 @@ const bool is_sanitizer_build = true;
 const bool is_sanitizer_build = false;
 #endif
 
+/** Backend used by asio for socket operations, io_uring is selected at build time with OSLO_IO_URING */
+#if defined(OSLO_IO_URING)
+const char * const NETWORK_IO_BACKEND = "io_uring";
+#elif defined(__linux__)
+const char * const NETWORK_IO_BACKEND = "epoll";
+#else
+const char * const NETWORK_IO_BACKEND = "default";
+#endif
+
 namespace oslo
 {
 uint8_t get_major_node_version ();
@@ -2,6 +2,7 @@
 
 #include <boost/filesystem.hpp>
 
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -29,3 +30,13 @@ void oslo::set_secure_perm_file (boost::filesystem::path const & path, boost::sy
 {
 	boost::filesystem::permissions (path, boost::filesystem::perms::owner_read | boost::filesystem::perms::owner_write, ec);
 }
+
+bool oslo::lock_memory (void const * address, size_t size)
+{
+	return mlock (address, size) != 0;
+}
+
+void oslo::unlock_memory (void const * address, size_t size)
+{
+	munlock (address, size);
+}
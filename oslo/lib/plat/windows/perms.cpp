@@ -57,3 +57,13 @@ bool oslo::is_windows_elevated ()
 	}
 	return is_elevated;
 }
+
+bool oslo::lock_memory (void const * address, size_t size)
+{
+	return VirtualLock (const_cast<void *> (address), size) == 0;
+}
+
+void oslo::unlock_memory (void const * address, size_t size)
+{
+	VirtualUnlock (const_cast<void *> (address), size);
+}
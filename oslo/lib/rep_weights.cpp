@@ -27,18 +27,30 @@ std::unordered_map<oslo::account, oslo::uint128_t> oslo::rep_weights::get_rep_am
 	return rep_amounts;
 }
 
+void oslo::rep_weights::observe (std::function<void(oslo::account const &, oslo::uint128_t const &, oslo::uint128_t const &)> const & observer_a)
+{
+	oslo::lock_guard<std::mutex> guard (mutex);
+	observer = observer_a;
+}
+
 void oslo::rep_weights::put (oslo::account const & account_a, oslo::uint128_union const & representation_a)
 {
 	auto it = rep_amounts.find (account_a);
 	auto amount = representation_a.number ();
+	oslo::uint128_t previous{ 0 };
 	if (it != rep_amounts.end ())
 	{
+		previous = it->second;
 		it->second = amount;
 	}
 	else
 	{
 		rep_amounts.emplace (account_a, amount);
 	}
+	if (observer && previous != amount)
+	{
+		observer (account_a, previous, amount);
+	}
 }
 
 oslo::uint128_t oslo::rep_weights::get (oslo::account const & account_a)
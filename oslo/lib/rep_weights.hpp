@@ -3,6 +3,7 @@
 #include <oslo/lib/numbers.hpp>
 #include <oslo/lib/utility.hpp>
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -19,10 +20,13 @@ public:
 	oslo::uint128_t representation_get (oslo::account const & account_a);
 	void representation_put (oslo::account const & account_a, oslo::uint128_union const & representation_a);
 	std::unordered_map<oslo::account, oslo::uint128_t> get_rep_amounts ();
+	/** Sets a callback invoked with the previous and new weight whenever a representative's weight changes. It is called with the internal mutex held so it must not call back into this object */
+	void observe (std::function<void(oslo::account const &, oslo::uint128_t const &, oslo::uint128_t const &)> const &);
 
 private:
 	std::mutex mutex;
 	std::unordered_map<oslo::account, oslo::uint128_t> rep_amounts;
+	std::function<void(oslo::account const &, oslo::uint128_t const &, oslo::uint128_t const &)> observer;
 	void put (oslo::account const & account_a, oslo::uint128_union const & representation_a);
 	oslo::uint128_t get (oslo::account const & account_a);
 
@@ -450,6 +450,18 @@ std::string oslo::stat::type_to_string (uint32_t key)
 		case oslo::stat::type::telemetry:
 			res = "telemetry";
 			break;
+		case oslo::stat::type::vote_generator:
+			res = "vote_generator";
+			break;
+		case oslo::stat::type::bandwidth:
+			res = "bandwidth";
+			break;
+		case oslo::stat::type::bandwidth_drop:
+			res = "bandwidth_drop";
+			break;
+		case oslo::stat::type::vote_batcher:
+			res = "vote_batcher";
+			break;
 	}
 	return res;
 }
@@ -481,6 +493,9 @@ std::string oslo::stat::detail_to_string (uint32_t key)
 		case oslo::stat::detail::bulk_pull_failed_account:
 			res = "bulk_pull_failed_account";
 			break;
+		case oslo::stat::detail::bulk_pull_pipelined:
+			res = "bulk_pull_pipelined";
+			break;
 		case oslo::stat::detail::bulk_pull_receive_block_failure:
 			res = "bulk_pull_receive_block_failure";
 			break;
@@ -490,6 +505,24 @@ std::string oslo::stat::detail_to_string (uint32_t key)
 		case oslo::stat::detail::bulk_push:
 			res = "bulk_push";
 			break;
+		case oslo::stat::detail::checkpoint_cemented:
+			res = "checkpoint_cemented";
+			break;
+		case oslo::stat::detail::checkpoint_invalid:
+			res = "checkpoint_invalid";
+			break;
+		case oslo::stat::detail::checkpoint_mismatch:
+			res = "checkpoint_mismatch";
+			break;
+		case oslo::stat::detail::checkpoint_rollback:
+			res = "checkpoint_rollback";
+			break;
+		case oslo::stat::detail::checkpoint_trusted:
+			res = "checkpoint_trusted";
+			break;
+		case oslo::stat::detail::checkpoint_validated:
+			res = "checkpoint_validated";
+			break;
 		case oslo::stat::detail::active_quorum:
 			res = "observer_confirmation_active_quorum";
 			break;
@@ -580,6 +613,9 @@ std::string oslo::stat::detail_to_string (uint32_t key)
 		case oslo::stat::detail::telemetry_ack:
 			res = "telemetry_ack";
 			break;
+		case oslo::stat::detail::publish_batch:
+			res = "publish_batch";
+			break;
 		case oslo::stat::detail::state_block:
 			res = "state_block";
 			break;
@@ -637,6 +673,39 @@ std::string oslo::stat::detail_to_string (uint32_t key)
 		case oslo::stat::detail::overflow:
 			res = "overflow";
 			break;
+		case oslo::stat::detail::batch_syscall:
+			res = "batch_syscall";
+			break;
+		case oslo::stat::detail::batch_packet:
+			res = "batch_packet";
+			break;
+		case oslo::stat::detail::class_vote:
+			res = "class_vote";
+			break;
+		case oslo::stat::detail::class_publish:
+			res = "class_publish";
+			break;
+		case oslo::stat::detail::class_confirm_req:
+			res = "class_confirm_req";
+			break;
+		case oslo::stat::detail::class_bootstrap:
+			res = "class_bootstrap";
+			break;
+		case oslo::stat::detail::class_telemetry:
+			res = "class_telemetry";
+			break;
+		case oslo::stat::detail::class_other:
+			res = "class_other";
+			break;
+		case oslo::stat::detail::batch_full:
+			res = "batch_full";
+			break;
+		case oslo::stat::detail::batch_deadline:
+			res = "batch_deadline";
+			break;
+		case oslo::stat::detail::batch_votes:
+			res = "batch_votes";
+			break;
 		case oslo::stat::detail::tcp_accept_success:
 			res = "accept_success";
 			break;
@@ -652,6 +721,9 @@ std::string oslo::stat::detail_to_string (uint32_t key)
 		case oslo::stat::detail::tcp_excluded:
 			res = "tcp_excluded";
 			break;
+		case oslo::stat::detail::tcp_message_drop:
+			res = "tcp_message_drop";
+			break;
 		case oslo::stat::detail::unreachable_host:
 			res = "unreachable_host";
 			break;
@@ -700,6 +772,15 @@ std::string oslo::stat::detail_to_string (uint32_t key)
 		case oslo::stat::detail::blocks_confirmed_bounded:
 			res = "blocks_confirmed_bounded";
 			break;
+		case oslo::stat::detail::parallel_batch:
+			res = "parallel_batch";
+			break;
+		case oslo::stat::detail::parallel_groups:
+			res = "parallel_groups";
+			break;
+		case oslo::stat::detail::parallel_workers:
+			res = "parallel_workers";
+			break;
 		case oslo::stat::detail::aggregator_accepted:
 			res = "aggregator_accepted";
 			break;
@@ -748,6 +829,12 @@ std::string oslo::stat::detail_to_string (uint32_t key)
 		case oslo::stat::detail::failed_send_telemetry_req:
 			res = "failed_send_telemetry_req";
 			break;
+		case oslo::stat::detail::generator_signed:
+			res = "generator_signed";
+			break;
+		case oslo::stat::detail::generator_signing_time:
+			res = "generator_signing_time";
+			break;
 	}
 	return res;
 }
@@ -202,6 +202,10 @@ public:
 		requests,
 		filter,
 		telemetry,
+		vote_generator,
+		bandwidth,
+		bandwidth_drop,
+		vote_batcher,
 	};
 
 	/** Optional detail type */
@@ -241,6 +245,7 @@ public:
 		node_id_handshake,
 		telemetry_req,
 		telemetry_ack,
+		publish_batch,
 
 		// bootstrap, callback
 		initiate,
@@ -253,9 +258,16 @@ public:
 		bulk_pull_deserialize_receive_block,
 		bulk_pull_error_starting_request,
 		bulk_pull_failed_account,
+		bulk_pull_pipelined,
 		bulk_pull_receive_block_failure,
 		bulk_pull_request_failure,
 		bulk_push,
+		checkpoint_cemented,
+		checkpoint_invalid,
+		checkpoint_mismatch,
+		checkpoint_rollback,
+		checkpoint_trusted,
+		checkpoint_validated,
 		frontier_req,
 		frontier_confirmation_failed,
 		frontier_confirmation_successful,
@@ -280,9 +292,24 @@ public:
 		election_drop,
 		election_restart,
 
+		// bandwidth, bandwidth_drop
+		class_vote,
+		class_publish,
+		class_confirm_req,
+		class_bootstrap,
+		class_telemetry,
+		class_other,
+
+		// vote_batcher
+		batch_full,
+		batch_deadline,
+		batch_votes,
+
 		// udp
 		blocking,
 		overflow,
+		batch_syscall,
+		batch_packet,
 		invalid_magic,
 		invalid_network,
 		invalid_header,
@@ -302,6 +329,7 @@ public:
 		tcp_write_drop,
 		tcp_write_no_socket_drop,
 		tcp_excluded,
+		tcp_message_drop,
 
 		// ipc
 		invocations,
@@ -313,6 +341,9 @@ public:
 		blocks_confirmed,
 		blocks_confirmed_unbounded,
 		blocks_confirmed_bounded,
+		parallel_batch,
+		parallel_groups,
+		parallel_workers,
 
 		// [request] aggregator
 		aggregator_accepted,
@@ -336,7 +367,11 @@ public:
 		request_within_protection_cache_zone,
 		no_response_received,
 		unsolicited_telemetry_ack,
-		failed_send_telemetry_req
+		failed_send_telemetry_req,
+
+		// vote generator
+		generator_signed,
+		generator_signing_time
 	};
 
 	/** Direction of the stat. If the direction is irrelevant, use in */
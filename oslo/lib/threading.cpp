@@ -81,6 +81,12 @@ std::string oslo::thread_role::get_string (oslo::thread_role::name role)
 		case oslo::thread_role::name::epoch_upgrader:
 			thread_role_name_string = "Epoch upgrader";
 			break;
+		case oslo::thread_role::name::ledger_import:
+			thread_role_name_string = "Ledger import";
+			break;
+		case oslo::thread_role::name::vote_batching:
+			thread_role_name_string = "Vote batching";
+			break;
 	}
 
 	/*
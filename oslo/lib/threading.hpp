@@ -35,7 +35,9 @@ namespace thread_role
 		worker,
 		request_aggregator,
 		state_block_signature_verification,
-		epoch_upgrader
+		epoch_upgrader,
+		ledger_import,
+		vote_batching
 	};
 	/*
 	 * Get/Set the identifier for the current thread
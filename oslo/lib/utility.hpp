@@ -88,6 +88,13 @@ void set_secure_perm_directory (boost::filesystem::path const & path, boost::sys
 void set_secure_perm_file (boost::filesystem::path const & path);
 void set_secure_perm_file (boost::filesystem::path const & path, boost::system::error_code & ec);
 
+/*
+ * Functions for keeping sensitive memory from being paged to disk, platform specific
+ * @return true if the pages could not be locked
+ */
+bool lock_memory (void const * address, size_t size);
+void unlock_memory (void const * address, size_t size);
+
 /*
  * Function to check if running Windows as an administrator
  */
@@ -16,10 +16,15 @@
 #include <boost/property_tree/json_parser.hpp>
 
 #include <csignal>
+#include <fstream>
 #include <future>
 #include <iomanip>
 #include <random>
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 /* Boost v1.70 introduced breaking changes; the conditional compilation allows 1.6x to be supported as well. */
 #if BOOST_VERSION < 107000
 using socket_type = boost::asio::ip::tcp::socket;
@@ -416,7 +421,105 @@ account_info account_info_rpc (boost::asio::io_context & ioc, tcp::resolver::res
 	return account_info;
 }
 
-/** This launches a node and fires a lot of send/recieve RPC requests at it (configurable), then other nodes are tested to make sure they observe these blocks as well. */
+std::string network_io_backend_rpc (boost::asio::io_context & ioc, tcp::resolver::results_type const & results)
+{
+	boost::property_tree::ptree request;
+	request.put ("action", "version");
+	auto json = rpc_request (request, ioc, results);
+	return json.get<std::string> ("network_io_backend", "unknown");
+}
+
+/** Realtime messages sent plus received by a node */
+uint64_t message_count_rpc (boost::asio::io_context & ioc, tcp::resolver::results_type const & results)
+{
+	boost::property_tree::ptree request;
+	request.put ("action", "stats");
+	request.put ("type", "counters");
+	auto json = rpc_request (request, ioc, results);
+	uint64_t result (0);
+	for (auto const & entry : json.get_child ("entries"))
+	{
+		if (entry.second.get<std::string> ("type") == "message" && entry.second.get<std::string> ("detail") == "all")
+		{
+			result += entry.second.get<uint64_t> ("value");
+		}
+	}
+	return result;
+}
+
+/** User plus system CPU time used by process \p pid, zero where /proc is not available */
+std::chrono::microseconds process_cpu_time (int pid)
+{
+	std::chrono::microseconds result{ 0 };
+#ifdef __linux__
+	std::ifstream stat_file ("/proc/" + std::to_string (pid) + "/stat");
+	std::string contents;
+	auto command_end (std::getline (stat_file, contents) ? contents.rfind (')') : std::string::npos);
+	if (command_end != std::string::npos)
+	{
+		// Fields are counted from the state, field 3, as the command name can contain spaces. utime and stime are fields 14 and 15
+		std::istringstream fields (contents.substr (command_end + 1));
+		std::string skipped;
+		for (auto i = 3; i < 14; ++i)
+		{
+			fields >> skipped;
+		}
+		uint64_t utime (0);
+		uint64_t stime (0);
+		if (fields >> utime >> stime)
+		{
+			result = std::chrono::microseconds ((utime + stime) * 1000000 / sysconf (_SC_CLK_TCK));
+		}
+	}
+#endif
+	return result;
+}
+
+class network_usage final
+{
+public:
+	uint64_t messages{ 0 };
+	std::chrono::microseconds cpu_time{ 0 };
+	std::chrono::steady_clock::time_point time{ std::chrono::steady_clock::now () };
+};
+
+network_usage network_usage_snapshot (boost::asio::io_context & ioc, tcp::resolver & resolver, int node_count, std::vector<int> const & node_pids)
+{
+	network_usage result;
+	for (int i = 0; i < node_count; ++i)
+	{
+		auto const results = resolver.resolve ("::1", std::to_string (rpc_port_start + i));
+		result.messages += message_count_rpc (ioc, results);
+	}
+	for (auto pid : node_pids)
+	{
+		result.cpu_time += process_cpu_time (pid);
+	}
+	return result;
+}
+
+/** Prints message throughput and node CPU time per message over all nodes between two snapshots */
+void network_usage_report (std::string const & backend, network_usage const & start, network_usage const & end)
+{
+	auto messages (end.messages - start.messages);
+	auto seconds (std::chrono::duration<double> (end.time - start.time).count ());
+	std::cout << "Network I/O backend: " << backend << "\n"
+	          << "Messages: " << messages << " in " << std::fixed << std::setprecision (2) << seconds << "s, " << (seconds > 0 ? messages / seconds : 0.0) << " messages/s" << std::endl;
+	if (end.cpu_time > start.cpu_time && messages > 0)
+	{
+		std::cout << "Node CPU time per message: " << static_cast<double> ((end.cpu_time - start.cpu_time).count ()) / messages << "us" << std::endl;
+	}
+	else
+	{
+		std::cout << "Node CPU time per message: unavailable" << std::endl;
+	}
+}
+
+/**
+ * This launches a node and fires a lot of send/recieve RPC requests at it (configurable), then other nodes are tested to make sure they observe these blocks as well.
+ * The realtime message rate and node CPU time per message over the run are reported, run once against an oslo_node
+ * built with OSLO_IO_URING and once against a default build to compare the io_uring and epoll backends.
+ */
 int main (int argc, char * const * argv)
 {
 	oslo::force_oslo_test_network ();
@@ -515,7 +618,14 @@ int main (int argc, char * const * argv)
 		nodes.emplace_back (std::make_unique<boost::process::child> (node_path, "--daemon", "--data_path", data_path.string (), "--network", current_network));
 		rpc_servers.emplace_back (std::make_unique<boost::process::child> (rpc_path, "--daemon", "--data_path", data_path.string (), "--network", current_network));
 	}
+	std::vector<int> node_pids;
+	for (auto const & node : nodes)
+	{
+		node_pids.push_back (node->id ());
+	}
 #else
+	// CPU time is only reported for child processes
+	std::vector<int> node_pids;
 	std::thread processes_thread ([&data_paths, &node_path, &rpc_path, &current_network]() {
 		auto formatted_command = "%1% --daemon --data_path=%2% --network=%3% %4%";
 		ASSERT_TRUE (!data_paths.empty ());
@@ -553,7 +663,7 @@ int main (int argc, char * const * argv)
 	tcp::resolver resolver{ ioc };
 	auto const primary_node_results = resolver.resolve ("::1", std::to_string (rpc_port_start));
 
-	std::thread t ([send_count, &ioc, &primary_node_results, &resolver, &node_count, &destination_count]() {
+	std::thread t ([send_count, &ioc, &primary_node_results, &resolver, &node_count, &destination_count, &node_pids]() {
 		for (int i = 0; i < node_count; ++i)
 		{
 			keepalive_rpc (ioc, primary_node_results, peering_port_start + i);
@@ -561,6 +671,9 @@ int main (int argc, char * const * argv)
 
 		std::cout << "Beginning tests" << std::endl;
 
+		auto network_backend = network_io_backend_rpc (ioc, primary_node_results);
+		auto network_start = network_usage_snapshot (ioc, resolver, node_count, node_pids);
+
 		// Create keys
 		std::vector<account> destination_accounts;
 		for (int i = 0; i < destination_count; ++i)
@@ -651,7 +764,13 @@ int main (int argc, char * const * argv)
 					std::this_thread::sleep_for (std::chrono::seconds (1));
 				}
 			}
+		}
+
+		network_usage_report (network_backend, network_start, network_usage_snapshot (ioc, resolver, node_count, node_pids));
 
+		for (int i = 1; i < node_count; ++i)
+		{
+			auto const results = resolver.resolve ("::1", std::to_string (rpc_port_start + i));
 			stop_rpc (ioc, results);
 		}
 
@@ -214,7 +214,7 @@ void oslo::block_processor::process_batch (oslo::unique_lock<std::mutex> & lock_
 {
 	auto scoped_write_guard = write_database_queue.wait (oslo::writer::process_batch);
 	block_post_events post_events;
-	auto transaction (node.store.tx_begin_write ({ tables::accounts, oslo::tables::cached_counts, oslo::tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked }, { tables::confirmation_height }));
+	auto transaction (node.store.tx_begin_write ({ tables::accounts, oslo::tables::cached_counts, oslo::tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::unchecked_modified }, { tables::confirmation_height }));
 	oslo::timer<std::chrono::milliseconds> timer_l;
 	lock_a.lock ();
 	timer_l.start ();
@@ -345,6 +345,10 @@ oslo::process_return oslo::block_processor::process_one (oslo::write_transaction
 				events_a.events.emplace_back ([this, hash, block = info_a.block, result, watch_work_a, origin_a]() { process_live (hash, block, result, watch_work_a, origin_a); });
 			}
 			queue_unchecked (transaction_a, hash);
+			if (node.bootstrap_initiator.checkpoint != nullptr && node.bootstrap_initiator.checkpoint->frontier_processed (*info_a.block))
+			{
+				events_a.events.emplace_back ([this, hash]() { node.confirmation_height_processor.add (hash); });
+			}
 			break;
 		}
 		case oslo::process_result::gap_previous:
@@ -359,13 +363,7 @@ oslo::process_return oslo::block_processor::process_one (oslo::write_transaction
 				info_a.modified = oslo::seconds_since_epoch ();
 			}
 
-			oslo::unchecked_key unchecked_key (info_a.block->previous (), hash);
-			auto exists = node.store.unchecked_exists (transaction_a, unchecked_key);
-			node.store.unchecked_put (transaction_a, unchecked_key, info_a);
-			if (!exists)
-			{
-				++node.ledger.cache.unchecked_count;
-			}
+			node.unchecked.put (transaction_a, oslo::unchecked_key (info_a.block->previous (), hash), info_a);
 
 			node.gap_cache.add (hash);
 			node.stats.inc (oslo::stat::type::ledger, oslo::stat::detail::gap_previous);
@@ -383,13 +381,7 @@ oslo::process_return oslo::block_processor::process_one (oslo::write_transaction
 				info_a.modified = oslo::seconds_since_epoch ();
 			}
 
-			oslo::unchecked_key unchecked_key (node.ledger.block_source (transaction_a, *(info_a.block)), hash);
-			auto exists = node.store.unchecked_exists (transaction_a, unchecked_key);
-			node.store.unchecked_put (transaction_a, unchecked_key, info_a);
-			if (!exists)
-			{
-				++node.ledger.cache.unchecked_count;
-			}
+			node.unchecked.put (transaction_a, oslo::unchecked_key (node.ledger.block_source (transaction_a, *(info_a.block)), hash), info_a);
 
 			node.gap_cache.add (hash);
 			node.stats.inc (oslo::stat::type::ledger, oslo::stat::detail::gap_source);
@@ -503,14 +495,12 @@ void oslo::block_processor::process_old (oslo::write_transaction const & transac
 
 void oslo::block_processor::queue_unchecked (oslo::write_transaction const & transaction_a, oslo::block_hash const & hash_a)
 {
-	auto unchecked_blocks (node.store.unchecked_get (transaction_a, hash_a));
+	auto unchecked_blocks (node.unchecked.get (transaction_a, hash_a));
 	for (auto & info : unchecked_blocks)
 	{
 		if (!node.flags.disable_block_processor_unchecked_deletion)
 		{
-			node.store.unchecked_del (transaction_a, oslo::unchecked_key (hash_a, info.block->hash ()));
-			debug_assert (node.ledger.cache.unchecked_count > 0);
-			--node.ledger.cache.unchecked_count;
+			node.unchecked.del (transaction_a, oslo::unchecked_key (hash_a, info.block->hash ()));
 		}
 		add (info, true);
 	}
@@ -10,9 +10,19 @@
 #include <algorithm>
 
 oslo::bootstrap_initiator::bootstrap_initiator (oslo::node & node_a) :
+peer_scores (node_a),
 node (node_a)
 {
 	connections = std::make_shared<oslo::bootstrap_connections> (node);
+	if (!node.flags.bootstrap_checkpoint.empty ())
+	{
+		checkpoint = std::make_unique<oslo::bootstrap_checkpoint> (node);
+		if (checkpoint->load (node.flags.bootstrap_checkpoint))
+		{
+			node.logger.always_log (boost::str (boost::format ("Unable to load bootstrap checkpoint %1%, bootstrapping without it") % node.flags.bootstrap_checkpoint));
+			checkpoint.reset ();
+		}
+	}
 	bootstrap_initiator_threads.push_back (boost::thread ([this]() {
 		oslo::thread_role::set (oslo::thread_role::name::bootstrap_connections);
 		connections->run ();
@@ -300,6 +310,11 @@ std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (bo
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "observers", count, sizeof_element }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "pulls_cache", cache_count, sizeof_cache_element }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "peer_scores", bootstrap_initiator.peer_scores.size (), sizeof (oslo::tcp_endpoint) + sizeof (oslo::bootstrap_peer_info) }));
+	if (bootstrap_initiator.checkpoint != nullptr)
+	{
+		composite->add_component (std::make_unique<container_info_leaf> (container_info{ "checkpoint_frontiers", bootstrap_initiator.checkpoint->size (), sizeof (oslo::block_hash) + sizeof (oslo::account) + sizeof (uint64_t) }));
+	}
 	return composite;
 }
 
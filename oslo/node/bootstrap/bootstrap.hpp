@@ -1,7 +1,9 @@
 #pragma once
 
 #include <oslo/node/bootstrap/bootstrap_bulk_pull.hpp>
+#include <oslo/node/bootstrap/bootstrap_checkpoint.hpp>
 #include <oslo/node/bootstrap/bootstrap_connections.hpp>
+#include <oslo/node/bootstrap/bootstrap_peer_scores.hpp>
 #include <oslo/node/common.hpp>
 
 #include <boost/multi_index/hashed_index.hpp>
@@ -99,6 +101,9 @@ public:
 	std::shared_ptr<oslo::bootstrap_attempt> current_wallet_attempt ();
 	oslo::pulls_cache cache;
 	oslo::bootstrap_attempts attempts;
+	/** Set when the node is started with a bootstrap checkpoint file */
+	std::unique_ptr<oslo::bootstrap_checkpoint> checkpoint;
+	oslo::bootstrap_peer_scores peer_scores;
 	void stop ();
 
 private:
@@ -123,9 +128,15 @@ class bootstrap_limits final
 public:
 	static constexpr double bootstrap_connection_scale_target_blocks = 10000.0;
 	static constexpr double bootstrap_connection_warmup_time_sec = 5.0;
+	static constexpr std::chrono::seconds bootstrap_connection_scale_interval = std::chrono::seconds (10);
+	static constexpr double bootstrap_connection_scale_improvement = 0.1;
+	static constexpr unsigned bootstrap_connection_scale_max_factor = 2;
+	static constexpr size_t bootstrap_peer_candidates = 8;
 	static constexpr double bootstrap_minimum_blocks_per_sec = 10.0;
 	static constexpr double bootstrap_minimum_elapsed_seconds_blockrate = 0.02;
 	static constexpr double bootstrap_minimum_frontier_blocks_per_sec = 1000.0;
+	static constexpr size_t frontier_accounts_batch_max = 4096;
+	static constexpr size_t frontier_req_ranges = 4;
 	static constexpr double bootstrap_minimum_termination_time_sec = 30.0;
 	static constexpr unsigned bootstrap_max_new_connections = 32;
 	static constexpr size_t bootstrap_max_confirm_frontiers = 70;
@@ -135,6 +146,7 @@ public:
 	static constexpr unsigned requeued_pulls_limit_test = 2;
 	static constexpr unsigned requeued_pulls_processed_blocks_factor = 4096;
 	static constexpr unsigned bulk_push_cost_limit = 200;
+	static constexpr unsigned bulk_pull_pipeline_depth = 8;
 	static constexpr std::chrono::seconds lazy_flush_delay_sec = std::chrono::seconds (5);
 	static constexpr unsigned lazy_destinations_request_limit = 256 * 1024;
 	static constexpr uint64_t lazy_batch_pull_count_resize_blocks_limit = 4 * 1024 * 1024;
@@ -15,6 +15,7 @@
 constexpr size_t oslo::bootstrap_limits::bootstrap_max_confirm_frontiers;
 constexpr double oslo::bootstrap_limits::required_frontier_confirmation_ratio;
 constexpr unsigned oslo::bootstrap_limits::frontier_confirmation_blocks_limit;
+constexpr size_t oslo::bootstrap_limits::frontier_req_ranges;
 constexpr unsigned oslo::bootstrap_limits::requeued_pulls_limit;
 constexpr unsigned oslo::bootstrap_limits::requeued_pulls_limit_test;
 
@@ -121,17 +122,17 @@ void oslo::bootstrap_attempt::restart_condition ()
 	debug_assert (mode == oslo::bootstrap_mode::legacy);
 }
 
-void oslo::bootstrap_attempt::add_frontier (oslo::pull_info const &)
+void oslo::bootstrap_attempt::add_frontiers (std::deque<oslo::pull_info> &)
 {
 	debug_assert (mode == oslo::bootstrap_mode::legacy);
 }
 
-void oslo::bootstrap_attempt::add_bulk_push_target (oslo::block_hash const &, oslo::block_hash const &)
+void oslo::bootstrap_attempt::add_bulk_push_target (oslo::tcp_endpoint const &, oslo::block_hash const &, oslo::block_hash const &)
 {
 	debug_assert (mode == oslo::bootstrap_mode::legacy);
 }
 
-bool oslo::bootstrap_attempt::request_bulk_push_target (std::pair<oslo::block_hash, oslo::block_hash> &)
+bool oslo::bootstrap_attempt::request_bulk_push_target (oslo::tcp_endpoint const &, std::pair<oslo::block_hash, oslo::block_hash> &)
 {
 	debug_assert (mode == oslo::bootstrap_mode::legacy);
 	return true;
@@ -144,7 +145,13 @@ void oslo::bootstrap_attempt::add_recent_pull (oslo::block_hash const &)
 
 bool oslo::bootstrap_attempt::process_block (std::shared_ptr<oslo::block> block_a, oslo::account const & known_account_a, uint64_t pull_blocks, oslo::bulk_pull::count_t max_blocks, bool block_expected, unsigned retry_limit)
 {
-	oslo::unchecked_info info (block_a, known_account_a, 0, oslo::signature_verification::unknown);
+	auto verified (oslo::signature_verification::unknown);
+	// Only blocks pulled by legacy bootstrap are matched against the checkpoint, realtime and lazy blocks are always checked
+	if (mode == oslo::bootstrap_mode::legacy && node->bootstrap_initiator.checkpoint != nullptr && node->bootstrap_initiator.checkpoint->trusted (*block_a))
+	{
+		verified = oslo::signature_verification::valid;
+	}
+	oslo::unchecked_info info (block_a, known_account_a, 0, verified);
 	node->block_processor.add (info);
 	return false;
 }
@@ -225,24 +232,30 @@ void oslo::bootstrap_attempt_legacy::stop ()
 	lock.unlock ();
 	condition.notify_all ();
 	lock.lock ();
-	if (auto i = frontiers.lock ())
+	for (auto const & frontier : frontiers)
 	{
-		try
-		{
-			i->promise.set_value (true);
-		}
-		catch (std::future_error &)
+		if (auto i = frontier.lock ())
 		{
+			try
+			{
+				i->promise.set_value (true);
+			}
+			catch (std::future_error &)
+			{
+			}
 		}
 	}
-	if (auto i = push.lock ())
+	for (auto const & push : pushes)
 	{
-		try
-		{
-			i->promise.set_value (true);
-		}
-		catch (std::future_error &)
+		if (auto i = push.lock ())
 		{
+			try
+			{
+				i->promise.set_value (true);
+			}
+			catch (std::future_error &)
+			{
+			}
 		}
 	}
 	lock.unlock ();
@@ -252,26 +265,38 @@ void oslo::bootstrap_attempt_legacy::stop ()
 void oslo::bootstrap_attempt_legacy::request_push (oslo::unique_lock<std::mutex> & lock_a)
 {
 	bool error (false);
-	lock_a.unlock ();
-	auto connection_l (node->bootstrap_initiator.connections->find_connection (endpoint_frontier_request));
-	lock_a.lock ();
-	if (connection_l)
+	std::vector<oslo::tcp_endpoint> endpoints;
+	for (auto const & targets : bulk_push_targets)
+	{
+		endpoints.push_back (targets.first);
+	}
+	// Each peer only receives the blocks it was found to be missing while serving its frontier range
+	std::vector<std::future<bool>> futures;
+	pushes.clear ();
+	for (auto const & endpoint : endpoints)
 	{
-		std::future<bool> future;
+		lock_a.unlock ();
+		auto connection_l (node->bootstrap_initiator.connections->find_connection (endpoint));
+		lock_a.lock ();
+		if (connection_l && !stopped)
 		{
 			auto this_l (shared_from_this ());
 			auto client (std::make_shared<oslo::bulk_push_client> (connection_l, this_l));
 			client->start ();
-			push = client;
-			future = client->promise.get_future ();
+			pushes.push_back (client);
+			futures.push_back (client->promise.get_future ());
 		}
-		lock_a.unlock ();
-		error = consume_future (future); // This is out of scope of `client' so when the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception.
-		lock_a.lock ();
 	}
+	lock_a.unlock ();
+	for (auto & future : futures)
+	{
+		error = consume_future (future) || error; // This is out of scope of `client' so when the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception.
+	}
+	lock_a.lock ();
+	bulk_push_targets.clear ();
 	if (node->config.logging.network_logging ())
 	{
-		node->logger.try_log ("Exiting bulk push client");
+		node->logger.try_log (boost::str (boost::format ("Exiting bulk push clients, %1% of %2% peers connected") % futures.size () % endpoints.size ()));
 		if (error)
 		{
 			node->logger.try_log ("Bulk push client failed");
@@ -279,27 +304,44 @@ void oslo::bootstrap_attempt_legacy::request_push (oslo::unique_lock<std::mutex>
 	}
 }
 
-void oslo::bootstrap_attempt_legacy::add_frontier (oslo::pull_info const & pull_a)
+void oslo::bootstrap_attempt_legacy::add_frontiers (std::deque<oslo::pull_info> & pulls_a)
 {
-	oslo::pull_info pull (pull_a);
-	oslo::lock_guard<std::mutex> lock (mutex);
-	frontier_pulls.push_back (pull);
+	// Shuffle pulls
+	release_assert (std::numeric_limits<CryptoPP::word32>::max () > pulls_a.size ());
+	if (!pulls_a.empty ())
+	{
+		for (auto i = static_cast<CryptoPP::word32> (pulls_a.size () - 1); i > 0; --i)
+		{
+			auto k = oslo::random_pool::generate_word32 (0, i);
+			std::swap (pulls_a[i], pulls_a[k]);
+		}
+	}
+	account_count += pulls_a.size ();
+	// Add to regular pulls as soon as a range completes
+	for (auto const & pull : pulls_a)
+	{
+		++pulling;
+		node->bootstrap_initiator.connections->add_pull (pull);
+	}
+	pulls_a.clear ();
+	condition.notify_all ();
 }
 
-void oslo::bootstrap_attempt_legacy::add_bulk_push_target (oslo::block_hash const & head, oslo::block_hash const & end)
+void oslo::bootstrap_attempt_legacy::add_bulk_push_target (oslo::tcp_endpoint const & endpoint_a, oslo::block_hash const & head, oslo::block_hash const & end)
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
-	bulk_push_targets.emplace_back (head, end);
+	bulk_push_targets[endpoint_a].emplace_back (head, end);
 }
 
-bool oslo::bootstrap_attempt_legacy::request_bulk_push_target (std::pair<oslo::block_hash, oslo::block_hash> & current_target_a)
+bool oslo::bootstrap_attempt_legacy::request_bulk_push_target (oslo::tcp_endpoint const & endpoint_a, std::pair<oslo::block_hash, oslo::block_hash> & current_target_a)
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
-	auto empty (bulk_push_targets.empty ());
+	auto existing (bulk_push_targets.find (endpoint_a));
+	auto empty (existing == bulk_push_targets.end () || existing->second.empty ());
 	if (!empty)
 	{
-		current_target_a = bulk_push_targets.back ();
-		bulk_push_targets.pop_back ();
+		current_target_a = existing->second.back ();
+		existing->second.pop_back ();
 	}
 	return empty;
 }
@@ -499,64 +541,69 @@ bool oslo::bootstrap_attempt_legacy::confirm_frontiers (oslo::unique_lock<std::m
 
 bool oslo::bootstrap_attempt_legacy::request_frontier (oslo::unique_lock<std::mutex> & lock_a, bool first_attempt)
 {
-	auto result (true);
-	lock_a.unlock ();
-	auto connection_l (node->bootstrap_initiator.connections->connection (shared_from_this (), first_attempt));
-	lock_a.lock ();
-	if (connection_l && !stopped)
+	auto result (false);
+	std::vector<std::pair<std::future<bool>, std::pair<oslo::account, oslo::account>>> requests;
+	std::vector<std::pair<oslo::account, oslo::account>> failed;
+	frontiers.clear ();
+	while (!stopped && (!frontier_ranges.empty () || !requests.empty ()))
 	{
-		endpoint_frontier_request = connection_l->channel->get_tcp_endpoint ();
-		std::future<bool> future;
+		std::shared_ptr<oslo::bootstrap_client> connection_l;
+		if (!frontier_ranges.empty ())
 		{
-			auto this_l (shared_from_this ());
-			auto client (std::make_shared<oslo::frontier_req_client> (connection_l, this_l));
-			client->run ();
-			frontiers = client;
-			future = client->promise.get_future ();
+			// Wait for a connection while nothing is in flight, otherwise request further ranges from connections as they become idle
+			lock_a.unlock ();
+			connection_l = requests.empty () ? node->bootstrap_initiator.connections->connection (shared_from_this (), first_attempt) : node->bootstrap_initiator.connections->idle_connection ();
+			lock_a.lock ();
 		}
-		lock_a.unlock ();
-		result = consume_future (future); // This is out of scope of `client' so when the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception.
-		lock_a.lock ();
-		if (result)
+		if (connection_l != nullptr && !stopped)
 		{
-			frontier_pulls.clear ();
+			auto range (frontier_ranges.front ());
+			frontier_ranges.pop_front ();
+			if (range.first.is_zero ())
+			{
+				endpoint_frontier_request = connection_l->channel->get_tcp_endpoint ();
+			}
+			auto client (std::make_shared<oslo::frontier_req_client> (connection_l, shared_from_this (), range.first, range.second));
+			client->run ();
+			frontiers.push_back (client);
+			requests.emplace_back (client->promise.get_future (), range);
 		}
-		else
+		else if (!requests.empty ())
 		{
-			account_count = frontier_pulls.size ();
-			// Shuffle pulls
-			release_assert (std::numeric_limits<CryptoPP::word32>::max () > frontier_pulls.size ());
-			if (!frontier_pulls.empty ())
+			lock_a.unlock ();
+			requests.front ().first.wait_for (std::chrono::milliseconds (100));
+			for (auto i (requests.begin ()); i != requests.end ();)
 			{
-				for (auto i = static_cast<CryptoPP::word32> (frontier_pulls.size () - 1); i > 0; --i)
+				if (i->first.wait_for (std::chrono::seconds (0)) == std::future_status::ready)
 				{
-					auto k = oslo::random_pool::generate_word32 (0, i);
-					std::swap (frontier_pulls[i], frontier_pulls[k]);
+					if (consume_future (i->first)) // Clients are out of scope here so when the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception.
+					{
+						failed.push_back (i->second);
+					}
+					i = requests.erase (i);
+				}
+				else
+				{
+					++i;
 				}
 			}
-			// Add to regular pulls
-			while (!frontier_pulls.empty ())
-			{
-				auto pull (frontier_pulls.front ());
-				lock_a.unlock ();
-				node->bootstrap_initiator.connections->add_pull (pull);
-				lock_a.lock ();
-				++pulling;
-				frontier_pulls.pop_front ();
-			}
+			lock_a.lock ();
 		}
-		if (node->config.logging.network_logging ())
+		else
 		{
-			if (!result)
-			{
-				node->logger.try_log (boost::str (boost::format ("Completed frontier request, %1% out of sync accounts according to %2%") % account_count % connection_l->channel->to_string ()));
-			}
-			else
-			{
-				node->stats.inc (oslo::stat::type::error, oslo::stat::detail::frontier_req, oslo::stat::dir::out);
-			}
+			break;
 		}
 	}
+	if (!failed.empty () || !frontier_ranges.empty ())
+	{
+		result = true;
+		frontier_ranges.insert (frontier_ranges.end (), failed.begin (), failed.end ());
+		node->stats.inc (oslo::stat::type::error, oslo::stat::detail::frontier_req, oslo::stat::dir::out);
+	}
+	if (node->config.logging.network_logging ())
+	{
+		node->logger.try_log (boost::str (boost::format ("Completed frontier request, %1% out of sync accounts, %2% account ranges remaining") % account_count % frontier_ranges.size ()));
+	}
 	return result;
 }
 
@@ -566,7 +613,16 @@ void oslo::bootstrap_attempt_legacy::run_start (oslo::unique_lock<std::mutex> &
 	frontiers_confirmed = false;
 	total_blocks = 0;
 	requeued_pulls = 0;
+	account_count = 0;
 	recent_pulls_head.clear ();
+	// Split the account keyspace into ranges requested concurrently from different peers, up to one range per peer
+	auto ranges (std::max<size_t> (1, std::min (node->network.size (), oslo::bootstrap_limits::frontier_req_ranges)));
+	oslo::uint256_t const step (std::numeric_limits<oslo::uint256_t>::max () / ranges);
+	frontier_ranges.clear ();
+	for (size_t i (0); i < ranges; ++i)
+	{
+		frontier_ranges.emplace_back (oslo::uint256_t (step * i), i + 1 < ranges ? oslo::uint256_t (step * (i + 1)) : oslo::uint256_t (0));
+	}
 	auto frontier_failure (true);
 	uint64_t frontier_attempts (0);
 	while (!stopped && frontier_failure)
@@ -620,7 +676,7 @@ void oslo::bootstrap_attempt_legacy::run ()
 void oslo::bootstrap_attempt_legacy::get_information (boost::property_tree::ptree & tree_a)
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
-	tree_a.put ("frontier_pulls", std::to_string (frontier_pulls.size ()));
+	tree_a.put ("frontier_ranges", std::to_string (frontier_ranges.size ()));
 	tree_a.put ("frontiers_received", static_cast<bool> (frontiers_received));
 	tree_a.put ("frontiers_confirmed", static_cast<bool> (frontiers_confirmed));
 	tree_a.put ("frontiers_confirmation_pending", static_cast<bool> (frontiers_confirmation_pending));
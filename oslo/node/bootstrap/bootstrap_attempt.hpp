@@ -5,6 +5,7 @@
 
 #include <atomic>
 #include <future>
+#include <unordered_map>
 
 namespace oslo
 {
@@ -25,9 +26,9 @@ public:
 	bool should_log ();
 	std::string mode_text ();
 	virtual void restart_condition ();
-	virtual void add_frontier (oslo::pull_info const &);
-	virtual void add_bulk_push_target (oslo::block_hash const &, oslo::block_hash const &);
-	virtual bool request_bulk_push_target (std::pair<oslo::block_hash, oslo::block_hash> &);
+	virtual void add_frontiers (std::deque<oslo::pull_info> &);
+	virtual void add_bulk_push_target (oslo::tcp_endpoint const &, oslo::block_hash const &, oslo::block_hash const &);
+	virtual bool request_bulk_push_target (oslo::tcp_endpoint const &, std::pair<oslo::block_hash, oslo::block_hash> &);
 	virtual void add_recent_pull (oslo::block_hash const &);
 	virtual void lazy_start (oslo::hash_or_account const &, bool confirmed = true);
 	virtual void lazy_add (oslo::pull_info const &);
@@ -67,9 +68,9 @@ public:
 	bool request_frontier (oslo::unique_lock<std::mutex> &, bool = false);
 	void request_pull (oslo::unique_lock<std::mutex> &);
 	void request_push (oslo::unique_lock<std::mutex> &);
-	void add_frontier (oslo::pull_info const &) override;
-	void add_bulk_push_target (oslo::block_hash const &, oslo::block_hash const &) override;
-	bool request_bulk_push_target (std::pair<oslo::block_hash, oslo::block_hash> &) override;
+	void add_frontiers (std::deque<oslo::pull_info> &) override;
+	void add_bulk_push_target (oslo::tcp_endpoint const &, oslo::block_hash const &, oslo::block_hash const &) override;
+	bool request_bulk_push_target (oslo::tcp_endpoint const &, std::pair<oslo::block_hash, oslo::block_hash> &) override;
 	void add_recent_pull (oslo::block_hash const &) override;
 	void run_start (oslo::unique_lock<std::mutex> &);
 	void restart_condition () override;
@@ -77,11 +78,13 @@ public:
 	bool confirm_frontiers (oslo::unique_lock<std::mutex> &);
 	void get_information (boost::property_tree::ptree &) override;
 	oslo::tcp_endpoint endpoint_frontier_request;
-	std::weak_ptr<oslo::frontier_req_client> frontiers;
-	std::weak_ptr<oslo::bulk_push_client> push;
-	std::deque<oslo::pull_info> frontier_pulls;
+	std::vector<std::weak_ptr<oslo::frontier_req_client>> frontiers;
+	std::vector<std::weak_ptr<oslo::bulk_push_client>> pushes;
+	/** Account ranges [first, second) whose frontiers were not received yet */
+	std::deque<std::pair<oslo::account, oslo::account>> frontier_ranges;
 	std::deque<oslo::block_hash> recent_pulls_head;
-	std::vector<std::pair<oslo::block_hash, oslo::block_hash>> bulk_push_targets;
+	/** Blocks the peer serving each frontier range is missing, pushed back to that same peer */
+	std::unordered_map<oslo::tcp_endpoint, std::vector<std::pair<oslo::block_hash, oslo::block_hash>>> bulk_push_targets;
 	std::atomic<unsigned> account_count{ 0 };
 	std::atomic<bool> frontiers_confirmation_pending{ false };
 };
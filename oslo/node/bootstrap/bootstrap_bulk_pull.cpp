@@ -18,6 +18,151 @@ bootstrap_id (bootstrap_id_a)
 {
 }
 
+namespace
+{
+// Field offsets in a serialized state block
+size_t constexpr state_account_offset = 0;
+size_t constexpr state_previous_offset = state_account_offset + sizeof (oslo::account);
+size_t constexpr state_representative_offset = state_previous_offset + sizeof (oslo::block_hash);
+size_t constexpr state_balance_offset = state_representative_offset + sizeof (oslo::account);
+size_t constexpr state_link_offset = state_balance_offset + sizeof (oslo::amount);
+size_t constexpr state_balance_size = sizeof (oslo::amount);
+uint8_t constexpr compact_flags_mask = oslo::bulk_pull_compact::account_same | oslo::bulk_pull_compact::representative_same | oslo::bulk_pull_compact::balance_delta | oslo::bulk_pull_compact::balance_decreased;
+
+oslo::uint128_t balance_from (uint8_t const * data_a)
+{
+	oslo::uint128_union result;
+	std::copy (data_a, data_a + state_balance_size, result.bytes.begin ());
+	return result.number ();
+}
+}
+
+void oslo::bulk_pull_compact::encode (std::vector<uint8_t> & stream_a, raw_block const & block_a, raw_block const * reference_a)
+{
+	uint8_t flags (0);
+	oslo::uint128_union balance;
+	std::copy (block_a.begin () + state_balance_offset, block_a.begin () + state_link_offset, balance.bytes.begin ());
+	auto balance_begin (balance.bytes.cbegin ());
+	if (reference_a != nullptr)
+	{
+		auto const & reference (*reference_a);
+		if (std::equal (block_a.begin () + state_account_offset, block_a.begin () + state_previous_offset, reference.begin () + state_account_offset))
+		{
+			flags |= account_same;
+		}
+		if (std::equal (block_a.begin () + state_representative_offset, block_a.begin () + state_balance_offset, reference.begin () + state_representative_offset))
+		{
+			flags |= representative_same;
+		}
+		auto current_l (balance.number ());
+		auto reference_l (balance_from (reference.data () + state_balance_offset));
+		flags |= balance_delta;
+		if (current_l < reference_l)
+		{
+			flags |= balance_decreased;
+			balance = oslo::uint128_union (reference_l - current_l);
+		}
+		else
+		{
+			balance = oslo::uint128_union (current_l - reference_l);
+		}
+		// Leading zero bytes of the delta are not sent
+		while (balance_begin != balance.bytes.cend () && *balance_begin == 0)
+		{
+			++balance_begin;
+		}
+	}
+	stream_a.push_back (type);
+	stream_a.push_back (flags);
+	stream_a.push_back (static_cast<uint8_t> (balance.bytes.cend () - balance_begin));
+	if ((flags & account_same) == 0)
+	{
+		stream_a.insert (stream_a.end (), block_a.begin () + state_account_offset, block_a.begin () + state_previous_offset);
+	}
+	stream_a.insert (stream_a.end (), block_a.begin () + state_previous_offset, block_a.begin () + state_representative_offset);
+	if ((flags & representative_same) == 0)
+	{
+		stream_a.insert (stream_a.end (), block_a.begin () + state_representative_offset, block_a.begin () + state_balance_offset);
+	}
+	stream_a.insert (stream_a.end (), balance_begin, balance.bytes.cend ());
+	stream_a.insert (stream_a.end (), block_a.begin () + state_link_offset, block_a.end ());
+}
+
+bool oslo::bulk_pull_compact::valid_header (uint8_t flags_a, uint8_t balance_size_a)
+{
+	auto result ((flags_a & ~compact_flags_mask) == 0 && balance_size_a <= state_balance_size);
+	if ((flags_a & balance_delta) == 0)
+	{
+		result = result && balance_size_a == state_balance_size && (flags_a & balance_decreased) == 0;
+	}
+	return result;
+}
+
+size_t oslo::bulk_pull_compact::body_size (uint8_t flags_a, uint8_t balance_size_a)
+{
+	size_t result (oslo::state_block::size - state_balance_size + balance_size_a);
+	if ((flags_a & account_same) != 0)
+	{
+		result -= sizeof (oslo::account);
+	}
+	if ((flags_a & representative_same) != 0)
+	{
+		result -= sizeof (oslo::account);
+	}
+	return result;
+}
+
+bool oslo::bulk_pull_compact::decode (uint8_t flags_a, uint8_t balance_size_a, uint8_t const * body_a, raw_block const * reference_a, raw_block & block_a)
+{
+	debug_assert (valid_header (flags_a, balance_size_a));
+	auto error ((flags_a & (account_same | representative_same | balance_delta)) != 0 && reference_a == nullptr);
+	if (!error)
+	{
+		auto read = [&body_a, &block_a](size_t offset_a, size_t size_a) {
+			std::copy (body_a, body_a + size_a, block_a.begin () + offset_a);
+			body_a += size_a;
+		};
+		if ((flags_a & account_same) != 0)
+		{
+			std::copy (reference_a->begin () + state_account_offset, reference_a->begin () + state_previous_offset, block_a.begin () + state_account_offset);
+		}
+		else
+		{
+			read (state_account_offset, sizeof (oslo::account));
+		}
+		read (state_previous_offset, sizeof (oslo::block_hash));
+		if ((flags_a & representative_same) != 0)
+		{
+			std::copy (reference_a->begin () + state_representative_offset, reference_a->begin () + state_balance_offset, block_a.begin () + state_representative_offset);
+		}
+		else
+		{
+			read (state_representative_offset, sizeof (oslo::account));
+		}
+		std::fill (block_a.begin () + state_balance_offset, block_a.begin () + state_link_offset, uint8_t (0));
+		read (state_link_offset - balance_size_a, balance_size_a);
+		if ((flags_a & balance_delta) != 0)
+		{
+			auto delta (balance_from (block_a.data () + state_balance_offset));
+			auto reference (balance_from (reference_a->data () + state_balance_offset));
+			oslo::uint128_union balance;
+			if ((flags_a & balance_decreased) != 0)
+			{
+				error = delta > reference;
+				balance = reference - delta;
+			}
+			else
+			{
+				error = delta > std::numeric_limits<oslo::uint128_t>::max () - reference;
+				balance = reference + delta;
+			}
+			std::copy (balance.bytes.begin (), balance.bytes.end (), block_a.begin () + state_balance_offset);
+		}
+		read (state_link_offset, oslo::state_block::size - state_link_offset);
+	}
+	return error;
+}
+
 oslo::bulk_pull_client::bulk_pull_client (std::shared_ptr<oslo::bootstrap_client> connection_a, std::shared_ptr<oslo::bootstrap_attempt> attempt_a, oslo::pull_info const & pull_a) :
 connection (connection_a),
 attempt (attempt_a),
@@ -40,6 +185,10 @@ oslo::bulk_pull_client::~bulk_pull_client ()
 			pull.account_or_head = expected;
 		}
 		pull.processed += pull_blocks - unexpected_count;
+		if (!pipeline_aborted)
+		{
+			connection->node->bootstrap_initiator.peer_scores.pull_result (connection->channel->get_tcp_endpoint (), true);
+		}
 		connection->node->bootstrap_initiator.connections->requeue_pull (pull, network_error);
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
@@ -48,6 +197,7 @@ oslo::bulk_pull_client::~bulk_pull_client ()
 	}
 	else
 	{
+		connection->node->bootstrap_initiator.peer_scores.pull_result (connection->channel->get_tcp_endpoint (), false);
 		connection->node->bootstrap_initiator.cache.remove (pull);
 	}
 	attempt->pull_finished ();
@@ -71,6 +221,7 @@ void oslo::bulk_pull_client::request ()
 	req.end = pull.end;
 	req.count = pull.count;
 	req.set_count_present (pull.count != 0);
+	req.set_compact (connection->channel->get_network_version () >= connection->node->network_params.protocol.bulk_pull_compact_version_min);
 
 	if (connection->node->config.logging.bulk_pull_logging ())
 	{
@@ -85,7 +236,7 @@ void oslo::bulk_pull_client::request ()
 	req, [this_l](boost::system::error_code const & ec, size_t size_a) {
 		if (!ec)
 		{
-			this_l->throttled_receive_block ();
+			this_l->connection->pipeline_sent (*this_l);
 		}
 		else
 		{
@@ -94,6 +245,7 @@ void oslo::bulk_pull_client::request ()
 				this_l->connection->node->logger.try_log (boost::str (boost::format ("Error sending bulk pull request to %1%: to %2%") % ec.message () % this_l->connection->channel->to_string ()));
 			}
 			this_l->connection->node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_request_failure, oslo::stat::dir::in);
+			this_l->connection->pipeline_abort (*this_l);
 		}
 	},
 	oslo::buffer_drop_policy::no_limiter_drop);
@@ -114,6 +266,10 @@ void oslo::bulk_pull_client::throttled_receive_block ()
 			{
 				this_l->throttled_receive_block ();
 			}
+			else
+			{
+				this_l->connection->pipeline_abort (*this_l);
+			}
 		});
 	}
 }
@@ -136,9 +292,14 @@ void oslo::bulk_pull_client::receive_block ()
 				}
 				this_l->connection->node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_receive_block_failure, oslo::stat::dir::in);
 				this_l->network_error = true;
+				this_l->connection->pipeline_abort (*this_l);
 			}
 		});
 	}
+	else
+	{
+		connection->pipeline_abort (*this);
+	}
 }
 
 void oslo::bulk_pull_client::received_type ()
@@ -148,135 +309,237 @@ void oslo::bulk_pull_client::received_type ()
 
 	if (auto socket_l = connection->channel->socket.lock ())
 	{
-		switch (type)
+		if (connection->receive_buffer->data ()[0] == oslo::bulk_pull_compact::type)
 		{
-			case oslo::block_type::send:
-			{
-				socket_l->async_read (connection->receive_buffer, oslo::send_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-					this_l->received_block (ec, size_a, type);
-				});
-				break;
-			}
-			case oslo::block_type::receive:
-			{
-				socket_l->async_read (connection->receive_buffer, oslo::receive_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-					this_l->received_block (ec, size_a, type);
-				});
-				break;
-			}
-			case oslo::block_type::open:
-			{
-				socket_l->async_read (connection->receive_buffer, oslo::open_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-					this_l->received_block (ec, size_a, type);
-				});
-				break;
-			}
-			case oslo::block_type::change:
-			{
-				socket_l->async_read (connection->receive_buffer, oslo::change_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-					this_l->received_block (ec, size_a, type);
-				});
-				break;
-			}
-			case oslo::block_type::state:
-			{
-				socket_l->async_read (connection->receive_buffer, oslo::state_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-					this_l->received_block (ec, size_a, type);
-				});
-				break;
-			}
-			case oslo::block_type::not_a_block:
-			{
-				// Avoid re-using slow peers, or peers that sent the wrong blocks.
-				if (!connection->pending_stop && (expected == pull.end || (pull.count != 0 && pull.count == pull_blocks)))
+			socket_l->async_read (connection->receive_buffer, oslo::bulk_pull_compact::header_size, [this_l](boost::system::error_code const & ec, size_t size_a) {
+				if (!ec)
 				{
-					connection->connections->pool_connection (connection);
+					this_l->received_compact_header ();
 				}
-				break;
-			}
-			default:
+				else
+				{
+					this_l->received_block (ec, size_a, oslo::block_type::state);
+				}
+			});
+		}
+		else
+		{
+			switch (type)
 			{
-				if (connection->node->config.logging.network_packet_logging ())
+				case oslo::block_type::send:
+				{
+					socket_l->async_read (connection->receive_buffer, oslo::send_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
+						this_l->received_block (ec, size_a, type);
+					});
+					break;
+				}
+				case oslo::block_type::receive:
+				{
+					socket_l->async_read (connection->receive_buffer, oslo::receive_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
+						this_l->received_block (ec, size_a, type);
+					});
+					break;
+				}
+				case oslo::block_type::open:
 				{
-					connection->node->logger.try_log (boost::str (boost::format ("Unknown type received as block type: %1%") % static_cast<int> (type)));
+					socket_l->async_read (connection->receive_buffer, oslo::open_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
+						this_l->received_block (ec, size_a, type);
+					});
+					break;
+				}
+				case oslo::block_type::change:
+				{
+					socket_l->async_read (connection->receive_buffer, oslo::change_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
+						this_l->received_block (ec, size_a, type);
+					});
+					break;
+				}
+				case oslo::block_type::state:
+				{
+					socket_l->async_read (connection->receive_buffer, oslo::state_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
+						this_l->received_block (ec, size_a, type);
+					});
+					break;
+				}
+				case oslo::block_type::not_a_block:
+				{
+					// Avoid re-using slow peers, or peers that sent the wrong blocks.
+					if (!connection->pending_stop && (draining || expected == pull.end || (pull.count != 0 && pull.count == pull_blocks)))
+					{
+						if (auto next = connection->pipeline_pop (*this))
+						{
+							next->throttled_receive_block ();
+						}
+						connection->connections->refill_pipeline (connection);
+					}
+					else
+					{
+						connection->pipeline_abort (*this);
+					}
+					break;
+				}
+				default:
+				{
+					if (connection->node->config.logging.network_packet_logging ())
+					{
+						connection->node->logger.try_log (boost::str (boost::format ("Unknown type received as block type: %1%") % static_cast<int> (type)));
+					}
+					connection->pipeline_abort (*this);
+					break;
 				}
-				break;
 			}
 		}
 	}
+	else
+	{
+		connection->pipeline_abort (*this);
+	}
 }
 
 void oslo::bulk_pull_client::received_block (boost::system::error_code const & ec, size_t size_a, oslo::block_type type_a)
 {
-	if (!ec)
+	if (!ec && draining)
 	{
+		receive_block ();
+	}
+	else if (!ec)
+	{
+		compact_reference_valid = type_a == oslo::block_type::state && size_a == compact_reference.size ();
+		if (compact_reference_valid)
+		{
+			std::copy_n (connection->receive_buffer->begin (), compact_reference.size (), compact_reference.begin ());
+		}
 		oslo::bufferstream stream (connection->receive_buffer->data (), size_a);
-		std::shared_ptr<oslo::block> block (oslo::deserialize_block (stream, type_a));
-		if (block != nullptr && !oslo::work_validate_entry (*block))
+		process_block (oslo::deserialize_block (stream, type_a));
+	}
+	else
+	{
+		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			auto hash (block->hash ());
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				std::string block_l;
-				block->serialize_json (block_l, connection->node->config.logging.single_line_record ());
-				connection->node->logger.try_log (boost::str (boost::format ("Pulled block %1% %2%") % hash.to_string () % block_l));
-			}
-			// Is block expected?
-			bool block_expected (false);
-			// Unconfirmed head is used only for lazy destinations if legacy bootstrap is not available, see oslo::bootstrap_attempt::lazy_destinations_increment (...)
-			bool unconfirmed_account_head (connection->node->flags.disable_legacy_bootstrap && pull_blocks == 0 && pull.retry_limit != std::numeric_limits<unsigned>::max () && expected == pull.account_or_head && block->account () == pull.account_or_head);
-			if (hash == expected || unconfirmed_account_head)
+			connection->node->logger.try_log (boost::str (boost::format ("Error bulk receiving block: %1%") % ec.message ()));
+		}
+		connection->node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_receive_block_failure, oslo::stat::dir::in);
+		network_error = true;
+		connection->pipeline_abort (*this);
+	}
+}
+
+void oslo::bulk_pull_client::received_compact_header ()
+{
+	auto flags (connection->receive_buffer->data ()[0]);
+	auto balance_size (connection->receive_buffer->data ()[1]);
+	auto socket_l (connection->channel->socket.lock ());
+	if (socket_l != nullptr && oslo::bulk_pull_compact::valid_header (flags, balance_size))
+	{
+		auto this_l (shared_from_this ());
+		socket_l->async_read (connection->receive_buffer, oslo::bulk_pull_compact::body_size (flags, balance_size), [this_l, flags, balance_size](boost::system::error_code const & ec, size_t size_a) {
+			this_l->received_compact (ec, size_a, flags, balance_size);
+		});
+	}
+	else
+	{
+		if (socket_l != nullptr)
+		{
+			connection->node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_deserialize_receive_block, oslo::stat::dir::in);
+		}
+		connection->pipeline_abort (*this);
+	}
+}
+
+void oslo::bulk_pull_client::received_compact (boost::system::error_code const & ec, size_t size_a, uint8_t flags_a, uint8_t balance_size_a)
+{
+	if (!ec && draining)
+	{
+		receive_block ();
+	}
+	else if (!ec)
+	{
+		oslo::bulk_pull_compact::raw_block raw;
+		auto error (size_a != oslo::bulk_pull_compact::body_size (flags_a, balance_size_a) || oslo::bulk_pull_compact::decode (flags_a, balance_size_a, connection->receive_buffer->data (), compact_reference_valid ? &compact_reference : nullptr, raw));
+		std::shared_ptr<oslo::block> block;
+		if (!error)
+		{
+			compact_reference = raw;
+			compact_reference_valid = true;
+			oslo::bufferstream stream (raw.data (), raw.size ());
+			block = oslo::deserialize_block (stream, oslo::block_type::state);
+		}
+		process_block (block);
+	}
+	else
+	{
+		received_block (ec, size_a, oslo::block_type::state);
+	}
+}
+
+void oslo::bulk_pull_client::process_block (std::shared_ptr<oslo::block> const & block_a)
+{
+	if (block_a != nullptr && !oslo::work_validate_entry (*block_a))
+	{
+		auto hash (block_a->hash ());
+		if (connection->node->config.logging.bulk_pull_logging ())
+		{
+			std::string block_l;
+			block_a->serialize_json (block_l, connection->node->config.logging.single_line_record ());
+			connection->node->logger.try_log (boost::str (boost::format ("Pulled block %1% %2%") % hash.to_string () % block_l));
+		}
+		// Is block expected?
+		bool block_expected (false);
+		// Unconfirmed head is used only for lazy destinations if legacy bootstrap is not available, see oslo::bootstrap_attempt::lazy_destinations_increment (...)
+		bool unconfirmed_account_head (connection->node->flags.disable_legacy_bootstrap && pull_blocks == 0 && pull.retry_limit != std::numeric_limits<unsigned>::max () && expected == pull.account_or_head && block_a->account () == pull.account_or_head);
+		if (hash == expected || unconfirmed_account_head)
+		{
+			expected = block_a->previous ();
+			block_expected = true;
+		}
+		else
+		{
+			unexpected_count++;
+		}
+		if (pull_blocks == 0 && block_expected)
+		{
+			known_account = block_a->account ();
+		}
+		if (connection->block_count++ == 0)
+		{
+			connection->set_start_time (std::chrono::steady_clock::now ());
+		}
+		attempt->total_blocks++;
+		bool stop_pull (attempt->process_block (block_a, known_account, pull_blocks, pull.count, block_expected, pull.retry_limit));
+		pull_blocks++;
+		if (!stop_pull && !connection->hard_stop.load ())
+		{
+			/* Process block in lazy pull if not stopped
+			Stop usual pull request with unexpected block & more than 16k blocks processed
+			to prevent spam */
+			if (attempt->mode != oslo::bootstrap_mode::legacy || unexpected_count < 16384)
 			{
-				expected = block->previous ();
-				block_expected = true;
+				throttled_receive_block ();
 			}
 			else
 			{
-				unexpected_count++;
-			}
-			if (pull_blocks == 0 && block_expected)
-			{
-				known_account = block->account ();
-			}
-			if (connection->block_count++ == 0)
-			{
-				connection->set_start_time (std::chrono::steady_clock::now ());
-			}
-			attempt->total_blocks++;
-			bool stop_pull (attempt->process_block (block, known_account, pull_blocks, pull.count, block_expected, pull.retry_limit));
-			pull_blocks++;
-			if (!stop_pull && !connection->hard_stop.load ())
-			{
-				/* Process block in lazy pull if not stopped
-				Stop usual pull request with unexpected block & more than 16k blocks processed
-				to prevent spam */
-				if (attempt->mode != oslo::bootstrap_mode::legacy || unexpected_count < 16384)
-				{
-					throttled_receive_block ();
-				}
-			}
-			else if (stop_pull && block_expected)
-			{
-				connection->connections->pool_connection (connection);
+				connection->pipeline_abort (*this);
 			}
 		}
+		else if (stop_pull && block_expected)
+		{
+			// Read up to the end of this response so the connection can be reused
+			draining = true;
+			receive_block ();
+		}
 		else
 		{
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				connection->node->logger.try_log ("Error deserializing block received from pull request");
-			}
-			connection->node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_deserialize_receive_block, oslo::stat::dir::in);
+			connection->pipeline_abort (*this);
 		}
 	}
 	else
 	{
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			connection->node->logger.try_log (boost::str (boost::format ("Error bulk receiving block: %1%") % ec.message ()));
+			connection->node->logger.try_log ("Error deserializing block received from pull request");
 		}
-		connection->node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_receive_block_failure, oslo::stat::dir::in);
-		network_error = true;
+		connection->node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_deserialize_receive_block, oslo::stat::dir::in);
+		connection->pipeline_abort (*this);
 	}
 }
 
@@ -480,20 +743,18 @@ void oslo::bulk_pull_server::set_current_end ()
 
 void oslo::bulk_pull_server::send_next ()
 {
-	auto block (get_next ());
-	if (block != nullptr)
+	send_buffer->clear ();
 	{
-		std::vector<uint8_t> send_buffer;
+		// Read ahead a window of blocks under a single transaction
+		auto transaction (connection->node->store.tx_begin_read ());
+		while (send_buffer->size () < send_buffer_size && serialize_next (transaction))
 		{
-			oslo::vectorstream stream (send_buffer);
-			oslo::serialize_block (stream, *block);
 		}
+	}
+	if (!send_buffer->empty ())
+	{
 		auto this_l (shared_from_this ());
-		if (connection->node->config.logging.bulk_pull_logging ())
-		{
-			connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ()));
-		}
-		connection->socket->async_write (oslo::shared_const_buffer (std::move (send_buffer)), [this_l](boost::system::error_code const & ec, size_t size_a) {
+		connection->socket->async_write (oslo::shared_const_buffer (send_buffer), [this_l](boost::system::error_code const & ec, size_t size_a) {
 			this_l->sent_action (ec, size_a);
 		});
 	}
@@ -503,33 +764,32 @@ void oslo::bulk_pull_server::send_next ()
 	}
 }
 
-std::shared_ptr<oslo::block> oslo::bulk_pull_server::get_next ()
+/*
+ * Determine if we should reply with a block
+ *
+ * If our cursor is on the final block, we should signal that we
+ * are done by returning false.
+ *
+ * Unless we are including the "start" member and this is the
+ * start member, then include it anyway and set \p last_a.
+ */
+bool oslo::bulk_pull_server::current_in_range (bool & last_a)
 {
-	std::shared_ptr<oslo::block> result;
-	bool send_current = false, set_current_to_end = false;
-
-	/*
-	 * Determine if we should reply with a block
-	 *
-	 * If our cursor is on the final block, we should signal that we
-	 * are done by returning a null result.
-	 *
-	 * Unless we are including the "start" member and this is the
-	 * start member, then include it anyway.
-	 */
+	bool result = false;
+	last_a = false;
 	if (current != request->end)
 	{
-		send_current = true;
+		result = true;
 	}
 	else if (current == request->end && include_start == true)
 	{
-		send_current = true;
+		result = true;
 
 		/*
 		 * We also need to ensure that the next time
 		 * are invoked that we return a null result
 		 */
-		set_current_to_end = true;
+		last_a = true;
 	}
 
 	/*
@@ -539,8 +799,16 @@ std::shared_ptr<oslo::block> oslo::bulk_pull_server::get_next ()
 	 */
 	if (max_count != 0 && sent_count >= max_count)
 	{
-		send_current = false;
+		result = false;
 	}
+	return result;
+}
+
+std::shared_ptr<oslo::block> oslo::bulk_pull_server::get_next ()
+{
+	std::shared_ptr<oslo::block> result;
+	bool set_current_to_end = false;
+	auto send_current (current_in_range (set_current_to_end));
 
 	if (send_current)
 	{
@@ -574,6 +842,63 @@ std::shared_ptr<oslo::block> oslo::bulk_pull_server::get_next ()
 	return result;
 }
 
+/*
+ * Same as get_next () but appends the stored bytes of the block to send_buffer
+ * without deserializing it. Returns false once there are no more blocks to send.
+ */
+bool oslo::bulk_pull_server::serialize_next (oslo::transaction const & transaction_a)
+{
+	bool set_current_to_end = false;
+	auto result (current_in_range (set_current_to_end));
+
+	if (result)
+	{
+		if (connection->node->config.logging.bulk_pull_logging ())
+		{
+			connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % current.to_string ()));
+		}
+		oslo::block_hash previous;
+		auto offset (send_buffer->size ());
+		result = !connection->node->store.block_serialized_get (transaction_a, current, *send_buffer, previous);
+		if (result && request->is_compact ())
+		{
+			compact (offset);
+		}
+		if (result && set_current_to_end == false && !previous.is_zero ())
+		{
+			current = previous;
+		}
+		else
+		{
+			current = request->end;
+		}
+
+		sent_count++;
+	}
+
+	include_start = false;
+
+	return result;
+}
+
+/*
+ * Replaces a state block appended to send_buffer at \p offset_a with its compact record
+ */
+void oslo::bulk_pull_server::compact (size_t offset_a)
+{
+	auto is_state ((*send_buffer)[offset_a] == static_cast<uint8_t> (oslo::block_type::state));
+	if (is_state)
+	{
+		oslo::bulk_pull_compact::raw_block raw;
+		debug_assert (send_buffer->size () == offset_a + 1 + raw.size ());
+		std::copy_n (send_buffer->begin () + offset_a + 1, raw.size (), raw.begin ());
+		send_buffer->resize (offset_a);
+		oslo::bulk_pull_compact::encode (*send_buffer, raw, compact_reference_valid ? &compact_reference : nullptr);
+		compact_reference = raw;
+	}
+	compact_reference_valid = is_state;
+}
+
 void oslo::bulk_pull_server::sent_action (boost::system::error_code const & ec, size_t size_a)
 {
 	if (!ec)
@@ -620,8 +945,10 @@ void oslo::bulk_pull_server::no_block_sent (boost::system::error_code const & ec
 
 oslo::bulk_pull_server::bulk_pull_server (std::shared_ptr<oslo::bootstrap_server> const & connection_a, std::unique_ptr<oslo::bulk_pull> request_a) :
 connection (connection_a),
-request (std::move (request_a))
+request (std::move (request_a)),
+send_buffer (std::make_shared<std::vector<uint8_t>> ())
 {
+	send_buffer->reserve (send_buffer_size + oslo::state_block::size + 1);
 	set_current_end ();
 }
 
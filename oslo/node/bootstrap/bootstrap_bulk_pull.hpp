@@ -3,6 +3,7 @@
 #include <oslo/node/common.hpp>
 #include <oslo/node/socket.hpp>
 
+#include <array>
 #include <unordered_set>
 
 namespace oslo
@@ -24,6 +25,30 @@ public:
 	unsigned retry_limit{ 0 };
 	uint64_t bootstrap_id{ 0 };
 };
+/**
+ * Compact encoding of state blocks in bulk_pull responses, used when the request has the compact flag set.
+ * Each state block is compared with the previous state block of the same response (the next newer block of the chain):
+ * an unchanged account or representative is omitted and the balance is sent as a minimal big endian delta.
+ * A record is [type][flags][balance size][account?][previous][representative?][balance][link][signature][work]
+ */
+class bulk_pull_compact final
+{
+public:
+	using raw_block = std::array<uint8_t, oslo::state_block::size>;
+	static uint8_t constexpr type = 0x80;
+	static uint8_t constexpr account_same = 0x01;
+	static uint8_t constexpr representative_same = 0x02;
+	static uint8_t constexpr balance_delta = 0x04;
+	static uint8_t constexpr balance_decreased = 0x08;
+	/** Size of the flags and balance size bytes following the type */
+	static size_t constexpr header_size = 2;
+	/** Appends the record for a serialized state block \p block_a, \p reference_a may be null */
+	static void encode (std::vector<uint8_t> &, raw_block const & block_a, raw_block const * reference_a);
+	static bool valid_header (uint8_t, uint8_t);
+	static size_t body_size (uint8_t, uint8_t);
+	/** Rebuilds the serialized state block from a record body, returns true on error */
+	static bool decode (uint8_t, uint8_t, uint8_t const *, raw_block const * reference_a, raw_block & block_a);
+};
 class bootstrap_client;
 class bulk_pull_client final : public std::enable_shared_from_this<oslo::bulk_pull_client>
 {
@@ -35,6 +60,9 @@ public:
 	void throttled_receive_block ();
 	void received_type ();
 	void received_block (boost::system::error_code const &, size_t, oslo::block_type);
+	void received_compact_header ();
+	void received_compact (boost::system::error_code const &, size_t, uint8_t, uint8_t);
+	void process_block (std::shared_ptr<oslo::block> const &);
 	oslo::block_hash first ();
 	std::shared_ptr<oslo::bootstrap_client> connection;
 	std::shared_ptr<oslo::bootstrap_attempt> attempt;
@@ -44,6 +72,13 @@ public:
 	uint64_t pull_blocks;
 	uint64_t unexpected_count;
 	bool network_error{ false };
+	/** Dropped because another pull on the same connection failed, which is the only one counted against the peer */
+	bool pipeline_aborted{ false };
+	/** Pull was stopped early, remaining blocks are read and discarded to reach the next pipelined response */
+	bool draining{ false };
+	/** Last state block of this response, reference for compact records */
+	oslo::bulk_pull_compact::raw_block compact_reference;
+	bool compact_reference_valid{ false };
 };
 class bulk_pull_account_client final : public std::enable_shared_from_this<oslo::bulk_pull_account_client>
 {
@@ -64,7 +99,10 @@ class bulk_pull_server final : public std::enable_shared_from_this<oslo::bulk_pu
 public:
 	bulk_pull_server (std::shared_ptr<oslo::bootstrap_server> const &, std::unique_ptr<oslo::bulk_pull>);
 	void set_current_end ();
+	bool current_in_range (bool &);
 	std::shared_ptr<oslo::block> get_next ();
+	bool serialize_next (oslo::transaction const &);
+	void compact (size_t);
 	void send_next ();
 	void sent_action (boost::system::error_code const &, size_t);
 	void send_finished ();
@@ -75,6 +113,11 @@ public:
 	bool include_start;
 	oslo::bulk_pull::count_t max_count;
 	oslo::bulk_pull::count_t sent_count;
+	/** Blocks are read ahead and serialized into a reused buffer which is sent once it reaches this size */
+	static size_t constexpr send_buffer_size = 64 * 1024;
+	std::shared_ptr<std::vector<uint8_t>> send_buffer;
+	oslo::bulk_pull_compact::raw_block compact_reference;
+	bool compact_reference_valid{ false };
 };
 class bulk_pull_account;
 class bulk_pull_account_server final : public std::enable_shared_from_this<oslo::bulk_pull_account_server>
@@ -44,7 +44,7 @@ void oslo::bulk_push_client::push ()
 	{
 		if (current_target.first.is_zero () || current_target.first == current_target.second)
 		{
-			finished = attempt->request_bulk_push_target (current_target);
+			finished = attempt->request_bulk_push_target (connection->channel->get_tcp_endpoint (), current_target);
 		}
 		if (!finished)
 		{
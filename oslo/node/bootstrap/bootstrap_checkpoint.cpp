@@ -0,0 +1,281 @@
+#include <oslo/node/bootstrap/bootstrap_checkpoint.hpp>
+#include <oslo/node/node.hpp>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/format.hpp>
+
+#include <sstream>
+
+oslo::bootstrap_checkpoint::bootstrap_checkpoint (oslo::node & node_a) :
+node (node_a)
+{
+}
+
+bool oslo::bootstrap_checkpoint::load (boost::filesystem::path const & path_a)
+{
+	boost::filesystem::ifstream file (path_a);
+	auto error (!file);
+	size_t line_number (0);
+	size_t existing (0);
+	std::string line;
+	auto transaction (node.store.tx_begin_read ());
+	oslo::lock_guard<std::mutex> guard (mutex);
+	while (!error && std::getline (file, line))
+	{
+		++line_number;
+		std::istringstream stream (line);
+		std::string account_text;
+		std::string frontier_text;
+		uint64_t height (0);
+		if ((stream >> account_text) && account_text[0] != '#')
+		{
+			oslo::account account;
+			oslo::block_hash frontier;
+			error = !(stream >> frontier_text >> height) || height == 0 || account.decode_account (account_text) || frontier.decode_hex (frontier_text);
+			if (!error)
+			{
+				if (!node.store.block_exists (transaction, frontier))
+				{
+					frontiers[frontier] = { account, height };
+					expected[frontier] = account;
+				}
+				else
+				{
+					++existing;
+				}
+			}
+			else
+			{
+				node.logger.always_log (boost::str (boost::format ("Invalid bootstrap checkpoint entry on line %1% of %2%") % line_number % path_a.string ()));
+			}
+		}
+	}
+	if (!error)
+	{
+		node.logger.always_log (boost::str (boost::format ("Loaded %1% bootstrap checkpoint frontiers, %2% already in the ledger") % frontiers.size () % existing));
+	}
+	return error;
+}
+
+bool oslo::bootstrap_checkpoint::trusted (oslo::block const & block_a)
+{
+	auto result (false);
+	auto hash (block_a.hash ());
+	oslo::account account;
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		auto existing (expected.find (hash));
+		if (existing != expected.end ())
+		{
+			account = existing->second;
+			result = true;
+		}
+	}
+	// The hash covers neither the work nor the signature. Only the signature check is skipped, a block with bad work is rejected
+	// as usual and does not use up the trusted hash, so the block can still be pulled from another peer.
+	result = result && !oslo::work_validate_entry (block_a);
+#ifndef NDEBUG
+	// The ledger asserts in debug builds that blocks marked as verified are signed correctly
+	result = result && signature_valid (account, block_a);
+#endif
+	if (result)
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		result = expected.erase (hash) > 0;
+		if (result && !block_a.previous ().is_zero ())
+		{
+			// The hash of a block covers its previous hash, so the previous block of a trusted block is trusted too
+			expected[block_a.previous ()] = account;
+		}
+	}
+	if (result)
+	{
+		node.stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_trusted);
+	}
+	return result;
+}
+
+bool oslo::bootstrap_checkpoint::frontier_processed (oslo::block const & block_a)
+{
+	auto result (false);
+	auto found (false);
+	auto start_validation_l (false);
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		auto existing (frontiers.find (block_a.hash ()));
+		if (existing != frontiers.end ())
+		{
+			found = true;
+			result = block_a.sideband ().height == existing->second.height;
+			if (result)
+			{
+				cemented.emplace_back (existing->second.account, existing->first);
+			}
+			else
+			{
+				node.logger.always_log (boost::str (boost::format ("Bootstrap checkpoint frontier %1% processed at height %2% instead of %3%, not cementing") % existing->first.to_string () % block_a.sideband ().height % existing->second.height));
+			}
+			frontiers.erase (existing);
+			start_validation_l = frontiers.empty ();
+		}
+	}
+	if (result)
+	{
+		node.stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_cemented);
+	}
+	else if (found)
+	{
+		node.stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_mismatch);
+	}
+	if (start_validation_l)
+	{
+		start_validation ();
+	}
+	return result;
+}
+
+void oslo::bootstrap_checkpoint::start_validation ()
+{
+	if (!validating.exchange (true))
+	{
+		node.worker.push_task ([node_w = std::weak_ptr<oslo::node> (node.shared ())]() {
+			if (auto node_l = node_w.lock ())
+			{
+				node_l->bootstrap_initiator.checkpoint->validate ();
+			}
+		});
+	}
+}
+
+bool oslo::bootstrap_checkpoint::signature_valid (oslo::account const & account_a, oslo::block const & block_a)
+{
+	auto hash (block_a.hash ());
+	// Epoch blocks are signed by the epoch signer instead of the account
+	auto error (oslo::validate_message (account_a, hash, block_a.block_signature ()));
+	if (error && block_a.type () == oslo::block_type::state && node.ledger.is_epoch_link (block_a.link ()))
+	{
+		error = oslo::validate_message (node.ledger.epoch_signer (block_a.link ()), hash, block_a.block_signature ());
+	}
+	return !error;
+}
+
+void oslo::bootstrap_checkpoint::validate ()
+{
+	decltype (cemented) chains;
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		chains.swap (cemented);
+	}
+	node.logger.always_log (boost::str (boost::format ("Validating signatures of %1% cemented bootstrap checkpoint chains") % chains.size ()));
+	uint64_t validated (0);
+	uint64_t invalid (0);
+	/** Lowest invalid block of each chain with one */
+	std::vector<std::pair<oslo::account, oslo::block_hash>> rollbacks;
+	{
+		auto transaction (node.store.tx_begin_read ());
+		for (auto i (chains.begin ()), n (chains.end ()); i != n && !node.stopped; ++i)
+		{
+			// Cementing is queued when the frontier is processed, wait for it so a rollback does not race the confirmation height processor
+			while (node.confirmation_height_processor.is_processing_block (i->second) && !node.stopped)
+			{
+				std::this_thread::sleep_for (std::chrono::milliseconds (10));
+			}
+			transaction.refresh ();
+			auto hash (i->second);
+			oslo::block_hash lowest_invalid (0);
+			while (!hash.is_zero () && !node.stopped)
+			{
+				auto block (node.store.block_get (transaction, hash));
+				if (block == nullptr)
+				{
+					break;
+				}
+				if (!signature_valid (i->first, *block) || oslo::work_validate_entry (*block))
+				{
+					++invalid;
+					lowest_invalid = hash;
+					node.stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_invalid);
+					node.logger.always_log (boost::str (boost::format ("Invalid signature or work on block %1% of bootstrap checkpoint chain for %2%") % hash.to_string () % i->first.to_account ()));
+				}
+				else
+				{
+					node.stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_validated);
+				}
+				if (++validated % 4096 == 0)
+				{
+					transaction.refresh ();
+				}
+				hash = block->previous ();
+			}
+			if (!lowest_invalid.is_zero ())
+			{
+				rollbacks.emplace_back (i->first, lowest_invalid);
+			}
+		}
+	}
+	node.logger.always_log (boost::str (boost::format ("Bootstrap checkpoint validation checked %1% blocks, %2% invalid") % validated % invalid));
+	for (auto const & rollback_l : rollbacks)
+	{
+		rollback (rollback_l.first, rollback_l.second);
+	}
+	validating = false;
+}
+
+void oslo::bootstrap_checkpoint::rollback (oslo::account const & account_a, oslo::block_hash const & hash_a)
+{
+	std::vector<std::shared_ptr<oslo::block>> rollback_list;
+	auto error (false);
+	{
+		auto transaction (node.store.tx_begin_write ({ oslo::tables::accounts, oslo::tables::cached_counts, oslo::tables::change_blocks, oslo::tables::confirmation_height, oslo::tables::frontiers, oslo::tables::open_blocks, oslo::tables::pending, oslo::tables::receive_blocks, oslo::tables::representation, oslo::tables::send_blocks, oslo::tables::state_blocks }));
+		auto block (node.store.block_get (transaction, hash_a));
+		error = block == nullptr;
+		if (!error)
+		{
+			// The chain was cemented without its signatures being checked, uncement it down to the block before the invalid one
+			auto height (block->sideband ().height);
+			oslo::confirmation_height_info confirmation_height{ 0, oslo::block_hash (0) };
+			node.store.confirmation_height_get (transaction, account_a, confirmation_height);
+			// The ledger refuses to roll back cemented blocks, so the height is lowered first and restored if the rollback fails
+			auto lowered (confirmation_height.height >= height);
+			if (lowered)
+			{
+				node.ledger.cache.cemented_count -= confirmation_height.height - (height - 1);
+				node.store.confirmation_height_put (transaction, account_a, { height - 1, block->previous () });
+			}
+			error = node.ledger.rollback (transaction, hash_a, rollback_list);
+			if (error && lowered)
+			{
+				// Blocks above the failure point may already be rolled back, only those still in the chain are cemented again
+				oslo::account_info info;
+				auto info_error (node.store.account_get (transaction, account_a, info));
+				(void)info_error;
+				debug_assert (!info_error);
+				if (info.block_count < confirmation_height.height)
+				{
+					confirmation_height = { info.block_count, info.head };
+				}
+				node.ledger.cache.cemented_count += confirmation_height.height - (height - 1);
+				node.store.confirmation_height_put (transaction, account_a, confirmation_height);
+			}
+		}
+	}
+	for (auto const & block : rollback_list)
+	{
+		node.active.erase (*block);
+	}
+	if (!error)
+	{
+		node.stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::checkpoint_rollback);
+		node.logger.always_log (boost::str (boost::format ("Rolled back %1% blocks of bootstrap checkpoint chain for %2% from invalid block %3%, they will be pulled and checked again") % rollback_list.size () % account_a.to_account () % hash_a.to_string ()));
+	}
+	else
+	{
+		node.logger.always_log (boost::str (boost::format ("Unable to roll back bootstrap checkpoint chain for %1% from invalid block %2%, dependent blocks are cemented and the ledger must be bootstrapped again without a checkpoint") % account_a.to_account () % hash_a.to_string ()));
+	}
+}
+
+size_t oslo::bootstrap_checkpoint::size ()
+{
+	oslo::lock_guard<std::mutex> guard (mutex);
+	return frontiers.size ();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <oslo/lib/numbers.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace oslo
+{
+class block;
+class node;
+/**
+ * Cemented frontiers supplied by the operator to speed up bootstrapping from scratch.
+ * Blocks pulled by legacy bootstrap which are a checkpoint frontier, or linked to one through previous hashes, skip signature
+ * checks in the block processor. Their work is checked as usual. The chain is cemented once its frontier is processed at the checkpoint height.
+ * Signatures of cemented checkpoint chains are checked in the background once all frontiers are processed, a chain with an invalid
+ * block is uncemented and rolled back from that block so it is pulled and checked again.
+ */
+class bootstrap_checkpoint final
+{
+public:
+	explicit bootstrap_checkpoint (oslo::node &);
+	/** Loads lines of "<account> <frontier hash> <height>", blank lines and lines starting with # are skipped. Returns true on error */
+	bool load (boost::filesystem::path const &);
+	/** Returns true if \p block_a is part of a checkpoint chain and has valid work, its previous block becomes the next trusted hash */
+	bool trusted (oslo::block const &);
+	/** Returns true if the processed \p block_a is a checkpoint frontier at the checkpoint height and can be cemented */
+	bool frontier_processed (oslo::block const &);
+	/** Checks signatures of the cemented checkpoint chains and rolls back chains with invalid blocks */
+	void validate ();
+	/** Frontiers which are not processed yet */
+	size_t size ();
+	std::atomic<bool> validating{ false };
+
+private:
+	class entry final
+	{
+	public:
+		oslo::account account;
+		uint64_t height;
+	};
+	void start_validation ();
+	bool signature_valid (oslo::account const &, oslo::block const &);
+	void rollback (oslo::account const &, oslo::block_hash const &);
+	oslo::node & node;
+	std::mutex mutex;
+	/** Frontiers which are not processed yet */
+	std::unordered_map<oslo::block_hash, entry> frontiers;
+	/** Next hash of each checkpoint chain being pulled, with the account of the chain */
+	std::unordered_map<oslo::block_hash, oslo::account> expected;
+	/** Cemented chains waiting for validation */
+	std::vector<std::pair<oslo::account, oslo::block_hash>> cemented;
+};
+}
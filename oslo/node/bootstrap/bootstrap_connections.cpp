@@ -8,10 +8,15 @@
 #include <boost/format.hpp>
 
 constexpr double oslo::bootstrap_limits::bootstrap_connection_scale_target_blocks;
+constexpr std::chrono::seconds oslo::bootstrap_limits::bootstrap_connection_scale_interval;
+constexpr double oslo::bootstrap_limits::bootstrap_connection_scale_improvement;
+constexpr unsigned oslo::bootstrap_limits::bootstrap_connection_scale_max_factor;
+constexpr size_t oslo::bootstrap_limits::bootstrap_peer_candidates;
 constexpr double oslo::bootstrap_limits::bootstrap_minimum_blocks_per_sec;
 constexpr double oslo::bootstrap_limits::bootstrap_minimum_termination_time_sec;
 constexpr unsigned oslo::bootstrap_limits::bootstrap_max_new_connections;
 constexpr unsigned oslo::bootstrap_limits::requeued_pulls_processed_blocks_factor;
+constexpr unsigned oslo::bootstrap_limits::bulk_pull_pipeline_depth;
 
 oslo::bootstrap_client::bootstrap_client (std::shared_ptr<oslo::node> node_a, std::shared_ptr<oslo::bootstrap_connections> connections_a, std::shared_ptr<oslo::transport::channel_tcp> channel_a, std::shared_ptr<oslo::socket> socket_a) :
 node (node_a),
@@ -27,6 +32,10 @@ start_time_m (std::chrono::steady_clock::now ())
 
 oslo::bootstrap_client::~bootstrap_client ()
 {
+	if (block_count > 0 && elapsed_seconds () > oslo::bootstrap_limits::bootstrap_connection_warmup_time_sec)
+	{
+		node->bootstrap_initiator.peer_scores.throughput (channel->get_tcp_endpoint (), block_rate ());
+	}
 	--connections->connections_count;
 }
 
@@ -48,6 +57,127 @@ double oslo::bootstrap_client::elapsed_seconds () const
 	return std::chrono::duration_cast<std::chrono::duration<double>> (std::chrono::steady_clock::now () - start_time_m).count ();
 }
 
+unsigned oslo::bootstrap_client::pipeline_depth () const
+{
+	return channel->get_network_version () >= node->network_params.protocol.bulk_pull_pipelining_version_min ? oslo::bootstrap_limits::bulk_pull_pipeline_depth : 1;
+}
+
+void oslo::bootstrap_client::pipeline_push (std::vector<std::shared_ptr<oslo::bulk_pull_client>> const & clients_a)
+{
+	std::shared_ptr<oslo::bulk_pull_client> send_l;
+	{
+		oslo::lock_guard<std::mutex> guard (pipeline_mutex);
+		if (pipeline_aborted)
+		{
+			// Pulls assigned before the abort must not be sent on this connection, they are requeued without counting an attempt
+			pipeline_pending -= clients_a.size ();
+			for (auto & client : clients_a)
+			{
+				client->network_error = true;
+				client->pipeline_aborted = true;
+			}
+			return;
+		}
+		pipeline.insert (pipeline.end (), clients_a.begin (), clients_a.end ());
+		pipeline_unsent += clients_a.size ();
+		if (!pipeline_sending && pipeline_unsent > 0)
+		{
+			pipeline_sending = true;
+			send_l = pipeline[pipeline.size () - pipeline_unsent];
+		}
+	}
+	if (send_l != nullptr)
+	{
+		send_l->request ();
+	}
+}
+
+void oslo::bootstrap_client::pipeline_sent (oslo::bulk_pull_client const & client_a)
+{
+	// The socket only allows a single outstanding write, requests are sent one after another in pipeline order
+	std::shared_ptr<oslo::bulk_pull_client> send_l;
+	std::shared_ptr<oslo::bulk_pull_client> receive_l;
+	{
+		oslo::lock_guard<std::mutex> guard (pipeline_mutex);
+		if (pipeline_unsent == 0 || pipeline[pipeline.size () - pipeline_unsent].get () != &client_a)
+		{
+			// Pipeline was aborted while the request was being written
+			return;
+		}
+		--pipeline_unsent;
+		if (pipeline_unsent > 0)
+		{
+			send_l = pipeline[pipeline.size () - pipeline_unsent];
+		}
+		else
+		{
+			pipeline_sending = false;
+		}
+		if (!pipeline_receiving && pipeline.size () > pipeline_unsent)
+		{
+			pipeline_receiving = true;
+			receive_l = pipeline.front ();
+		}
+		if (pipeline.size () - pipeline_unsent > 1)
+		{
+			node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_pipelined, oslo::stat::dir::out);
+		}
+	}
+	if (send_l != nullptr)
+	{
+		send_l->request ();
+	}
+	if (receive_l != nullptr)
+	{
+		receive_l->throttled_receive_block ();
+	}
+}
+
+std::shared_ptr<oslo::bulk_pull_client> oslo::bootstrap_client::pipeline_pop (oslo::bulk_pull_client const & client_a)
+{
+	// Front response was fully received, the next response follows on the socket
+	std::shared_ptr<oslo::bulk_pull_client> result;
+	oslo::lock_guard<std::mutex> guard (pipeline_mutex);
+	if (!pipeline.empty () && pipeline.front ().get () == &client_a)
+	{
+		pipeline.pop_front ();
+		--pipeline_pending;
+		if (pipeline.size () > pipeline_unsent)
+		{
+			result = pipeline.front ();
+		}
+		else
+		{
+			pipeline_receiving = false;
+		}
+	}
+	return result;
+}
+
+void oslo::bootstrap_client::pipeline_abort (oslo::bulk_pull_client const & client_a)
+{
+	decltype (pipeline) aborted;
+	{
+		oslo::lock_guard<std::mutex> guard (pipeline_mutex);
+		aborted.swap (pipeline);
+		pipeline_aborted = true;
+		pipeline_unsent = 0;
+		pipeline_sending = false;
+		pipeline_receiving = false;
+		pipeline_pending -= aborted.size ();
+	}
+	// Responses queued behind a failed one cannot be read, requeue them without counting an attempt
+	pending_stop = true;
+	for (auto & client : aborted)
+	{
+		if (client.get () != &client_a)
+		{
+			client->network_error = true;
+			client->pipeline_aborted = true;
+		}
+	}
+}
+
 void oslo::bootstrap_client::stop (bool force)
 {
 	pending_stop = true;
@@ -71,8 +201,18 @@ std::shared_ptr<oslo::bootstrap_client> oslo::bootstrap_connections::connection
 	{
 		if (!use_front_connection)
 		{
-			result = idle.back ();
-			idle.pop_back ();
+			// Pulls go to the idle peer with the best bootstrap score first
+			std::vector<oslo::tcp_endpoint> endpoints;
+			endpoints.reserve (idle.size ());
+			for (auto const & client : idle)
+			{
+				endpoints.push_back (client->channel->get_tcp_endpoint ());
+			}
+			auto scores (node.bootstrap_initiator.peer_scores.scores (endpoints));
+			auto best (std::max_element (scores.rbegin (), scores.rend ()));
+			auto index (std::distance (best, scores.rend ()) - 1);
+			result = idle[index];
+			idle.erase (idle.begin () + index);
 		}
 		else
 		{
@@ -89,6 +229,19 @@ std::shared_ptr<oslo::bootstrap_client> oslo::bootstrap_connections::connection
 	return result;
 }
 
+std::shared_ptr<oslo::bootstrap_client> oslo::bootstrap_connections::idle_connection ()
+{
+	// Same as connection () without waiting for one to become idle
+	oslo::lock_guard<std::mutex> lock (mutex);
+	std::shared_ptr<oslo::bootstrap_client> result;
+	if (!stopped && !idle.empty ())
+	{
+		result = idle.back ();
+		idle.pop_back ();
+	}
+	return result;
+}
+
 void oslo::bootstrap_connections::pool_connection (std::shared_ptr<oslo::bootstrap_client> client_a, bool new_client, bool push_front)
 {
 	oslo::unique_lock<std::mutex> lock (mutex);
@@ -151,18 +304,24 @@ void oslo::bootstrap_connections::connect_client (oslo::tcp_endpoint const & end
 	auto socket (std::make_shared<oslo::socket> (node.shared ()));
 	auto this_l (shared_from_this ());
 	socket->async_connect (endpoint_a,
-	[this_l, socket, endpoint_a, push_front](boost::system::error_code const & ec) {
+	[this_l, socket, endpoint_a, push_front, start_time = std::chrono::steady_clock::now ()](boost::system::error_code const & ec) {
 		if (!ec)
 		{
+			this_l->node.bootstrap_initiator.peer_scores.rtt (endpoint_a, std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - start_time));
 			if (this_l->node.config.logging.bulk_pull_logging ())
 			{
 				this_l->node.logger.try_log (boost::str (boost::format ("Connection established to %1%") % endpoint_a));
 			}
-			auto client (std::make_shared<oslo::bootstrap_client> (this_l->node.shared (), this_l, std::make_shared<oslo::transport::channel_tcp> (*this_l->node.shared (), socket), socket));
+			auto channel (std::make_shared<oslo::transport::channel_tcp> (*this_l->node.shared (), socket));
+			// Bootstrap connections do not handshake, take the protocol version from the realtime channel to the same peer
+			auto realtime_channel (this_l->node.network.find_channel (oslo::transport::map_tcp_to_endpoint (endpoint_a)));
+			channel->set_network_version (realtime_channel != nullptr ? realtime_channel->get_network_version () : this_l->node.network_params.protocol.protocol_version_min (this_l->node.ledger.cache.epoch_2_started));
+			auto client (std::make_shared<oslo::bootstrap_client> (this_l->node.shared (), this_l, channel, socket));
 			this_l->pool_connection (client, true, push_front);
 		}
 		else
 		{
+			this_l->node.bootstrap_initiator.peer_scores.pull_result (endpoint_a, true);
 			if (this_l->node.config.logging.network_logging ())
 			{
 				switch (ec.value ())
@@ -185,16 +344,45 @@ void oslo::bootstrap_connections::connect_client (oslo::tcp_endpoint const & end
 
 unsigned oslo::bootstrap_connections::target_connections (size_t pulls_remaining, size_t attempts_count)
 {
+	unsigned result;
 	unsigned attempts_factor = node.config.bootstrap_connections * attempts_count;
 	if (attempts_factor >= node.config.bootstrap_connections_max)
 	{
-		return std::max (1U, node.config.bootstrap_connections_max);
+		result = std::max (1U, node.config.bootstrap_connections_max);
 	}
+	else
+	{
+		// Only scale up to bootstrap_connections_max for large pulls.
+		double step_scale = std::min (1.0, std::max (0.0, (double)pulls_remaining / oslo::bootstrap_limits::bootstrap_connection_scale_target_blocks));
+		double target = (double)attempts_factor + (double)(node.config.bootstrap_connections_max - attempts_factor) * step_scale;
+		result = std::max (1U, (unsigned)(target + 0.5f));
+	}
+	auto scaled_max (std::max (result, node.config.bootstrap_connections_max * oslo::bootstrap_limits::bootstrap_connection_scale_max_factor));
+	return std::min (result + scaled_connections, scaled_max);
+}
 
-	// Only scale up to bootstrap_connections_max for large pulls.
-	double step_scale = std::min (1.0, std::max (0.0, (double)pulls_remaining / oslo::bootstrap_limits::bootstrap_connection_scale_target_blocks));
-	double target = (double)attempts_factor + (double)(node.config.bootstrap_connections_max - attempts_factor) * step_scale;
-	return std::max (1U, (unsigned)(target + 0.5f));
+void oslo::bootstrap_connections::scale_connections (double rate_sum_a, unsigned target_a, size_t attempts_count_a)
+{
+	// Keep adding connections beyond the configured target while each step improves the aggregate block rate, step back once it drops
+	auto now (std::chrono::steady_clock::now ());
+	if (now - scale_time >= oslo::bootstrap_limits::bootstrap_connection_scale_interval)
+	{
+		auto step (std::max (1U, node.config.bootstrap_connections));
+		if (attempts_count_a == 0)
+		{
+			scaled_connections = 0;
+		}
+		else if (connections_count >= target_a && rate_sum_a > scale_rate * (1.0 + oslo::bootstrap_limits::bootstrap_connection_scale_improvement))
+		{
+			scaled_connections = std::min (scaled_connections + step, node.config.bootstrap_connections_max * oslo::bootstrap_limits::bootstrap_connection_scale_max_factor);
+		}
+		else if (rate_sum_a < scale_rate * (1.0 - oslo::bootstrap_limits::bootstrap_connection_scale_improvement))
+		{
+			scaled_connections -= std::min (step, scaled_connections.load ());
+		}
+		scale_rate = rate_sum_a;
+		scale_time = now;
+	}
 }
 
 struct block_rate_cmp
@@ -251,6 +439,7 @@ void oslo::bootstrap_connections::populate_connections (bool repeat)
 	}
 
 	auto target = target_connections (num_pulls, attempts_count);
+	scale_connections (rate_sum, target, attempts_count);
 
 	// We only want to drop slow peers when more than 2/3 are active. 2/3 because 1/2 is too aggressive, and 100% rarely happens.
 	// Probably needs more tuning.
@@ -280,7 +469,7 @@ void oslo::bootstrap_connections::populate_connections (bool repeat)
 
 	if (node.config.logging.bulk_pull_logging ())
 	{
-		node.logger.try_log (boost::str (boost::format ("Bulk pull connections: %1%, rate: %2% blocks/sec, bootstrap attempts %3%, remaining pulls: %4%") % connections_count.load () % (int)rate_sum % attempts_count % num_pulls));
+		node.logger.try_log (boost::str (boost::format ("Bulk pull connections: %1%, rate: %2% blocks/sec, bootstrap attempts %3%, remaining pulls: %4%, scaled connections: %5%") % connections_count.load () % (int)rate_sum % attempts_count % num_pulls % scaled_connections.load ()));
 	}
 
 	if (connections_count < target && (attempts_count != 0 || new_connections_empty) && !stopped)
@@ -344,7 +533,21 @@ void oslo::bootstrap_connections::request_pull (oslo::unique_lock<std::mutex> &
 	lock_a.unlock ();
 	auto connection_l (connection ());
 	lock_a.lock ();
-	if (connection_l != nullptr && !pulls.empty ())
+	if (connection_l != nullptr && !fill_pipeline (connection_l, lock_a))
+	{
+		// Reuse connection if pulls deque become empty
+		lock_a.unlock ();
+		pool_connection (connection_l);
+		lock_a.lock ();
+	}
+}
+
+bool oslo::bootstrap_connections::fill_pipeline (std::shared_ptr<oslo::bootstrap_client> const & connection_a, oslo::unique_lock<std::mutex> & lock_a)
+{
+	debug_assert (lock_a.owns_lock ());
+	std::vector<std::pair<std::shared_ptr<oslo::bootstrap_attempt>, oslo::pull_info>> requests;
+	auto depth (connection_a->pipeline_depth ());
+	while (connection_a->pipeline_pending + requests.size () < depth && !pulls.empty ())
 	{
 		std::shared_ptr<oslo::bootstrap_attempt> attempt_l;
 		oslo::pull_info pull;
@@ -367,20 +570,37 @@ void oslo::bootstrap_connections::request_pull (oslo::unique_lock<std::mutex> &
 			{
 				attempt_l->add_recent_pull (pull.head);
 			}
-			// The bulk_pull_client destructor attempt to requeue_pull which can cause a deadlock if this is the last reference
-			// Dispatch request in an external thread in case it needs to be destroyed
-			node.background ([connection_l, attempt_l, pull]() {
-				auto client (std::make_shared<oslo::bulk_pull_client> (connection_l, attempt_l, pull));
-				client->request ();
-			});
+			requests.emplace_back (attempt_l, pull);
 		}
 	}
-	else if (connection_l != nullptr)
+	if (!requests.empty ())
 	{
-		// Reuse connection if pulls deque become empty
-		lock_a.unlock ();
-		pool_connection (connection_l);
-		lock_a.lock ();
+		connection_a->pipeline_pending += requests.size ();
+		// The bulk_pull_client destructor attempt to requeue_pull which can cause a deadlock if this is the last reference
+		// Dispatch request in an external thread in case it needs to be destroyed
+		node.background ([connection_a, requests = std::move (requests)]() {
+			std::vector<std::shared_ptr<oslo::bulk_pull_client>> clients;
+			clients.reserve (requests.size ());
+			for (auto const & request : requests)
+			{
+				clients.push_back (std::make_shared<oslo::bulk_pull_client> (connection_a, request.first, request.second));
+			}
+			connection_a->pipeline_push (clients);
+		});
+		return true;
+	}
+	return false;
+}
+
+void oslo::bootstrap_connections::refill_pipeline (std::shared_ptr<oslo::bootstrap_client> const & connection_a)
+{
+	// Called once a pull response was fully received, keeps the connection busy with queued pulls and pools it when there is nothing left in flight
+	oslo::unique_lock<std::mutex> lock (mutex);
+	auto filled (!stopped && !connection_a->pending_stop && fill_pipeline (connection_a, lock));
+	if (!filled && connection_a->pipeline_pending == 0)
+	{
+		lock.unlock ();
+		pool_connection (connection_a);
 	}
 }
 
@@ -15,6 +15,7 @@ namespace transport
 
 class bootstrap_attempt;
 class bootstrap_connections;
+class bulk_pull_client;
 class frontier_req_client;
 class pull_info;
 class bootstrap_client final : public std::enable_shared_from_this<bootstrap_client>
@@ -27,6 +28,11 @@ public:
 	double block_rate () const;
 	double elapsed_seconds () const;
 	void set_start_time (std::chrono::steady_clock::time_point start_time_a);
+	unsigned pipeline_depth () const;
+	void pipeline_push (std::vector<std::shared_ptr<oslo::bulk_pull_client>> const & clients_a);
+	void pipeline_sent (oslo::bulk_pull_client const & client_a);
+	std::shared_ptr<oslo::bulk_pull_client> pipeline_pop (oslo::bulk_pull_client const & client_a);
+	void pipeline_abort (oslo::bulk_pull_client const & client_a);
 	std::shared_ptr<oslo::node> node;
 	std::shared_ptr<oslo::bootstrap_connections> connections;
 	std::shared_ptr<oslo::transport::channel_tcp> channel;
@@ -35,10 +41,20 @@ public:
 	std::atomic<uint64_t> block_count{ 0 };
 	std::atomic<bool> pending_stop{ false };
 	std::atomic<bool> hard_stop{ false };
+	/** Pulls assigned to this connection whose response has not been fully received yet */
+	std::atomic<unsigned> pipeline_pending{ 0 };
 
 private:
 	mutable std::mutex start_time_mutex;
 	std::chrono::steady_clock::time_point start_time_m;
+	std::mutex pipeline_mutex;
+	/** Pull clients in the order their responses arrive on the socket, the last pipeline_unsent of them have not been sent yet */
+	std::deque<std::shared_ptr<oslo::bulk_pull_client>> pipeline;
+	size_t pipeline_unsent{ 0 };
+	bool pipeline_sending{ false };
+	bool pipeline_receiving{ false };
+	/** Set once by pipeline_abort, pulls pushed afterwards are rejected */
+	bool pipeline_aborted{ false };
 };
 
 class bootstrap_connections final : public std::enable_shared_from_this<bootstrap_connections>
@@ -47,6 +63,7 @@ public:
 	bootstrap_connections (oslo::node & node_a);
 	std::shared_ptr<oslo::bootstrap_connections> shared ();
 	std::shared_ptr<oslo::bootstrap_client> connection (std::shared_ptr<oslo::bootstrap_attempt> attempt_a = nullptr, bool use_front_connection = false);
+	std::shared_ptr<oslo::bootstrap_client> idle_connection ();
 	void pool_connection (std::shared_ptr<oslo::bootstrap_client> client_a, bool new_client = false, bool push_front = false);
 	void add_connection (oslo::endpoint const & endpoint_a);
 	std::shared_ptr<oslo::bootstrap_client> find_connection (oslo::tcp_endpoint const & endpoint_a);
@@ -56,6 +73,8 @@ public:
 	void start_populate_connections ();
 	void add_pull (oslo::pull_info const & pull_a);
 	void request_pull (oslo::unique_lock<std::mutex> & lock_a);
+	bool fill_pipeline (std::shared_ptr<oslo::bootstrap_client> const & connection_a, oslo::unique_lock<std::mutex> & lock_a);
+	void refill_pipeline (std::shared_ptr<oslo::bootstrap_client> const & connection_a);
 	void requeue_pull (oslo::pull_info const & pull_a, bool network_error = false);
 	void clear_pulls (uint64_t);
 	void run ();
@@ -68,7 +87,14 @@ public:
 	std::atomic<bool> populate_connections_started{ false };
 	std::atomic<bool> new_connections_empty{ false };
 	std::atomic<bool> stopped{ false };
+	/** Connections added to the target while the aggregate block rate keeps improving */
+	std::atomic<unsigned> scaled_connections{ 0 };
 	std::mutex mutex;
 	oslo::condition_variable condition;
+
+private:
+	void scale_connections (double rate_sum_a, unsigned target_a, size_t attempts_count_a);
+	double scale_rate{ 0.0 };
+	std::chrono::steady_clock::time_point scale_time{ std::chrono::steady_clock::now () };
 };
 }
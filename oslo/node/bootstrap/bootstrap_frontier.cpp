@@ -9,13 +9,14 @@ constexpr double oslo::bootstrap_limits::bootstrap_connection_warmup_time_sec;
 constexpr double oslo::bootstrap_limits::bootstrap_minimum_elapsed_seconds_blockrate;
 constexpr double oslo::bootstrap_limits::bootstrap_minimum_frontier_blocks_per_sec;
 constexpr unsigned oslo::bootstrap_limits::bulk_push_cost_limit;
+constexpr size_t oslo::bootstrap_limits::frontier_accounts_batch_max;
 
 constexpr size_t oslo::frontier_req_client::size_frontier;
 
 void oslo::frontier_req_client::run ()
 {
 	oslo::frontier_req request;
-	request.start.clear ();
+	request.start = start;
 	request.age = std::numeric_limits<decltype (request.age)>::max ();
 	request.count = std::numeric_limits<decltype (request.count)>::max ();
 	auto this_l (shared_from_this ());
@@ -36,10 +37,12 @@ void oslo::frontier_req_client::run ()
 	oslo::buffer_drop_policy::no_limiter_drop);
 }
 
-oslo::frontier_req_client::frontier_req_client (std::shared_ptr<oslo::bootstrap_client> connection_a, std::shared_ptr<oslo::bootstrap_attempt> attempt_a) :
+oslo::frontier_req_client::frontier_req_client (std::shared_ptr<oslo::bootstrap_client> connection_a, std::shared_ptr<oslo::bootstrap_attempt> attempt_a, oslo::account const & start_a, oslo::account const & end_a) :
 connection (connection_a),
 attempt (attempt_a),
-current (0),
+start (start_a),
+end (end_a),
+current (start_a.is_zero () ? 0 : start_a.number () - 1),
 count (0),
 bulk_push_cost (0)
 {
@@ -77,7 +80,7 @@ void oslo::frontier_req_client::unsynced (oslo::block_hash const & head, oslo::b
 {
 	if (bulk_push_cost < oslo::bootstrap_limits::bulk_push_cost_limit)
 	{
-		attempt->add_bulk_push_target (head, end);
+		attempt->add_bulk_push_target (connection->channel->get_tcp_endpoint (), head, end);
 		if (end.is_zero ())
 		{
 			bulk_push_cost += 2;
@@ -123,7 +126,7 @@ void oslo::frontier_req_client::received_frontier (boost::system::error_code con
 		{
 			connection->node->logger.always_log (boost::str (boost::format ("Received %1% frontiers from %2%") % std::to_string (count) % connection->channel->to_string ()));
 		}
-		if (!account.is_zero ())
+		if (!account.is_zero () && in_range (account))
 		{
 			while (!current.is_zero () && current < account)
 			{
@@ -148,7 +151,7 @@ void oslo::frontier_req_client::received_frontier (boost::system::error_code con
 						}
 						else
 						{
-							attempt->add_frontier (oslo::pull_info (account, latest, frontier, attempt->incremental_id, 0, connection->node->network_params.bootstrap.frontier_retry_limit));
+							pulls.emplace_back (oslo::pull_info (account, latest, frontier, attempt->incremental_id, 0, connection->node->network_params.bootstrap.frontier_retry_limit));
 							// Either we're behind or there's a fork we differ on
 							// Either way, bulk pushing will probably not be effective
 							bulk_push_cost += 5;
@@ -159,12 +162,12 @@ void oslo::frontier_req_client::received_frontier (boost::system::error_code con
 				else
 				{
 					debug_assert (account < current);
-					attempt->add_frontier (oslo::pull_info (account, latest, oslo::block_hash (0), attempt->incremental_id, 0, connection->node->network_params.bootstrap.frontier_retry_limit));
+					pulls.emplace_back (oslo::pull_info (account, latest, oslo::block_hash (0), attempt->incremental_id, 0, connection->node->network_params.bootstrap.frontier_retry_limit));
 				}
 			}
 			else
 			{
-				attempt->add_frontier (oslo::pull_info (account, latest, oslo::block_hash (0), attempt->incremental_id, 0, connection->node->network_params.bootstrap.frontier_retry_limit));
+				pulls.emplace_back (oslo::pull_info (account, latest, oslo::block_hash (0), attempt->incremental_id, 0, connection->node->network_params.bootstrap.frontier_retry_limit));
 			}
 			receive_frontier ();
 		}
@@ -180,6 +183,7 @@ void oslo::frontier_req_client::received_frontier (boost::system::error_code con
 			{
 				connection->node->logger.try_log ("Bulk push cost: ", bulk_push_cost);
 			}
+			attempt->add_frontiers (pulls);
 			{
 				try
 				{
@@ -188,7 +192,15 @@ void oslo::frontier_req_client::received_frontier (boost::system::error_code con
 				catch (std::future_error &)
 				{
 				}
-				connection->connections->pool_connection (connection);
+				if (account.is_zero ())
+				{
+					connection->connections->pool_connection (connection);
+				}
+				else if (auto socket_l = connection->channel->socket.lock ())
+				{
+					// The peer keeps streaming frontiers past the end of the range, the connection cannot be reused
+					socket_l->close ();
+				}
 			}
 		}
 	}
@@ -201,25 +213,32 @@ void oslo::frontier_req_client::received_frontier (boost::system::error_code con
 	}
 }
 
+bool oslo::frontier_req_client::in_range (oslo::account const & account_a) const
+{
+	return end.is_zero () || account_a < end;
+}
+
 void oslo::frontier_req_client::next ()
 {
 	// Filling accounts deque to prevent often read transactions
 	if (accounts.empty ())
 	{
-		size_t max_size (128);
+		size_t max_size (accounts_batch);
 		auto transaction (connection->node->store.tx_begin_read ());
-		for (auto i (connection->node->store.latest_begin (transaction, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size; ++i)
+		for (auto i (connection->node->store.latest_begin (transaction, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size && in_range (i->first); ++i)
 		{
 			oslo::account_info const & info (i->second);
 			oslo::account const & account (i->first);
 			accounts.emplace_back (account, info.head);
 		}
-		/* If loop breaks before max_size, then latest_end () is reached
+		/* If loop breaks before max_size, then latest_end () or the end of the range is reached
 		Add empty record to finish frontier_req_server */
 		if (accounts.size () != max_size)
 		{
 			accounts.emplace_back (oslo::account (0), oslo::block_hash (0));
 		}
+		// Following reads are larger, the first one is kept small so comparing starts quickly
+		accounts_batch = std::min (accounts_batch * 2, oslo::bootstrap_limits::frontier_accounts_batch_max);
 	}
 	// Retrieving accounts from deque
 	auto const & account_pair (accounts.front ());
@@ -321,7 +340,8 @@ void oslo::frontier_req_server::next ()
 	{
 		auto now (oslo::seconds_since_epoch ());
 		bool skip_old (request->age != std::numeric_limits<decltype (request->age)>::max ());
-		size_t max_size (128);
+		// No need to read more accounts than are left to send
+		size_t max_size (std::min (accounts_batch, std::max<size_t> (request->count - count, 1)));
 		auto transaction (connection->node->store.tx_begin_read ());
 		for (auto i (connection->node->store.latest_begin (transaction, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size; ++i)
 		{
@@ -338,6 +358,7 @@ void oslo::frontier_req_server::next ()
 		{
 			accounts.emplace_back (oslo::account (0), oslo::block_hash (0));
 		}
+		accounts_batch = std::min (accounts_batch * 2, oslo::bootstrap_limits::frontier_accounts_batch_max);
 	}
 	// Retrieving accounts from deque
 	auto const & account_pair (accounts.front ());
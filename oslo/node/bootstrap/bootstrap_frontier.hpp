@@ -1,5 +1,6 @@
 #pragma once
 
+#include <oslo/node/bootstrap/bootstrap_bulk_pull.hpp>
 #include <oslo/node/common.hpp>
 
 #include <deque>
@@ -12,15 +13,19 @@ class bootstrap_client;
 class frontier_req_client final : public std::enable_shared_from_this<oslo::frontier_req_client>
 {
 public:
-	explicit frontier_req_client (std::shared_ptr<oslo::bootstrap_client>, std::shared_ptr<oslo::bootstrap_attempt>);
+	frontier_req_client (std::shared_ptr<oslo::bootstrap_client>, std::shared_ptr<oslo::bootstrap_attempt>, oslo::account const & = 0, oslo::account const & = 0);
 	~frontier_req_client ();
 	void run ();
 	void receive_frontier ();
 	void received_frontier (boost::system::error_code const &, size_t);
 	void unsynced (oslo::block_hash const &, oslo::block_hash const &);
 	void next ();
+	bool in_range (oslo::account const &) const;
 	std::shared_ptr<oslo::bootstrap_client> connection;
 	std::shared_ptr<oslo::bootstrap_attempt> attempt;
+	/** Account range [start, end) requested from the peer, a zero end covers the rest of the keyspace */
+	oslo::account start;
+	oslo::account end;
 	oslo::account current;
 	oslo::block_hash frontier;
 	unsigned count;
@@ -31,6 +36,9 @@ public:
 	/** A very rough estimate of the cost of `bulk_push`ing missing blocks */
 	uint64_t bulk_push_cost;
 	std::deque<std::pair<oslo::account, oslo::block_hash>> accounts;
+	size_t accounts_batch{ 128 };
+	/** Pulls for this range, handed to the attempt once the range completes */
+	std::deque<oslo::pull_info> pulls;
 	static size_t constexpr size_frontier = sizeof (oslo::account) + sizeof (oslo::block_hash);
 };
 class bootstrap_server;
@@ -50,5 +58,6 @@ public:
 	std::unique_ptr<oslo::frontier_req> request;
 	size_t count;
 	std::deque<std::pair<oslo::account, oslo::block_hash>> accounts;
+	size_t accounts_batch{ 128 };
 };
 }
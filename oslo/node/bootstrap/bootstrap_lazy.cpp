@@ -271,10 +271,10 @@ bool oslo::bootstrap_attempt_lazy::process_block_lazy (std::shared_ptr<oslo::blo
 		// Adding lazy balances for first processed block in pull
 		if (pull_blocks == 0 && (block_a->type () == oslo::block_type::state || block_a->type () == oslo::block_type::send))
 		{
-			lazy_balances.emplace (hash, block_a->balance ().number ());
+			lazy_balances.insert (hash, block_a->balance ().number ());
 		}
 		// Clearing lazy balances for previous block
-		if (!block_a->previous ().is_zero () && lazy_balances.find (block_a->previous ()) != lazy_balances.end ())
+		if (!block_a->previous ().is_zero ())
 		{
 			lazy_balances.erase (block_a->previous ());
 		}
@@ -324,9 +324,9 @@ void oslo::bootstrap_attempt_lazy::lazy_block_state (std::shared_ptr<oslo::block
 			else if (lazy_blocks_processed (previous))
 			{
 				auto previous_balance (lazy_balances.find (previous));
-				if (previous_balance != lazy_balances.end ())
+				if (previous_balance != nullptr)
 				{
-					if (previous_balance->second <= balance)
+					if (*previous_balance <= balance)
 					{
 						lazy_add (link, retry_limit);
 					}
@@ -334,13 +334,13 @@ void oslo::bootstrap_attempt_lazy::lazy_block_state (std::shared_ptr<oslo::block
 					{
 						lazy_destinations_increment (link);
 					}
-					lazy_balances.erase (previous_balance);
+					lazy_balances.erase (previous);
 				}
 			}
 			// Insert in backlog state blocks if previous wasn't already processed
 			else
 			{
-				lazy_state_backlog.emplace (previous, oslo::lazy_state_backlog_item{ link, balance, retry_limit });
+				lazy_state_backlog.insert (previous, oslo::lazy_state_backlog_item{ previous, link, balance, retry_limit });
 			}
 		}
 	}
@@ -350,9 +350,9 @@ void oslo::bootstrap_attempt_lazy::lazy_block_state_backlog_check (std::shared_p
 {
 	// Search unknown state blocks balances
 	auto find_state (lazy_state_backlog.find (hash_a));
-	if (find_state != lazy_state_backlog.end ())
+	if (find_state != nullptr)
 	{
-		auto next_block (find_state->second);
+		auto next_block (*find_state);
 		// Retrieve balance for previous state & send blocks
 		if (block_a->type () == oslo::block_type::state || block_a->type () == oslo::block_type::send)
 		{
@@ -366,12 +366,11 @@ void oslo::bootstrap_attempt_lazy::lazy_block_state_backlog_check (std::shared_p
 			}
 		}
 		// Assumption for other legacy block types
-		else if (lazy_undefined_links.find (next_block.link) == lazy_undefined_links.end ())
+		else if (lazy_undefined_links.insert (next_block.link))
 		{
 			lazy_add (next_block.link, node->network_params.bootstrap.lazy_retry_limit); // Head is not confirmed. It can be account or hash or non-existing
-			lazy_undefined_links.insert (next_block.link);
 		}
-		lazy_state_backlog.erase (find_state);
+		lazy_state_backlog.erase (hash_a);
 	}
 }
 
@@ -379,33 +378,35 @@ void oslo::bootstrap_attempt_lazy::lazy_backlog_cleanup ()
 {
 	uint64_t read_count (0);
 	auto transaction (node->store.tx_begin_read ());
-	for (auto it (lazy_state_backlog.begin ()), end (lazy_state_backlog.end ()); it != end && !stopped;)
-	{
-		if (node->store.block_exists (transaction, it->first))
+	lazy_state_backlog.erase_if ([this, &read_count, &transaction](oslo::lazy_state_backlog_item const & next_block) {
+		auto erase (false);
+		if (!stopped)
 		{
-			auto next_block (it->second);
-			if (node->ledger.balance (transaction, it->first) <= next_block.balance) // balance
+			if (node->store.block_exists (transaction, next_block.previous))
 			{
-				lazy_add (next_block.link, next_block.retry_limit); // link
+				if (node->ledger.balance (transaction, next_block.previous) <= next_block.balance) // balance
+				{
+					lazy_add (next_block.link, next_block.retry_limit); // link
+				}
+				else
+				{
+					lazy_destinations_increment (next_block.link);
+				}
+				erase = true;
 			}
 			else
 			{
-				lazy_destinations_increment (next_block.link);
+				lazy_add (next_block.previous, next_block.retry_limit);
+			}
+			// We don't want to open read transactions for too long
+			++read_count;
+			if (read_count % batch_read_size == 0)
+			{
+				transaction.refresh ();
 			}
-			it = lazy_state_backlog.erase (it);
-		}
-		else
-		{
-			lazy_add (it->first, it->second.retry_limit);
-			++it;
-		}
-		// We don't want to open read transactions for too long
-		++read_count;
-		if (read_count % batch_read_size == 0)
-		{
-			transaction.refresh ();
 		}
-	}
+		return erase;
+	});
 }
 
 void oslo::bootstrap_attempt_lazy::lazy_destinations_increment (oslo::account const & destination_a)
@@ -444,8 +445,7 @@ void oslo::bootstrap_attempt_lazy::lazy_destinations_flush ()
 void oslo::bootstrap_attempt_lazy::lazy_blocks_insert (oslo::block_hash const & hash_a)
 {
 	debug_assert (!mutex.try_lock ());
-	auto inserted (lazy_blocks.insert (std::hash<::oslo::block_hash> () (hash_a)));
-	if (inserted.second)
+	if (lazy_blocks.insert (hash_a))
 	{
 		++lazy_blocks_count;
 		debug_assert (lazy_blocks_count > 0);
@@ -455,8 +455,7 @@ void oslo::bootstrap_attempt_lazy::lazy_blocks_insert (oslo::block_hash const &
 void oslo::bootstrap_attempt_lazy::lazy_blocks_erase (oslo::block_hash const & hash_a)
 {
 	debug_assert (!mutex.try_lock ());
-	auto erased (lazy_blocks.erase (std::hash<::oslo::block_hash> () (hash_a)));
-	if (erased)
+	if (lazy_blocks.erase (hash_a))
 	{
 		--lazy_blocks_count;
 		debug_assert (lazy_blocks_count != std::numeric_limits<size_t>::max ());
@@ -465,7 +464,7 @@ void oslo::bootstrap_attempt_lazy::lazy_blocks_erase (oslo::block_hash const & h
 
 bool oslo::bootstrap_attempt_lazy::lazy_blocks_processed (oslo::block_hash const & hash_a)
 {
-	return lazy_blocks.find (std::hash<::oslo::block_hash> () (hash_a)) != lazy_blocks.end ();
+	return lazy_blocks.contains (hash_a);
 }
 
 bool oslo::bootstrap_attempt_lazy::lazy_processed_or_exists (oslo::block_hash const & hash_a)
@@ -501,6 +500,14 @@ void oslo::bootstrap_attempt_lazy::get_information (boost::property_tree::ptree
 	{
 		tree_a.put ("lazy_key_1", (*(lazy_keys.begin ())).to_string ());
 	}
+	tree_a.put ("lazy_memory", std::to_string (memory ()));
+}
+
+size_t oslo::bootstrap_attempt_lazy::memory ()
+{
+	debug_assert (!mutex.try_lock ());
+	// Approximate, node based containers are counted by their elements only
+	return lazy_blocks.memory () + lazy_state_backlog.memory () + lazy_undefined_links.memory () + lazy_balances.memory () + lazy_keys.size () * sizeof (oslo::block_hash) + lazy_pulls.size () * sizeof (decltype (lazy_pulls)::value_type) + lazy_destinations.size () * sizeof (oslo::lazy_destinations_item);
 }
 
 oslo::bootstrap_attempt_wallet::bootstrap_attempt_wallet (std::shared_ptr<oslo::node> node_a, uint64_t incremental_id_a, std::string id_a) :
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <oslo/crypto_lib/random_pool.hpp>
 #include <oslo/node/bootstrap/bootstrap_attempt.hpp>
 #include <oslo/node/bootstrap/bootstrap_bulk_pull.hpp>
 
@@ -17,9 +18,196 @@ namespace mi = boost::multi_index;
 namespace oslo
 {
 class node;
+/**
+ * Open addressing table keyed by seeded 64 bit fingerprints of 256 bit keys, storing the fingerprint instead of the key.
+ * Distinct keys sharing a fingerprint are treated as equal, only for bookkeeping where such a rare false positive is harmless.
+ * Uses linear probing with backward shift deletion, a zero fingerprint marks an empty slot. Sets use a uint8_t value.
+ */
+template <typename T>
+class fingerprint_table final
+{
+public:
+	fingerprint_table ()
+	{
+		oslo::random_pool::generate_block (reinterpret_cast<unsigned char *> (&seed), sizeof (seed));
+	}
+	T * find (oslo::uint256_union const & key_a)
+	{
+		T * result (nullptr);
+		if (!fingerprints.empty ())
+		{
+			auto fingerprint_l (fingerprint (key_a));
+			for (auto i (index (fingerprint_l)); fingerprints[i] != 0; i = next (i))
+			{
+				if (fingerprints[i] == fingerprint_l)
+				{
+					result = &values[i];
+					break;
+				}
+			}
+		}
+		return result;
+	}
+	bool contains (oslo::uint256_union const & key_a)
+	{
+		return find (key_a) != nullptr;
+	}
+	/** Returns true if the key was inserted, existing values are kept */
+	bool insert (oslo::uint256_union const & key_a, T const & value_a = T{})
+	{
+		if ((count + 1) * 4 > fingerprints.size () * 3)
+		{
+			grow ();
+		}
+		auto fingerprint_l (fingerprint (key_a));
+		auto i (index (fingerprint_l));
+		for (; fingerprints[i] != 0; i = next (i))
+		{
+			if (fingerprints[i] == fingerprint_l)
+			{
+				return false;
+			}
+		}
+		fingerprints[i] = fingerprint_l;
+		values[i] = value_a;
+		++count;
+		return true;
+	}
+	/** Returns true if the key was found and erased */
+	bool erase (oslo::uint256_union const & key_a)
+	{
+		auto result (false);
+		if (!fingerprints.empty ())
+		{
+			auto fingerprint_l (fingerprint (key_a));
+			for (auto i (index (fingerprint_l)); fingerprints[i] != 0; i = next (i))
+			{
+				if (fingerprints[i] == fingerprint_l)
+				{
+					erase_slot (i);
+					result = true;
+					break;
+				}
+			}
+		}
+		return result;
+	}
+	/** Visits every value once, erasing the ones for which predicate_a returns true */
+	template <typename Predicate>
+	void erase_if (Predicate predicate_a)
+	{
+		if (count != 0)
+		{
+			// Backward shift never moves values across an empty slot, starting after one visits every value exactly once
+			size_t empty (0);
+			while (fingerprints[empty] != 0)
+			{
+				++empty;
+			}
+			auto i (next (empty));
+			while (i != empty)
+			{
+				if (fingerprints[i] != 0 && predicate_a (values[i]))
+				{
+					// A following value may have been shifted into this slot
+					erase_slot (i);
+				}
+				else
+				{
+					i = next (i);
+				}
+			}
+		}
+	}
+	size_t size () const
+	{
+		return count;
+	}
+	bool empty () const
+	{
+		return count == 0;
+	}
+	void clear ()
+	{
+		std::vector<uint64_t> ().swap (fingerprints);
+		std::vector<T> ().swap (values);
+		count = 0;
+	}
+	/** Bytes allocated for slots */
+	size_t memory () const
+	{
+		return fingerprints.capacity () * sizeof (uint64_t) + values.capacity () * sizeof (T);
+	}
+
+private:
+	uint64_t fingerprint (oslo::uint256_union const & key_a) const
+	{
+		// Seeded so chosen keys (accounts and links) cannot be crafted to collide across nodes
+		auto result (seed);
+		for (auto qword : key_a.qwords)
+		{
+			result = (result ^ qword) * 0x9e3779b97f4a7c15ULL;
+			result ^= result >> 32;
+		}
+		return result != 0 ? result : 1;
+	}
+	size_t index (uint64_t fingerprint_a) const
+	{
+		return static_cast<size_t> (fingerprint_a) & (fingerprints.size () - 1);
+	}
+	size_t next (size_t index_a) const
+	{
+		return (index_a + 1) & (fingerprints.size () - 1);
+	}
+	void erase_slot (size_t index_a)
+	{
+		// Shift following values of the probe sequence back so lookups never stop early at the freed slot
+		auto hole (index_a);
+		for (auto i (next (hole)); fingerprints[i] != 0; i = next (i))
+		{
+			auto home (index (fingerprints[i]));
+			// Move the value if its home slot is not cyclically within (hole, i]
+			if ((i > hole && (home <= hole || home > i)) || (i < hole && home <= hole && home > i))
+			{
+				fingerprints[hole] = fingerprints[i];
+				values[hole] = std::move (values[i]);
+				hole = i;
+			}
+		}
+		fingerprints[hole] = 0;
+		values[hole] = T{};
+		--count;
+	}
+	void grow ()
+	{
+		std::vector<uint64_t> fingerprints_l (std::max<size_t> (64, fingerprints.size () * 2), 0);
+		std::vector<T> values_l (fingerprints_l.size ());
+		fingerprints.swap (fingerprints_l);
+		values.swap (values_l);
+		for (size_t i (0), n (fingerprints_l.size ()); i < n; ++i)
+		{
+			if (fingerprints_l[i] != 0)
+			{
+				auto j (index (fingerprints_l[i]));
+				while (fingerprints[j] != 0)
+				{
+					j = next (j);
+				}
+				fingerprints[j] = fingerprints_l[i];
+				values[j] = std::move (values_l[i]);
+			}
+		}
+	}
+	uint64_t seed{ 0 };
+	size_t count{ 0 };
+	std::vector<uint64_t> fingerprints;
+	std::vector<T> values;
+};
 class lazy_state_backlog_item final
 {
 public:
+	/** Previous block the balance is waiting for, kept in the value as the table only stores fingerprints of it */
+	oslo::block_hash previous{ 0 };
 	oslo::link link{ 0 };
 	oslo::uint128_t balance{ 0 };
 	unsigned retry_limit{ 0 };
@@ -56,10 +244,13 @@ public:
 	bool lazy_blocks_processed (oslo::block_hash const &);
 	bool lazy_processed_or_exists (oslo::block_hash const &) override;
 	void get_information (boost::property_tree::ptree &) override;
-	std::unordered_set<size_t> lazy_blocks;
-	std::unordered_map<oslo::block_hash, oslo::lazy_state_backlog_item> lazy_state_backlog;
-	std::unordered_set<oslo::block_hash> lazy_undefined_links;
-	std::unordered_map<oslo::block_hash, oslo::uint128_t> lazy_balances;
+	size_t memory ();
+	/** Processed blocks, a false positive skips pulling a block which is then found by a later pull or legacy bootstrap */
+	oslo::fingerprint_table<uint8_t> lazy_blocks;
+	oslo::fingerprint_table<oslo::lazy_state_backlog_item> lazy_state_backlog;
+	oslo::fingerprint_table<uint8_t> lazy_undefined_links;
+	oslo::fingerprint_table<oslo::uint128_t> lazy_balances;
+	/** Bounded by the lazy_start limit, kept as full hashes for reporting */
 	std::unordered_set<oslo::block_hash> lazy_keys;
 	std::deque<std::pair<oslo::hash_or_account, unsigned>> lazy_pulls;
 	std::chrono::steady_clock::time_point lazy_start_time;
@@ -0,0 +1,163 @@
+#include <oslo/crypto_lib/random_pool.hpp>
+#include <oslo/node/bootstrap/bootstrap_peer_scores.hpp>
+#include <oslo/node/node.hpp>
+
+#include <numeric>
+
+constexpr double oslo::bootstrap_peer_scores::ewma_weight;
+constexpr double oslo::bootstrap_peer_scores::minimum_score;
+constexpr size_t oslo::bootstrap_peer_scores::max_peers;
+
+oslo::bootstrap_peer_scores::bootstrap_peer_scores (oslo::node & node_a) :
+node (node_a)
+{
+}
+
+void oslo::bootstrap_peer_scores::load ()
+{
+	auto transaction (node.store.tx_begin_read ());
+	oslo::lock_guard<std::mutex> guard (mutex);
+	for (auto i (node.store.bootstrap_peers_begin (transaction)), n (node.store.bootstrap_peers_end ()); i != n && peers.size () < max_peers; ++i)
+	{
+		oslo::tcp_endpoint endpoint (boost::asio::ip::address_v6 (i->first.address_bytes ()), i->first.port ());
+		peers[endpoint] = i->second;
+	}
+}
+
+void oslo::bootstrap_peer_scores::store ()
+{
+	// Copy the scores so the mutex is not held while waiting for a write transaction
+	decltype (peers) peers_l;
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		peers_l = peers;
+	}
+	if (!peers_l.empty ())
+	{
+		auto transaction (node.store.tx_begin_write ({ tables::bootstrap_peers }));
+		node.store.bootstrap_peer_clear (transaction);
+		for (auto const & peer : peers_l)
+		{
+			oslo::endpoint_key endpoint_key (peer.first.address ().to_v6 ().to_bytes (), peer.first.port ());
+			node.store.bootstrap_peer_put (transaction, endpoint_key, peer.second);
+		}
+	}
+}
+
+oslo::bootstrap_peer_info * oslo::bootstrap_peer_scores::find_or_insert (oslo::tcp_endpoint const & endpoint_a)
+{
+	oslo::bootstrap_peer_info * result (nullptr);
+	auto existing (peers.find (endpoint_a));
+	if (existing != peers.end ())
+	{
+		result = &existing->second;
+	}
+	else if (peers.size () < max_peers)
+	{
+		result = &peers[endpoint_a];
+	}
+	return result;
+}
+
+void oslo::bootstrap_peer_scores::throughput (oslo::tcp_endpoint const & endpoint_a, double blocks_per_sec_a)
+{
+	oslo::lock_guard<std::mutex> guard (mutex);
+	if (auto info = find_or_insert (endpoint_a))
+	{
+		info->throughput = info->samples == 0 ? blocks_per_sec_a : info->throughput + ewma_weight * (blocks_per_sec_a - info->throughput);
+		++info->samples;
+	}
+}
+
+void oslo::bootstrap_peer_scores::pull_result (oslo::tcp_endpoint const & endpoint_a, bool error_a)
+{
+	oslo::lock_guard<std::mutex> guard (mutex);
+	if (auto info = find_or_insert (endpoint_a))
+	{
+		info->error_rate += ewma_weight * ((error_a ? 1.0 : 0.0) - info->error_rate);
+	}
+}
+
+void oslo::bootstrap_peer_scores::rtt (oslo::tcp_endpoint const & endpoint_a, std::chrono::milliseconds const & rtt_a)
+{
+	auto rtt_l (static_cast<double> (rtt_a.count ()));
+	oslo::lock_guard<std::mutex> guard (mutex);
+	if (auto info = find_or_insert (endpoint_a))
+	{
+		info->rtt = info->rtt == 0.0 ? rtt_l : info->rtt + ewma_weight * (rtt_l - info->rtt);
+	}
+}
+
+double oslo::bootstrap_peer_scores::score_l (oslo::bootstrap_peer_info const & info_a) const
+{
+	// Failed pulls are requeued and slow connections delay the last pulls of an attempt
+	return std::max (minimum_score, info_a.throughput * (1.0 - info_a.error_rate) / (1.0 + info_a.rtt / 1000.0));
+}
+
+double oslo::bootstrap_peer_scores::average_score () const
+{
+	double sum (0.0);
+	size_t count (0);
+	for (auto const & peer : peers)
+	{
+		if (peer.second.samples > 0)
+		{
+			sum += score_l (peer.second);
+			++count;
+		}
+	}
+	return count > 0 ? sum / count : minimum_score;
+}
+
+double oslo::bootstrap_peer_scores::score (oslo::tcp_endpoint const & endpoint_a)
+{
+	oslo::lock_guard<std::mutex> guard (mutex);
+	auto existing (peers.find (endpoint_a));
+	return (existing != peers.end () && existing->second.samples > 0) ? score_l (existing->second) : average_score ();
+}
+
+std::vector<double> oslo::bootstrap_peer_scores::scores (std::vector<oslo::tcp_endpoint> const & endpoints_a)
+{
+	std::vector<double> result;
+	result.reserve (endpoints_a.size ());
+	oslo::lock_guard<std::mutex> guard (mutex);
+	auto average (average_score ());
+	for (auto const & endpoint : endpoints_a)
+	{
+		auto existing (peers.find (endpoint));
+		result.push_back ((existing != peers.end () && existing->second.samples > 0) ? score_l (existing->second) : average);
+	}
+	return result;
+}
+
+size_t oslo::bootstrap_peer_scores::select (std::vector<oslo::tcp_endpoint> const & candidates_a)
+{
+	debug_assert (!candidates_a.empty ());
+	auto weights (scores (candidates_a));
+	auto total (std::accumulate (weights.begin (), weights.end (), 0.0));
+	auto target (total * oslo::random_pool::generate_word32 (0, std::numeric_limits<uint32_t>::max ()) / std::numeric_limits<uint32_t>::max ());
+	size_t result (0);
+	for (; result + 1 < weights.size () && target >= weights[result]; ++result)
+	{
+		target -= weights[result];
+	}
+	return result;
+}
+
+boost::optional<oslo::bootstrap_peer_info> oslo::bootstrap_peer_scores::get (oslo::tcp_endpoint const & endpoint_a)
+{
+	boost::optional<oslo::bootstrap_peer_info> result;
+	oslo::lock_guard<std::mutex> guard (mutex);
+	auto existing (peers.find (endpoint_a));
+	if (existing != peers.end ())
+	{
+		result = existing->second;
+	}
+	return result;
+}
+
+size_t oslo::bootstrap_peer_scores::size ()
+{
+	oslo::lock_guard<std::mutex> guard (mutex);
+	return peers.size ();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <oslo/node/common.hpp>
+#include <oslo/secure/common.hpp>
+
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace oslo
+{
+class node;
+/**
+ * Bootstrap performance of peers kept across bootstrap attempts and node restarts.
+ * Throughput, pull error rate and connection round trip time are exponentially weighted moving averages,
+ * the resulting score weights bootstrap peer selection and which idle connection receives the next pulls.
+ */
+class bootstrap_peer_scores final
+{
+public:
+	explicit bootstrap_peer_scores (oslo::node &);
+	/** Reads scores from the bootstrap_peers table */
+	void load ();
+	/** Replaces the contents of the bootstrap_peers table with the current scores */
+	void store ();
+	/** Block rate of a finished bootstrap connection */
+	void throughput (oslo::tcp_endpoint const &, double);
+	/** Outcome of a pull, \p error_a is set when the pull ended before its expected end block */
+	void pull_result (oslo::tcp_endpoint const &, bool error_a);
+	/** Time taken to establish a bootstrap connection */
+	void rtt (oslo::tcp_endpoint const &, std::chrono::milliseconds const &);
+	/** Estimated useful blocks per second, peers without throughput samples get the average score of known peers */
+	double score (oslo::tcp_endpoint const &);
+	std::vector<double> scores (std::vector<oslo::tcp_endpoint> const &);
+	/** Returns the index of one of \p candidates_a picked with a probability proportional to its score */
+	size_t select (std::vector<oslo::tcp_endpoint> const & candidates_a);
+	boost::optional<oslo::bootstrap_peer_info> get (oslo::tcp_endpoint const &);
+	size_t size ();
+	/** Weight of a new sample in the moving averages */
+	static double constexpr ewma_weight = 0.25;
+	/** Lowest selection weight so that slow peers still get sampled again */
+	static double constexpr minimum_score = 1.0;
+	static size_t constexpr max_peers = 4096;
+
+private:
+	oslo::bootstrap_peer_info * find_or_insert (oslo::tcp_endpoint const &);
+	double score_l (oslo::bootstrap_peer_info const &) const;
+	double average_score () const;
+	oslo::node & node;
+	std::mutex mutex;
+	std::unordered_map<oslo::tcp_endpoint, oslo::bootstrap_peer_info> peers;
+};
+}
@@ -6,6 +6,8 @@
 
 #include <boost/format.hpp>
 
+constexpr size_t oslo::bootstrap_server::read_buffer_size;
+
 oslo::bootstrap_listener::bootstrap_listener (uint16_t port_a, oslo::node & node_a) :
 node (node_a),
 port (port_a)
@@ -149,6 +151,11 @@ void oslo::bootstrap_server::stop ()
 
 void oslo::bootstrap_server::receive ()
 {
+	if (is_realtime_connection ())
+	{
+		receive_buffered ();
+		return;
+	}
 	// Increase timeout to receive TCP header (idle server socket)
 	socket->set_timeout (node->network_params.node.idle_timeout);
 	auto this_l (shared_from_this ());
@@ -517,11 +524,206 @@ void oslo::bootstrap_server::receive_node_id_handshake_action (boost::system::er
 	}
 }
 
+void oslo::bootstrap_server::receive_buffered ()
+{
+	if (read_buffer == nullptr)
+	{
+		read_buffer = std::make_shared<std::vector<uint8_t>> (read_buffer_size);
+	}
+	// Move the start of a partial message to the front so the rest of it fits
+	if (read_begin > 0)
+	{
+		std::copy (read_buffer->begin () + read_begin, read_buffer->begin () + read_end, read_buffer->begin ());
+		read_end -= read_begin;
+		read_begin = 0;
+	}
+	// Idle timeout between messages, default timeout while the rest of a message is pending
+	socket->set_timeout (read_end == 0 ? node->network_params.node.idle_timeout : node->config.tcp_io_timeout);
+	auto this_l (shared_from_this ());
+	socket->async_read_some (read_buffer, read_end, read_buffer->size () - read_end, [this_l](boost::system::error_code const & ec, size_t size_a) {
+		if (this_l->remote_endpoint.port () == 0)
+		{
+			this_l->remote_endpoint = this_l->socket->remote_endpoint ();
+		}
+		this_l->receive_buffered_action (ec, size_a);
+	});
+}
+
+void oslo::bootstrap_server::receive_buffered_action (boost::system::error_code const & ec, size_t size_a)
+{
+	if (!ec)
+	{
+		read_end += size_a;
+		debug_assert (read_end <= read_buffer->size ());
+		std::vector<oslo::tcp_message_item> items;
+		auto error (parse_buffered (items));
+		if (!items.empty ())
+		{
+			node->network.tcp_message_manager.put_messages (items);
+			std::weak_ptr<oslo::bootstrap_server> this_w (shared_from_this ());
+			node->alarm.add (std::chrono::steady_clock::now () + (node->config.tcp_io_timeout * 2) + std::chrono::seconds (1), [this_w]() {
+				if (auto this_l = this_w.lock ())
+				{
+					this_l->timeout ();
+				}
+			});
+		}
+		if (!error)
+		{
+			receive_buffered ();
+		}
+	}
+	else
+	{
+		if (node->config.logging.network_message_logging ())
+		{
+			node->logger.try_log (boost::str (boost::format ("Error receiving realtime messages: %1%") % ec.message ()));
+		}
+	}
+}
+
+bool oslo::bootstrap_server::parse_buffered (std::vector<oslo::tcp_message_item> & items_a)
+{
+	auto error (false);
+	auto complete (true);
+	while (!error && complete && read_end - read_begin >= oslo::message_header::size)
+	{
+		oslo::bufferstream header_stream (read_buffer->data () + read_begin, oslo::message_header::size);
+		oslo::message_header header (error, header_stream);
+		if (!error)
+		{
+			auto payload_size (header.payload_length_bytes ());
+			// Messages are parsed in place, each has to fit in the buffer
+			error = oslo::message_header::size + payload_size > read_buffer->size ();
+			complete = read_end - read_begin >= oslo::message_header::size + payload_size;
+			if (!error && complete)
+			{
+				auto payload (read_buffer->data () + read_begin + oslo::message_header::size);
+				read_begin += oslo::message_header::size + payload_size;
+				auto message (deserialize_realtime (error, header, payload, payload_size));
+				if (message != nullptr)
+				{
+					items_a.push_back (oslo::tcp_message_item{ message, remote_endpoint, remote_node_id, socket, type });
+				}
+			}
+		}
+	}
+	if (read_begin == read_end)
+	{
+		read_begin = read_end = 0;
+	}
+	return error;
+}
+
+std::shared_ptr<oslo::message> oslo::bootstrap_server::deserialize_realtime (bool & error_a, oslo::message_header const & header_a, uint8_t const * data_a, size_t size_a)
+{
+	std::shared_ptr<oslo::message> result;
+	oslo::bufferstream stream (data_a, size_a);
+	switch (header_a.type)
+	{
+		case oslo::message_type::keepalive:
+		{
+			result = std::make_shared<oslo::keepalive> (error_a, stream, header_a);
+			break;
+		}
+		case oslo::message_type::publish:
+		{
+			oslo::uint128_t digest;
+			if (!node->network.publish_filter.apply (data_a, size_a, &digest))
+			{
+				result = std::make_shared<oslo::publish> (error_a, stream, header_a, digest);
+			}
+			else
+			{
+				node->stats.inc (oslo::stat::type::filter, oslo::stat::detail::duplicate_publish);
+			}
+			break;
+		}
+		case oslo::message_type::publish_batch:
+		{
+			auto message (std::make_shared<oslo::publish_batch> (error_a, stream, header_a, &node->network.publish_filter));
+			if (!error_a && message->duplicates > 0)
+			{
+				node->stats.add (oslo::stat::type::filter, oslo::stat::detail::duplicate_publish, oslo::stat::dir::in, message->duplicates);
+			}
+			auto insufficient_work (error_a ? 0 : message->remove_insufficient_work (&node->network.publish_filter));
+			if (insufficient_work > 0)
+			{
+				node->stats.add (oslo::stat::type::error, oslo::stat::detail::insufficient_work, oslo::stat::dir::in, insufficient_work, true);
+			}
+			if (!message->blocks.empty ())
+			{
+				result = message;
+			}
+			break;
+		}
+		case oslo::message_type::confirm_req:
+		{
+			result = std::make_shared<oslo::confirm_req> (error_a, stream, header_a);
+			break;
+		}
+		case oslo::message_type::confirm_ack:
+		{
+			result = std::make_shared<oslo::confirm_ack> (error_a, stream, header_a);
+			break;
+		}
+		case oslo::message_type::telemetry_req:
+		{
+			// Only handle telemetry requests if they are outside of the cutoff time
+			auto is_very_first_message = last_telemetry_req == std::chrono::steady_clock::time_point{};
+			auto cache_exceeded = std::chrono::steady_clock::now () >= last_telemetry_req + oslo::telemetry_cache_cutoffs::network_to_time (node->network_params.network);
+			if (is_very_first_message || cache_exceeded)
+			{
+				last_telemetry_req = std::chrono::steady_clock::now ();
+				result = std::make_shared<oslo::telemetry_req> (header_a);
+			}
+			else
+			{
+				node->stats.inc (oslo::stat::type::telemetry, oslo::stat::detail::request_within_protection_cache_zone);
+			}
+			break;
+		}
+		case oslo::message_type::telemetry_ack:
+		{
+			result = std::make_shared<oslo::telemetry_ack> (error_a, stream, header_a);
+			break;
+		}
+		case oslo::message_type::bulk_pull:
+		case oslo::message_type::bulk_pull_account:
+		case oslo::message_type::bulk_push:
+		case oslo::message_type::frontier_req:
+		case oslo::message_type::node_id_handshake:
+		{
+			// Bootstrap requests and handshakes are not served on realtime connections
+			break;
+		}
+		default:
+		{
+			error_a = true;
+			if (node->config.logging.network_logging ())
+			{
+				node->logger.try_log (boost::str (boost::format ("Received invalid type from realtime connection %1%") % static_cast<uint8_t> (header_a.type)));
+			}
+			break;
+		}
+	}
+	if (error_a)
+	{
+		result = nullptr;
+	}
+	return result;
+}
+
 void oslo::bootstrap_server::add_request (std::unique_ptr<oslo::message> message_a)
 {
 	debug_assert (message_a != nullptr);
 	oslo::unique_lock<std::mutex> lock (mutex);
 	auto start (requests.empty ());
+	if (!start && message_a->header.type == oslo::message_type::bulk_pull)
+	{
+		// Requests queued behind the one being served are streamed back-to-back
+		node->stats.inc (oslo::stat::type::bootstrap, oslo::stat::detail::bulk_pull_pipelined, oslo::stat::dir::in);
+	}
 	requests.push (std::move (message_a));
 	if (start)
 	{
@@ -601,6 +803,10 @@ public:
 	{
 		connection->node->network.tcp_message_manager.put_message (oslo::tcp_message_item{ std::make_shared<oslo::publish> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket, connection->type });
 	}
+	void publish_batch (oslo::publish_batch const & message_a) override
+	{
+		connection->node->network.tcp_message_manager.put_message (oslo::tcp_message_item{ std::make_shared<oslo::publish_batch> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket, connection->type });
+	}
 	void confirm_req (oslo::confirm_req const & message_a) override
 	{
 		connection->node->network.tcp_message_manager.put_message (oslo::tcp_message_item{ std::make_shared<oslo::confirm_req> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket, connection->type });
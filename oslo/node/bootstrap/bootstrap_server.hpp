@@ -5,6 +5,7 @@
 
 #include <atomic>
 #include <queue>
+#include <vector>
 
 namespace oslo
 {
@@ -34,6 +35,7 @@ private:
 std::unique_ptr<container_info_component> collect_container_info (bootstrap_listener & bootstrap_listener, const std::string & name);
 
 class message;
+class tcp_message_item;
 enum class bootstrap_server_type
 {
 	undefined,
@@ -58,6 +60,11 @@ public:
 	void receive_confirm_ack_action (boost::system::error_code const &, size_t, oslo::message_header const &);
 	void receive_node_id_handshake_action (boost::system::error_code const &, size_t, oslo::message_header const &);
 	void receive_telemetry_ack_action (boost::system::error_code const & ec, size_t size_a, oslo::message_header const & header_a);
+	void receive_buffered ();
+	void receive_buffered_action (boost::system::error_code const &, size_t);
+	/** Parses all complete messages in the read buffer, returns true if the connection sent an invalid message */
+	bool parse_buffered (std::vector<oslo::tcp_message_item> &);
+	std::shared_ptr<oslo::message> deserialize_realtime (bool &, oslo::message_header const &, uint8_t const *, size_t);
 	void add_request (std::unique_ptr<oslo::message>);
 	void finish_request ();
 	void finish_request_async ();
@@ -66,6 +73,14 @@ public:
 	bool is_bootstrap_connection ();
 	bool is_realtime_connection ();
 	std::shared_ptr<std::vector<uint8_t>> receive_buffer;
+	/**
+	 * Realtime connections read as much as is available into this buffer and parse every complete message per read,
+	 * instead of one read for the header and one for the payload of each message. Allocated once a connection is realtime.
+	 */
+	std::shared_ptr<std::vector<uint8_t>> read_buffer;
+	size_t read_begin{ 0 };
+	size_t read_end{ 0 };
+	static size_t constexpr read_buffer_size = 16 * 1024;
 	std::shared_ptr<oslo::socket> socket;
 	std::shared_ptr<oslo::node> node;
 	std::mutex mutex;
@@ -2,6 +2,7 @@
 #include <oslo/node/cli.hpp>
 #include <oslo/node/common.hpp>
 #include <oslo/node/daemonconfig.hpp>
+#include <oslo/node/ledger_snapshot.hpp>
 #include <oslo/node/node.hpp>
 
 #include <boost/format.hpp>
@@ -46,6 +47,8 @@ void oslo::add_node_options (boost::program_options::options_description & descr
 	("account_key", "Get the public key for <account>")
 	("vacuum", "Compact database. If data_path is missing, the database in data directory is compacted.")
 	("snapshot", "Compact database and create snapshot, functions similar to vacuum but does not replace the existing database")
+	("ledger_export", "Write the ledger to <file> in a checksummed format independent of the database backend")
+	("ledger_import", "Verify and import a ledger written by ledger_export from <file> in to a database holding only the genesis block")
 	("data_path", boost::program_options::value<std::string> (), "Use the supplied path as the data directory")
 	("network", boost::program_options::value<std::string> (), "Use the supplied network (live, beta or test)")
 	("clear_send_ids", "Remove all send IDs from the database (dangerous: not intended for production use)")
@@ -92,18 +95,22 @@ void oslo::add_node_flag_options (boost::program_options::options_description &
 		("disable_tcp_realtime", "Disables TCP realtime network")
 		("disable_udp", "(Deprecated) UDP is disabled by default")
 		("enable_udp", "Enables UDP realtime network")
+		("disable_udp_batching", "Receive and send one UDP datagram per system call instead of batching them with recvmmsg and sendmmsg (Linux only)")
 		("disable_unchecked_cleanup", "Disables periodic cleanup of old records from unchecked table")
 		("disable_unchecked_drop", "Disables drop of unchecked table at startup")
 		("disable_providing_telemetry_metrics", "Disable using any node information in the telemetry_ack messages.")
 		("disable_block_processor_unchecked_deletion", "Disable deletion of unchecked blocks after processing")
+		("unchecked_memory_only", "Keep unchecked blocks in memory only, the oldest are dropped instead of written to the unchecked table once unchecked_memory_max is reached")
 		("allow_bootstrap_peers_duplicates", "Allow multiple connections to same peer in bootstrap attempts")
 		("fast_bootstrap", "Increase bootstrap speed for high end nodes with higher limits")
+		("bootstrap_checkpoint", boost::program_options::value<std::string>(), "Trust blocks linked to the cemented frontiers in <file> while bootstrapping. Each line is \"<account> <frontier hash> <height>\". Signatures of blocks up to these frontiers are not checked until a background validation pass after they are cemented")
 		("batch_size", boost::program_options::value<std::size_t>(), "(Deprecated) Increase sideband batch size, default 512. This change only affects nodes upgrading from v17 (or earlier) of the node.")
 		("block_processor_batch_size", boost::program_options::value<std::size_t>(), "Increase block processor transaction batch write size, default 0 (limited by config block_processor_batch_max_time), 256k for fast_bootstrap")
 		("block_processor_full_size", boost::program_options::value<std::size_t>(), "Increase block processor allowed blocks queue size before dropping live network packets and holding bootstrap download, default 65536, 1 million for fast_bootstrap")
 		("block_processor_verification_size", boost::program_options::value<std::size_t>(), "Increase batch signature verification size in block processor, default 0 (limited by config signature_checker_threads), unlimited for fast_bootstrap")
 		("inactive_votes_cache_size", boost::program_options::value<std::size_t>(), "Increase cached votes without active elections size, default 16384")
 		("vote_processor_capacity", boost::program_options::value<std::size_t>(), "Vote processor queue size before dropping votes, default 144k")
+		("unchecked_memory_max", boost::program_options::value<std::size_t>(), "Unchecked blocks kept in memory before the oldest are written to the unchecked table, default 64k, 1 million for fast_bootstrap")
 		;
 	// clang-format on
 }
@@ -135,17 +142,25 @@ std::error_code oslo::update_flags (oslo::node_flags & flags_a, boost::program_o
 	{
 		ec = oslo::error_cli::disable_all_network;
 	}
+	flags_a.disable_udp_batching = (vm.count ("disable_udp_batching") > 0);
 	flags_a.disable_unchecked_cleanup = (vm.count ("disable_unchecked_cleanup") > 0);
 	flags_a.disable_unchecked_drop = (vm.count ("disable_unchecked_drop") > 0);
 	flags_a.disable_block_processor_unchecked_deletion = (vm.count ("disable_block_processor_unchecked_deletion") > 0);
+	flags_a.unchecked_memory_only = (vm.count ("unchecked_memory_only") > 0);
 	flags_a.allow_bootstrap_peers_duplicates = (vm.count ("allow_bootstrap_peers_duplicates") > 0);
 	flags_a.fast_bootstrap = (vm.count ("fast_bootstrap") > 0);
+	auto bootstrap_checkpoint_it = vm.find ("bootstrap_checkpoint");
+	if (bootstrap_checkpoint_it != vm.end ())
+	{
+		flags_a.bootstrap_checkpoint = bootstrap_checkpoint_it->second.as<std::string> ();
+	}
 	if (flags_a.fast_bootstrap)
 	{
 		flags_a.disable_block_processor_unchecked_deletion = true;
 		flags_a.block_processor_batch_size = 256 * 1024;
 		flags_a.block_processor_full_size = 1024 * 1024;
 		flags_a.block_processor_verification_size = std::numeric_limits<size_t>::max ();
+		flags_a.unchecked_memory_max = 1024 * 1024;
 	}
 	auto block_processor_batch_size_it = vm.find ("block_processor_batch_size");
 	if (block_processor_batch_size_it != vm.end ())
@@ -172,6 +187,11 @@ std::error_code oslo::update_flags (oslo::node_flags & flags_a, boost::program_o
 	{
 		flags_a.vote_processor_capacity = vote_processor_capacity_it->second.as<size_t> ();
 	}
+	auto unchecked_memory_max_it = vm.find ("unchecked_memory_max");
+	if (unchecked_memory_max_it != vm.end ())
+	{
+		flags_a.unchecked_memory_max = unchecked_memory_max_it->second.as<size_t> ();
+	}
 	// Config overriding
 	auto config (vm.find ("config"));
 	if (config != vm.end ())
@@ -437,6 +457,44 @@ std::error_code oslo::handle_node_options (boost::program_options::variables_map
 			std::cerr << "Snapshot failed (unknown reason)" << std::endl;
 		}
 	}
+	else if (vm.count ("ledger_export") || vm.count ("ledger_import"))
+	{
+		if (vm.count ("file") == 1)
+		{
+			boost::filesystem::path file_path (vm["file"].as<std::string> ());
+			auto importing (vm.count ("ledger_import") > 0);
+			auto node_flags = oslo::inactive_node_flag_defaults ();
+			node_flags.read_only = !importing;
+			oslo::update_flags (node_flags, vm);
+			oslo::inactive_node node (data_path, node_flags);
+			if (!node.node->init_error ())
+			{
+				oslo::ledger_snapshot snapshot (node.node->store, node.node->network_params);
+				auto begin (std::chrono::steady_clock::now ());
+				std::cout << (importing ? "Importing ledger from " : "Exporting ledger to ") << file_path << "\nThis may take a while..." << std::endl;
+				auto error (importing ? snapshot.import_ledger (file_path, std::max (1u, std::thread::hardware_concurrency ())) : snapshot.export_ledger (file_path));
+				if (!error)
+				{
+					auto seconds (std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - begin).count ());
+					std::cout << boost::str (boost::format ("%1% accounts, %2% blocks and %3% pending entries %4% in %5% seconds\n") % snapshot.accounts % snapshot.blocks % snapshot.pending % (importing ? "imported" : "exported") % seconds);
+				}
+				else
+				{
+					std::cerr << (importing ? "Ledger import failed: " : "Ledger export failed: ") << snapshot.error_message << std::endl;
+					ec = oslo::error_cli::generic;
+				}
+			}
+			else
+			{
+				database_write_lock_error (ec);
+			}
+		}
+		else
+		{
+			std::cerr << "ledger_export and ledger_import commands require one <file> option\n";
+			ec = oslo::error_cli::invalid_arguments;
+		}
+	}
 	else if (vm.count ("unchecked_clear"))
 	{
 		boost::filesystem::path data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : oslo::working_path ();
@@ -1075,7 +1133,7 @@ std::error_code oslo::handle_node_options (boost::program_options::variables_map
 						auto account (wallet->second->store.find (transaction, account_id));
 						if (account != wallet->second->store.end ())
 						{
-							wallet->second->store.erase (transaction, account_id);
+							wallet->second->erase (transaction, account_id);
 						}
 						else
 						{
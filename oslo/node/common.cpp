@@ -10,6 +10,7 @@
 #include <boost/pool/pool_alloc.hpp>
 #include <boost/variant/get.hpp>
 
+#include <algorithm>
 #include <numeric>
 
 std::bitset<16> constexpr oslo::message_header::block_type_mask;
@@ -231,6 +232,10 @@ size_t oslo::message_header::payload_length_bytes () const
 		{
 			return oslo::block::size (block_type ());
 		}
+		case oslo::message_type::publish_batch:
+		{
+			return oslo::publish_batch::size (block_type (), count_get ());
+		}
 		case oslo::message_type::confirm_ack:
 		{
 			return oslo::confirm_ack::size (block_type (), count_get ());
@@ -378,6 +383,11 @@ void oslo::message_parser::deserialize_buffer (uint8_t const * buffer_a, size_t
 						}
 						break;
 					}
+					case oslo::message_type::publish_batch:
+					{
+						deserialize_publish_batch (stream, header);
+						break;
+					}
 					case oslo::message_type::confirm_req:
 					{
 						deserialize_confirm_req (stream, header);
@@ -453,6 +463,37 @@ void oslo::message_parser::deserialize_publish (oslo::stream & stream_a, oslo::m
 	}
 }
 
+void oslo::message_parser::deserialize_publish_batch (oslo::stream & stream_a, oslo::message_header const & header_a)
+{
+	auto error (false);
+	oslo::publish_batch incoming (error, stream_a, header_a, &publish_filter, &block_uniquer);
+	if (!error && at_end (stream_a))
+	{
+		// Blocks with enough work are passed on as if each came in its own publish
+		auto insufficient_work (incoming.remove_insufficient_work (&publish_filter));
+		if (!incoming.blocks.empty ())
+		{
+			visitor.publish_batch (incoming);
+		}
+		if (insufficient_work > 0)
+		{
+			status = parse_status::insufficient_work;
+		}
+		else if (incoming.blocks.empty ())
+		{
+			status = parse_status::duplicate_publish_message;
+		}
+	}
+	else
+	{
+		if (!error)
+		{
+			publish_filter.clear (incoming.digests);
+		}
+		status = parse_status::invalid_publish_message;
+	}
+}
+
 void oslo::message_parser::deserialize_confirm_req (oslo::stream & stream_a, oslo::message_header const & header_a)
 {
 	auto error (false);
@@ -655,6 +696,137 @@ bool oslo::publish::operator== (oslo::publish const & other_a) const
 	return *block == *other_a.block;
 }
 
+constexpr size_t oslo::publish_batch::max_blocks;
+
+oslo::publish_batch::publish_batch (bool & error_a, oslo::stream & stream_a, oslo::message_header const & header_a, oslo::network_filter * filter_a, oslo::block_uniquer * uniquer_a) :
+message (header_a)
+{
+	if (!error_a)
+	{
+		error_a = deserialize (stream_a, filter_a, uniquer_a);
+	}
+}
+
+oslo::publish_batch::publish_batch (std::vector<std::shared_ptr<oslo::block>> const & blocks_a) :
+message (oslo::message_type::publish_batch),
+blocks (blocks_a)
+{
+	debug_assert (!blocks.empty () && blocks.size () <= max_blocks);
+	debug_assert (std::all_of (blocks.begin (), blocks.end (), [type = blocks.front ()->type ()](std::shared_ptr<oslo::block> const & block_a) { return block_a->type () == type; }));
+	header.block_type_set (blocks.front ()->type ());
+	header.count_set (static_cast<uint8_t> (blocks.size ()));
+}
+
+void oslo::publish_batch::serialize (oslo::stream & stream_a, bool use_epoch_2_min_version_a) const
+{
+	debug_assert (!blocks.empty ());
+	header.serialize (stream_a, use_epoch_2_min_version_a);
+	for (auto const & block : blocks)
+	{
+		block->serialize (stream_a);
+	}
+}
+
+bool oslo::publish_batch::deserialize (oslo::stream & stream_a, oslo::network_filter * filter_a, oslo::block_uniquer * uniquer_a)
+{
+	debug_assert (header.type == oslo::message_type::publish_batch);
+	auto type (header.block_type ());
+	auto count (header.count_get ());
+	auto block_size (size (type, 1));
+	auto result (count == 0 || block_size == 0);
+	if (!result)
+	{
+		// Read the serialized blocks first so the whole batch is checked against the filter at once
+		std::vector<uint8_t> bytes (count * block_size);
+		result = stream_a.sgetn (bytes.data (), bytes.size ()) != static_cast<std::streamsize> (bytes.size ());
+		std::vector<oslo::uint128_t> digests_l;
+		std::vector<bool> existed (count, false);
+		if (!result && filter_a != nullptr)
+		{
+			for (size_t i (0); i < count; ++i)
+			{
+				digests_l.push_back (filter_a->hash (bytes.data () + i * block_size, block_size));
+			}
+			existed = filter_a->apply (digests_l);
+		}
+		for (size_t i (0); i < count && !result; ++i)
+		{
+			if (!existed[i])
+			{
+				oslo::bufferstream block_stream (bytes.data () + i * block_size, block_size);
+				auto block (oslo::deserialize_block (block_stream, type, uniquer_a));
+				result = block == nullptr;
+				if (!result)
+				{
+					blocks.push_back (block);
+					digests.push_back (filter_a != nullptr ? digests_l[i] : oslo::uint128_t (0));
+				}
+			}
+			else
+			{
+				++duplicates;
+			}
+		}
+		if (result && !digests_l.empty ())
+		{
+			// None of the blocks are passed on, allow every block added to the filter to be received again in a well formed message
+			std::vector<oslo::uint128_t> added;
+			for (size_t i (0); i < count; ++i)
+			{
+				if (!existed[i])
+				{
+					added.push_back (digests_l[i]);
+				}
+			}
+			filter_a->clear (added);
+		}
+	}
+	return result;
+}
+
+size_t oslo::publish_batch::remove_insufficient_work (oslo::network_filter * filter_a)
+{
+	size_t result (0);
+	for (size_t i (0); i < blocks.size ();)
+	{
+		if (oslo::work_validate_entry (*blocks[i]))
+		{
+			if (filter_a != nullptr)
+			{
+				filter_a->clear (digests[i]);
+			}
+			blocks.erase (blocks.begin () + i);
+			digests.erase (digests.begin () + i);
+			++result;
+		}
+		else
+		{
+			++i;
+		}
+	}
+	return result;
+}
+
+void oslo::publish_batch::visit (oslo::message_visitor & visitor_a) const
+{
+	visitor_a.publish_batch (*this);
+}
+
+bool oslo::publish_batch::operator== (oslo::publish_batch const & other_a) const
+{
+	return std::equal (blocks.begin (), blocks.end (), other_a.blocks.begin (), other_a.blocks.end (), [](std::shared_ptr<oslo::block> const & lhs, std::shared_ptr<oslo::block> const & rhs) { return *lhs == *rhs; });
+}
+
+size_t oslo::publish_batch::size (oslo::block_type type_a, size_t count_a)
+{
+	size_t result (0);
+	if (type_a != oslo::block_type::invalid && type_a != oslo::block_type::not_a_block)
+	{
+		result = oslo::block::size (type_a) * count_a;
+	}
+	return result;
+}
+
 oslo::confirm_req::confirm_req (bool & error_a, oslo::stream & stream_a, oslo::message_header const & header_a, oslo::block_uniquer * uniquer_a) :
 message (header_a)
 {
@@ -1001,6 +1173,16 @@ void oslo::bulk_pull::set_count_present (bool value_a)
 	header.extensions.set (count_present_flag, value_a);
 }
 
+bool oslo::bulk_pull::is_compact () const
+{
+	return header.extensions.test (compact_flag);
+}
+
+void oslo::bulk_pull::set_compact (bool value_a)
+{
+	header.extensions.set (compact_flag, value_a);
+}
+
 oslo::bulk_pull_account::bulk_pull_account () :
 message (oslo::message_type::bulk_pull_account)
 {
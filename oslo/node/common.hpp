@@ -174,7 +174,8 @@ enum class message_type : uint8_t
 	node_id_handshake = 0x0a,
 	bulk_pull_account = 0x0b,
 	telemetry_req = 0x0c,
-	telemetry_ack = 0x0d
+	telemetry_ack = 0x0d,
+	publish_batch = 0x0e
 };
 
 enum class bulk_pull_account_flags : uint8_t
@@ -208,6 +209,7 @@ public:
 
 	void flag_set (uint8_t);
 	static uint8_t constexpr bulk_pull_count_present_flag = 0;
+	static uint8_t constexpr bulk_pull_compact_flag = 1;
 	bool bulk_pull_is_count_present () const;
 	static uint8_t constexpr node_id_handshake_query_flag = 0;
 	static uint8_t constexpr node_id_handshake_response_flag = 1;
@@ -261,6 +263,7 @@ public:
 	void deserialize_buffer (uint8_t const *, size_t);
 	void deserialize_keepalive (oslo::stream &, oslo::message_header const &);
 	void deserialize_publish (oslo::stream &, oslo::message_header const &, oslo::uint128_t const & = 0);
+	void deserialize_publish_batch (oslo::stream &, oslo::message_header const &);
 	void deserialize_confirm_req (oslo::stream &, oslo::message_header const &);
 	void deserialize_confirm_ack (oslo::stream &, oslo::message_header const &);
 	void deserialize_node_id_handshake (oslo::stream &, oslo::message_header const &);
@@ -301,6 +304,31 @@ public:
 	std::shared_ptr<oslo::block> block;
 	oslo::uint128_t digest{ 0 };
 };
+/**
+ * Up to max_blocks blocks of one type in a single message, the count is in the header like confirm_req.
+ * Only sent to peers at or above publish_batch_version_min.
+ */
+class publish_batch final : public message
+{
+public:
+	/** Blocks already in \p filter_a are skipped without being deserialized, the others are added to it */
+	publish_batch (bool &, oslo::stream &, oslo::message_header const &, oslo::network_filter * = nullptr, oslo::block_uniquer * = nullptr);
+	explicit publish_batch (std::vector<std::shared_ptr<oslo::block>> const &);
+	void visit (oslo::message_visitor &) const override;
+	void serialize (oslo::stream &, bool) const override;
+	bool deserialize (oslo::stream &, oslo::network_filter *, oslo::block_uniquer *);
+	bool operator== (oslo::publish_batch const &) const;
+	/** Removes blocks with insufficient work and clears their digests from \p filter_a, returns the number removed */
+	size_t remove_insufficient_work (oslo::network_filter *);
+	static size_t size (oslo::block_type, size_t);
+	/** Limited by the 4 bit header count */
+	static size_t constexpr max_blocks = 15;
+	std::vector<std::shared_ptr<oslo::block>> blocks;
+	/** Publish filter digests of \p blocks, the same as a publish message of each block would have */
+	std::vector<oslo::uint128_t> digests;
+	/** Number of blocks skipped because they were already in the filter */
+	size_t duplicates{ 0 };
+};
 class confirm_req final : public message
 {
 public:
@@ -418,6 +446,10 @@ public:
 	bool is_count_present () const;
 	void set_count_present (bool);
 	static size_t constexpr count_present_flag = oslo::message_header::bulk_pull_count_present_flag;
+	/** Requests state blocks in the response to be sent in the bulk_pull_compact encoding */
+	bool is_compact () const;
+	void set_compact (bool);
+	static size_t constexpr compact_flag = oslo::message_header::bulk_pull_compact_flag;
 	static size_t constexpr extended_parameters_size = 8;
 	static size_t constexpr size = sizeof (start) + sizeof (end);
 };
@@ -471,6 +503,7 @@ public:
 	virtual void node_id_handshake (oslo::node_id_handshake const &) = 0;
 	virtual void telemetry_req (oslo::telemetry_req const &) = 0;
 	virtual void telemetry_ack (oslo::telemetry_ack const &) = 0;
+	virtual void publish_batch (oslo::publish_batch const &) = 0;
 	virtual ~message_visitor ();
 };
 
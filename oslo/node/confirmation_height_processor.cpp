@@ -1,5 +1,7 @@
+#include <oslo/boost/asio/post.hpp>
 #include <oslo/lib/logger_mt.hpp>
 #include <oslo/lib/numbers.hpp>
+#include <oslo/lib/stats.hpp>
 #include <oslo/lib/threading.hpp>
 #include <oslo/lib/utility.hpp>
 #include <oslo/node/confirmation_height_processor.hpp>
@@ -9,21 +11,34 @@
 
 #include <boost/thread/latch.hpp>
 
+#include <future>
 #include <numeric>
 
-oslo::confirmation_height_processor::confirmation_height_processor (oslo::ledger & ledger_a, oslo::write_database_queue & write_database_queue_a, std::chrono::milliseconds batch_separate_pending_min_time_a, oslo::logger_mt & logger_a, boost::latch & latch, confirmation_height_mode mode_a) :
+oslo::confirmation_height_processor::confirmation_height_processor (oslo::ledger & ledger_a, oslo::write_database_queue & write_database_queue_a, std::chrono::milliseconds batch_separate_pending_min_time_a, oslo::logger_mt & logger_a, boost::latch & latch, confirmation_height_mode mode_a, unsigned threads_a) :
 ledger (ledger_a),
 write_database_queue (write_database_queue_a),
 // clang-format off
 unbounded_processor (ledger_a, write_database_queue_a, batch_separate_pending_min_time_a, logger_a, stopped, original_hash, batch_write_size, [this](auto & cemented_blocks) { this->notify_observers (cemented_blocks); }, [this](auto const & block_hash_a) { this->notify_observers (block_hash_a); }, [this]() { return this->awaiting_processing_size (); }),
 bounded_processor (ledger_a, write_database_queue_a, batch_separate_pending_min_time_a, logger_a, stopped, original_hash, batch_write_size, [this](auto & cemented_blocks) { this->notify_observers (cemented_blocks); }, [this](auto const & block_hash_a) { this->notify_observers (block_hash_a); }, [this]() { return this->awaiting_processing_size (); }),
 // clang-format on
+parallel_pool (std::max (threads_a, 1u) - 1),
 thread ([this, &latch, mode_a]() {
 	oslo::thread_role::set (oslo::thread_role::name::confirmation_height_processing);
 	// Do not start running the processing thread until other threads have finished their operations
 	latch.wait ();
 	this->run (mode_a);
 })
+{
+	for (auto i (0u); i < std::max (threads_a, 1u); ++i)
+	{
+		parallel_workers.push_back (std::make_unique<parallel_worker> (ledger_a, write_database_queue_a, logger_a, stopped));
+	}
+}
+
+oslo::confirmation_height_processor::parallel_worker::parallel_worker (oslo::ledger & ledger_a, oslo::write_database_queue & write_database_queue_a, oslo::logger_mt & logger_a, std::atomic<bool> & stopped_a) :
+// clang-format off
+processor (ledger_a, write_database_queue_a, std::chrono::milliseconds::max (), logger_a, stopped_a, original_hash, batch_write_size, [this](auto & cemented_blocks) { cemented.insert (cemented.end (), cemented_blocks.begin (), cemented_blocks.end ()); }, [this](auto const & block_hash_a) { already_cemented.push_back (block_hash_a); }, []() { return uint64_t (1); })
+// clang-format on
 {
 }
 
@@ -43,6 +58,7 @@ void oslo::confirmation_height_processor::stop ()
 	{
 		thread.join ();
 	}
+	parallel_pool.join ();
 }
 
 void oslo::confirmation_height_processor::run (confirmation_height_mode mode_a)
@@ -60,24 +76,31 @@ void oslo::confirmation_height_processor::run (confirmation_height_mode mode_a)
 				lk.unlock ();
 			}
 
-			set_next_hash ();
-
 			const auto num_blocks_to_use_unbounded = confirmation_height::unbounded_cutoff;
 			auto blocks_within_automatic_unbounded_selection = (ledger.cache.block_count < num_blocks_to_use_unbounded || ledger.cache.block_count - num_blocks_to_use_unbounded < ledger.cache.cemented_count);
 
-			// Don't want to mix up pending writes across different processors
-			auto valid_unbounded = (mode_a == confirmation_height_mode::automatic && blocks_within_automatic_unbounded_selection && bounded_processor.pending_empty ());
-			auto force_unbounded = (!unbounded_processor.pending_empty () || mode_a == confirmation_height_mode::unbounded);
-			if (force_unbounded || valid_unbounded)
+			if (use_parallel (mode_a, blocks_within_automatic_unbounded_selection))
 			{
-				debug_assert (bounded_processor.pending_empty ());
-				unbounded_processor.process ();
+				process_parallel ();
 			}
 			else
 			{
-				debug_assert (mode_a == confirmation_height_mode::bounded || mode_a == confirmation_height_mode::automatic);
-				debug_assert (unbounded_processor.pending_empty ());
-				bounded_processor.process ();
+				set_next_hash ();
+
+				// Don't want to mix up pending writes across different processors
+				auto valid_unbounded = ((mode_a == confirmation_height_mode::automatic || mode_a == confirmation_height_mode::parallel) && blocks_within_automatic_unbounded_selection && bounded_processor.pending_empty ());
+				auto force_unbounded = (!unbounded_processor.pending_empty () || mode_a == confirmation_height_mode::unbounded);
+				if (force_unbounded || valid_unbounded)
+				{
+					debug_assert (bounded_processor.pending_empty ());
+					unbounded_processor.process ();
+				}
+				else
+				{
+					debug_assert (mode_a != confirmation_height_mode::unbounded);
+					debug_assert (unbounded_processor.pending_empty ());
+					bounded_processor.process ();
+				}
 			}
 
 			lk.lock ();
@@ -162,6 +185,275 @@ void oslo::confirmation_height_processor::set_next_hash ()
 	original_hash = awaiting_processing.get<tag_sequence> ().front ();
 	original_hashes_pending.insert (original_hash);
 	awaiting_processing.get<tag_sequence> ().pop_front ();
+	parallel_excluded.erase (original_hash);
+}
+
+bool oslo::confirmation_height_processor::use_parallel (confirmation_height_mode mode_a, bool unbounded_selection_a)
+{
+	auto result (false);
+	// Parallel batches are written in their own transaction and cannot be mixed with pending writes of the other processors
+	if (bounded_processor.pending_empty () && unbounded_processor.pending_empty ())
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		debug_assert (!awaiting_processing.empty ());
+		if (parallel_excluded.count (awaiting_processing.get<tag_sequence> ().front ()) == 0)
+		{
+			result = mode_a == confirmation_height_mode::parallel || (mode_a == confirmation_height_mode::automatic && unbounded_selection_a && parallel_workers.size () > 1 && awaiting_processing.size () >= parallel_min);
+		}
+	}
+	return result;
+}
+
+/*
+ * Cements a batch of queued hashes on multiple threads. The accounts each hash depends on are collected first,
+ * hashes sharing any account are grouped and the groups are spread over the workers. As the groups touch disjoint
+ * accounts the workers can traverse them concurrently, their confirmation height writes are then committed together.
+ */
+void oslo::confirmation_height_processor::process_parallel ()
+{
+	std::vector<oslo::block_hash> batch;
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		auto & sequence (awaiting_processing.get<tag_sequence> ());
+		while (!sequence.empty () && batch.size () < parallel_batch_max && parallel_excluded.count (sequence.front ()) == 0)
+		{
+			batch.push_back (sequence.front ());
+			original_hashes_pending.insert (sequence.front ());
+			sequence.pop_front ();
+		}
+		debug_assert (!batch.empty ());
+		original_hash = batch.front ();
+	}
+
+	// Walk the chains of each hash concurrently to find the accounts it depends on
+	std::vector<std::vector<oslo::account>> dependencies (batch.size ());
+	std::vector<uint64_t> blocks (batch.size (), 0);
+	std::vector<uint8_t> heavy (batch.size (), 0);
+	std::atomic<size_t> next{ 0 };
+	run_parallel ([this, &batch, &dependencies, &blocks, &heavy, &next]() {
+		auto transaction (ledger.store.tx_begin_read ());
+		for (auto i (next++); i < batch.size () && !stopped; i = next++)
+		{
+			heavy[i] = walk_dependencies (transaction, batch[i], dependencies[i], blocks[i]);
+		}
+	});
+
+	// Group hashes sharing an account
+	std::vector<size_t> parent (batch.size ());
+	std::iota (parent.begin (), parent.end (), 0);
+	auto root = [&parent](size_t index_a) {
+		while (parent[index_a] != index_a)
+		{
+			parent[index_a] = parent[parent[index_a]];
+			index_a = parent[index_a];
+		}
+		return index_a;
+	};
+	std::unordered_map<oslo::account, size_t> owners;
+	for (size_t i (0); i < batch.size (); ++i)
+	{
+		for (auto const & account : dependencies[i])
+		{
+			auto existing (owners.emplace (account, i));
+			if (!existing.second)
+			{
+				parent[root (i)] = root (existing.first->second);
+			}
+		}
+	}
+	std::unordered_map<size_t, std::pair<uint64_t, std::vector<size_t>>> groups_by_root;
+	std::vector<oslo::block_hash> excluded;
+	std::vector<oslo::block_hash> deferred;
+	for (size_t i (0); i < batch.size (); ++i)
+	{
+		if (heavy[i])
+		{
+			// Chains too long to fit a single write batch use the sequential processors
+			excluded.push_back (batch[i]);
+		}
+		else
+		{
+			auto & group (groups_by_root[root (i)]);
+			group.first += blocks[i];
+			group.second.push_back (i);
+		}
+	}
+	std::vector<std::pair<uint64_t, std::vector<size_t>>> groups;
+	groups.reserve (groups_by_root.size ());
+	for (auto & group : groups_by_root)
+	{
+		groups.push_back (std::move (group.second));
+	}
+	std::sort (groups.begin (), groups.end (), [](auto const & lhs, auto const & rhs) { return lhs.first > rhs.first; });
+
+	// Largest groups first to the least loaded worker. Workers are kept within a single write batch so they never write on their own
+	for (auto const & group : groups)
+	{
+		auto worker (std::min_element (parallel_workers.begin (), parallel_workers.end (), [](auto const & lhs, auto const & rhs) { return lhs->blocks < rhs->blocks; }));
+		auto & target (group.first >= confirmation_height::unbounded_cutoff ? excluded : deferred);
+		if ((*worker)->blocks + group.first < confirmation_height::unbounded_cutoff)
+		{
+			(*worker)->blocks += group.first;
+			for (auto i : group.second)
+			{
+				(*worker)->hashes.push_back (batch[i]);
+			}
+		}
+		else
+		{
+			for (auto i : group.second)
+			{
+				target.push_back (batch[i]);
+			}
+		}
+	}
+
+	std::atomic<size_t> next_worker{ 0 };
+	run_parallel ([this, &next_worker]() {
+		for (auto i (next_worker++); i < parallel_workers.size (); i = next_worker++)
+		{
+			auto & worker (*parallel_workers[i]);
+			for (auto j (worker.hashes.begin ()), n (worker.hashes.end ()); j != n && !stopped; ++j)
+			{
+				worker.original_hash = *j;
+				worker.processor.process ();
+			}
+		}
+	});
+
+	std::vector<std::shared_ptr<oslo::block>> cemented_blocks;
+	auto error (false);
+	auto pending (std::any_of (parallel_workers.begin (), parallel_workers.end (), [](auto const & worker_a) { return !worker_a->processor.pending_empty (); }));
+	if (pending && !stopped)
+	{
+		auto scoped_write_guard = write_database_queue.wait (oslo::writer::confirmation_height);
+		{
+			auto transaction (ledger.store.tx_begin_write ({}, { oslo::tables::confirmation_height }));
+			for (auto & worker : parallel_workers)
+			{
+				error = worker->processor.cement_pending (transaction, cemented_blocks) || error;
+			}
+		}
+		scoped_write_guard.release ();
+	}
+	auto active_workers (std::count_if (parallel_workers.begin (), parallel_workers.end (), [](auto const & worker_a) { return !worker_a->hashes.empty (); }));
+	ledger.stats.inc (oslo::stat::type::confirmation_height, oslo::stat::detail::parallel_batch, oslo::stat::dir::in);
+	ledger.stats.add (oslo::stat::type::confirmation_height, oslo::stat::detail::parallel_groups, oslo::stat::dir::in, groups.size ());
+	ledger.stats.add (oslo::stat::type::confirmation_height, oslo::stat::detail::parallel_workers, oslo::stat::dir::in, active_workers);
+
+	for (auto & worker : parallel_workers)
+	{
+		for (auto const & hash : worker->already_cemented)
+		{
+			notify_observers (hash);
+		}
+		notify_observers (worker->cemented);
+		worker->already_cemented.clear ();
+		worker->cemented.clear ();
+		worker->hashes.clear ();
+		worker->blocks = 0;
+		worker->processor.clear_process_vars ();
+	}
+	notify_observers (cemented_blocks);
+	release_assert (!error);
+
+	// Put back hashes which were not processed in this batch, in their original order
+	oslo::lock_guard<std::mutex> guard (mutex);
+	auto & sequence (awaiting_processing.get<tag_sequence> ());
+	for (auto i (deferred.rbegin ()), n (deferred.rend ()); i != n; ++i)
+	{
+		sequence.push_front (*i);
+	}
+	for (auto i (excluded.rbegin ()), n (excluded.rend ()); i != n; ++i)
+	{
+		if (sequence.push_front (*i).second)
+		{
+			parallel_excluded.insert (*i);
+		}
+	}
+}
+
+/** Runs \p task_a on the calling thread and each thread of the pool, returning once all have finished */
+void oslo::confirmation_height_processor::run_parallel (std::function<void()> const & task_a)
+{
+	std::vector<std::future<void>> helpers_done;
+	helpers_done.reserve (parallel_workers.size () - 1);
+	for (size_t i (1); i < parallel_workers.size (); ++i)
+	{
+		auto promise (std::make_shared<std::promise<void>> ());
+		helpers_done.push_back (promise->get_future ());
+		boost::asio::post (parallel_pool, [promise, &task_a]() {
+			if (oslo::thread_role::get () != oslo::thread_role::name::confirmation_height_processing)
+			{
+				oslo::thread_role::set (oslo::thread_role::name::confirmation_height_processing);
+			}
+			task_a ();
+			promise->set_value ();
+		});
+	}
+	task_a ();
+	for (auto & done : helpers_done)
+	{
+		done.wait ();
+	}
+}
+
+/*
+ * Collects the accounts with uncemented blocks that cementing \p hash_a would cement, following the sources of receives.
+ * Returns true if more than a write batch worth of blocks would be cemented, in which case the walk is stopped early.
+ */
+bool oslo::confirmation_height_processor::walk_dependencies (oslo::read_transaction const & transaction_a, oslo::block_hash const & hash_a, std::vector<oslo::account> & accounts_a, uint64_t & blocks_a)
+{
+	auto heavy (false);
+	// Confirmation height of each account and the height up to which its blocks are cemented or already walked
+	std::unordered_map<oslo::account, std::pair<uint64_t, uint64_t>> walked;
+	std::vector<oslo::block_hash> pending{ hash_a };
+	while (!pending.empty () && !heavy && !stopped)
+	{
+		auto block (ledger.store.block_get (transaction_a, pending.back ()));
+		pending.pop_back ();
+		if (block != nullptr)
+		{
+			oslo::account account (block->account ());
+			if (account.is_zero ())
+			{
+				account = block->sideband ().account;
+			}
+			auto existing (walked.find (account));
+			if (existing == walked.end ())
+			{
+				oslo::confirmation_height_info confirmation_height_info;
+				ledger.store.confirmation_height_get (transaction_a, account, confirmation_height_info);
+				existing = walked.emplace (account, std::make_pair (confirmation_height_info.height, confirmation_height_info.height)).first;
+			}
+			auto height (block->sideband ().height);
+			auto const lower (existing->second.second);
+			existing->second.second = std::max (height, lower);
+			for (; height > lower && block != nullptr && !heavy; --height)
+			{
+				auto source (block->source ());
+				if (source.is_zero ())
+				{
+					source = block->link ();
+				}
+				if (!source.is_zero () && !ledger.is_epoch_link (source) && ledger.store.source_exists (transaction_a, source))
+				{
+					pending.push_back (source);
+				}
+				heavy = ++blocks_a >= confirmation_height::unbounded_cutoff;
+				block = height - 1 > lower ? ledger.store.block_get (transaction_a, block->previous ()) : nullptr;
+			}
+		}
+	}
+	for (auto const & account : walked)
+	{
+		// Accounts only reached through already cemented blocks are not dependencies
+		if (account.second.second > account.second.first)
+		{
+			accounts_a.push_back (account.first);
+		}
+	}
+	return heavy;
 }
 
 // Not thread-safe, only call before this processor has begun cementing
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <oslo/boost/asio/thread_pool.hpp>
 #include <oslo/lib/numbers.hpp>
 #include <oslo/node/confirmation_height_bounded.hpp>
 #include <oslo/node/confirmation_height_unbounded.hpp>
@@ -12,6 +13,7 @@
 #include <boost/multi_index_container.hpp>
 
 #include <condition_variable>
+#include <limits>
 #include <mutex>
 #include <thread>
 #include <unordered_set>
@@ -30,7 +32,7 @@ class write_database_queue;
 class confirmation_height_processor final
 {
 public:
-	confirmation_height_processor (oslo::ledger &, oslo::write_database_queue &, std::chrono::milliseconds, oslo::logger_mt &, boost::latch & initialized_latch, confirmation_height_mode = confirmation_height_mode::automatic);
+	confirmation_height_processor (oslo::ledger &, oslo::write_database_queue &, std::chrono::milliseconds, oslo::logger_mt &, boost::latch & initialized_latch, confirmation_height_mode = confirmation_height_mode::automatic, unsigned threads_a = 1);
 	~confirmation_height_processor ();
 	void pause ();
 	void unpause ();
@@ -59,6 +61,8 @@ private:
 
 	// Hashes which have been added and processed, but have not been cemented
 	std::unordered_set<oslo::block_hash> original_hashes_pending;
+	// Queued hashes which depend on too many blocks to be cemented in a parallel batch
+	std::unordered_set<oslo::block_hash> parallel_excluded;
 	bool paused{ false };
 
 	/** This is the last block popped off the confirmation height pending collection */
@@ -77,9 +81,33 @@ private:
 
 	confirmation_height_unbounded unbounded_processor;
 	confirmation_height_bounded bounded_processor;
+
+	/** Unbounded processor cementing a share of the independent account chains of a parallel batch */
+	class parallel_worker final
+	{
+	public:
+		parallel_worker (oslo::ledger &, oslo::write_database_queue &, oslo::logger_mt &, std::atomic<bool> &);
+		oslo::block_hash original_hash{ 0 };
+		uint64_t batch_write_size{ std::numeric_limits<uint64_t>::max () };
+		std::vector<oslo::block_hash> hashes;
+		uint64_t blocks{ 0 };
+		// Observers are notified from the processing thread once the batch is written
+		std::vector<std::shared_ptr<oslo::block>> cemented;
+		std::vector<oslo::block_hash> already_cemented;
+		confirmation_height_unbounded processor;
+	};
+	/** Parallel batches are used in automatic mode when at least this many hashes are queued */
+	static size_t constexpr parallel_min{ 64 };
+	static size_t constexpr parallel_batch_max{ 4096 };
+	std::vector<std::unique_ptr<parallel_worker>> parallel_workers;
+	boost::asio::thread_pool parallel_pool;
 	std::thread thread;
 
 	void set_next_hash ();
+	bool use_parallel (confirmation_height_mode, bool);
+	void process_parallel ();
+	void run_parallel (std::function<void()> const &);
+	bool walk_dependencies (oslo::read_transaction const &, oslo::block_hash const &, std::vector<oslo::account> &, uint64_t &);
 	void notify_observers (std::vector<std::shared_ptr<oslo::block>> const &);
 	void notify_observers (oslo::block_hash const &);
 
@@ -343,50 +343,7 @@ void oslo::confirmation_height_unbounded::cement_blocks (oslo::write_guard & sco
 	{
 		auto transaction (ledger.store.tx_begin_write ({}, { oslo::tables::confirmation_height }));
 		cemented_batch_timer.start ();
-		while (!pending_writes.empty ())
-		{
-			auto & pending = pending_writes.front ();
-			oslo::confirmation_height_info confirmation_height_info;
-			error = ledger.store.confirmation_height_get (transaction, pending.account, confirmation_height_info);
-			if (error)
-			{
-				auto error_str = (boost::format ("Failed to read confirmation height for account %1% when writing block %2% (unbounded processor)") % pending.account.to_account () % pending.hash.to_string ()).str ();
-				logger.always_log (error_str);
-				std::cerr << error_str << std::endl;
-			}
-			auto confirmation_height = confirmation_height_info.height;
-			if (!error && pending.height > confirmation_height)
-			{
-				auto block = ledger.store.block_get (transaction, pending.hash);
-				debug_assert (network_params.network.is_test_network () || block != nullptr);
-				debug_assert (network_params.network.is_test_network () || block->sideband ().height == pending.height);
-
-				if (!block)
-				{
-					auto error_str = (boost::format ("Failed to write confirmation height for block %1% (unbounded processor)") % pending.hash.to_string ()).str ();
-					logger.always_log (error_str);
-					std::cerr << error_str << std::endl;
-					error = true;
-					break;
-				}
-				ledger.stats.add (oslo::stat::type::confirmation_height, oslo::stat::detail::blocks_confirmed, oslo::stat::dir::in, pending.height - confirmation_height);
-				ledger.stats.add (oslo::stat::type::confirmation_height, oslo::stat::detail::blocks_confirmed_unbounded, oslo::stat::dir::in, pending.height - confirmation_height);
-				debug_assert (pending.num_blocks_confirmed == pending.height - confirmation_height);
-				confirmation_height = pending.height;
-				ledger.cache.cemented_count += pending.num_blocks_confirmed;
-				ledger.store.confirmation_height_put (transaction, pending.account, { confirmation_height, pending.hash });
-
-				// Reverse it so that the callbacks start from the lowest newly cemented block and move upwards
-				std::reverse (pending.block_callback_data.begin (), pending.block_callback_data.end ());
-
-				std::transform (pending.block_callback_data.begin (), pending.block_callback_data.end (), std::back_inserter (cemented_blocks), [& block_cache = block_cache](auto const & hash_a) {
-					debug_assert (block_cache.find (hash_a) != block_cache.end ());
-					return block_cache.at (hash_a);
-				});
-			}
-			pending_writes.erase (pending_writes.begin ());
-			--pending_writes_size;
-		}
+		error = cement_pending (transaction, cemented_blocks);
 	}
 
 	auto time_spent_cementing = cemented_batch_timer.since_start ().count ();
@@ -411,6 +368,56 @@ void oslo::confirmation_height_unbounded::cement_blocks (oslo::write_guard & sco
 	timer.restart ();
 }
 
+bool oslo::confirmation_height_unbounded::cement_pending (oslo::write_transaction const & transaction, std::vector<std::shared_ptr<oslo::block>> & cemented_blocks)
+{
+	auto error = false;
+	while (!pending_writes.empty ())
+	{
+		auto & pending = pending_writes.front ();
+		oslo::confirmation_height_info confirmation_height_info;
+		error = ledger.store.confirmation_height_get (transaction, pending.account, confirmation_height_info);
+		if (error)
+		{
+			auto error_str = (boost::format ("Failed to read confirmation height for account %1% when writing block %2% (unbounded processor)") % pending.account.to_account () % pending.hash.to_string ()).str ();
+			logger.always_log (error_str);
+			std::cerr << error_str << std::endl;
+		}
+		auto confirmation_height = confirmation_height_info.height;
+		if (!error && pending.height > confirmation_height)
+		{
+			auto block = ledger.store.block_get (transaction, pending.hash);
+			debug_assert (network_params.network.is_test_network () || block != nullptr);
+			debug_assert (network_params.network.is_test_network () || block->sideband ().height == pending.height);
+
+			if (!block)
+			{
+				auto error_str = (boost::format ("Failed to write confirmation height for block %1% (unbounded processor)") % pending.hash.to_string ()).str ();
+				logger.always_log (error_str);
+				std::cerr << error_str << std::endl;
+				error = true;
+				break;
+			}
+			ledger.stats.add (oslo::stat::type::confirmation_height, oslo::stat::detail::blocks_confirmed, oslo::stat::dir::in, pending.height - confirmation_height);
+			ledger.stats.add (oslo::stat::type::confirmation_height, oslo::stat::detail::blocks_confirmed_unbounded, oslo::stat::dir::in, pending.height - confirmation_height);
+			debug_assert (pending.num_blocks_confirmed == pending.height - confirmation_height);
+			confirmation_height = pending.height;
+			ledger.cache.cemented_count += pending.num_blocks_confirmed;
+			ledger.store.confirmation_height_put (transaction, pending.account, { confirmation_height, pending.hash });
+
+			// Reverse it so that the callbacks start from the lowest newly cemented block and move upwards
+			std::reverse (pending.block_callback_data.begin (), pending.block_callback_data.end ());
+
+			std::transform (pending.block_callback_data.begin (), pending.block_callback_data.end (), std::back_inserter (cemented_blocks), [& block_cache = block_cache](auto const & hash_a) {
+				debug_assert (block_cache.find (hash_a) != block_cache.end ());
+				return block_cache.at (hash_a);
+			});
+		}
+		pending_writes.erase (pending_writes.begin ());
+		--pending_writes_size;
+	}
+	return error;
+}
+
 std::shared_ptr<oslo::block> oslo::confirmation_height_unbounded::get_block_and_sideband (oslo::block_hash const & hash_a, oslo::transaction const & transaction_a)
 {
 	auto block_cache_it = block_cache.find (hash_a);
@@ -11,6 +11,7 @@ namespace oslo
 {
 class ledger;
 class read_transaction;
+class write_transaction;
 class logger_mt;
 class write_database_queue;
 class write_guard;
@@ -23,6 +24,8 @@ public:
 	void clear_process_vars ();
 	void process ();
 	void cement_blocks (oslo::write_guard &);
+	/** Writes pending confirmation heights using an existing transaction, appending newly cemented blocks. Returns true on error */
+	bool cement_pending (oslo::write_transaction const &, std::vector<std::shared_ptr<oslo::block>> &);
 
 private:
 	class confirmed_iterated_pair
@@ -687,7 +687,7 @@ void oslo::json_handler::account_remove ()
 			rpc_l->wallet_account_impl (transaction, wallet, account);
 			if (!rpc_l->ec)
 			{
-				wallet->store.erase (transaction, account);
+				wallet->erase (transaction, account);
 				rpc_l->response_l.put ("removed", "1");
 			}
 		}
@@ -1678,6 +1678,31 @@ void oslo::json_handler::bootstrap_status ()
 		connections.put ("idle", std::to_string (node.bootstrap_initiator.connections->idle.size ()));
 		connections.put ("target_connections", std::to_string (node.bootstrap_initiator.connections->target_connections (node.bootstrap_initiator.connections->pulls.size (), attempts_count)));
 		connections.put ("pulls", std::to_string (node.bootstrap_initiator.connections->pulls.size ()));
+		connections.put ("scaled_connections", std::to_string (node.bootstrap_initiator.connections->scaled_connections));
+		boost::property_tree::ptree peers;
+		for (auto const & client_w : node.bootstrap_initiator.connections->clients)
+		{
+			if (auto client = client_w.lock ())
+			{
+				boost::property_tree::ptree entry;
+				auto endpoint (client->channel->get_tcp_endpoint ());
+				entry.put ("address", client->channel->to_string ());
+				entry.put ("block_count", std::to_string (client->block_count));
+				entry.put ("block_rate", std::to_string (client->block_rate ()));
+				entry.put ("elapsed_seconds", std::to_string (client->elapsed_seconds ()));
+				auto info (node.bootstrap_initiator.peer_scores.get (endpoint));
+				if (info)
+				{
+					entry.put ("average_block_rate", std::to_string (info->throughput));
+					entry.put ("error_rate", std::to_string (info->error_rate));
+					entry.put ("rtt", std::to_string (info->rtt));
+					entry.put ("samples", std::to_string (info->samples));
+				}
+				entry.put ("score", std::to_string (node.bootstrap_initiator.peer_scores.score (endpoint)));
+				peers.push_back (std::make_pair ("", entry));
+			}
+		}
+		connections.add_child ("peers", peers);
 	}
 	response_l.add_child ("connections", connections);
 	boost::property_tree::ptree attempts;
@@ -3883,9 +3908,7 @@ void oslo::json_handler::unchecked ()
 	{
 		boost::property_tree::ptree unchecked;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
-		{
-			oslo::unchecked_info const & info (i->second);
+		node.unchecked.for_each (transaction, oslo::unchecked_key (0, 0), [&unchecked, count, json_block_l](oslo::unchecked_key const &, oslo::unchecked_info const & info) {
 			if (json_block_l)
 			{
 				boost::property_tree::ptree block_node_l;
@@ -3898,7 +3921,8 @@ void oslo::json_handler::unchecked ()
 				info.block->serialize_json (contents);
 				unchecked.put (info.block->hash ().to_string (), contents);
 			}
-		}
+			return unchecked.size () < count;
+		});
 		response_l.add_child ("blocks", unchecked);
 	}
 	response_errors ();
@@ -3907,9 +3931,8 @@ void oslo::json_handler::unchecked ()
 void oslo::json_handler::unchecked_clear ()
 {
 	node.worker.push_task (create_worker_task ([](std::shared_ptr<oslo::json_handler> const & rpc_l) {
-		auto transaction (rpc_l->node.store.tx_begin_write ({ tables::unchecked }));
-		rpc_l->node.store.unchecked_clear (transaction);
-		rpc_l->node.ledger.cache.unchecked_count = 0;
+		auto transaction (rpc_l->node.store.tx_begin_write ({ tables::unchecked, tables::unchecked_modified }));
+		rpc_l->node.unchecked.clear (transaction);
 		rpc_l->response_l.put ("success", "");
 		rpc_l->response_errors ();
 	}));
@@ -3922,12 +3945,10 @@ void oslo::json_handler::unchecked_get ()
 	if (!ec)
 	{
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n; ++i)
-		{
-			oslo::unchecked_key const & key (i->first);
-			if (key.hash == hash)
+		node.unchecked.for_each (transaction, oslo::unchecked_key (0, 0), [this, &hash, json_block_l](oslo::unchecked_key const & key, oslo::unchecked_info const & info) {
+			auto found (key.hash == hash);
+			if (found)
 			{
-				oslo::unchecked_info const & info (i->second);
 				response_l.put ("modified_timestamp", std::to_string (info.modified));
 
 				if (json_block_l)
@@ -3942,9 +3963,9 @@ void oslo::json_handler::unchecked_get ()
 					info.block->serialize_json (contents);
 					response_l.put ("contents", contents);
 				}
-				break;
 			}
-		}
+			return !found;
+		});
 		if (response_l.empty ())
 		{
 			ec = oslo::error_blocks::not_found;
@@ -3970,11 +3991,9 @@ void oslo::json_handler::unchecked_keys ()
 	{
 		boost::property_tree::ptree unchecked;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction, oslo::unchecked_key (key, 0))), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
-		{
+		node.unchecked.for_each (transaction, oslo::unchecked_key (key, 0), [&unchecked, count, json_block_l](oslo::unchecked_key const & key_a, oslo::unchecked_info const & info) {
 			boost::property_tree::ptree entry;
-			oslo::unchecked_info const & info (i->second);
-			entry.put ("key", i->first.key ().to_string ());
+			entry.put ("key", key_a.key ().to_string ());
 			entry.put ("hash", info.block->hash ().to_string ());
 			entry.put ("modified_timestamp", std::to_string (info.modified));
 			if (json_block_l)
@@ -3990,7 +4009,8 @@ void oslo::json_handler::unchecked_keys ()
 				entry.put ("contents", contents);
 			}
 			unchecked.push_back (std::make_pair ("", entry));
-		}
+			return unchecked.size () < count;
+		});
 		response_l.add_child ("unchecked", unchecked);
 	}
 	response_errors ();
@@ -4072,6 +4092,7 @@ void oslo::json_handler::version ()
 	response_l.put ("network", node.network_params.network.get_current_network_as_string ());
 	response_l.put ("network_identifier", node.network_params.ledger.genesis_hash.to_string ());
 	response_l.put ("build_info", BUILD_INFO);
+	response_l.put ("network_io_backend", NETWORK_IO_BACKEND);
 	response_errors ();
 }
 
@@ -0,0 +1,624 @@
+#include <oslo/lib/locks.hpp>
+#include <oslo/lib/threading.hpp>
+#include <oslo/node/ledger_snapshot.hpp>
+#include <oslo/secure/blockstore.hpp>
+#include <oslo/secure/buffer.hpp>
+
+#include <crypto/blake2/blake2.h>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <deque>
+#include <thread>
+
+constexpr uint64_t oslo::ledger_snapshot::magic;
+constexpr uint8_t oslo::ledger_snapshot::format_version;
+constexpr size_t oslo::ledger_snapshot::import_batch_blocks;
+
+namespace
+{
+uint8_t constexpr record_end = 0;
+uint8_t constexpr record_account = 1;
+uint8_t constexpr record_pending = 2;
+size_t constexpr header_size = sizeof (uint64_t) + sizeof (uint8_t) + sizeof (uint32_t) + sizeof (oslo::block_hash);
+size_t constexpr account_record_size = sizeof (oslo::account) + sizeof (oslo::block_hash) + sizeof (oslo::account) + sizeof (oslo::block_hash) + sizeof (oslo::amount) + sizeof (uint64_t) + sizeof (uint64_t) + sizeof (oslo::epoch) + sizeof (uint64_t) + sizeof (oslo::block_hash);
+size_t constexpr pending_record_size = sizeof (oslo::account) + sizeof (oslo::block_hash) + sizeof (oslo::account) + sizeof (oslo::amount) + sizeof (oslo::epoch);
+size_t constexpr trailer_size = 3 * sizeof (uint64_t);
+
+/** Writes the snapshot while hashing everything written */
+class snapshot_writer final
+{
+public:
+	explicit snapshot_writer (boost::filesystem::path const & path_a) :
+	file (path_a, std::ios::binary | std::ios::trunc)
+	{
+		blake2b_init (&hash, sizeof (oslo::uint256_union));
+	}
+	void write (std::vector<uint8_t> const & data_a)
+	{
+		blake2b_update (&hash, data_a.data (), data_a.size ());
+		file.write (reinterpret_cast<char const *> (data_a.data ()), data_a.size ());
+	}
+	/** Appends the checksum of everything written so far, returns true on error */
+	bool finish ()
+	{
+		oslo::uint256_union checksum;
+		blake2b_final (&hash, checksum.bytes.data (), checksum.bytes.size ());
+		file.write (reinterpret_cast<char const *> (checksum.bytes.data ()), checksum.bytes.size ());
+		file.flush ();
+		return !file;
+	}
+	boost::filesystem::ofstream file;
+
+private:
+	blake2b_state hash;
+};
+
+/** Reads the snapshot while hashing everything read */
+class snapshot_reader final
+{
+public:
+	explicit snapshot_reader (boost::filesystem::path const & path_a) :
+	file (path_a, std::ios::binary)
+	{
+		blake2b_init (&hash, sizeof (oslo::uint256_union));
+	}
+	/** Replaces the contents of \p buffer_a with the next \p size_a bytes, returns true on error */
+	bool read (std::vector<uint8_t> & buffer_a, size_t size_a)
+	{
+		buffer_a.resize (size_a);
+		file.read (reinterpret_cast<char *> (buffer_a.data ()), size_a);
+		auto error (static_cast<size_t> (file.gcount ()) != size_a);
+		if (!error)
+		{
+			blake2b_update (&hash, buffer_a.data (), buffer_a.size ());
+		}
+		return error;
+	}
+	/** Reads the trailing checksum, returns true if it does not match or is not at the end of the file */
+	bool checksum_mismatch ()
+	{
+		oslo::uint256_union expected;
+		oslo::uint256_union checksum;
+		blake2b_final (&hash, checksum.bytes.data (), checksum.bytes.size ());
+		file.read (reinterpret_cast<char *> (expected.bytes.data ()), expected.bytes.size ());
+		auto error (static_cast<size_t> (file.gcount ()) != expected.bytes.size () || expected != checksum);
+		return error || file.peek () != std::char_traits<char>::eof ();
+	}
+	boost::filesystem::ifstream file;
+
+private:
+	blake2b_state hash;
+};
+
+class account_group final
+{
+public:
+	oslo::account account;
+	oslo::account_info info;
+	oslo::confirmation_height_info confirmation_height{ 0, oslo::block_hash (0) };
+	std::vector<oslo::block_type> types;
+	/** Blocks followed by their sideband, from open to head */
+	std::vector<uint8_t> data;
+};
+
+class import_batch final
+{
+public:
+	std::vector<account_group> accounts;
+	std::vector<std::pair<oslo::pending_key, oslo::pending_info>> pending;
+	size_t blocks{ 0 };
+};
+
+size_t entry_size (oslo::block_type type_a)
+{
+	return oslo::block::size (type_a) + oslo::block_sideband::size (type_a);
+}
+
+bool valid_type (oslo::block_type type_a)
+{
+	switch (type_a)
+	{
+		case oslo::block_type::send:
+		case oslo::block_type::receive:
+		case oslo::block_type::open:
+		case oslo::block_type::change:
+		case oslo::block_type::state:
+			return true;
+		default:
+			return false;
+	}
+}
+
+template <typename T>
+void write_big (oslo::stream & stream_a, T value_a)
+{
+	oslo::write (stream_a, boost::endian::native_to_big (value_a));
+}
+
+template <typename T>
+void read_big (oslo::stream & stream_a, T & value_a)
+{
+	oslo::read (stream_a, value_a);
+	boost::endian::big_to_native_inplace (value_a);
+}
+
+/**
+ * Reads the records following the header up to and including the checksum.
+ * Blocks are kept in account groups only if \p keep_blocks_a is set. Returns true on error.
+ */
+template <typename AccountHandler, typename PendingHandler>
+bool read_records (snapshot_reader & reader_a, bool keep_blocks_a, AccountHandler const & account_handler_a, PendingHandler const & pending_handler_a, std::string & error_message_a)
+{
+	std::vector<uint8_t> buffer;
+	uint64_t accounts (0);
+	uint64_t blocks (0);
+	uint64_t pending (0);
+	auto error (false);
+	auto done (false);
+	while (!error && !done)
+	{
+		error = reader_a.read (buffer, 1);
+		auto tag (error ? record_end : buffer[0]);
+		if (!error && tag == record_account)
+		{
+			account_group group;
+			error = reader_a.read (buffer, account_record_size);
+			if (!error)
+			{
+				oslo::bufferstream stream (buffer.data (), buffer.size ());
+				oslo::read (stream, group.account.bytes);
+				oslo::read (stream, group.info.head.bytes);
+				oslo::read (stream, group.info.representative.bytes);
+				oslo::read (stream, group.info.open_block.bytes);
+				oslo::read (stream, group.info.balance.bytes);
+				read_big (stream, group.info.modified);
+				read_big (stream, group.info.block_count);
+				oslo::read (stream, group.info.epoch_m);
+				read_big (stream, group.confirmation_height.height);
+				oslo::read (stream, group.confirmation_height.frontier.bytes);
+			}
+			for (uint64_t i (0); !error && i < group.info.block_count; ++i)
+			{
+				error = reader_a.read (buffer, 1);
+				auto type (static_cast<oslo::block_type> (error ? 0 : buffer[0]));
+				error = error || !valid_type (type) || reader_a.read (buffer, entry_size (type));
+				if (!error && keep_blocks_a)
+				{
+					group.types.push_back (type);
+					group.data.insert (group.data.end (), buffer.begin (), buffer.end ());
+				}
+			}
+			if (!error)
+			{
+				++accounts;
+				blocks += group.info.block_count;
+				account_handler_a (group);
+			}
+		}
+		else if (!error && tag == record_pending)
+		{
+			error = reader_a.read (buffer, pending_record_size);
+			if (!error)
+			{
+				oslo::pending_key key;
+				oslo::pending_info info;
+				oslo::bufferstream stream (buffer.data (), buffer.size ());
+				oslo::read (stream, key.account.bytes);
+				oslo::read (stream, key.hash.bytes);
+				oslo::read (stream, info.source.bytes);
+				oslo::read (stream, info.amount.bytes);
+				oslo::read (stream, info.epoch);
+				++pending;
+				pending_handler_a (key, info);
+			}
+		}
+		else if (!error && tag == record_end)
+		{
+			error = reader_a.read (buffer, trailer_size);
+			if (!error)
+			{
+				uint64_t accounts_l;
+				uint64_t blocks_l;
+				uint64_t pending_l;
+				oslo::bufferstream stream (buffer.data (), buffer.size ());
+				read_big (stream, accounts_l);
+				read_big (stream, blocks_l);
+				read_big (stream, pending_l);
+				error = accounts_l != accounts || blocks_l != blocks || pending_l != pending;
+				if (error)
+				{
+					error_message_a = "Record counts do not match the trailer";
+				}
+				else if (reader_a.checksum_mismatch ())
+				{
+					error = true;
+					error_message_a = "Checksum mismatch";
+				}
+			}
+			done = true;
+		}
+		else if (!error)
+		{
+			error = true;
+		}
+		if (error && error_message_a.empty ())
+		{
+			error_message_a = "Truncated or malformed snapshot";
+		}
+	}
+	return error;
+}
+
+/** Checks that the blocks of \p group_a form the chain described by its account info and collects their hashes, returns true on error */
+bool verify_group (account_group const & group_a, std::vector<oslo::block_hash> & hashes_a)
+{
+	auto error (group_a.types.empty () || group_a.types.size () != group_a.info.block_count || group_a.confirmation_height.height > group_a.info.block_count);
+	oslo::block_hash successor (0);
+	size_t offset (0);
+	hashes_a.clear ();
+	for (size_t i (0); !error && i < group_a.types.size (); ++i)
+	{
+		auto type (group_a.types[i]);
+		oslo::bufferstream stream (group_a.data.data () + offset, entry_size (type));
+		offset += entry_size (type);
+		auto block (oslo::deserialize_block (stream, type));
+		oslo::block_sideband sideband;
+		error = block == nullptr || sideband.deserialize (stream, type);
+		if (!error)
+		{
+			auto hash (block->hash ());
+			auto const & account (block->account ().is_zero () ? sideband.account : block->account ());
+			auto previous (hashes_a.empty () ? oslo::block_hash (0) : hashes_a.back ());
+			error = account != group_a.account || block->previous () != previous || sideband.height != i + 1 || (i > 0 && successor != hash);
+			successor = sideband.successor;
+			hashes_a.push_back (hash);
+		}
+	}
+	if (!error)
+	{
+		error = !successor.is_zero () || hashes_a.front () != group_a.info.open_block || hashes_a.back () != group_a.info.head;
+		error = error || (group_a.confirmation_height.height > 0 && hashes_a[group_a.confirmation_height.height - 1] != group_a.confirmation_height.frontier);
+	}
+	return error;
+}
+
+/** Writes the blocks as stored values, so successors are not rewritten and no ledger checks are made */
+void write_batch (oslo::block_store & store_a, oslo::network_params const & network_params_a, import_batch const & batch_a, std::vector<std::vector<oslo::block_hash>> const & hashes_a)
+{
+	auto transaction (store_a.tx_begin_write ());
+	std::vector<uint8_t> value;
+	for (size_t i (0); i < batch_a.accounts.size (); ++i)
+	{
+		auto const & group (batch_a.accounts[i]);
+		auto data (group.data.begin ());
+		for (size_t j (0); j < group.types.size (); ++j)
+		{
+			auto type (group.types[j]);
+			value.assign (data, data + entry_size (type));
+			data += entry_size (type);
+			store_a.block_raw_put (transaction, value, type, hashes_a[i][j]);
+		}
+		store_a.account_put (transaction, group.account, group.info);
+		if (group.account == network_params_a.ledger.genesis_account && group.info.head != network_params_a.ledger.genesis_hash)
+		{
+			// The frontier put when the store was initialized would otherwise let legacy blocks fork the genesis open block
+			store_a.frontier_del (transaction, network_params_a.ledger.genesis_hash);
+		}
+		if (group.confirmation_height.height > 0)
+		{
+			store_a.confirmation_height_put (transaction, group.account, group.confirmation_height);
+		}
+		if (group.types.back () != oslo::block_type::state)
+		{
+			store_a.frontier_put (transaction, group.info.head, group.account);
+		}
+	}
+	for (auto const & pending : batch_a.pending)
+	{
+		store_a.pending_put (transaction, pending.first, pending.second);
+	}
+}
+}
+
+oslo::ledger_snapshot::ledger_snapshot (oslo::block_store & store_a, oslo::network_params const & network_params_a) :
+store (store_a),
+network_params (network_params_a)
+{
+}
+
+bool oslo::ledger_snapshot::fail (std::string const & message_a)
+{
+	error_message = message_a;
+	return true;
+}
+
+bool oslo::ledger_snapshot::export_ledger (boost::filesystem::path const & path_a)
+{
+	snapshot_writer writer (path_a);
+	auto error (!writer.file);
+	if (error)
+	{
+		return fail ("Unable to open " + path_a.string ());
+	}
+	accounts = 0;
+	blocks = 0;
+	pending = 0;
+	auto transaction (store.tx_begin_read ());
+	std::vector<uint8_t> buffer;
+	{
+		oslo::vectorstream stream (buffer);
+		write_big (stream, magic);
+		oslo::write (stream, format_version);
+		write_big (stream, static_cast<uint32_t> (store.version_get (transaction)));
+		oslo::write (stream, network_params.ledger.genesis_hash.bytes);
+	}
+	writer.write (buffer);
+	for (auto i (store.latest_begin (transaction)), n (store.latest_end ()); i != n && !error; ++i)
+	{
+		oslo::account const & account (i->first);
+		oslo::account_info const & info (i->second);
+		oslo::confirmation_height_info confirmation_height{ 0, oslo::block_hash (0) };
+		store.confirmation_height_get (transaction, account, confirmation_height);
+		buffer.clear ();
+		{
+			oslo::vectorstream stream (buffer);
+			oslo::write (stream, record_account);
+			oslo::write (stream, account.bytes);
+			oslo::write (stream, info.head.bytes);
+			oslo::write (stream, info.representative.bytes);
+			oslo::write (stream, info.open_block.bytes);
+			oslo::write (stream, info.balance.bytes);
+			write_big (stream, info.modified);
+			write_big (stream, info.block_count);
+			oslo::write (stream, info.epoch_m);
+			write_big (stream, confirmation_height.height);
+			oslo::write (stream, confirmation_height.frontier.bytes);
+		}
+		writer.write (buffer);
+		auto hash (info.open_block);
+		for (uint64_t count (0); count < info.block_count && !error; ++count)
+		{
+			auto block (store.block_get (transaction, hash));
+			error = block == nullptr;
+			if (!error)
+			{
+				buffer.clear ();
+				{
+					oslo::vectorstream stream (buffer);
+					oslo::write (stream, block->type ());
+					block->serialize (stream);
+					block->sideband ().serialize (stream, block->type ());
+				}
+				writer.write (buffer);
+				hash = block->sideband ().successor;
+				++blocks;
+			}
+		}
+		error = error || !hash.is_zero ();
+		if (error)
+		{
+			fail ("Chain of account " + account.to_account () + " does not match its account info");
+		}
+		++accounts;
+	}
+	for (auto i (store.pending_begin (transaction)), n (store.pending_end ()); i != n && !error; ++i)
+	{
+		oslo::pending_key const & key (i->first);
+		oslo::pending_info const & info (i->second);
+		buffer.clear ();
+		{
+			oslo::vectorstream stream (buffer);
+			oslo::write (stream, record_pending);
+			oslo::write (stream, key.account.bytes);
+			oslo::write (stream, key.hash.bytes);
+			oslo::write (stream, info.source.bytes);
+			oslo::write (stream, info.amount.bytes);
+			oslo::write (stream, info.epoch);
+		}
+		writer.write (buffer);
+		++pending;
+	}
+	if (!error)
+	{
+		buffer.clear ();
+		{
+			oslo::vectorstream stream (buffer);
+			oslo::write (stream, record_end);
+			write_big (stream, accounts.load ());
+			write_big (stream, blocks.load ());
+			write_big (stream, pending.load ());
+		}
+		writer.write (buffer);
+		error = writer.finish ();
+		if (error)
+		{
+			fail ("Unable to write " + path_a.string ());
+		}
+	}
+	return error;
+}
+
+namespace
+{
+/** Reads and checks the header, returns true on error */
+bool read_header (snapshot_reader & reader_a, oslo::block_store & store_a, oslo::network_params const & network_params_a, std::string & error_message_a)
+{
+	std::vector<uint8_t> buffer;
+	auto error (!reader_a.file || reader_a.read (buffer, header_size));
+	if (!error)
+	{
+		uint64_t magic;
+		uint8_t format_version;
+		uint32_t store_version;
+		oslo::block_hash genesis;
+		oslo::bufferstream stream (buffer.data (), buffer.size ());
+		read_big (stream, magic);
+		oslo::read (stream, format_version);
+		read_big (stream, store_version);
+		oslo::read (stream, genesis.bytes);
+		error = magic != oslo::ledger_snapshot::magic || format_version != oslo::ledger_snapshot::format_version;
+		if (error)
+		{
+			error_message_a = "Not a ledger snapshot or unsupported format version";
+		}
+		else if (genesis != network_params_a.ledger.genesis_hash)
+		{
+			error = true;
+			error_message_a = "Snapshot belongs to a different network";
+		}
+		else if (store_version != static_cast<uint32_t> (store_a.version_get (store_a.tx_begin_read ())))
+		{
+			error = true;
+			error_message_a = "Snapshot was exported from a different database version";
+		}
+	}
+	else
+	{
+		error_message_a = "Unable to read snapshot header";
+	}
+	return error;
+}
+}
+
+bool oslo::ledger_snapshot::verify (boost::filesystem::path const & path_a, unsigned threads_a)
+{
+	error_message.clear ();
+	return process (path_a, threads_a, false);
+}
+
+bool oslo::ledger_snapshot::import_ledger (boost::filesystem::path const & path_a, unsigned threads_a)
+{
+	auto error (verify (path_a, threads_a));
+	if (!error)
+	{
+		auto transaction (store.tx_begin_read ());
+		if (store.account_count (transaction) > 1 || store.block_count (transaction).sum () > 1)
+		{
+			error = fail ("The ledger must only contain the genesis block");
+		}
+	}
+	if (!error)
+	{
+		error = process (path_a, threads_a, true);
+	}
+	return error;
+}
+
+bool oslo::ledger_snapshot::process (boost::filesystem::path const & path_a, unsigned threads_a, bool write_a)
+{
+	snapshot_reader reader (path_a);
+	std::string error_message_l;
+	auto error (read_header (reader, store, network_params, error_message_l));
+	if (!error)
+	{
+		accounts = 0;
+		blocks = 0;
+		pending = 0;
+		std::mutex mutex;
+		oslo::condition_variable condition;
+		std::deque<std::unique_ptr<import_batch>> batches;
+		auto done (false);
+		std::atomic<bool> failed{ false };
+		std::mutex write_mutex;
+		auto threads_l (std::max (1u, threads_a));
+		std::vector<std::thread> threads;
+		for (auto i (0u); i < threads_l; ++i)
+		{
+			threads.emplace_back ([this, write_a, &mutex, &condition, &batches, &done, &failed, &write_mutex]() {
+				oslo::thread_role::set (oslo::thread_role::name::ledger_import);
+				std::vector<std::vector<oslo::block_hash>> hashes;
+				oslo::unique_lock<std::mutex> lock (mutex);
+				while (!batches.empty () || !done)
+				{
+					if (!batches.empty ())
+					{
+						auto batch (std::move (batches.front ()));
+						batches.pop_front ();
+						condition.notify_all ();
+						lock.unlock ();
+						// Blocks are deserialized and hashed concurrently, writes are serialized
+						hashes.resize (batch->accounts.size ());
+						auto error_l (failed.load ());
+						for (size_t j (0); !error_l && j < batch->accounts.size (); ++j)
+						{
+							error_l = verify_group (batch->accounts[j], hashes[j]);
+						}
+						if (!error_l)
+						{
+							oslo::lock_guard<std::mutex> write_lock (write_mutex);
+							if (write_a)
+							{
+								write_batch (store, network_params, *batch, hashes);
+							}
+							accounts += batch->accounts.size ();
+							blocks += batch->blocks;
+							pending += batch->pending.size ();
+						}
+						failed = failed || error_l;
+						lock.lock ();
+					}
+					else
+					{
+						condition.wait (lock);
+					}
+				}
+			});
+		}
+		auto batch (std::make_unique<import_batch> ());
+		auto submit = [&mutex, &condition, &batches, &batch, &failed, threads_l]() {
+			oslo::unique_lock<std::mutex> lock (mutex);
+			// Bound the memory held by batches waiting for a thread
+			condition.wait (lock, [&batches, &failed, threads_l]() { return batches.size () < 2 * threads_l || failed; });
+			batches.push_back (std::move (batch));
+			condition.notify_all ();
+			batch = std::make_unique<import_batch> ();
+		};
+		error = read_records (
+		reader, true, [&batch, &submit](account_group & group_a) {
+			batch->blocks += group_a.types.size ();
+			batch->accounts.push_back (std::move (group_a));
+			if (batch->blocks >= import_batch_blocks)
+			{
+				submit ();
+			}
+		},
+		[&batch, &submit](oslo::pending_key const & key_a, oslo::pending_info const & info_a) {
+			batch->pending.emplace_back (key_a, info_a);
+			if (batch->pending.size () >= import_batch_blocks)
+			{
+				submit ();
+			}
+		},
+		error_message_l);
+		if (!error)
+		{
+			submit ();
+		}
+		{
+			oslo::lock_guard<std::mutex> lock (mutex);
+			done = true;
+		}
+		condition.notify_all ();
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		if (!error && failed)
+		{
+			error = true;
+			error_message_l = "Chains in the snapshot do not match their account info";
+		}
+	}
+	if (error && write_a)
+	{
+		// The whole file was verified before the first write, so it changed in between
+		fail ("Snapshot changed while importing, the ledger is incomplete and must be removed: " + error_message_l);
+	}
+	else if (error)
+	{
+		fail (error_message_l);
+	}
+	return error;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <oslo/secure/common.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <atomic>
+#include <string>
+
+namespace oslo
+{
+class block_store;
+/**
+ * Offline ledger snapshot in a streaming format which does not depend on the database backend.
+ * The file holds a header, one record per account with its confirmation height and its chain from open to head
+ * including sideband, the pending entries and a trailer with the record counts and a blake2b checksum of the file.
+ * Blocks are imported without ledger or signature checks, the snapshot has to come from a trusted source.
+ */
+class ledger_snapshot final
+{
+public:
+	ledger_snapshot (oslo::block_store &, oslo::network_params const &);
+	/** Writes the ledger from a single read transaction to \p path_a, returns true on error */
+	bool export_ledger (boost::filesystem::path const & path_a);
+	/** Checks the checksum and trailer of the whole file and that every chain matches its account info, returns true on error */
+	bool verify (boost::filesystem::path const & path_a, unsigned threads_a = 1);
+	/** Verifies the whole file, then writes its contents with \p threads_a threads into a ledger holding only the genesis block, returns true on error */
+	bool import_ledger (boost::filesystem::path const & path_a, unsigned threads_a);
+	std::atomic<uint64_t> accounts{ 0 };
+	std::atomic<uint64_t> blocks{ 0 };
+	std::atomic<uint64_t> pending{ 0 };
+	/** Description of the last error */
+	std::string error_message;
+	/** "osloledg" */
+	static uint64_t constexpr magic = 0x6f736c6f6c656467;
+	static uint8_t constexpr format_version = 1;
+	/** Blocks written per import transaction */
+	static size_t constexpr import_batch_blocks = 64 * 1024;
+
+private:
+	bool fail (std::string const &);
+	/** Reads the file checking every chain with \p threads_a threads and writes the records to the store if \p write_a is set, returns true on error */
+	bool process (boost::filesystem::path const & path_a, unsigned threads_a, bool write_a);
+	oslo::block_store & store;
+	oslo::network_params const & network_params;
+};
+}
@@ -181,10 +181,12 @@ void oslo::mdb_store::open_databases (bool & error_a, oslo::transaction const &
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "open", flags, &open_blocks) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "change", flags, &change_blocks) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "unchecked", flags, &unchecked) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "unchecked_modified", flags, &unchecked_modified) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "vote", flags, &vote) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "online_weight", flags, &online_weight) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "meta", flags, &meta) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "peers", flags, &peers) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "bootstrap_peers", flags, &bootstrap_peers) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "confirmation_height", flags, &confirmation_height) != 0;
 	if (!full_sideband (transaction_a))
 	{
@@ -261,6 +263,10 @@ bool oslo::mdb_store::do_upgrades (oslo::write_transaction & transaction_a, bool
 			upgrade_v17_to_v18 (transaction_a);
 			needs_vacuuming = true;
 		case 18:
+			upgrade_v18_to_v19 (transaction_a);
+		case 19:
+			upgrade_v19_to_v20 (transaction_a);
+		case 20:
 			break;
 		default:
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
@@ -848,6 +854,27 @@ void oslo::mdb_store::upgrade_v17_to_v18 (oslo::write_transaction const & transa
 	logger.always_log ("Finished upgrading the sideband");
 }
 
+void oslo::mdb_store::upgrade_v18_to_v19 (oslo::write_transaction const & transaction_a)
+{
+	// The bootstrap_peers table is created when opening the databases
+	version_put (transaction_a, 19);
+	logger.always_log ("Finished creating the bootstrap peers table");
+}
+
+void oslo::mdb_store::upgrade_v19_to_v20 (oslo::write_transaction const & transaction_a)
+{
+	logger.always_log ("Preparing v19 to v20 database upgrade...");
+	size_t count (0);
+	for (oslo::mdb_iterator<oslo::unchecked_key, oslo::unchecked_info> i (transaction_a, unchecked), n (oslo::mdb_iterator<oslo::unchecked_key, oslo::unchecked_info>{}); i != n; ++i, ++count)
+	{
+		oslo::unchecked_info info (i->second);
+		auto status (mdb_put (env.tx (transaction_a), unchecked_modified, oslo::mdb_val (oslo::unchecked_modified_key (info.modified, oslo::unchecked_key (i->first))), oslo::mdb_val (static_cast<uint64_t> (0)), 0));
+		release_assert (success (status));
+	}
+	version_put (transaction_a, 20);
+	logger.always_log (boost::str (boost::format ("Finished indexing %1% unchecked blocks by modified time") % count));
+}
+
 /** Takes a filepath, appends '_backup_<timestamp>' to the end (but before any extension) and saves that file in the same directory */
 void oslo::mdb_store::create_backup_file (oslo::mdb_env & env_a, boost::filesystem::path const & filepath_a, oslo::logger_mt & logger_a)
 {
@@ -990,6 +1017,8 @@ MDB_dbi oslo::mdb_store::table_to_dbi (tables table_a) const
 			return blocks_info;
 		case tables::unchecked:
 			return unchecked;
+		case tables::unchecked_modified:
+			return unchecked_modified;
 		case tables::vote:
 			return vote;
 		case tables::online_weight:
@@ -998,6 +1027,8 @@ MDB_dbi oslo::mdb_store::table_to_dbi (tables table_a) const
 			return meta;
 		case tables::peers:
 			return peers;
+		case tables::bootstrap_peers:
+			return bootstrap_peers;
 		case tables::confirmation_height:
 			return confirmation_height;
 		default:
@@ -160,6 +160,12 @@ public:
 	 */
 	MDB_dbi unchecked{ 0 };
 
+	/**
+	 * Unchecked keys ordered by the time they were last modified, so expired entries are found without scanning unchecked.
+	 * oslo::unchecked_modified_key -> uint64_t (unused)
+	 */
+	MDB_dbi unchecked_modified{ 0 };
+
 	/**
 	 * Highest vote observed for account.
 	 * oslo::account -> uint64_t
@@ -184,6 +190,12 @@ public:
 	*/
 	MDB_dbi peers{ 0 };
 
+	/*
+	 * Bootstrap performance of peers
+	 * oslo::endpoint_key -> oslo::bootstrap_peer_info
+	 */
+	MDB_dbi bootstrap_peers{ 0 };
+
 	/*
 	 * Confirmation height of an account, and the hash for the block at that height
 	 * oslo::account -> uint64_t, oslo::block_hash
@@ -244,6 +256,8 @@ private:
 	void upgrade_v15_to_v16 (oslo::write_transaction const &);
 	void upgrade_v16_to_v17 (oslo::write_transaction const &);
 	void upgrade_v17_to_v18 (oslo::write_transaction const &);
+	void upgrade_v18_to_v19 (oslo::write_transaction const &);
+	void upgrade_v19_to_v20 (oslo::write_transaction const &);
 
 	void open_databases (bool &, oslo::transaction const &, unsigned);
 
@@ -14,8 +14,15 @@ oslo::network::network (oslo::node & node_a, uint16_t port_a) :
 syn_cookies (node_a.network_params.node.max_peers_per_ip),
 buffer_container (node_a.stats, oslo::network::buffer_size, 4096), // 2Mb receive buffer
 resolver (node_a.io_ctx),
-limiter (node_a.config.bandwidth_limit_burst_ratio, node_a.config.bandwidth_limit),
-tcp_message_manager (node_a.config.tcp_incoming_connections_max),
+limiter (node_a.config.bandwidth_limit_burst_ratio, node_a.config.bandwidth_limit, node_a.config.bandwidth_shares, node_a.config.bandwidth_limit_per_peer),
+tcp_message_manager (node_a.stats, node_a.config.tcp_incoming_connections_max, [&node_a](oslo::tcp_message_item const & item_a) {
+	auto channel (node_a.network.find_channel (oslo::transport::map_tcp_to_endpoint (item_a.endpoint)));
+	if (channel == nullptr && !item_a.node_id.is_zero ())
+	{
+		channel = node_a.network.find_node_id (item_a.node_id);
+	}
+	return channel != nullptr && node_a.rep_crawler.is_pr (*channel);
+}),
 node (node_a),
 publish_filter (256 * 1024),
 udp_channels (node_a, port_a),
@@ -215,27 +222,71 @@ void oslo::network::flood_block_initial (std::shared_ptr<oslo::block> const & bl
 
 void oslo::network::flood_vote (std::shared_ptr<oslo::vote> const & vote_a, float scale)
 {
-	oslo::confirm_ack message (vote_a);
 	for (auto & i : list (fanout (scale)))
 	{
-		i->send (message, nullptr);
+		node.vote_batcher.add (i, vote_a);
 	}
 }
 
 void oslo::network::flood_vote_pr (std::shared_ptr<oslo::vote> const & vote_a)
 {
-	oslo::confirm_ack message (vote_a);
 	for (auto const & i : node.rep_crawler.principal_representatives ())
 	{
-		i.channel->send (message, nullptr, oslo::buffer_drop_policy::no_limiter_drop);
+		node.vote_batcher.add (i.channel, vote_a, oslo::buffer_drop_policy::no_limiter_drop);
+	}
+}
+
+void oslo::network::flood_block_batch (std::vector<std::shared_ptr<oslo::block>> const & blocks_a, oslo::buffer_drop_policy const drop_policy_a)
+{
+	debug_assert (!blocks_a.empty ());
+	auto split = [&blocks_a](size_t per_message_a) {
+		std::vector<oslo::publish_batch> result;
+		for (auto i (blocks_a.begin ()), n (blocks_a.end ()); i != n;)
+		{
+			auto end (i + std::min<size_t> (per_message_a, n - i));
+			result.emplace_back (std::vector<std::shared_ptr<oslo::block>> (i, end));
+			i = end;
+		}
+		return result;
+	};
+	// Datagrams have to stay within the safe UDP message size
+	auto udp_per_message (std::max<size_t> (1, (oslo::message_parser::max_safe_udp_message_size - oslo::message_header::size) / oslo::block::size (blocks_a.front ()->type ())));
+	auto const tcp_messages (split (oslo::publish_batch::max_blocks));
+	auto const udp_messages (split (udp_per_message));
+	std::vector<oslo::publish> single_messages;
+	for (auto & i : list (fanout ()))
+	{
+		if (i->get_network_version () >= node.network_params.protocol.publish_batch_version_min)
+		{
+			for (auto const & message : i->get_type () == oslo::transport::transport_type::udp ? udp_messages : tcp_messages)
+			{
+				i->send (message, nullptr, drop_policy_a);
+			}
+		}
+		else
+		{
+			for (auto j (single_messages.size ()); j < blocks_a.size (); ++j)
+			{
+				single_messages.emplace_back (blocks_a[j]);
+			}
+			for (auto const & message : single_messages)
+			{
+				i->send (message, nullptr, drop_policy_a);
+			}
+		}
 	}
 }
 
 void oslo::network::flood_block_many (std::deque<std::shared_ptr<oslo::block>> blocks_a, std::function<void()> callback_a, unsigned delay_a)
 {
-	auto block_l (blocks_a.front ());
-	blocks_a.pop_front ();
-	flood_block (block_l);
+	std::vector<std::shared_ptr<oslo::block>> batch;
+	auto type (blocks_a.front ()->type ());
+	while (!blocks_a.empty () && batch.size () < oslo::publish_batch::max_blocks && blocks_a.front ()->type () == type)
+	{
+		batch.push_back (std::move (blocks_a.front ()));
+		blocks_a.pop_front ();
+	}
+	flood_block_batch (batch);
 	if (!blocks_a.empty ())
 	{
 		std::weak_ptr<oslo::node> node_w (node.shared ());
@@ -432,6 +483,26 @@ public:
 			node.stats.inc (oslo::stat::type::drop, oslo::stat::detail::publish, oslo::stat::dir::in);
 		}
 	}
+	void publish_batch (oslo::publish_batch const & message_a) override
+	{
+		if (node.config.logging.network_message_logging ())
+		{
+			node.logger.try_log (boost::str (boost::format ("Publish batch message from %1% with %2% blocks") % channel->to_string () % message_a.blocks.size ()));
+		}
+		node.stats.inc (oslo::stat::type::message, oslo::stat::detail::publish_batch, oslo::stat::dir::in);
+		for (size_t i (0), n (message_a.blocks.size ()); i < n; ++i)
+		{
+			if (!node.block_processor.full ())
+			{
+				node.process_active (message_a.blocks[i]);
+			}
+			else
+			{
+				node.network.publish_filter.clear (message_a.digests[i]);
+				node.stats.inc (oslo::stat::type::drop, oslo::stat::detail::publish_batch, oslo::stat::dir::in);
+			}
+		}
+	}
 	void confirm_req (oslo::confirm_req const & message_a) override
 	{
 		if (node.config.logging.network_message_logging ())
@@ -602,32 +673,14 @@ bool oslo::network::reachout (oslo::endpoint const & endpoint_a, bool allow_loca
 
 std::deque<std::shared_ptr<oslo::transport::channel>> oslo::network::list (size_t count_a, uint8_t minimum_version_a, bool include_tcp_temporary_channels_a)
 {
-	std::deque<std::shared_ptr<oslo::transport::channel>> result;
-	tcp_channels.list (result, minimum_version_a, include_tcp_temporary_channels_a);
-	udp_channels.list (result, minimum_version_a);
-	oslo::random_pool_shuffle (result.begin (), result.end ());
-	if (result.size () > count_a)
-	{
-		result.resize (count_a, nullptr);
-	}
-	return result;
+	auto channels (snapshot ()->sample (count_a, minimum_version_a, include_tcp_temporary_channels_a, true));
+	return std::deque<std::shared_ptr<oslo::transport::channel>> (std::make_move_iterator (channels.begin ()), std::make_move_iterator (channels.end ()));
 }
 
 std::deque<std::shared_ptr<oslo::transport::channel>> oslo::network::list_non_pr (size_t count_a)
 {
-	std::deque<std::shared_ptr<oslo::transport::channel>> result;
-	tcp_channels.list (result);
-	udp_channels.list (result);
-	oslo::random_pool_shuffle (result.begin (), result.end ());
-	result.erase (std::remove_if (result.begin (), result.end (), [this](std::shared_ptr<oslo::transport::channel> const & channel) {
-		return this->node.rep_crawler.is_pr (*channel);
-	}),
-	result.end ());
-	if (result.size () > count_a)
-	{
-		result.resize (count_a, nullptr);
-	}
-	return result;
+	auto channels (snapshot ()->sample (count_a, 0, true, false));
+	return std::deque<std::shared_ptr<oslo::transport::channel>> (std::make_move_iterator (channels.begin ()), std::make_move_iterator (channels.end ()));
 }
 
 // Simulating with sqrt_broadcast_simulate shows we only need to broadcast to sqrt(total_peers) random peers in order to successfully publish to everyone with high probability
@@ -638,19 +691,49 @@ size_t oslo::network::fanout (float scale) const
 
 std::unordered_set<std::shared_ptr<oslo::transport::channel>> oslo::network::random_set (size_t count_a, uint8_t min_version_a, bool include_temporary_channels_a) const
 {
-	std::unordered_set<std::shared_ptr<oslo::transport::channel>> result (tcp_channels.random_set (count_a, min_version_a, include_temporary_channels_a));
-	std::unordered_set<std::shared_ptr<oslo::transport::channel>> udp_random (udp_channels.random_set (count_a, min_version_a));
-	for (auto i (udp_random.begin ()), n (udp_random.end ()); i != n && result.size () < count_a * 1.5; ++i)
+	// Sampled channels are distinct already
+	auto channels (snapshot ()->sample (count_a, min_version_a, include_temporary_channels_a, true));
+	return std::unordered_set<std::shared_ptr<oslo::transport::channel>> (std::make_move_iterator (channels.begin ()), std::make_move_iterator (channels.end ()));
+}
+
+std::shared_ptr<oslo::channel_snapshot const> oslo::network::snapshot () const
+{
+	auto result (std::atomic_load (&channels_snapshot));
+	if (result == nullptr || std::chrono::steady_clock::now () - result->published > snapshot_interval)
 	{
-		result.insert (*i);
+		// Picks up changes in protocol versions and principal representatives
+		snapshot_stale = true;
 	}
-	while (result.size () > count_a)
+	if (snapshot_stale.exchange (false) || result == nullptr)
 	{
-		result.erase (result.begin ());
+		result = publish_snapshot ();
 	}
 	return result;
 }
 
+void oslo::network::snapshot_invalidate ()
+{
+	snapshot_stale = true;
+}
+
+std::shared_ptr<oslo::channel_snapshot const> oslo::network::publish_snapshot () const
+{
+	std::deque<std::shared_ptr<oslo::transport::channel>> channels;
+	tcp_channels.list (channels, 0, true);
+	udp_channels.list (channels);
+	std::vector<oslo::channel_snapshot::entry> representatives;
+	std::vector<oslo::channel_snapshot::entry> others;
+	for (auto & channel : channels)
+	{
+		auto tcp (channel->get_type () == oslo::transport::transport_type::tcp ? static_cast<oslo::transport::channel_tcp const *> (channel.get ()) : nullptr);
+		auto & partition (node.rep_crawler.is_pr (*channel) ? representatives : others);
+		partition.push_back ({ std::move (channel), tcp });
+	}
+	auto result (std::make_shared<oslo::channel_snapshot const> (std::move (representatives), std::move (others)));
+	std::atomic_store (&channels_snapshot, result);
+	return result;
+}
+
 void oslo::network::random_fill (std::array<oslo::endpoint, 8> & target_a) const
 {
 	auto peers (random_set (target_a.size (), 0, false)); // Don't include channels with ephemeral remote ports
@@ -793,13 +876,117 @@ void oslo::network::erase (oslo::transport::channel const & channel_a)
 	}
 }
 
+namespace
+{
+size_t ring_capacity (size_t count_a)
+{
+	size_t result (1);
+	while (result < count_a)
+	{
+		result <<= 1;
+	}
+	return result;
+}
+}
+
+oslo::message_buffer_ring::message_buffer_ring (size_t count_a) :
+cells (ring_capacity (count_a)),
+mask (cells.size () - 1)
+{
+	for (size_t i (0); i < cells.size (); ++i)
+	{
+		cells[i].sequence.store (i, std::memory_order_relaxed);
+	}
+}
+
+bool oslo::message_buffer_ring::push (oslo::message_buffer * data_a)
+{
+	auto position (enqueue_position.load (std::memory_order_relaxed));
+	cell * cell_l (nullptr);
+	auto result (true);
+	while (cell_l == nullptr && result)
+	{
+		auto & candidate (cells[position & mask]);
+		auto sequence (candidate.sequence.load (std::memory_order_acquire));
+		auto difference (static_cast<std::ptrdiff_t> (sequence) - static_cast<std::ptrdiff_t> (position));
+		if (difference == 0)
+		{
+			// The cell is free for this position, claim it
+			if (enqueue_position.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+			{
+				cell_l = &candidate;
+			}
+		}
+		else if (difference < 0)
+		{
+			// The cell still holds the item from one lap ago. The ring is only full if that item has not been claimed by a consumer,
+			// otherwise the consumer has not yet handed the cell back and it will be free shortly.
+			if (static_cast<std::ptrdiff_t> (position - dequeue_position.load (std::memory_order_acquire)) >= static_cast<std::ptrdiff_t> (cells.size ()))
+			{
+				result = false;
+			}
+			else
+			{
+				std::this_thread::yield ();
+				position = enqueue_position.load (std::memory_order_relaxed);
+			}
+		}
+		else
+		{
+			position = enqueue_position.load (std::memory_order_relaxed);
+		}
+	}
+	if (result)
+	{
+		cell_l->data = data_a;
+		cell_l->sequence.store (position + 1, std::memory_order_release);
+	}
+	return result;
+}
+
+oslo::message_buffer * oslo::message_buffer_ring::pop ()
+{
+	auto position (dequeue_position.load (std::memory_order_relaxed));
+	cell * cell_l (nullptr);
+	auto empty (false);
+	while (cell_l == nullptr && !empty)
+	{
+		auto & candidate (cells[position & mask]);
+		auto sequence (candidate.sequence.load (std::memory_order_acquire));
+		auto difference (static_cast<std::ptrdiff_t> (sequence) - static_cast<std::ptrdiff_t> (position + 1));
+		if (difference == 0)
+		{
+			if (dequeue_position.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+			{
+				cell_l = &candidate;
+			}
+		}
+		else if (difference < 0)
+		{
+			empty = true;
+		}
+		else
+		{
+			position = dequeue_position.load (std::memory_order_relaxed);
+		}
+	}
+	oslo::message_buffer * result (nullptr);
+	if (cell_l != nullptr)
+	{
+		result = cell_l->data;
+		// Hand the cell back to producers for the next lap
+		cell_l->sequence.store (position + mask + 1, std::memory_order_release);
+	}
+	return result;
+}
+
 oslo::message_buffer_manager::message_buffer_manager (oslo::stat & stats_a, size_t size, size_t count) :
 stats (stats_a),
-free (count),
-full (count),
+// Spare cells keep producers from waiting on a consumer that has claimed, but not yet released, the cell from one lap ago
+free (2 * count),
+full (2 * count),
 slab (size * count),
-entries (count),
-stopped (false)
+entries (count)
 {
 	debug_assert (count > 0);
 	debug_assert (size > 0);
@@ -808,56 +995,56 @@ stopped (false)
 	for (auto i (0); i < count; ++i, ++entry_data)
 	{
 		*entry_data = { slab_data + i * size, 0, oslo::endpoint () };
-		free.push_back (entry_data);
+		free.push (entry_data);
 	}
 }
 
-oslo::message_buffer * oslo::message_buffer_manager::allocate ()
+oslo::message_buffer * oslo::message_buffer_manager::allocate_nonblocking ()
 {
-	oslo::unique_lock<std::mutex> lock (mutex);
-	if (!stopped && free.empty () && full.empty ())
-	{
-		stats.inc (oslo::stat::type::udp, oslo::stat::detail::blocking, oslo::stat::dir::in);
-		condition.wait (lock, [& stopped = stopped, &free = free, &full = full] { return stopped || !free.empty () || !full.empty (); });
-	}
-	oslo::message_buffer * result (nullptr);
-	if (!free.empty ())
+	auto result (free.pop ());
+	if (result == nullptr)
 	{
-		result = free.front ();
-		free.pop_front ();
+		// Drop the oldest unserviced buffer
+		result = full.pop ();
+		if (result != nullptr)
+		{
+			stats.inc (oslo::stat::type::udp, oslo::stat::detail::overflow, oslo::stat::dir::in);
+		}
 	}
-	if (result == nullptr && !full.empty ())
+	return result;
+}
+
+oslo::message_buffer * oslo::message_buffer_manager::allocate ()
+{
+	auto result (allocate_nonblocking ());
+	if (result == nullptr && !stopped)
 	{
-		result = full.front ();
-		full.pop_front ();
-		stats.inc (oslo::stat::type::udp, oslo::stat::detail::overflow, oslo::stat::dir::in);
+		stats.inc (oslo::stat::type::udp, oslo::stat::detail::blocking, oslo::stat::dir::in);
+		result = wait ([this]() { return allocate_nonblocking (); });
 	}
 	release_assert (result || stopped);
 	return result;
 }
 
+oslo::message_buffer * oslo::message_buffer_manager::try_allocate ()
+{
+	return stopped ? nullptr : free.pop ();
+}
+
 void oslo::message_buffer_manager::enqueue (oslo::message_buffer * data_a)
 {
 	debug_assert (data_a != nullptr);
-	{
-		oslo::lock_guard<std::mutex> lock (mutex);
-		full.push_back (data_a);
-	}
-	condition.notify_all ();
+	auto pushed (full.push (data_a));
+	release_assert (pushed);
+	notify ();
 }
 
 oslo::message_buffer * oslo::message_buffer_manager::dequeue ()
 {
-	oslo::unique_lock<std::mutex> lock (mutex);
-	while (!stopped && full.empty ())
+	auto result (full.pop ());
+	if (result == nullptr && !stopped)
 	{
-		condition.wait (lock);
-	}
-	oslo::message_buffer * result (nullptr);
-	if (!full.empty ())
-	{
-		result = full.front ();
-		full.pop_front ();
+		result = wait ([this]() { return full.pop (); });
 	}
 	return result;
 }
@@ -865,23 +1052,84 @@ oslo::message_buffer * oslo::message_buffer_manager::dequeue ()
 void oslo::message_buffer_manager::release (oslo::message_buffer * data_a)
 {
 	debug_assert (data_a != nullptr);
-	{
-		oslo::lock_guard<std::mutex> lock (mutex);
-		free.push_back (data_a);
-	}
-	condition.notify_all ();
+	auto pushed (free.push (data_a));
+	release_assert (pushed);
+	notify ();
 }
 
 void oslo::message_buffer_manager::stop ()
 {
+	stopped = true;
+	oslo::lock_guard<std::mutex> lock (mutex);
+	condition.notify_all ();
+}
+
+oslo::message_buffer * oslo::message_buffer_manager::wait (std::function<oslo::message_buffer *()> const & action_a)
+{
+	oslo::message_buffer * result (nullptr);
+	oslo::unique_lock<std::mutex> lock (mutex);
+	++waiting;
+	// Pairs with the fence in notify, either the waiter sees the pushed buffer or the notifier sees the waiter
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	condition.wait (lock, [this, &result, &action_a]() {
+		result = action_a ();
+		return result != nullptr || stopped;
+	});
+	--waiting;
+	return result;
+}
+
+void oslo::message_buffer_manager::notify ()
+{
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	if (waiting.load () > 0)
 	{
+		// Taking the mutex orders the notification after a waiter checked for buffers and went to sleep
 		oslo::lock_guard<std::mutex> lock (mutex);
-		stopped = true;
+		condition.notify_all ();
 	}
-	condition.notify_all ();
 }
 
-oslo::tcp_message_manager::tcp_message_manager (unsigned incoming_connections_max_a) :
+oslo::channel_snapshot::channel_snapshot (std::vector<entry> representatives_a, std::vector<entry> others_a) :
+representatives (std::move (representatives_a)),
+others (std::move (others_a)),
+published (std::chrono::steady_clock::now ())
+{
+}
+
+std::vector<std::shared_ptr<oslo::transport::channel>> oslo::channel_snapshot::sample (size_t count_a, uint8_t minimum_version_a, bool include_temporary_a, bool include_representatives_a) const
+{
+	std::vector<std::shared_ptr<oslo::transport::channel>> result;
+	auto total (others.size () + (include_representatives_a ? representatives.size () : 0));
+	std::vector<uint32_t> indices (total);
+	std::iota (indices.begin (), indices.end (), 0);
+	result.reserve (std::min (count_a, total));
+	// Partial Fisher-Yates shuffle of the indices, stopping once enough channels passed the filters
+	for (size_t i (0); i < total && result.size () < count_a; ++i)
+	{
+		auto j (i + oslo::random_pool::generate_word32 (0, static_cast<CryptoPP::word32> (total - i - 1)));
+		std::swap (indices[i], indices[j]);
+		auto const & entry (indices[i] < others.size () ? others[indices[i]] : representatives[indices[i] - others.size ()]);
+		if (entry.channel->get_network_version () >= minimum_version_a && (include_temporary_a || entry.tcp == nullptr || !entry.tcp->temporary))
+		{
+			result.push_back (entry.channel);
+		}
+	}
+	return result;
+}
+
+size_t oslo::channel_snapshot::size () const
+{
+	return representatives.size () + others.size ();
+}
+
+constexpr std::chrono::milliseconds oslo::network::snapshot_interval;
+constexpr size_t oslo::tcp_message_manager::max_entries_per_peer;
+constexpr size_t oslo::tcp_message_manager::quantum;
+
+oslo::tcp_message_manager::tcp_message_manager (oslo::stat & stats_a, unsigned incoming_connections_max_a, std::function<bool(oslo::tcp_message_item const &)> is_priority_a) :
+stats (stats_a),
+is_priority (is_priority_a),
 max_entries (incoming_connections_max_a * oslo::tcp_message_manager::max_entries_per_connection + 1)
 {
 	debug_assert (max_entries > 0);
@@ -889,28 +1137,130 @@ max_entries (incoming_connections_max_a * oslo::tcp_message_manager::max_entries
 
 void oslo::tcp_message_manager::put_message (oslo::tcp_message_item const & item_a)
 {
+	auto priority (is_priority (item_a));
+	auto added (false);
 	{
 		oslo::unique_lock<std::mutex> lock (mutex);
-		while (entries.size () > max_entries && !stopped)
+		while (entries_count > max_entries && !stopped)
 		{
 			condition.wait (lock);
 		}
-		entries.push_back (item_a);
+		added = put (item_a, priority);
+	}
+	if (added)
+	{
+		condition.notify_all ();
+	}
+}
+
+void oslo::tcp_message_manager::put_messages (std::vector<oslo::tcp_message_item> & items_a)
+{
+	debug_assert (!items_a.empty ());
+	// Messages of a single read come from the same peer
+	auto priority (is_priority (items_a.front ()));
+	auto added (false);
+	{
+		oslo::unique_lock<std::mutex> lock (mutex);
+		while (entries_count > max_entries && !stopped)
+		{
+			condition.wait (lock);
+		}
+		for (auto const & item : items_a)
+		{
+			added |= put (item, priority);
+		}
+	}
+	if (added)
+	{
+		condition.notify_all ();
+	}
+	items_a.clear ();
+}
+
+bool oslo::tcp_message_manager::put (oslo::tcp_message_item const & item_a, bool priority_a)
+{
+	auto result (false);
+	auto & queue (queues[item_a.endpoint]);
+	if (queue.entries.empty ())
+	{
+		// A peer stays in its lane until its queue is empty
+		(priority_a ? active_priority : active).push_back (item_a.endpoint);
+	}
+	if (queue.entries.size () < max_entries_per_peer)
+	{
+		queue.entries.push_back (item_a);
+		++entries_count;
+		result = true;
+	}
+	else
+	{
+		// Counted here so that drops from peers not tracked in drops are still visible
+		stats.inc (oslo::stat::type::tcp, oslo::stat::detail::tcp_message_drop, oslo::stat::dir::in);
+		auto existing (drops.find (item_a.endpoint));
+		if (existing != drops.end ())
+		{
+			++existing->second;
+		}
+		else if (drops.size () < max_entries)
+		{
+			drops.emplace (item_a.endpoint, 1);
+		}
+	}
+	return result;
+}
+
+oslo::tcp_message_item oslo::tcp_message_manager::next ()
+{
+	debug_assert (entries_count > 0);
+	auto & lane (!active_priority.empty () ? active_priority : active);
+	while (true)
+	{
+		debug_assert (!lane.empty ());
+		auto existing (queues.find (lane.front ()));
+		debug_assert (existing != queues.end () && !existing->second.entries.empty ());
+		auto & queue (existing->second);
+		auto const & message (*queue.entries.front ().message);
+		auto cost (oslo::message_header::size + message.header.payload_length_bytes ());
+		if (queue.deficit < cost)
+		{
+			// Move on to the next peer, this one can send another quantum on its next turn
+			queue.deficit += quantum;
+			lane.push_back (lane.front ());
+			lane.pop_front ();
+		}
+		else
+		{
+			auto result (std::move (queue.entries.front ()));
+			queue.entries.pop_front ();
+			queue.deficit -= cost;
+			--entries_count;
+			if (queue.entries.empty ())
+			{
+				queues.erase (existing);
+				lane.pop_front ();
+			}
+			return result;
+		}
 	}
-	condition.notify_all ();
 }
 
 oslo::tcp_message_item oslo::tcp_message_manager::get_message ()
 {
 	oslo::unique_lock<std::mutex> lock (mutex);
-	while (entries.empty () && !stopped)
+	while (entries_count == 0 && !stopped)
 	{
 		condition.wait (lock);
 	}
-	if (!entries.empty ())
+	if (entries_count > 0)
 	{
-		auto result (entries.front ());
-		entries.pop_front ();
+		// Producers only wait while the total is above the limit
+		auto notify (entries_count > max_entries);
+		auto result (next ());
+		lock.unlock ();
+		if (notify)
+		{
+			condition.notify_all ();
+		}
 		return result;
 	}
 	else
@@ -928,6 +1278,37 @@ void oslo::tcp_message_manager::stop ()
 	condition.notify_all ();
 }
 
+size_t oslo::tcp_message_manager::size ()
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	return entries_count;
+}
+
+uint64_t oslo::tcp_message_manager::dropped (oslo::tcp_endpoint const & endpoint_a)
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	auto existing (drops.find (endpoint_a));
+	return existing != drops.end () ? existing->second : 0;
+}
+
+std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (tcp_message_manager & tcp_message_manager, const std::string & name)
+{
+	size_t queues_count;
+	size_t entries_count;
+	size_t drops_count;
+	{
+		oslo::lock_guard<std::mutex> guard (tcp_message_manager.mutex);
+		queues_count = tcp_message_manager.queues.size ();
+		entries_count = tcp_message_manager.entries_count;
+		drops_count = tcp_message_manager.drops.size ();
+	}
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "queues", queues_count, sizeof (decltype (tcp_message_manager.queues)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "entries", entries_count, sizeof (oslo::tcp_message_item) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "drops", drops_count, sizeof (decltype (tcp_message_manager.drops)::value_type) }));
+	return composite;
+}
+
 oslo::syn_cookies::syn_cookies (size_t max_cookies_per_ip_a) :
 max_cookies_per_ip (max_cookies_per_ip_a)
 {
@@ -1019,6 +1400,8 @@ std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (ne
 	composite->add_component (network.udp_channels.collect_container_info ("udp_channels"));
 	composite->add_component (network.syn_cookies.collect_container_info ("syn_cookies"));
 	composite->add_component (collect_container_info (network.excluded_peers, "excluded_peers"));
+	composite->add_component (collect_container_info (network.tcp_message_manager, "tcp_message_manager"));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "channel_snapshot", network.snapshot ()->size (), sizeof (oslo::channel_snapshot::entry) }));
 	return composite;
 }
 
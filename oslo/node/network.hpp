@@ -8,6 +8,8 @@
 
 #include <boost/thread/thread.hpp>
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <queue>
 #include <unordered_set>
@@ -24,12 +26,45 @@ public:
 	size_t size{ 0 };
 	oslo::endpoint endpoint;
 };
+/**
+  * Bounded multi-producer multi-consumer FIFO of message buffers.
+  * Each cell carries a sequence number telling producers and consumers whether it is ready for them,
+  * so pushing and popping only take a compare-and-swap on the shared position.
+  * The capacity is rounded up to a power of two.
+*/
+class message_buffer_ring final
+{
+public:
+	explicit message_buffer_ring (size_t);
+	/**
+	 * Waits for a consumer to hand back the cell if it has already claimed the item from one lap ago
+	 * @return false if the ring is full
+	 */
+	bool push (oslo::message_buffer *);
+	/** @return nullptr if the ring is empty */
+	oslo::message_buffer * pop ();
+
+private:
+	class cell final
+	{
+	public:
+		std::atomic<size_t> sequence{ 0 };
+		oslo::message_buffer * data{ nullptr };
+	};
+	std::vector<cell> cells;
+	size_t const mask;
+	// Kept on separate cache lines so producers and consumers do not invalidate each other's position
+	alignas (64) std::atomic<size_t> enqueue_position{ 0 };
+	alignas (64) std::atomic<size_t> dequeue_position{ 0 };
+};
 /**
   * A circular buffer for servicing oslo realtime messages.
   * This container follows a producer/consumer model where the operating system is producing data in to
   * buffers which are serviced by internal threads.
   * If buffers are not serviced fast enough they're internally dropped.
   * This container has a maximum space to hold N buffers of M size and will allocate them in round-robin order.
+  * Buffers move between lock-free free and full rings. The mutex and condition variable are only used
+  * to put threads to sleep when there is nothing to allocate or dequeue, and are skipped when nobody is waiting.
   * All public methods are thread-safe
 */
 class message_buffer_manager final
@@ -45,6 +80,8 @@ public:
 	// Function will block if there are no free or unserviced buffers
 	// Return nullptr if the container has stopped
 	oslo::message_buffer * allocate ();
+	// Return a free buffer, or nullptr without blocking or dequeueing unserviced buffers if there are none
+	oslo::message_buffer * try_allocate ();
 	// Queue a buffer that has been filled with message data and notify servicing threads
 	void enqueue (oslo::message_buffer *);
 	// Return a buffer that has been filled with message data
@@ -57,32 +94,69 @@ public:
 	void stop ();
 
 private:
+	oslo::message_buffer * allocate_nonblocking ();
+	// Sleeps until \p action_a returns a buffer or the container is stopped
+	oslo::message_buffer * wait (std::function<oslo::message_buffer *()> const & action_a);
+	void notify ();
 	oslo::stat & stats;
 	std::mutex mutex;
 	oslo::condition_variable condition;
-	boost::circular_buffer<oslo::message_buffer *> free;
-	boost::circular_buffer<oslo::message_buffer *> full;
+	oslo::message_buffer_ring free;
+	oslo::message_buffer_ring full;
 	std::vector<uint8_t> slab;
 	std::vector<oslo::message_buffer> entries;
-	bool stopped;
+	std::atomic<unsigned> waiting{ 0 };
+	std::atomic<bool> stopped{ false };
 };
+/**
+  * Realtime TCP messages waiting for the packet processing threads, queued per peer.
+  * Peers are served by deficit round robin on message size, so a peer flooding messages only delays its own traffic.
+  * Peers whose channel belongs to a principal representative are queued in a separate lane which is served first.
+  * Messages from a peer with a full queue are dropped, the total number of queued messages still blocks the network threads.
+*/
 class tcp_message_manager final
 {
 public:
-	tcp_message_manager (unsigned incoming_connections_max_a);
+	tcp_message_manager (oslo::stat &, unsigned incoming_connections_max_a, std::function<bool(oslo::tcp_message_item const &)> is_priority_a);
 	void put_message (oslo::tcp_message_item const & item_a);
+	/** Queues all messages parsed from a single socket read under one lock, \p items_a is left empty */
+	void put_messages (std::vector<oslo::tcp_message_item> & items_a);
 	oslo::tcp_message_item get_message ();
 	// Stop container and notify waiting threads
 	void stop ();
+	size_t size ();
+	/** Number of messages dropped because the queue of \p endpoint_a was full */
+	uint64_t dropped (oslo::tcp_endpoint const & endpoint_a);
+	static size_t constexpr max_entries_per_peer = 128;
+	/** Bytes of messages a peer can dequeue each round */
+	static size_t constexpr quantum = 1024;
 
 private:
+	class peer_queue final
+	{
+	public:
+		std::deque<oslo::tcp_message_item> entries;
+		size_t deficit{ 0 };
+	};
+	bool put (oslo::tcp_message_item const &, bool);
+	oslo::tcp_message_item next ();
+	oslo::stat & stats;
+	std::function<bool(oslo::tcp_message_item const &)> is_priority;
 	std::mutex mutex;
 	oslo::condition_variable condition;
-	std::deque<oslo::tcp_message_item> entries;
+	std::unordered_map<oslo::tcp_endpoint, peer_queue> queues;
+	/** Peers with queued messages in round robin order */
+	std::deque<oslo::tcp_endpoint> active;
+	std::deque<oslo::tcp_endpoint> active_priority;
+	std::unordered_map<oslo::tcp_endpoint, uint64_t> drops;
+	size_t entries_count{ 0 };
 	unsigned max_entries;
 	static unsigned const max_entries_per_connection = 16;
 	bool stopped{ false };
+
+	friend std::unique_ptr<container_info_component> collect_container_info (tcp_message_manager &, const std::string &);
 };
+std::unique_ptr<container_info_component> collect_container_info (tcp_message_manager & tcp_message_manager, const std::string & name);
 /**
   * Node ID cookies for node ID handshakes
 */
@@ -112,6 +186,29 @@ private:
 	std::unordered_map<boost::asio::ip::address, unsigned> cookies_per_ip;
 	size_t max_cookies_per_ip;
 };
+/**
+ * Immutable list of the realtime channels, shared by floods and random peer selection without taking the channel container locks.
+ * Principal representatives are kept apart from other peers. The minimum protocol version and temporary channel filters are
+ * checked on the channels themselves while sampling, as those change without a channel being added or removed.
+ */
+class channel_snapshot final
+{
+public:
+	class entry final
+	{
+	public:
+		std::shared_ptr<oslo::transport::channel> channel;
+		// Set for TCP channels, which can be temporary
+		oslo::transport::channel_tcp const * tcp;
+	};
+	channel_snapshot (std::vector<entry>, std::vector<entry>);
+	/** Up to \p count_a distinct channels in random order, from all channels or only those which are not principal representatives */
+	std::vector<std::shared_ptr<oslo::transport::channel>> sample (size_t count_a, uint8_t minimum_version_a, bool include_temporary_a, bool include_representatives_a) const;
+	size_t size () const;
+	std::vector<entry> const representatives;
+	std::vector<entry> const others;
+	std::chrono::steady_clock::time_point const published;
+};
 class network final
 {
 public:
@@ -132,7 +229,10 @@ public:
 	void flood_block_initial (std::shared_ptr<oslo::block> const &);
 	// Flood block to a random selection of peers
 	void flood_block (std::shared_ptr<oslo::block> const &, oslo::buffer_drop_policy const = oslo::buffer_drop_policy::limiter);
-	void flood_block_many (std::deque<std::shared_ptr<oslo::block>>, std::function<void()> = nullptr, unsigned = broadcast_interval_ms);
+	/** Flood blocks of one type to a random selection of peers, as publish_batch messages to peers which understand them */
+	void flood_block_batch (std::vector<std::shared_ptr<oslo::block>> const &, oslo::buffer_drop_policy const = oslo::buffer_drop_policy::limiter);
+	/** Floods runs of up to publish_batch::max_blocks blocks of the same type, waiting about \p delay_a milliseconds between runs */
+	void flood_block_many (std::deque<std::shared_ptr<oslo::block>>, std::function<void()> = nullptr, unsigned delay_a = broadcast_interval_ms);
 	void merge_peers (std::array<oslo::endpoint, 8> const &);
 	void merge_peer (oslo::endpoint const &);
 	void send_keepalive (std::shared_ptr<oslo::transport::channel>);
@@ -170,6 +270,10 @@ public:
 	bool empty () const;
 	void erase (oslo::transport::channel const &);
 	void erase_below_version (uint8_t);
+	/** Current channel snapshot, republished if channels were added or removed or it is older than snapshot_interval */
+	std::shared_ptr<oslo::channel_snapshot const> snapshot () const;
+	/** Called by the channel containers when channels are added or removed */
+	void snapshot_invalidate ();
 	oslo::message_buffer_manager buffer_container;
 	boost::asio::ip::udp::resolver resolver;
 	std::vector<boost::thread> packet_processing_threads;
@@ -189,6 +293,13 @@ public:
 	static size_t const buffer_size = 512;
 	static size_t const confirm_req_hashes_max = 7;
 	static size_t const confirm_ack_hashes_max = 12;
+	static std::chrono::milliseconds constexpr snapshot_interval{ 1000 };
+
+private:
+	std::shared_ptr<oslo::channel_snapshot const> publish_snapshot () const;
+	// Read and replaced with std::atomic_load and std::atomic_store
+	mutable std::shared_ptr<oslo::channel_snapshot const> channels_snapshot;
+	mutable std::atomic<bool> snapshot_stale{ true };
 };
 std::unique_ptr<container_info_component> collect_container_info (network & network, const std::string & name);
 }
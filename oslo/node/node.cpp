@@ -104,6 +104,7 @@ wallets_store_impl (std::make_unique<oslo::mdb_wallets_store> (application_path_
 wallets_store (*wallets_store_impl),
 gap_cache (*this),
 ledger (store, stats, flags_a.generate_cache, [this]() { this->network.erase_below_version (network_params.protocol.protocol_version_min (true)); }),
+unchecked (store, ledger.cache, flags.unchecked_memory_max, flags.unchecked_memory_only),
 checker (config.signature_checker_threads),
 network (*this, config.peering_port),
 telemetry (std::make_shared<oslo::telemetry> (network, alarm, worker, observers.telemetry, stats, network_params, flags.disable_ongoing_telemetry_requests)),
@@ -122,11 +123,12 @@ block_processor_thread ([this]() {
 }),
 // clang-format on
 online_reps (ledger, network_params, config.online_weight_minimum.number ()),
-votes_cache (wallets),
+votes_cache (wallets, config.votes_cache_max_bytes),
 vote_uniquer (block_uniquer),
-confirmation_height_processor (ledger, write_database_queue, config.conf_height_processor_batch_min_time, logger, node_initialized_latch, flags.confirmation_height_processor_mode),
+confirmation_height_processor (ledger, write_database_queue, config.conf_height_processor_batch_min_time, logger, node_initialized_latch, flags.confirmation_height_processor_mode, config.confirmation_height_threads),
 active (*this, confirmation_height_processor),
-aggregator (network_params.network, config, stats, votes_cache, ledger, wallets, active),
+vote_batcher (stats, config.vote_batch_delay),
+aggregator (network_params.network, config, stats, votes_cache, ledger, wallets, active, vote_batcher),
 payment_observer_processor (observers.blocks),
 wallets (wallets_store.init_error (), *this),
 startup_time (std::chrono::steady_clock::now ()),
@@ -337,6 +339,7 @@ node_seq (seq)
 		logger.always_log ("Node starting, version: ", OSLO_VERSION_STRING);
 		logger.always_log ("Build information: ", BUILD_INFO);
 		logger.always_log ("Database backend: ", store.vendor_get ());
+		logger.always_log ("Network I/O backend: ", NETWORK_IO_BACKEND);
 
 		auto network_label = network_params.network.get_current_network_as_string ();
 		logger.always_log ("Active network: ", network_label);
@@ -423,9 +426,8 @@ node_seq (seq)
 			// Drop unchecked blocks if initial bootstrap is completed
 			if (!flags.disable_unchecked_drop && !use_bootstrap_weight && !flags.read_only)
 			{
-				auto transaction (store.tx_begin_write ({ tables::unchecked }));
-				store.unchecked_clear (transaction);
-				ledger.cache.unchecked_count = 0;
+				auto transaction (store.tx_begin_write ({ tables::unchecked, tables::unchecked_modified }));
+				unchecked.clear (transaction);
 				logger.always_log ("Dropping unchecked blocks");
 			}
 		}
@@ -563,6 +565,7 @@ std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (no
 	composite->add_component (collect_container_info (node.alarm, "alarm"));
 	composite->add_component (collect_container_info (node.work, "work"));
 	composite->add_component (collect_container_info (node.gap_cache, "gap_cache"));
+	composite->add_component (collect_container_info (node.unchecked, "unchecked"));
 	composite->add_component (collect_container_info (node.ledger, "ledger"));
 	composite->add_component (collect_container_info (node.active, "active"));
 	composite->add_component (collect_container_info (node.bootstrap_initiator, "bootstrap_initiator"));
@@ -586,6 +589,7 @@ std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (no
 	composite->add_component (collect_container_info (node.worker, "worker"));
 	composite->add_component (collect_container_info (node.distributed_work, "distributed_work"));
 	composite->add_component (collect_container_info (node.aggregator, "request_aggregator"));
+	composite->add_component (collect_container_info (node.vote_batcher, "vote_batcher"));
 	return composite;
 }
 
@@ -619,6 +623,7 @@ oslo::process_return oslo::node::process_local (std::shared_ptr<oslo::block> blo
 void oslo::node::start ()
 {
 	long_inactivity_cleanup ();
+	bootstrap_initiator.peer_scores.load ();
 	network.start ();
 	add_initial_peers ();
 	if (!flags.disable_legacy_bootstrap)
@@ -679,7 +684,14 @@ void oslo::node::stop ()
 		{
 			block_processor_thread.join ();
 		}
+		if (!flags.read_only && unchecked.memory_size () > 0)
+		{
+			// Keep unchecked blocks across restarts
+			auto transaction (store.tx_begin_write ({ tables::unchecked, tables::unchecked_modified }));
+			unchecked.flush (transaction);
+		}
 		aggregator.stop ();
+		vote_batcher.stop ();
 		vote_processor.stop ();
 		active.stop ();
 		confirmation_height_processor.stop ();
@@ -774,7 +786,7 @@ oslo::uint128_t oslo::node::minimum_principal_weight (oslo::uint128_t const & on
 void oslo::node::long_inactivity_cleanup ()
 {
 	bool perform_cleanup = false;
-	auto transaction (store.tx_begin_write ({ tables::online_weight, tables::peers }));
+	auto transaction (store.tx_begin_write ({ tables::bootstrap_peers, tables::online_weight, tables::peers }));
 	if (store.online_weight_count (transaction) > 0)
 	{
 		auto i (store.online_weight_begin (transaction));
@@ -792,6 +804,8 @@ void oslo::node::long_inactivity_cleanup ()
 	{
 		store.online_weight_clear (transaction);
 		store.peer_clear (transaction);
+		store.bootstrap_peer_clear (transaction);
+		online_reps.clear ();
 		logger.always_log ("Removed records of peers and online weight after a long period of inactivity");
 	}
 }
@@ -852,6 +866,7 @@ void oslo::node::ongoing_peer_store ()
 {
 	bool stored (network.tcp_channels.store_all (true));
 	network.udp_channels.store_all (!stored);
+	bootstrap_initiator.peer_scores.store ();
 	std::weak_ptr<oslo::node> node_w (shared_from_this ());
 	alarm.add (std::chrono::steady_clock::now () + network_params.node.peer_interval, [node_w]() {
 		if (auto node_l = node_w.lock ())
@@ -927,17 +942,31 @@ void oslo::node::unchecked_cleanup ()
 	// Collect old unchecked keys
 	if (!flags.disable_unchecked_cleanup && ledger.cache.block_count >= ledger.bootstrap_weight_max_blocks && !long_attempt)
 	{
-		auto now (oslo::seconds_since_epoch ());
-		auto transaction (store.tx_begin_read ());
-		// Max 1M records to clean, max 2 minutes reading to prevent slow i/o systems issues
-		for (auto i (store.unchecked_begin (transaction)), n (store.unchecked_end ()); i != n && cleaning_list.size () < 1024 * 1024 && oslo::seconds_since_epoch () - now < 120; ++i)
+		auto cutoff (oslo::seconds_since_epoch () - static_cast<uint64_t> (config.unchecked_cutoff_time.count ()));
+		// Memory entries are ordered by modified time, only expired ones are visited
+		auto expired (unchecked.erase_expired (cutoff));
+		for (auto const & block : expired)
+		{
+			digests.push_back (network.publish_filter.hash (block));
+		}
+		if (!expired.empty ())
+		{
+			logger.always_log (boost::str (boost::format ("Deleted %1% old unchecked blocks from memory") % expired.size ()));
+		}
+		// The unchecked table only holds entries which did not fit in memory
+		if (unchecked.table_size () > 0)
 		{
-			oslo::unchecked_key const & key (i->first);
-			oslo::unchecked_info const & info (i->second);
-			if ((now - info.modified) > static_cast<uint64_t> (config.unchecked_cutoff_time.count ()))
+			auto transaction (store.tx_begin_read ());
+			// The unchecked_modified table is ordered by modified time, iteration stops at the first entry which has not expired. Max 1M records to clean
+			for (auto i (store.unchecked_modified_begin (transaction)), n (store.unchecked_modified_end ()); i != n && i->first.modified () < cutoff && cleaning_list.size () < 1024 * 1024; ++i)
 			{
-				digests.push_back (network.publish_filter.hash (info.block));
-				cleaning_list.push_back (key);
+				oslo::unchecked_key const & key (i->first.key ());
+				auto existing (store.unchecked_begin (transaction, key));
+				if (existing != store.unchecked_end () && existing->first == key)
+				{
+					digests.push_back (network.publish_filter.hash (existing->second.block));
+					cleaning_list.push_back (key);
+				}
 			}
 		}
 	}
@@ -949,17 +978,12 @@ void oslo::node::unchecked_cleanup ()
 	while (!cleaning_list.empty ())
 	{
 		size_t deleted_count (0);
-		auto transaction (store.tx_begin_write ({ tables::unchecked }));
+		auto transaction (store.tx_begin_write ({ tables::unchecked, tables::unchecked_modified }));
 		while (deleted_count++ < 2 * 1024 && !cleaning_list.empty ())
 		{
 			auto key (cleaning_list.front ());
 			cleaning_list.pop_front ();
-			if (store.unchecked_exists (transaction, key))
-			{
-				store.unchecked_del (transaction, key);
-				debug_assert (ledger.cache.unchecked_count > 0);
-				--ledger.cache.unchecked_count;
-			}
+			unchecked.del (transaction, key);
 		}
 	}
 	// Delete from the duplicate filter
@@ -23,6 +23,8 @@
 #include <oslo/node/request_aggregator.hpp>
 #include <oslo/node/signatures.hpp>
 #include <oslo/node/telemetry.hpp>
+#include <oslo/node/unchecked_map.hpp>
+#include <oslo/node/vote_batcher.hpp>
 #include <oslo/node/vote_processor.hpp>
 #include <oslo/node/wallet.hpp>
 #include <oslo/node/write_database_queue.hpp>
@@ -167,6 +169,7 @@ public:
 	oslo::wallets_store & wallets_store;
 	oslo::gap_cache gap_cache;
 	oslo::ledger ledger;
+	oslo::unchecked_map unchecked;
 	oslo::signature_checker checker;
 	oslo::network network;
 	std::shared_ptr<oslo::telemetry> telemetry;
@@ -188,6 +191,7 @@ public:
 	oslo::vote_uniquer vote_uniquer;
 	oslo::confirmation_height_processor confirmation_height_processor;
 	oslo::active_transactions active;
+	oslo::vote_batcher vote_batcher;
 	oslo::request_aggregator aggregator;
 	oslo::payment_observer_processor payment_observer_processor;
 	oslo::wallets wallets;
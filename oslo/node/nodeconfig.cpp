@@ -10,6 +10,8 @@
 
 #include <boost/format.hpp>
 
+#include <numeric>
+
 namespace
 {
 const char * preconfigured_peers_key = "preconfigured_peers";
@@ -17,6 +19,7 @@ const char * signature_checker_threads_key = "signature_checker_threads";
 const char * pow_sleep_interval_key = "pow_sleep_interval";
 const char * default_beta_peer_network = "peering-beta.oslo.vidaru.org";
 const char * default_live_peer_network = "peering.oslo.vidaru.org";
+std::array<char const *, 6> const bandwidth_share_keys{ { "vote", "publish", "confirm_req", "bootstrap", "telemetry", "other" } };
 }
 
 oslo::node_config::node_config () :
@@ -78,6 +81,9 @@ oslo::error oslo::node_config::serialize_toml (oslo::tomlconfig & toml) const
 	toml.put ("vote_minimum", vote_minimum.to_string_dec (), "Local representatives do not vote if the delegated weight is under this threshold. Saves on system resources.\ntype:string,amount,raw");
 	toml.put ("vote_generator_delay", vote_generator_delay.count (), "Delay before votes are sent to allow for efficient bundling of hashes in votes.\ntype:milliseconds");
 	toml.put ("vote_generator_threshold", vote_generator_threshold, "Number of bundled hashes required for an additional generator delay.\ntype:uint64,[1..11]");
+	toml.put ("vote_batch_delay", vote_batch_delay.count (), "Maximum time outgoing votes wait to be sent in a single write with other votes to the same peer. 0 sends each vote directly.\ntype:milliseconds");
+	toml.put ("vote_generator_threads", vote_generator_threads, "Number of additional threads dedicated to signing generated votes. Defaults to number of CPU threads / 4, at most 2.\ntype:uint64");
+	toml.put ("votes_cache_max_bytes", votes_cache_max_bytes, "Approximate memory limit of the cache of generated votes, shared by the local voting representatives.\ntype:uint64");
 	toml.put ("unchecked_cutoff_time", unchecked_cutoff_time.count (), "Number of seconds before deleting an unchecked entry.\nWarning: lower values (e.g., 3600 seconds, or 1 hour) may result in unsuccessful bootstraps, especially a bootstrap from scratch.\ntype:seconds");
 	toml.put ("tcp_io_timeout", tcp_io_timeout.count (), "Timeout for TCP connect-, read- and write operations.\nWarning: a low value (e.g., below 5 seconds) may result in TCP connections failing.\ntype:seconds");
 	toml.put ("pow_sleep_interval", pow_sleep_interval.count (), "Time to sleep between batch work generation attempts. Reduces max CPU usage at the expense of a longer generation time.\ntype:nanoseconds");
@@ -89,12 +95,15 @@ oslo::error oslo::node_config::serialize_toml (oslo::tomlconfig & toml) const
 	toml.put ("active_elections_size", active_elections_size, "Number of active elections. Elections beyond this limit have limited survival time.\nWarning: modifying this value may result in a lower confirmation rate.\ntype:uint64,[250..]");
 	toml.put ("bandwidth_limit", bandwidth_limit, "Outbound traffic limit in bytes/sec after which messages will be dropped.\nNote: changing to unlimited bandwidth (0) is not recommended for limited connections.\ntype:uint64");
 	toml.put ("bandwidth_limit_burst_ratio", bandwidth_limit_burst_ratio, "Burst ratio for outbound traffic shaping.\ntype:double");
+	toml.put ("bandwidth_limit_per_peer", bandwidth_limit_per_peer, "Outbound traffic limit to a single peer in bytes/sec. 0 disables the per peer limit.\ntype:uint64");
 	toml.put ("conf_height_processor_batch_min_time", conf_height_processor_batch_min_time.count (), "Minimum write batching time when there are blocks pending confirmation height.\ntype:milliseconds");
 	toml.put ("backup_before_upgrade", backup_before_upgrade, "Backup the ledger database before performing upgrades.\nWarning: uses more disk storage and increases startup time when upgrading.\ntype:bool");
 	toml.put ("work_watcher_period", work_watcher_period.count (), "Time between checks for confirmation and re-generating higher difficulty work if unconfirmed, for blocks in the work watcher.\ntype:seconds");
 	toml.put ("max_work_generate_multiplier", max_work_generate_multiplier, "Maximum allowed difficulty multiplier for work generation.\ntype:double,[1..]");
 	toml.put ("frontiers_confirmation", serialize_frontiers_confirmation (frontiers_confirmation), "Mode controlling frontier confirmation rate.\ntype:string,{auto,always,disabled}");
 	toml.put ("max_queued_requests", max_queued_requests, "Limit for number of queued confirmation requests for one channel, after which new requests are dropped until the queue drops below this value.\ntype:uint32");
+	toml.put ("request_aggregator_threads", request_aggregator_threads, "Number of threads processing queued confirmation requests. Defaults to number of CPU threads / 2, between 1 and 4.\ntype:uint64,[1..]");
+	toml.put ("confirmation_height_threads", confirmation_height_threads, "Number of threads cementing blocks of independent accounts concurrently when many blocks are awaiting confirmation height. 1 disables parallel cementing. Defaults to number of CPU threads / 2, between 1 and 4.\ntype:uint64,[1..]");
 
 	auto work_peers_l (toml.create_array ("work_peers", "A list of \"address:port\" entries to identify work peers."));
 	for (auto i (work_peers.begin ()), n (work_peers.end ()); i != n; ++i)
@@ -123,6 +132,13 @@ oslo::error oslo::node_config::serialize_toml (oslo::tomlconfig & toml) const
 	}
 	toml.put_child ("experimental", experimental_l);
 
+	oslo::tomlconfig bandwidth_shares_l;
+	for (size_t i (0); i < bandwidth_share_keys.size (); ++i)
+	{
+		bandwidth_shares_l.put (bandwidth_share_keys[i], bandwidth_shares[i], "Relative share of bandwidth_limit reserved for this message class. Unused share is lent to other classes.\ntype:uint32");
+	}
+	toml.put_child ("bandwidth_shares", bandwidth_shares_l);
+
 	oslo::tomlconfig callback_l;
 	callback_l.put ("address", callback_address, "Callback address.\ntype:string,ip");
 	callback_l.put ("port", callback_port, "Callback port number.\ntype:uint16");
@@ -278,6 +294,13 @@ oslo::error oslo::node_config::deserialize_toml (oslo::tomlconfig & toml)
 
 		toml.get<unsigned> ("vote_generator_threshold", vote_generator_threshold);
 
+		auto vote_batch_delay_l = vote_batch_delay.count ();
+		toml.get ("vote_batch_delay", vote_batch_delay_l);
+		vote_batch_delay = std::chrono::milliseconds (vote_batch_delay_l);
+
+		toml.get<unsigned> ("vote_generator_threads", vote_generator_threads);
+		toml.get<size_t> ("votes_cache_max_bytes", votes_cache_max_bytes);
+
 		auto block_processor_batch_max_time_l = block_processor_batch_max_time.count ();
 		toml.get ("block_processor_batch_max_time", block_processor_batch_max_time_l);
 		block_processor_batch_max_time = std::chrono::milliseconds (block_processor_batch_max_time_l);
@@ -341,6 +364,15 @@ oslo::error oslo::node_config::deserialize_toml (oslo::tomlconfig & toml)
 		toml.get<size_t> ("active_elections_size", active_elections_size);
 		toml.get<size_t> ("bandwidth_limit", bandwidth_limit);
 		toml.get<double> ("bandwidth_limit_burst_ratio", bandwidth_limit_burst_ratio);
+		toml.get<size_t> ("bandwidth_limit_per_peer", bandwidth_limit_per_peer);
+		if (toml.has_key ("bandwidth_shares"))
+		{
+			auto bandwidth_shares_l (toml.get_required_child ("bandwidth_shares"));
+			for (size_t i (0); i < bandwidth_share_keys.size (); ++i)
+			{
+				bandwidth_shares_l.get<unsigned> (bandwidth_share_keys[i], bandwidth_shares[i]);
+			}
+		}
 		toml.get<bool> ("backup_before_upgrade", backup_before_upgrade);
 
 		auto work_watcher_period_l = work_watcher_period.count ();
@@ -355,6 +387,8 @@ oslo::error oslo::node_config::deserialize_toml (oslo::tomlconfig & toml)
 		toml.get<double> ("max_work_generate_multiplier", max_work_generate_multiplier);
 
 		toml.get<uint32_t> ("max_queued_requests", max_queued_requests);
+		toml.get<unsigned> ("request_aggregator_threads", request_aggregator_threads);
+		toml.get<unsigned> ("confirmation_height_threads", confirmation_height_threads);
 
 		if (toml.has_key ("frontiers_confirmation"))
 		{
@@ -396,6 +430,10 @@ oslo::error oslo::node_config::deserialize_toml (oslo::tomlconfig & toml)
 		{
 			toml.get_error ().set ("bandwidth_limit unbounded = 0, default = 10485760, max = 18446744073709551615");
 		}
+		if (std::accumulate (bandwidth_shares.begin (), bandwidth_shares.end (), 0ull) == 0)
+		{
+			toml.get_error ().set ("bandwidth_shares must not all be zero");
+		}
 		if (vote_generator_threshold < 1 || vote_generator_threshold > 11)
 		{
 			toml.get_error ().set ("vote_generator_threshold must be a number between 1 and 11");
@@ -408,6 +446,14 @@ oslo::error oslo::node_config::deserialize_toml (oslo::tomlconfig & toml)
 		{
 			toml.get_error ().set ("max_work_generate_multiplier must be greater than or equal to 1");
 		}
+		if (request_aggregator_threads == 0)
+		{
+			toml.get_error ().set ("request_aggregator_threads must be non-zero");
+		}
+		if (confirmation_height_threads == 0)
+		{
+			toml.get_error ().set ("confirmation_height_threads must be non-zero");
+		}
 		if (frontiers_confirmation == oslo::frontiers_confirmation_mode::invalid)
 		{
 			toml.get_error ().set ("frontiers_confirmation value is invalid (available: always, auto, disabled)");
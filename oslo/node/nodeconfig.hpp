@@ -13,6 +13,7 @@
 #include <oslo/node/websocketconfig.hpp>
 #include <oslo/secure/common.hpp>
 
+#include <array>
 #include <chrono>
 #include <vector>
 
@@ -54,6 +55,12 @@ public:
 	oslo::amount vote_minimum{ oslo::Gxrb_ratio };
 	std::chrono::milliseconds vote_generator_delay{ std::chrono::milliseconds (100) };
 	unsigned vote_generator_threshold{ 3 };
+	/** Time outgoing votes wait to be written together with other votes to the same TCP channel, 0 sends each vote directly */
+	std::chrono::milliseconds vote_batch_delay{ std::chrono::milliseconds (5) };
+	/** Additional threads signing batches of generated votes, the voting thread signs as well */
+	unsigned vote_generator_threads{ std::min<unsigned> (2, std::thread::hardware_concurrency () / 4) };
+	/** Memory for votes generated by local representatives kept to answer repeated confirmation requests */
+	size_t votes_cache_max_bytes{ 16 * 1024 * 1024 };
 	oslo::amount online_weight_minimum{ 60000 * oslo::Gxrb_ratio };
 	unsigned online_weight_quorum{ 50 };
 	unsigned password_fanout{ 1024 };
@@ -94,11 +101,19 @@ public:
 	size_t bandwidth_limit{ 10 * 1024 * 1024 };
 	/** By default, allow bursts of 15MB/s (not sustainable) */
 	double bandwidth_limit_burst_ratio{ 3. };
+	/** Relative shares of bandwidth_limit for vote, publish, confirm_req, bootstrap, telemetry and other messages, unused share is lent to other classes */
+	std::array<unsigned, 6> bandwidth_shares{ { 40, 25, 15, 10, 5, 5 } };
+	/** Outbound traffic limit to a single peer in bytes/sec, 0 for no per peer limit */
+	size_t bandwidth_limit_per_peer{ 0 };
 	std::chrono::milliseconds conf_height_processor_batch_min_time{ 50 };
 	bool backup_before_upgrade{ false };
 	std::chrono::seconds work_watcher_period{ std::chrono::seconds (5) };
 	double max_work_generate_multiplier{ 64. };
 	uint32_t max_queued_requests{ 512 };
+	/** Number of threads replying to confirmation requests */
+	unsigned request_aggregator_threads{ std::max<unsigned> (1, std::min<unsigned> (4, std::thread::hardware_concurrency () / 2)) };
+	/** Number of threads cementing independent account chains when many blocks are queued for confirmation height */
+	unsigned confirmation_height_threads{ std::max<unsigned> (1, std::min<unsigned> (4, std::thread::hardware_concurrency () / 2)) };
 	oslo::rocksdb_config rocksdb_config;
 	oslo::lmdb_config lmdb_config;
 	oslo::frontiers_confirmation_mode frontiers_confirmation{ oslo::frontiers_confirmation_mode::automatic };
@@ -128,17 +143,23 @@ public:
 	bool disable_request_loop{ false };
 	bool disable_tcp_realtime{ false };
 	bool disable_udp{ true };
+	/** Use one socket call per datagram instead of recvmmsg and sendmmsg batches on Linux */
+	bool disable_udp_batching{ false };
 	bool disable_unchecked_cleanup{ false };
 	bool disable_unchecked_drop{ true };
 	bool disable_providing_telemetry_metrics{ false };
 	bool disable_ongoing_telemetry_requests{ false };
 	bool disable_initial_telemetry_requests{ false };
 	bool disable_block_processor_unchecked_deletion{ false };
+	/** Keep unchecked blocks only in memory, dropping the oldest ones instead of writing them to the unchecked table */
+	bool unchecked_memory_only{ false };
 	bool disable_block_processor_republishing{ false };
 	bool allow_bootstrap_peers_duplicates{ false };
 	bool disable_max_peers_per_ip{ false }; // For testing only
 	bool fast_bootstrap{ false };
 	bool read_only{ false };
+	/** File of cemented frontiers trusted while bootstrapping, see oslo::bootstrap_checkpoint */
+	std::string bootstrap_checkpoint;
 	oslo::confirmation_height_mode confirmation_height_processor_mode{ oslo::confirmation_height_mode::automatic };
 	oslo::generate_cache generate_cache;
 	bool inactive_node{ false };
@@ -148,5 +169,6 @@ public:
 	size_t block_processor_verification_size{ 0 };
 	size_t inactive_votes_cache_size{ 16 * 1024 };
 	size_t vote_processor_capacity{ 144 * 1024 };
+	size_t unchecked_memory_max{ 64 * 1024 };
 };
 }
@@ -6,60 +6,85 @@
 oslo::online_reps::online_reps (oslo::ledger & ledger_a, oslo::network_params & network_params_a, oslo::uint128_t minimum_a) :
 ledger (ledger_a),
 network_params (network_params_a),
+samples (network_params_a.node.max_weight_samples),
 minimum (minimum_a)
 {
 	if (!ledger.store.init_error ())
 	{
 		auto transaction (ledger.store.tx_begin_read ());
-		online = trend (transaction);
+		for (auto i (ledger.store.online_weight_begin (transaction)), n (ledger.store.online_weight_end ()); i != n; ++i)
+		{
+			samples.push_back (i->second.number ());
+		}
 	}
+	trended_set (trend ());
+	ledger.cache.rep_weights.observe ([this](oslo::account const & rep_a, oslo::uint128_t const &, oslo::uint128_t const & weight_a) {
+		weight_changed (rep_a, weight_a);
+	});
+}
+
+oslo::online_reps::~online_reps ()
+{
+	ledger.cache.rep_weights.observe (nullptr);
 }
 
 void oslo::online_reps::observe (oslo::account const & rep_a)
 {
-	if (ledger.weight (rep_a) > 0)
+	// Weight is read before locking, weight_changed is called with rep_weights locked and takes this mutex
+	auto weight (ledger.weight (rep_a));
+	if (weight > 0)
 	{
 		oslo::lock_guard<std::mutex> lock (mutex);
-		reps.insert (rep_a);
+		if (reps.emplace (rep_a, weight).second)
+		{
+			current += weight;
+		}
 	}
 }
 
-void oslo::online_reps::sample ()
+void oslo::online_reps::weight_changed (oslo::account const & rep_a, oslo::uint128_t const & weight_a)
 {
-	auto transaction (ledger.store.tx_begin_write ({ tables::online_weight }));
-	// Discard oldest entries
-	while (ledger.store.online_weight_count (transaction) >= network_params.node.max_weight_samples)
+	oslo::lock_guard<std::mutex> lock (mutex);
+	auto existing (reps.find (rep_a));
+	if (existing != reps.end ())
 	{
-		auto oldest (ledger.store.online_weight_begin (transaction));
-		debug_assert (oldest != ledger.store.online_weight_end ());
-		ledger.store.online_weight_del (transaction, oldest->first);
+		current = current - existing->second + weight_a;
+		existing->second = weight_a;
 	}
-	// Calculate current active rep weight
-	oslo::uint128_t current;
-	std::unordered_set<oslo::account> reps_copy;
+}
+
+void oslo::online_reps::sample ()
+{
+	// Observed representatives expire at each sample
+	oslo::uint128_t current_l;
 	{
 		oslo::lock_guard<std::mutex> lock (mutex);
-		reps_copy.swap (reps);
+		current_l = current;
+		current = 0;
+		reps.clear ();
 	}
-	for (auto & i : reps_copy)
 	{
-		current += ledger.weight (i);
+		auto transaction (ledger.store.tx_begin_write ({ tables::online_weight }));
+		// Discard oldest entries
+		while (ledger.store.online_weight_count (transaction) >= network_params.node.max_weight_samples)
+		{
+			auto oldest (ledger.store.online_weight_begin (transaction));
+			debug_assert (oldest != ledger.store.online_weight_end ());
+			ledger.store.online_weight_del (transaction, oldest->first);
+		}
+		ledger.store.online_weight_put (transaction, std::chrono::system_clock::now ().time_since_epoch ().count (), current_l);
 	}
-	ledger.store.online_weight_put (transaction, std::chrono::system_clock::now ().time_since_epoch ().count (), current);
-	auto trend_l (trend (transaction));
 	oslo::lock_guard<std::mutex> lock (mutex);
-	online = trend_l;
+	samples.push_back (current_l);
+	trended_set (trend ());
 }
 
-oslo::uint128_t oslo::online_reps::trend (oslo::transaction & transaction_a)
+oslo::uint128_t oslo::online_reps::trend ()
 {
 	std::vector<oslo::uint128_t> items;
-	items.reserve (network_params.node.max_weight_samples + 1);
+	items.reserve (samples.size () + 1);
 	items.push_back (minimum);
-	for (auto i (ledger.store.online_weight_begin (transaction_a)), n (ledger.store.online_weight_end ()); i != n; ++i)
-	{
-		items.push_back (i->second.number ());
-	}
+	items.insert (items.end (), samples.begin (), samples.end ());
 
 	// Pick median value for our target vote weight
 	auto median_idx = items.size () / 2;
@@ -67,30 +92,69 @@ oslo::uint128_t oslo::online_reps::trend (oslo::transaction & transaction_a)
 	return oslo::uint128_t{ items[median_idx] };
 }
 
+void oslo::online_reps::trended_set (oslo::uint128_t const & trended_a)
+{
+	auto sequence (trended_sequence.load (std::memory_order_relaxed));
+	trended_sequence.store (sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence (std::memory_order_release);
+	trended[0].store (static_cast<uint64_t> (trended_a), std::memory_order_relaxed);
+	trended[1].store (static_cast<uint64_t> (trended_a >> 64), std::memory_order_relaxed);
+	trended_sequence.store (sequence + 2, std::memory_order_release);
+}
+
 oslo::uint128_t oslo::online_reps::online_stake () const
+{
+	uint64_t sequence;
+	uint64_t low;
+	uint64_t high;
+	do
+	{
+		sequence = trended_sequence.load (std::memory_order_acquire);
+		low = trended[0].load (std::memory_order_relaxed);
+		high = trended[1].load (std::memory_order_relaxed);
+		std::atomic_thread_fence (std::memory_order_acquire);
+	} while ((sequence & 1) != 0 || sequence != trended_sequence.load (std::memory_order_relaxed));
+	return std::max ((oslo::uint128_t (high) << 64) | low, minimum);
+}
+
+oslo::uint128_t oslo::online_reps::online () const
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
-	return std::max (online, minimum);
+	return current;
 }
 
 std::vector<oslo::account> oslo::online_reps::list ()
 {
 	std::vector<oslo::account> result;
 	oslo::lock_guard<std::mutex> lock (mutex);
-	result.insert (result.end (), reps.begin (), reps.end ());
+	result.reserve (reps.size ());
+	for (auto const & rep : reps)
+	{
+		result.push_back (rep.first);
+	}
 	return result;
 }
 
+void oslo::online_reps::clear ()
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	samples.clear ();
+	trended_set (trend ());
+}
+
 std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (online_reps & online_reps, const std::string & name)
 {
 	size_t count;
+	size_t samples_count;
 	{
 		oslo::lock_guard<std::mutex> guard (online_reps.mutex);
 		count = online_reps.reps.size ();
+		samples_count = online_reps.samples.size ();
 	}
 
 	auto sizeof_element = sizeof (decltype (online_reps.reps)::value_type);
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "reps", count, sizeof_element }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "samples", samples_count, sizeof (decltype (online_reps.samples)::value_type) }));
 	return composite;
 }
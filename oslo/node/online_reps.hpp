@@ -3,37 +3,55 @@
 #include <oslo/lib/numbers.hpp>
 #include <oslo/lib/utility.hpp>
 
+#include <boost/circular_buffer.hpp>
+
+#include <array>
+#include <atomic>
 #include <memory>
-#include <unordered_set>
+#include <unordered_map>
 #include <vector>
 
 namespace oslo
 {
 class ledger;
 class network_params;
-class transaction;
 
-/** Track online representatives and trend online weight */
+/**
+ * Track online representatives and trend online weight
+ * The weight of representatives observed in the current period is summed incrementally, following weight changes reported by the ledger's rep_weights.
+ * Samples are kept in a ring buffer mirrored to the online_weight table.
+ */
 class online_reps final
 {
 public:
 	online_reps (oslo::ledger & ledger_a, oslo::network_params & network_params_a, oslo::uint128_t minimum_a);
+	~online_reps ();
 	/** Add voting account \p rep_account to the set of online representatives */
 	void observe (oslo::account const & rep_account);
 	/** Called periodically to sample online weight */
 	void sample ();
-	/** Returns the trended online stake, but never less than configured minimum */
+	/** Returns the trended online stake, but never less than configured minimum. Does not block */
 	oslo::uint128_t online_stake () const;
+	/** Weight of the representatives observed since the last sample */
+	oslo::uint128_t online () const;
 	/** List of online representatives */
 	std::vector<oslo::account> list ();
+	/** Discards samples, used when the online_weight table is cleared */
+	void clear ();
 
 private:
-	oslo::uint128_t trend (oslo::transaction &);
+	void weight_changed (oslo::account const &, oslo::uint128_t const &);
+	oslo::uint128_t trend ();
+	void trended_set (oslo::uint128_t const &);
 	mutable std::mutex mutex;
 	oslo::ledger & ledger;
 	oslo::network_params & network_params;
-	std::unordered_set<oslo::account> reps;
-	oslo::uint128_t online;
+	std::unordered_map<oslo::account, oslo::uint128_t> reps;
+	oslo::uint128_t current{ 0 };
+	boost::circular_buffer<oslo::uint128_t> samples;
+	/** Trended weight published as two 64-bit halves guarded by a sequence counter, odd while a write is in progress */
+	std::atomic<uint64_t> trended_sequence{ 0 };
+	std::array<std::atomic<uint64_t>, 2> trended{};
 	oslo::uint128_t minimum;
 
 	friend std::unique_ptr<container_info_component> collect_container_info (online_reps & online_reps, const std::string & name);
@@ -6,12 +6,13 @@
 #include <oslo/node/nodeconfig.hpp>
 #include <oslo/node/request_aggregator.hpp>
 #include <oslo/node/transport/udp.hpp>
+#include <oslo/node/vote_batcher.hpp>
 #include <oslo/node/voting.hpp>
 #include <oslo/node/wallet.hpp>
 #include <oslo/secure/blockstore.hpp>
 #include <oslo/secure/ledger.hpp>
 
-oslo::request_aggregator::request_aggregator (oslo::network_constants const & network_constants_a, oslo::node_config const & config_a, oslo::stat & stats_a, oslo::votes_cache & cache_a, oslo::ledger & ledger_a, oslo::wallets & wallets_a, oslo::active_transactions & active_a) :
+oslo::request_aggregator::request_aggregator (oslo::network_constants const & network_constants_a, oslo::node_config const & config_a, oslo::stat & stats_a, oslo::votes_cache & cache_a, oslo::ledger & ledger_a, oslo::wallets & wallets_a, oslo::active_transactions & active_a, oslo::vote_batcher & vote_batcher_a) :
 max_delay (network_constants_a.is_test_network () ? 50 : 300),
 small_delay (network_constants_a.is_test_network () ? 10 : 50),
 max_channel_requests (config_a.max_queued_requests),
@@ -20,10 +21,15 @@ votes_cache (cache_a),
 ledger (ledger_a),
 wallets (wallets_a),
 active (active_a),
-thread ([this]() { run (); })
+vote_batcher (vote_batcher_a)
 {
+	auto const threads_count (std::max<unsigned> (1, config_a.request_aggregator_threads));
+	for (auto i (0u); i < threads_count; ++i)
+	{
+		threads.emplace_back ([this]() { run (); });
+	}
 	oslo::unique_lock<std::mutex> lock (mutex);
-	condition.wait (lock, [& started = started] { return started; });
+	condition.wait (lock, [& started = started, threads_count] { return started == threads_count; });
 }
 
 void oslo::request_aggregator::add (std::shared_ptr<oslo::transport::channel> & channel_a, std::vector<std::pair<oslo::block_hash, oslo::root>> const & hashes_roots_a)
@@ -65,8 +71,11 @@ void oslo::request_aggregator::add (std::shared_ptr<oslo::transport::channel> &
 void oslo::request_aggregator::run ()
 {
 	oslo::thread_role::set (oslo::thread_role::name::request_aggregator);
+	// Each worker keeps its own read transaction, renewed for every pool instead of being recreated
+	auto transaction (ledger.store.tx_begin_read ());
+	transaction.reset ();
 	oslo::unique_lock<std::mutex> lock (mutex);
-	started = true;
+	++started;
 	lock.unlock ();
 	condition.notify_all ();
 	lock.lock ();
@@ -88,13 +97,14 @@ void oslo::request_aggregator::run ()
 				requests_by_deadline.erase (front);
 				lock.unlock ();
 				erase_duplicates (hashes_roots);
-				auto transaction (ledger.store.tx_begin_read ());
+				transaction.renew ();
 				auto remaining = aggregate (transaction, hashes_roots, channel);
 				if (!remaining.empty ())
 				{
 					// Generate votes for the remaining hashes
 					generate (transaction, remaining, channel);
 				}
+				transaction.reset ();
 				lock.lock ();
 			}
 			else
@@ -117,9 +127,12 @@ void oslo::request_aggregator::stop ()
 		stopped = true;
 	}
 	condition.notify_all ();
-	if (thread.joinable ())
+	for (auto & thread : threads)
 	{
-		thread.join ();
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
 	}
 }
 
@@ -231,8 +244,7 @@ std::vector<oslo::block_hash> oslo::request_aggregator::aggregate (oslo::transac
 	cached_votes.erase (std::unique (cached_votes.begin (), cached_votes.end ()), cached_votes.end ());
 	for (auto const & vote : cached_votes)
 	{
-		oslo::confirm_ack confirm (vote);
-		channel_a->send (confirm);
+		vote_batcher.add (channel_a, vote);
 	}
 	stats.add (oslo::stat::type::requests, oslo::stat::detail::requests_cached_hashes, stat::dir::in, cached_hashes);
 	stats.add (oslo::stat::type::requests, oslo::stat::detail::requests_cached_votes, stat::dir::in, cached_votes.size ());
@@ -254,8 +266,7 @@ void oslo::request_aggregator::generate (oslo::transaction const & transaction_a
 		wallets.foreach_representative ([this, &generated_l, &hashes_l, &channel_a, &transaction_a](oslo::public_key const & pub_a, oslo::raw_key const & prv_a) {
 			auto vote (this->ledger.store.vote_generate (transaction_a, pub_a, prv_a, hashes_l));
 			++generated_l;
-			oslo::confirm_ack confirm (vote);
-			channel_a->send (confirm);
+			this->vote_batcher.add (channel_a, vote);
 			this->votes_cache.add (vote);
 		});
 	}
@@ -21,6 +21,7 @@ class active_transactions;
 class ledger;
 class node_config;
 class stat;
+class vote_batcher;
 class votes_cache;
 class wallets;
 /**
@@ -30,6 +31,7 @@ class wallets;
  * * A request arrives for hashes {1,4,5}. Another request arrives soon afterwards for hashes {2,3,6}
  * * The aggregator will reply with the two cached votes
  * Votes are generated for uncached hashes.
+ * Pools are processed by several workers in deadline order, so replies with cached votes are not held back by vote generation for other channels.
  */
 class request_aggregator final
 {
@@ -59,7 +61,7 @@ class request_aggregator final
 
 public:
 	request_aggregator () = delete;
-	request_aggregator (oslo::network_constants const &, oslo::node_config const & config, oslo::stat & stats_a, oslo::votes_cache &, oslo::ledger &, oslo::wallets &, oslo::active_transactions &);
+	request_aggregator (oslo::network_constants const &, oslo::node_config const & config, oslo::stat & stats_a, oslo::votes_cache &, oslo::ledger &, oslo::wallets &, oslo::active_transactions &, oslo::vote_batcher &);
 
 	/** Add a new request by \p channel_a for hashes \p hashes_roots_a */
 	void add (std::shared_ptr<oslo::transport::channel> & channel_a, std::vector<std::pair<oslo::block_hash, oslo::root>> const & hashes_roots_a);
@@ -86,6 +88,7 @@ private:
 	oslo::ledger & ledger;
 	oslo::wallets & wallets;
 	oslo::active_transactions & active;
+	oslo::vote_batcher & vote_batcher;
 
 	// clang-format off
 	boost::multi_index_container<channel_pool,
@@ -98,10 +101,10 @@ private:
 	// clang-format on
 
 	bool stopped{ false };
-	bool started{ false };
+	unsigned started{ 0 };
 	oslo::condition_variable condition;
 	std::mutex mutex;
-	std::thread thread;
+	std::vector<std::thread> threads;
 
 	friend std::unique_ptr<container_info_component> collect_container_info (request_aggregator &, const std::string &);
 };
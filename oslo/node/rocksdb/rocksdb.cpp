@@ -74,7 +74,7 @@ oslo::rocksdb_store::~rocksdb_store ()
 
 void oslo::rocksdb_store::open (bool & error_a, boost::filesystem::path const & path_a, bool open_read_only_a)
 {
-	std::initializer_list<const char *> names{ rocksdb::kDefaultColumnFamilyName.c_str (), "frontiers", "accounts", "send", "receive", "open", "change", "state_blocks", "pending", "representation", "unchecked", "vote", "online_weight", "meta", "peers", "cached_counts", "confirmation_height" };
+	std::initializer_list<const char *> names{ rocksdb::kDefaultColumnFamilyName.c_str (), "frontiers", "accounts", "send", "receive", "open", "change", "state_blocks", "pending", "representation", "unchecked", "vote", "online_weight", "meta", "peers", "cached_counts", "confirmation_height", "bootstrap_peers", "unchecked_modified" };
 	std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
 	for (const auto & cf_name : names)
 	{
@@ -102,14 +102,32 @@ void oslo::rocksdb_store::open (bool & error_a, boost::filesystem::path const &
 
 	if (!error_a)
 	{
-		auto transaction = tx_begin_read ();
-		auto version_l = version_get (transaction);
+		auto version_l = version_get (tx_begin_read ());
 		if (version_l > version)
 		{
 			error_a = true;
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
 		}
+		else if (version_l < version && !open_read_only_a)
+		{
+			// Ledgers written before the version was stored read as version 1, the only upgrade needed is the unchecked_modified index
+			auto transaction (tx_begin_write ());
+			upgrade_unchecked_modified (transaction);
+		}
+	}
+}
+
+void oslo::rocksdb_store::upgrade_unchecked_modified (oslo::write_transaction const & transaction_a)
+{
+	logger.always_log ("Preparing unchecked modified index upgrade...");
+	size_t count (0);
+	for (auto i (unchecked_begin (transaction_a)), n (unchecked_end ()); i != n; ++i, ++count)
+	{
+		auto status (put (transaction_a, tables::unchecked_modified, oslo::unchecked_modified_key (i->second.modified, i->first), oslo::rocksdb_val (static_cast<uint64_t> (0))));
+		release_assert (success (status));
 	}
+	version_put (transaction_a, version);
+	logger.always_log (boost::str (boost::format ("Finished indexing %1% unchecked blocks by modified time") % count));
 }
 
 oslo::write_transaction oslo::rocksdb_store::tx_begin_write (std::vector<oslo::tables> const & tables_requiring_locks_a, std::vector<oslo::tables> const & tables_no_locks_a)
@@ -177,6 +195,8 @@ rocksdb::ColumnFamilyHandle * oslo::rocksdb_store::table_to_column_family (table
 			return get_handle ("representation");
 		case tables::unchecked:
 			return get_handle ("unchecked");
+		case tables::unchecked_modified:
+			return get_handle ("unchecked_modified");
 		case tables::vote:
 			return get_handle ("vote");
 		case tables::online_weight:
@@ -185,6 +205,8 @@ rocksdb::ColumnFamilyHandle * oslo::rocksdb_store::table_to_column_family (table
 			return get_handle ("meta");
 		case tables::peers:
 			return get_handle ("peers");
+		case tables::bootstrap_peers:
+			return get_handle ("bootstrap_peers");
 		case tables::cached_counts:
 			return get_handle ("cached_counts");
 		case tables::confirmation_height:
@@ -381,6 +403,13 @@ size_t oslo::rocksdb_store::count (oslo::transaction const & transaction_a, tabl
 			++sum;
 		}
 	}
+	else if (table_a == tables::bootstrap_peers)
+	{
+		for (auto i (bootstrap_peers_begin (transaction_a)), n (bootstrap_peers_end ()); i != n; ++i)
+		{
+			++sum;
+		}
+	}
 	// This should only be used during initialization as can be expensive during bootstrapping
 	else if (table_a == tables::unchecked)
 	{
@@ -432,6 +461,16 @@ int oslo::rocksdb_store::drop (oslo::write_transaction const & transaction_a, ta
 			}
 			return status;
 		}
+		else if (table_a == tables::bootstrap_peers)
+		{
+			int status = 0;
+			for (auto i = bootstrap_peers_begin (transaction_a), n = bootstrap_peers_end (); i != n; ++i)
+			{
+				status = del (transaction_a, tables::bootstrap_peers, oslo::rocksdb_val (i->first));
+				release_assert (success (status));
+			}
+			return status;
+		}
 		else
 		{
 			return clear (col);
@@ -548,7 +587,7 @@ rocksdb::ColumnFamilyOptions oslo::rocksdb_store::get_cf_options () const
 
 std::vector<oslo::tables> oslo::rocksdb_store::all_tables () const
 {
-	return std::vector<oslo::tables>{ tables::accounts, tables::cached_counts, tables::change_blocks, tables::confirmation_height, tables::frontiers, tables::meta, tables::online_weight, tables::open_blocks, tables::peers, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::vote };
+	return std::vector<oslo::tables>{ tables::accounts, tables::bootstrap_peers, tables::cached_counts, tables::change_blocks, tables::confirmation_height, tables::frontiers, tables::meta, tables::online_weight, tables::open_blocks, tables::peers, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::unchecked_modified, tables::vote };
 }
 
 bool oslo::rocksdb_store::copy_db (boost::filesystem::path const & destination_path)
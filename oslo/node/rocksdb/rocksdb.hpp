@@ -93,6 +93,7 @@ private:
 	int clear (rocksdb::ColumnFamilyHandle * column_family);
 
 	void open (bool & error_a, boost::filesystem::path const & path_a, bool open_read_only_a);
+	void upgrade_unchecked_modified (oslo::write_transaction const &);
 	uint64_t count (oslo::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle) const;
 	bool is_caching_counts (oslo::tables table_a) const;
 
@@ -55,6 +55,8 @@ public:
 	virtual ~socket ();
 	void async_connect (boost::asio::ip::tcp::endpoint const &, std::function<void(boost::system::error_code const &)>);
 	void async_read (std::shared_ptr<std::vector<uint8_t>>, size_t, std::function<void(boost::system::error_code const &, size_t)>);
+	/** Reads up to \p size_a bytes into \p buffer_a starting at \p offset_a, completes as soon as some data is available */
+	void async_read_some (std::shared_ptr<std::vector<uint8_t>> buffer_a, size_t offset_a, size_t size_a, std::function<void(boost::system::error_code const &, size_t)>);
 	void async_write (oslo::shared_const_buffer const &, std::function<void(boost::system::error_code const &, size_t)> = nullptr, oslo::buffer_drop_policy = oslo::buffer_drop_policy::limiter);
 
 	void close ();
@@ -118,6 +118,7 @@ bool oslo::transport::tcp_channels::insert (std::shared_ptr<oslo::transport::cha
 			channels.get<endpoint_tag> ().emplace (channel_a, socket_a, bootstrap_server_a);
 			attempts.get<endpoint_tag> ().erase (endpoint);
 			error = false;
+			node.network.snapshot_invalidate ();
 			lock.unlock ();
 			node.network.channel_observer (channel_a);
 			// Remove UDP channel to same IP:port if exists
@@ -133,6 +134,7 @@ void oslo::transport::tcp_channels::erase (oslo::tcp_endpoint const & endpoint_a
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
 	channels.get<endpoint_tag> ().erase (endpoint_a);
+	node.network.snapshot_invalidate ();
 }
 
 size_t oslo::transport::tcp_channels::size () const
@@ -241,21 +243,25 @@ oslo::tcp_endpoint oslo::transport::tcp_channels::bootstrap_peer (uint8_t connec
 {
 	oslo::tcp_endpoint result (boost::asio::ip::address_v6::any (), 0);
 	oslo::lock_guard<std::mutex> lock (mutex);
-	for (auto i (channels.get<last_bootstrap_attempt_tag> ().begin ()), n (channels.get<last_bootstrap_attempt_tag> ().end ()); i != n;)
+	// Choose among the least recently attempted peers, weighted by their bootstrap score
+	std::vector<decltype (channels.get<last_bootstrap_attempt_tag> ().begin ())> candidates;
+	std::vector<oslo::tcp_endpoint> endpoints;
+	for (auto i (channels.get<last_bootstrap_attempt_tag> ().begin ()), n (channels.get<last_bootstrap_attempt_tag> ().end ()); i != n && candidates.size () < oslo::bootstrap_limits::bootstrap_peer_candidates; ++i)
 	{
 		if (i->channel->get_network_version () >= connection_protocol_version_min)
 		{
-			result = i->endpoint ();
-			channels.get<last_bootstrap_attempt_tag> ().modify (i, [](channel_tcp_wrapper & wrapper_a) {
-				wrapper_a.channel->set_last_bootstrap_attempt (std::chrono::steady_clock::now ());
-			});
-			i = n;
-		}
-		else
-		{
-			++i;
+			candidates.push_back (i);
+			endpoints.push_back (i->endpoint ());
 		}
 	}
+	if (!candidates.empty ())
+	{
+		auto index (node.bootstrap_initiator.peer_scores.select (endpoints));
+		result = endpoints[index];
+		channels.get<last_bootstrap_attempt_tag> ().modify (candidates[index], [](channel_tcp_wrapper & wrapper_a) {
+			wrapper_a.channel->set_last_bootstrap_attempt (std::chrono::steady_clock::now ());
+		});
+	}
 	return result;
 }
 
@@ -409,6 +415,7 @@ void oslo::transport::tcp_channels::purge (std::chrono::steady_clock::time_point
 	// Check if any tcp channels belonging to old protocol versions which may still be alive due to async operations
 	auto lower_bound = channels.get<version_tag> ().lower_bound (node.network_params.protocol.protocol_version_min (node.ledger.cache.epoch_2_started));
 	channels.get<version_tag> ().erase (channels.get<version_tag> ().begin (), lower_bound);
+	node.network.snapshot_invalidate ();
 
 	// Cleanup any sockets which may still be existing from failed node id handshakes
 	node_id_handshake_sockets.erase (std::remove_if (node_id_handshake_sockets.begin (), node_id_handshake_sockets.end (), [this](auto socket) {
@@ -470,7 +477,7 @@ void oslo::transport::tcp_channels::list_below_version (std::vector<std::shared_
 	// clang-format on
 }
 
-void oslo::transport::tcp_channels::list (std::deque<std::shared_ptr<oslo::transport::channel>> & deque_a, uint8_t minimum_version_a, bool include_temporary_channels_a)
+void oslo::transport::tcp_channels::list (std::deque<std::shared_ptr<oslo::transport::channel>> & deque_a, uint8_t minimum_version_a, bool include_temporary_channels_a) const
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
 	// clang-format off
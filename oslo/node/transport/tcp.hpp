@@ -113,7 +113,7 @@ namespace transport
 		void purge (std::chrono::steady_clock::time_point const &);
 		void ongoing_keepalive ();
 		void list_below_version (std::vector<std::shared_ptr<oslo::transport::channel>> &, uint8_t);
-		void list (std::deque<std::shared_ptr<oslo::transport::channel>> &, uint8_t = 0, bool = true);
+		void list (std::deque<std::shared_ptr<oslo::transport::channel>> &, uint8_t = 0, bool = true) const;
 		void modify (std::shared_ptr<oslo::transport::channel_tcp>, std::function<void(std::shared_ptr<oslo::transport::channel_tcp>)>);
 		void update (oslo::tcp_endpoint const &);
 		// Connection start
@@ -55,6 +55,10 @@ public:
 	{
 		result = oslo::stat::detail::telemetry_ack;
 	}
+	void publish_batch (oslo::publish_batch const & message_a) override
+	{
+		result = oslo::stat::detail::publish_batch;
+	}
 	oslo::stat::detail result;
 };
 }
@@ -85,21 +89,64 @@ node (node_a)
 	set_network_version (node_a.network_params.protocol.protocol_version);
 }
 
+namespace
+{
+oslo::bandwidth_class bandwidth_class_of (oslo::stat::detail detail_a)
+{
+	auto result (oslo::bandwidth_class::other);
+	switch (detail_a)
+	{
+		case oslo::stat::detail::confirm_ack:
+			result = oslo::bandwidth_class::vote;
+			break;
+		case oslo::stat::detail::publish:
+		case oslo::stat::detail::publish_batch:
+			result = oslo::bandwidth_class::publish;
+			break;
+		case oslo::stat::detail::confirm_req:
+			result = oslo::bandwidth_class::confirm_req;
+			break;
+		case oslo::stat::detail::bulk_pull:
+		case oslo::stat::detail::bulk_pull_account:
+		case oslo::stat::detail::bulk_push:
+		case oslo::stat::detail::frontier_req:
+			result = oslo::bandwidth_class::bootstrap;
+			break;
+		case oslo::stat::detail::telemetry_req:
+		case oslo::stat::detail::telemetry_ack:
+			result = oslo::bandwidth_class::telemetry;
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+
+oslo::stat::detail stat_detail_of (oslo::bandwidth_class class_a)
+{
+	static std::array<oslo::stat::detail, oslo::bandwidth_limiter::class_count> const details{ { oslo::stat::detail::class_vote, oslo::stat::detail::class_publish, oslo::stat::detail::class_confirm_req, oslo::stat::detail::class_bootstrap, oslo::stat::detail::class_telemetry, oslo::stat::detail::class_other } };
+	return details[static_cast<size_t> (class_a)];
+}
+}
+
 void oslo::transport::channel::send (oslo::message const & message_a, std::function<void(boost::system::error_code const &, size_t)> const & callback_a, oslo::buffer_drop_policy drop_policy_a)
 {
 	callback_visitor visitor;
 	message_a.visit (visitor);
 	auto buffer (message_a.to_shared_const_buffer (node.ledger.cache.epoch_2_started));
 	auto detail (visitor.result);
+	auto class_l (bandwidth_class_of (detail));
 	auto is_droppable_by_limiter = drop_policy_a == oslo::buffer_drop_policy::limiter;
-	auto should_drop (node.network.limiter.should_drop (buffer.size ()));
+	auto should_drop (node.network.limiter.should_drop (buffer.size (), class_l, get_endpoint ()));
 	if (!is_droppable_by_limiter || !should_drop)
 	{
 		send_buffer (buffer, detail, callback_a, drop_policy_a);
 		node.stats.inc (oslo::stat::type::message, detail, oslo::stat::dir::out);
+		node.stats.add (oslo::stat::type::bandwidth, stat_detail_of (class_l), oslo::stat::dir::out, buffer.size ());
 	}
 	else
 	{
+		node.stats.inc (oslo::stat::type::bandwidth_drop, stat_detail_of (class_l), oslo::stat::dir::out);
 		if (callback_a)
 		{
 			callback_a (boost::system::errc::make_error_code (boost::system::errc::not_supported), 0);
@@ -114,6 +161,37 @@ void oslo::transport::channel::send (oslo::message const & message_a, std::funct
 	}
 }
 
+void oslo::transport::channel::send_many (std::vector<std::shared_ptr<oslo::message>> const & messages_a, oslo::buffer_drop_policy drop_policy_a)
+{
+	debug_assert (!messages_a.empty ());
+	debug_assert (get_type () == oslo::transport::transport_type::tcp);
+	callback_visitor visitor;
+	messages_a.front ()->visit (visitor);
+	auto detail (visitor.result);
+	auto bytes (std::make_shared<std::vector<uint8_t>> ());
+	{
+		oslo::vectorstream stream (*bytes);
+		for (auto const & message : messages_a)
+		{
+			message->serialize (stream, node.ledger.cache.epoch_2_started);
+		}
+	}
+	oslo::shared_const_buffer buffer (bytes);
+	auto class_l (bandwidth_class_of (detail));
+	auto should_drop (node.network.limiter.should_drop (buffer.size (), class_l, get_endpoint ()));
+	if (drop_policy_a != oslo::buffer_drop_policy::limiter || !should_drop)
+	{
+		send_buffer (buffer, detail, nullptr, drop_policy_a);
+		node.stats.add (oslo::stat::type::message, detail, oslo::stat::dir::out, messages_a.size ());
+		node.stats.add (oslo::stat::type::bandwidth, stat_detail_of (class_l), oslo::stat::dir::out, buffer.size ());
+	}
+	else
+	{
+		node.stats.inc (oslo::stat::type::bandwidth_drop, stat_detail_of (class_l), oslo::stat::dir::out);
+		node.stats.add (oslo::stat::type::drop, detail, oslo::stat::dir::out, messages_a.size ());
+	}
+}
+
 namespace
 {
 boost::asio::ip::address_v6 mapped_from_v4_bytes (unsigned long address_a)
@@ -223,12 +301,121 @@ bool oslo::transport::reserved_address (oslo::endpoint const & endpoint_a, bool
 
 using namespace std::chrono_literals;
 
+constexpr size_t oslo::bandwidth_limiter::class_count;
+constexpr std::chrono::seconds oslo::bandwidth_limiter::peer_cutoff;
+constexpr std::chrono::seconds oslo::bandwidth_limiter::class_idle_cutoff;
+
 oslo::bandwidth_limiter::bandwidth_limiter (const double limit_burst_ratio_a, const size_t limit_a) :
-bucket (limit_a * limit_burst_ratio_a, limit_a)
+bandwidth_limiter (limit_burst_ratio_a, limit_a, { 0, 0, 0, 0, 0, 1 }, 0)
+{
+}
+
+oslo::bandwidth_limiter::bandwidth_limiter (const double limit_burst_ratio_a, const size_t limit_a, std::array<unsigned, class_count> const & weights_a, size_t limit_per_peer_a) :
+unbounded (limit_a == 0),
+limit_per_peer (static_cast<double> (limit_per_peer_a)),
+burst_ratio (limit_burst_ratio_a)
+{
+	auto total_weight (std::accumulate (weights_a.begin (), weights_a.end (), 0.0));
+	debug_assert (total_weight > 0);
+	for (size_t i (0); i < class_count; ++i)
+	{
+		auto & bucket (classes[i]);
+		bucket.rate = total_weight > 0 ? limit_a * weights_a[i] / total_weight : 0;
+		bucket.capacity = bucket.tokens = bucket.rate * burst_ratio;
+	}
+}
+
+void oslo::bandwidth_limiter::bucket::refill (std::chrono::steady_clock::time_point const & now_a)
 {
+	auto elapsed (std::chrono::duration_cast<std::chrono::nanoseconds> (now_a - last_refill).count () / 1e9);
+	tokens = std::min (capacity, tokens + elapsed * rate);
+	last_refill = now_a;
 }
 
 bool oslo::bandwidth_limiter::should_drop (const size_t & message_size_a)
 {
-	return !bucket.try_consume (message_size_a);
+	oslo::lock_guard<std::mutex> lock (mutex);
+	return should_drop_class (message_size_a, oslo::bandwidth_class::other, std::chrono::steady_clock::now ());
+}
+
+bool oslo::bandwidth_limiter::should_drop (size_t message_size_a, oslo::bandwidth_class class_a, oslo::endpoint const & endpoint_a)
+{
+	auto now (std::chrono::steady_clock::now ());
+	oslo::lock_guard<std::mutex> lock (mutex);
+	oslo::bandwidth_limiter::bucket * peer_bucket (nullptr);
+	auto result (false);
+	if (limit_per_peer > 0)
+	{
+		purge_peers (now);
+		auto & peer_l (peers[endpoint_a]);
+		if (peer_l.bucket.rate == 0)
+		{
+			peer_l.bucket.rate = limit_per_peer;
+			peer_l.bucket.capacity = peer_l.bucket.tokens = limit_per_peer * burst_ratio;
+		}
+		peer_l.last_use = now;
+		peer_bucket = &peer_l.bucket;
+		peer_bucket->refill (now);
+		result = peer_bucket->tokens < message_size_a;
+	}
+	if (!result)
+	{
+		result = should_drop_class (message_size_a, class_a, now);
+		if (!result && peer_bucket != nullptr)
+		{
+			peer_bucket->tokens -= message_size_a;
+		}
+	}
+	return result;
+}
+
+bool oslo::bandwidth_limiter::should_drop_class (size_t message_size_a, oslo::bandwidth_class class_a, std::chrono::steady_clock::time_point const & now_a)
+{
+	auto result (false);
+	if (!unbounded)
+	{
+		auto & own (classes[static_cast<size_t> (class_a)]);
+		// Sending classes only lend the upper half of their bucket, idle classes lend everything
+		auto lendable = [&own, &now_a](bucket const & bucket_a) {
+			auto reserved (now_a - bucket_a.last_use < class_idle_cutoff ? bucket_a.capacity / 2 : 0.0);
+			return &bucket_a == &own ? bucket_a.tokens : std::max (0.0, bucket_a.tokens - reserved);
+		};
+		double needed (message_size_a);
+		double available (0);
+		for (auto & bucket : classes)
+		{
+			bucket.refill (now_a);
+			available += lendable (bucket);
+		}
+		result = available < needed;
+		if (!result)
+		{
+			auto taken (std::min (own.tokens, needed));
+			own.tokens -= taken;
+			needed -= taken;
+			for (auto i (classes.begin ()), n (classes.end ()); i != n && needed > 0; ++i)
+			{
+				if (&*i != &own)
+				{
+					auto lent (std::min (needed, lendable (*i)));
+					i->tokens -= lent;
+					needed -= lent;
+				}
+			}
+			own.last_use = now_a;
+		}
+	}
+	return result;
+}
+
+void oslo::bandwidth_limiter::purge_peers (std::chrono::steady_clock::time_point const & now_a)
+{
+	if (now_a - last_purge > peer_cutoff)
+	{
+		for (auto i (peers.begin ()); i != peers.end ();)
+		{
+			i = now_a - i->second.last_use > peer_cutoff ? peers.erase (i) : std::next (i);
+		}
+		last_purge = now_a;
+	}
 }
@@ -1,22 +1,73 @@
 #pragma once
 
 #include <oslo/lib/locks.hpp>
-#include <oslo/lib/rate_limiting.hpp>
 #include <oslo/lib/stats.hpp>
 #include <oslo/node/common.hpp>
 #include <oslo/node/socket.hpp>
 
+#include <array>
+#include <unordered_map>
+
 namespace oslo
 {
+/** Outbound traffic classes sharing the bandwidth limit */
+enum class bandwidth_class : uint8_t
+{
+	vote,
+	publish,
+	confirm_req,
+	bootstrap,
+	telemetry,
+	other
+};
+
+/**
+ * Outbound traffic shaping with a share of the bandwidth limit for each traffic class.
+ * Every class has a token bucket refilled at its share of the limit. A class which ran out of tokens borrows
+ * from the other classes. Idle classes lend all of their tokens, classes which sent recently keep half of
+ * their capacity reserved for themselves. Optionally, each peer is also capped.
+ */
 class bandwidth_limiter final
 {
 public:
+	static size_t constexpr class_count = 6;
 	// initialize with limit 0 = unbounded
 	bandwidth_limiter (const double, const size_t);
+	/** Weights of the classes in bandwidth_class order, \p limit_per_peer_a of 0 does not cap peers */
+	bandwidth_limiter (const double, const size_t, std::array<unsigned, class_count> const & weights_a, size_t limit_per_peer_a);
 	bool should_drop (const size_t &);
+	bool should_drop (size_t, oslo::bandwidth_class, oslo::endpoint const &);
+	/** Peers not sending for this long have their caps forgotten */
+	static std::chrono::seconds constexpr peer_cutoff{ 60 };
+	/** Classes not sending for this long lend their reserved tokens too */
+	static std::chrono::seconds constexpr class_idle_cutoff{ 1 };
 
 private:
-	oslo::rate::token_bucket bucket;
+	class bucket final
+	{
+	public:
+		void refill (std::chrono::steady_clock::time_point const &);
+		double tokens{ 0 };
+		double capacity{ 0 };
+		double rate{ 0 };
+		std::chrono::steady_clock::time_point last_refill{ std::chrono::steady_clock::now () };
+		std::chrono::steady_clock::time_point last_use{};
+	};
+	class peer final
+	{
+	public:
+		oslo::bandwidth_limiter::bucket bucket;
+		std::chrono::steady_clock::time_point last_use;
+	};
+	bool should_drop_class (size_t, oslo::bandwidth_class, std::chrono::steady_clock::time_point const &);
+	void purge_peers (std::chrono::steady_clock::time_point const &);
+	bool const unbounded;
+	double const limit_per_peer;
+	double const burst_ratio;
+	std::array<bucket, class_count> classes;
+	std::unordered_map<oslo::endpoint, peer> peers;
+	std::chrono::steady_clock::time_point last_purge{ std::chrono::steady_clock::now () };
+	std::mutex mutex;
 };
 
 namespace transport
@@ -42,6 +93,8 @@ namespace transport
 		virtual size_t hash_code () const = 0;
 		virtual bool operator== (oslo::transport::channel const &) const = 0;
 		void send (oslo::message const &, std::function<void(boost::system::error_code const &, size_t)> const & = nullptr, oslo::buffer_drop_policy = oslo::buffer_drop_policy::limiter);
+		/** Sends \p messages_a in a single write, only for TCP channels where the receiver reads messages from a stream */
+		void send_many (std::vector<std::shared_ptr<oslo::message>> const & messages_a, oslo::buffer_drop_policy = oslo::buffer_drop_policy::limiter);
 		virtual void send_buffer (oslo::shared_const_buffer const &, oslo::stat::detail, std::function<void(boost::system::error_code const &, size_t)> const & = nullptr, oslo::buffer_drop_policy = oslo::buffer_drop_policy::limiter) = 0;
 		virtual std::function<void(boost::system::error_code const &, size_t)> callback (oslo::stat::detail, std::function<void(boost::system::error_code const &, size_t)> const & = nullptr) const = 0;
 		virtual std::string to_string () const = 0;
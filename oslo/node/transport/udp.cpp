@@ -7,6 +7,12 @@
 
 #include <boost/format.hpp>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
+constexpr size_t oslo::transport::udp_channels::batch_size;
+
 oslo::transport::channel_udp::channel_udp (oslo::transport::udp_channels & channels_a, oslo::endpoint const & endpoint_a, uint8_t protocol_version_a) :
 channel (channels_a.node),
 endpoint (endpoint_a),
@@ -80,6 +86,9 @@ strand (node_a.io_ctx.get_executor ())
 			node.logger.try_log ("Unable to retrieve port: ", ec.message ());
 		}
 		local_endpoint = oslo::endpoint (boost::asio::ip::address_v6::loopback (), port);
+#ifdef __linux__
+		batching = !node.flags.disable_udp_batching;
+#endif
 	}
 	else
 	{
@@ -94,12 +103,111 @@ void oslo::transport::udp_channels::send (oslo::shared_const_buffer const & buff
 	[this, buffer_a, endpoint_a, callback_a]() {
 		if (!this->stopped)
 		{
-			this->socket->async_send_to (buffer_a, endpoint_a,
-			boost::asio::bind_executor (strand, callback_a));
+			if (this->batching)
+			{
+				// Sends posted before the batch runs, such as the rest of a flood, join the same sendmmsg call
+				this->send_queue.push_back ({ buffer_a, endpoint_a, callback_a });
+				if (!this->sending)
+				{
+					this->sending = true;
+					boost::asio::post (strand, [this]() {
+						this->send_batch ();
+					});
+				}
+			}
+			else
+			{
+				this->socket->async_send_to (buffer_a, endpoint_a,
+				boost::asio::bind_executor (strand, callback_a));
+			}
 		}
 	});
 }
 
+void oslo::transport::udp_channels::send_batch ()
+{
+#ifdef __linux__
+	while (!stopped && !send_queue.empty ())
+	{
+		std::array<mmsghdr, batch_size> headers;
+		std::array<iovec, batch_size> vectors;
+		auto count (std::min (send_queue.size (), batch_size));
+		for (size_t i (0); i < count; ++i)
+		{
+			auto & entry (send_queue[i]);
+			auto const & buffer (*entry.buffer.begin ());
+			vectors[i] = { const_cast<void *> (buffer.data ()), buffer.size () };
+			headers[i] = mmsghdr{};
+			headers[i].msg_hdr.msg_name = entry.endpoint.data ();
+			headers[i].msg_hdr.msg_namelen = static_cast<socklen_t> (entry.endpoint.size ());
+			headers[i].msg_hdr.msg_iov = &vectors[i];
+			headers[i].msg_hdr.msg_iovlen = 1;
+		}
+		auto sent (::sendmmsg (socket->native_handle (), headers.data (), static_cast<unsigned> (count), MSG_DONTWAIT));
+		if (sent > 0)
+		{
+			node.stats.inc (oslo::stat::type::udp, oslo::stat::detail::batch_syscall, oslo::stat::dir::out);
+			node.stats.add (oslo::stat::type::udp, oslo::stat::detail::batch_packet, oslo::stat::dir::out, static_cast<uint64_t> (sent));
+			for (auto i (0); i < sent; ++i)
+			{
+				auto entry (std::move (send_queue.front ()));
+				send_queue.pop_front ();
+				if (entry.callback)
+				{
+					entry.callback (boost::system::error_code{}, headers[i].msg_len);
+				}
+			}
+		}
+		else if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			socket->async_wait (boost::asio::ip::udp::socket::wait_write,
+			boost::asio::bind_executor (strand,
+			[this](boost::system::error_code const & error) {
+				if (!error)
+				{
+					this->send_batch ();
+				}
+				else
+				{
+					this->send_queue_fail (error);
+					this->sending = false;
+				}
+			}));
+			return;
+		}
+		else
+		{
+			// The first datagram failed, report it and carry on with the rest
+			boost::system::error_code error (errno, boost::system::system_category ());
+			auto entry (std::move (send_queue.front ()));
+			send_queue.pop_front ();
+			if (entry.callback)
+			{
+				entry.callback (error, 0);
+			}
+		}
+	}
+	if (stopped)
+	{
+		send_queue_fail (boost::asio::error::operation_aborted);
+	}
+#endif
+	sending = false;
+}
+
+void oslo::transport::udp_channels::send_queue_fail (boost::system::error_code const & error_a)
+{
+	decltype (send_queue) failed;
+	failed.swap (send_queue);
+	for (auto const & entry : failed)
+	{
+		if (entry.callback)
+		{
+			entry.callback (error_a, 0);
+		}
+	}
+}
+
 std::shared_ptr<oslo::transport::channel_udp> oslo::transport::udp_channels::insert (oslo::endpoint const & endpoint_a, unsigned network_version_a)
 {
 	debug_assert (endpoint_a.address ().is_v6 ());
@@ -117,6 +225,7 @@ std::shared_ptr<oslo::transport::channel_udp> oslo::transport::udp_channels::ins
 			result = std::make_shared<oslo::transport::channel_udp> (*this, endpoint_a, network_version_a);
 			channels.get<endpoint_tag> ().insert (result);
 			attempts.get<endpoint_tag> ().erase (endpoint_a);
+			node.network.snapshot_invalidate ();
 			lock.unlock ();
 			node.network.channel_observer (result);
 		}
@@ -128,6 +237,7 @@ void oslo::transport::udp_channels::erase (oslo::endpoint const & endpoint_a)
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
 	channels.get<endpoint_tag> ().erase (endpoint_a);
+	node.network.snapshot_invalidate ();
 }
 
 size_t oslo::transport::udp_channels::size () const
@@ -235,6 +345,7 @@ void oslo::transport::udp_channels::clean_node_id (oslo::account const & node_id
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
 	channels.get<node_id_tag> ().erase (node_id_a);
+	node.network.snapshot_invalidate ();
 }
 
 void oslo::transport::udp_channels::clean_node_id (oslo::endpoint const & endpoint_a, oslo::account const & node_id_a)
@@ -247,6 +358,7 @@ void oslo::transport::udp_channels::clean_node_id (oslo::endpoint const & endpoi
 		if (record.endpoint ().address () == endpoint_a.address () && record.endpoint ().port () != endpoint_a.port ())
 		{
 			channels.get<endpoint_tag> ().erase (record.endpoint ());
+			node.network.snapshot_invalidate ();
 			break;
 		}
 	}
@@ -256,21 +368,25 @@ oslo::tcp_endpoint oslo::transport::udp_channels::bootstrap_peer (uint8_t connec
 {
 	oslo::tcp_endpoint result (boost::asio::ip::address_v6::any (), 0);
 	oslo::lock_guard<std::mutex> lock (mutex);
-	for (auto i (channels.get<last_bootstrap_attempt_tag> ().begin ()), n (channels.get<last_bootstrap_attempt_tag> ().end ()); i != n;)
+	// Choose among the least recently attempted peers, weighted by their bootstrap score
+	std::vector<decltype (channels.get<last_bootstrap_attempt_tag> ().begin ())> candidates;
+	std::vector<oslo::tcp_endpoint> endpoints;
+	for (auto i (channels.get<last_bootstrap_attempt_tag> ().begin ()), n (channels.get<last_bootstrap_attempt_tag> ().end ()); i != n && candidates.size () < oslo::bootstrap_limits::bootstrap_peer_candidates; ++i)
 	{
 		if (i->channel->get_network_version () >= connection_protocol_version_min)
 		{
-			result = oslo::transport::map_endpoint_to_tcp (i->endpoint ());
-			channels.get<last_bootstrap_attempt_tag> ().modify (i, [](channel_udp_wrapper & wrapper_a) {
-				wrapper_a.channel->set_last_bootstrap_attempt (std::chrono::steady_clock::now ());
-			});
-			i = n;
-		}
-		else
-		{
-			++i;
+			candidates.push_back (i);
+			endpoints.push_back (oslo::transport::map_endpoint_to_tcp (i->endpoint ()));
 		}
 	}
+	if (!candidates.empty ())
+	{
+		auto index (node.bootstrap_initiator.peer_scores.select (endpoints));
+		result = endpoints[index];
+		channels.get<last_bootstrap_attempt_tag> ().modify (candidates[index], [](channel_udp_wrapper & wrapper_a) {
+			wrapper_a.channel->set_last_bootstrap_attempt (std::chrono::steady_clock::now ());
+		});
+	}
 	return result;
 }
 
@@ -314,15 +430,100 @@ void oslo::transport::udp_channels::receive ()
 	}
 }
 
+void oslo::transport::udp_channels::receive_batch ()
+{
+	if (!stopped)
+	{
+		release_assert (socket != nullptr);
+		socket->async_wait (boost::asio::ip::udp::socket::wait_read,
+		boost::asio::bind_executor (strand,
+		[this](boost::system::error_code const & error) {
+			if (!error && !this->stopped)
+			{
+				this->read_batch ();
+				this->receive_batch ();
+			}
+			else
+			{
+				if (error && this->node.config.logging.network_logging ())
+				{
+					this->node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % error.message ()));
+				}
+				if (!this->stopped)
+				{
+					this->node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [this]() { this->receive_batch (); });
+				}
+			}
+		}));
+	}
+}
+
+void oslo::transport::udp_channels::read_batch ()
+{
+#ifdef __linux__
+	std::array<oslo::message_buffer *, batch_size> buffers;
+	std::array<mmsghdr, batch_size> headers;
+	std::array<iovec, batch_size> vectors;
+	size_t count (0);
+	// Only the first buffer may wait for one to be released, the rest of the batch is limited to free buffers
+	for (auto data (node.network.buffer_container.allocate ()); data != nullptr; data = count < batch_size ? node.network.buffer_container.try_allocate () : nullptr)
+	{
+		buffers[count] = data;
+		vectors[count] = { data->buffer, oslo::network::buffer_size };
+		headers[count] = mmsghdr{};
+		headers[count].msg_hdr.msg_name = data->endpoint.data ();
+		headers[count].msg_hdr.msg_namelen = static_cast<socklen_t> (data->endpoint.capacity ());
+		headers[count].msg_hdr.msg_iov = &vectors[count];
+		headers[count].msg_hdr.msg_iovlen = 1;
+		++count;
+	}
+	auto received (count > 0 ? ::recvmmsg (socket->native_handle (), headers.data (), static_cast<unsigned> (count), MSG_DONTWAIT, nullptr) : 0);
+	if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && node.config.logging.network_logging ())
+	{
+		boost::system::error_code error (errno, boost::system::system_category ());
+		node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % error.message ()));
+	}
+	size_t received_l (received > 0 ? received : 0);
+	if (received_l > 0)
+	{
+		node.stats.inc (oslo::stat::type::udp, oslo::stat::detail::batch_syscall, oslo::stat::dir::in);
+		node.stats.add (oslo::stat::type::udp, oslo::stat::detail::batch_packet, oslo::stat::dir::in, received_l);
+	}
+	for (size_t i (0); i < count; ++i)
+	{
+		if (i < received_l)
+		{
+			buffers[i]->size = headers[i].msg_len;
+			buffers[i]->endpoint.resize (headers[i].msg_hdr.msg_namelen);
+			node.network.buffer_container.enqueue (buffers[i]);
+		}
+		else
+		{
+			node.network.buffer_container.release (buffers[i]);
+		}
+	}
+#endif
+}
+
 void oslo::transport::udp_channels::start ()
 {
 	debug_assert (!node.flags.disable_udp);
-	for (size_t i = 0; i < node.config.io_threads && !stopped; ++i)
+	if (batching)
 	{
+		// A single pending wait is enough as every wakeup drains up to a batch of datagrams
 		boost::asio::post (strand, [this]() {
-			receive ();
+			receive_batch ();
 		});
 	}
+	else
+	{
+		for (size_t i = 0; i < node.config.io_threads && !stopped; ++i)
+		{
+			boost::asio::post (strand, [this]() {
+				receive ();
+			});
+		}
+	}
 	ongoing_keepalive ();
 }
 
@@ -409,6 +610,10 @@ public:
 	{
 		message (message_a);
 	}
+	void publish_batch (oslo::publish_batch const & message_a) override
+	{
+		message (message_a);
+	}
 	void confirm_req (oslo::confirm_req const & message_a) override
 	{
 		message (message_a);
@@ -686,6 +891,7 @@ void oslo::transport::udp_channels::purge (std::chrono::steady_clock::time_point
 	oslo::lock_guard<std::mutex> lock (mutex);
 	auto disconnect_cutoff (channels.get<last_packet_received_tag> ().lower_bound (cutoff_a));
 	channels.get<last_packet_received_tag> ().erase (channels.get<last_packet_received_tag> ().begin (), disconnect_cutoff);
+	node.network.snapshot_invalidate ();
 	// Remove keepalive attempt tracking for attempts older than cutoff
 	auto attempts_cutoff (attempts.get<last_attempt_tag> ().lower_bound (cutoff_a));
 	attempts.get<last_attempt_tag> ().erase (attempts.get<last_attempt_tag> ().begin (), attempts_cutoff);
@@ -726,7 +932,7 @@ void oslo::transport::udp_channels::list_below_version (std::vector<std::shared_
 	// clang-format on
 }
 
-void oslo::transport::udp_channels::list (std::deque<std::shared_ptr<oslo::transport::channel>> & deque_a, uint8_t minimum_version_a)
+void oslo::transport::udp_channels::list (std::deque<std::shared_ptr<oslo::transport::channel>> & deque_a, uint8_t minimum_version_a) const
 {
 	oslo::lock_guard<std::mutex> lock (mutex);
 	// clang-format off
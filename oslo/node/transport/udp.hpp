@@ -10,6 +10,7 @@
 #include <boost/multi_index/random_access_index.hpp>
 #include <boost/multi_index_container.hpp>
 
+#include <deque>
 #include <mutex>
 #include <unordered_set>
 
@@ -90,6 +91,8 @@ namespace transport
 		// Get the next peer for attempting a tcp bootstrap connection
 		oslo::tcp_endpoint bootstrap_peer (uint8_t connection_protocol_version_min);
 		void receive ();
+		/** Waits for the socket to be readable and receives up to batch_size datagrams with a single recvmmsg call */
+		void receive_batch ();
 		void start ();
 		void stop ();
 		void send (oslo::shared_const_buffer const & buffer_a, oslo::endpoint endpoint_a, std::function<void(boost::system::error_code const &, size_t)> const & callback_a);
@@ -104,12 +107,26 @@ namespace transport
 		void purge (std::chrono::steady_clock::time_point const &);
 		void ongoing_keepalive ();
 		void list_below_version (std::vector<std::shared_ptr<oslo::transport::channel>> &, uint8_t);
-		void list (std::deque<std::shared_ptr<oslo::transport::channel>> &, uint8_t = 0);
+		void list (std::deque<std::shared_ptr<oslo::transport::channel>> &, uint8_t = 0) const;
 		void modify (std::shared_ptr<oslo::transport::channel_udp>, std::function<void(std::shared_ptr<oslo::transport::channel_udp>)>);
 		oslo::node & node;
+		/** Maximum number of datagrams per recvmmsg and sendmmsg call */
+		static size_t constexpr batch_size = 64;
 
 	private:
 		void close_socket ();
+		void read_batch ();
+		/** Sends queued datagrams with sendmmsg until the queue is empty, waiting for the socket when it would block */
+		void send_batch ();
+		/** Empties the send queue, reporting \p error_a to each pending callback */
+		void send_queue_fail (boost::system::error_code const & error_a);
+		class send_entry final
+		{
+		public:
+			oslo::shared_const_buffer buffer;
+			oslo::endpoint endpoint;
+			std::function<void(boost::system::error_code const &, size_t)> callback;
+		};
 		class endpoint_tag
 		{
 		};
@@ -205,6 +222,11 @@ namespace transport
 		std::unique_ptr<boost::asio::ip::udp::socket> socket;
 		oslo::endpoint local_endpoint;
 		std::atomic<bool> stopped{ false };
+		/** Set when recvmmsg and sendmmsg are used */
+		bool batching{ false };
+		/** Datagrams waiting for sendmmsg, only accessed through the strand */
+		std::deque<send_entry> send_queue;
+		bool sending{ false };
 	};
 } // namespace transport
 } // namespace oslo
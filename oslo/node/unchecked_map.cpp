@@ -0,0 +1,201 @@
+#include <oslo/node/unchecked_map.hpp>
+#include <oslo/secure/blockstore.hpp>
+
+oslo::unchecked_map::unchecked_map (oslo::block_store & store_a, oslo::ledger_cache & cache_a, size_t max_memory_a, bool memory_only_a) :
+store (store_a),
+cache (cache_a),
+max_memory (max_memory_a),
+memory_only (memory_only_a)
+{
+	// Entries left in the table by an earlier run are still read and deleted as their dependencies arrive
+	auto transaction (store.tx_begin_read ());
+	if (store.unchecked_begin (transaction) != store.unchecked_end ())
+	{
+		table_count = store.unchecked_count (transaction);
+	}
+}
+
+void oslo::unchecked_map::put (oslo::write_transaction const & transaction_a, oslo::unchecked_key const & key_a, oslo::unchecked_info const & info_a)
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	auto existing (entries.get<tag_key> ().find (key_a));
+	if (existing != entries.get<tag_key> ().end ())
+	{
+		entries.get<tag_key> ().modify (existing, [&info_a](oslo::unchecked_map_entry & entry_a) {
+			entry_a.info = info_a;
+		});
+	}
+	else if (exists_table (transaction_a, key_a))
+	{
+		store.unchecked_put (transaction_a, key_a, info_a);
+	}
+	else
+	{
+		entries.get<tag_key> ().insert ({ key_a, info_a });
+		++cache.unchecked_count;
+		while (entries.size () > max_memory)
+		{
+			auto oldest (entries.get<tag_modified> ().begin ());
+			if (!memory_only)
+			{
+				put_table (transaction_a, oldest->key, oldest->info);
+			}
+			else
+			{
+				debug_assert (cache.unchecked_count > 0);
+				--cache.unchecked_count;
+			}
+			entries.get<tag_modified> ().erase (oldest);
+		}
+	}
+}
+
+void oslo::unchecked_map::put_table (oslo::write_transaction const & transaction_a, oslo::unchecked_key const & key_a, oslo::unchecked_info const & info_a)
+{
+	// Memory entries are never in the table, keys found there are replaced in place by put
+	store.unchecked_put_new (transaction_a, key_a, info_a);
+	++table_count;
+}
+
+bool oslo::unchecked_map::exists_table (oslo::transaction const & transaction_a, oslo::unchecked_key const & key_a)
+{
+	return table_count > 0 && store.unchecked_exists (transaction_a, key_a);
+}
+
+bool oslo::unchecked_map::exists (oslo::transaction const & transaction_a, oslo::unchecked_key const & key_a)
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	return entries.get<tag_key> ().find (key_a) != entries.get<tag_key> ().end () || exists_table (transaction_a, key_a);
+}
+
+void oslo::unchecked_map::del (oslo::write_transaction const & transaction_a, oslo::unchecked_key const & key_a)
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	auto existing (entries.get<tag_key> ().find (key_a));
+	auto erased (existing != entries.get<tag_key> ().end ());
+	if (erased)
+	{
+		entries.get<tag_key> ().erase (existing);
+	}
+	else if (exists_table (transaction_a, key_a))
+	{
+		store.unchecked_del (transaction_a, key_a);
+		debug_assert (table_count > 0);
+		--table_count;
+		erased = true;
+	}
+	if (erased)
+	{
+		debug_assert (cache.unchecked_count > 0);
+		--cache.unchecked_count;
+	}
+}
+
+std::vector<oslo::unchecked_info> oslo::unchecked_map::get (oslo::transaction const & transaction_a, oslo::block_hash const & hash_a)
+{
+	std::vector<oslo::unchecked_info> result;
+	{
+		oslo::lock_guard<std::mutex> lock (mutex);
+		for (auto i (entries.get<tag_key> ().lower_bound (oslo::unchecked_key (hash_a, 0))), n (entries.get<tag_key> ().end ()); i != n && i->key.previous == hash_a; ++i)
+		{
+			result.push_back (i->info);
+		}
+	}
+	if (table_count > 0)
+	{
+		auto table_entries (store.unchecked_get (transaction_a, hash_a));
+		result.insert (result.end (), table_entries.begin (), table_entries.end ());
+	}
+	return result;
+}
+
+void oslo::unchecked_map::clear (oslo::write_transaction const & transaction_a)
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	entries.clear ();
+	store.unchecked_clear (transaction_a);
+	table_count = 0;
+	cache.unchecked_count = 0;
+}
+
+size_t oslo::unchecked_map::count (oslo::transaction const & transaction_a)
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	return entries.size () + table_count;
+}
+
+void oslo::unchecked_map::for_each (oslo::transaction const & transaction_a, oslo::unchecked_key const & key_a, std::function<bool(oslo::unchecked_key const &, oslo::unchecked_info const &)> const & action_a)
+{
+	std::vector<oslo::unchecked_map_entry> memory_entries;
+	{
+		oslo::lock_guard<std::mutex> lock (mutex);
+		memory_entries.assign (entries.get<tag_key> ().lower_bound (key_a), entries.get<tag_key> ().end ());
+	}
+	// Merge memory entries with the table, both are in key order
+	oslo::unchecked_key_compare compare;
+	auto m (memory_entries.begin ());
+	auto m_end (memory_entries.end ());
+	auto i (table_count > 0 ? store.unchecked_begin (transaction_a, key_a) : store.unchecked_end ());
+	auto n (store.unchecked_end ());
+	for (auto proceed (true); proceed && (m != m_end || i != n);)
+	{
+		if (i == n || (m != m_end && compare (m->key, i->first)))
+		{
+			proceed = action_a (m->key, m->info);
+			++m;
+		}
+		else
+		{
+			proceed = action_a (i->first, i->second);
+			++i;
+		}
+	}
+}
+
+std::vector<std::shared_ptr<oslo::block>> oslo::unchecked_map::erase_expired (uint64_t cutoff_a)
+{
+	std::vector<std::shared_ptr<oslo::block>> result;
+	oslo::lock_guard<std::mutex> lock (mutex);
+	auto & entries_by_modified (entries.get<tag_modified> ());
+	for (auto i (entries_by_modified.begin ()), n (entries_by_modified.end ()); i != n && i->info.modified < cutoff_a;)
+	{
+		result.push_back (i->info.block);
+		i = entries_by_modified.erase (i);
+		debug_assert (cache.unchecked_count > 0);
+		--cache.unchecked_count;
+	}
+	return result;
+}
+
+void oslo::unchecked_map::flush (oslo::write_transaction const & transaction_a)
+{
+	if (!memory_only)
+	{
+		oslo::lock_guard<std::mutex> lock (mutex);
+		for (auto const & entry : entries)
+		{
+			put_table (transaction_a, entry.key, entry.info);
+		}
+		entries.clear ();
+	}
+}
+
+size_t oslo::unchecked_map::memory_size ()
+{
+	oslo::lock_guard<std::mutex> lock (mutex);
+	return entries.size ();
+}
+
+uint64_t oslo::unchecked_map::table_size () const
+{
+	return table_count;
+}
+
+std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (unchecked_map & unchecked_map, const std::string & name)
+{
+	auto count = unchecked_map.memory_size ();
+	auto sizeof_element = sizeof (decltype (unchecked_map.entries)::value_type);
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "entries", count, sizeof_element }));
+	return composite;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <oslo/lib/numbers.hpp>
+#include <oslo/lib/utility.hpp>
+#include <oslo/secure/common.hpp>
+
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace oslo
+{
+class block_store;
+class transaction;
+class write_transaction;
+
+class unchecked_map_entry final
+{
+public:
+	uint64_t modified () const
+	{
+		return info.modified;
+	}
+	oslo::unchecked_key key;
+	oslo::unchecked_info info;
+};
+
+/** Orders unchecked keys the same way as the unchecked table, by dependency then by block hash */
+class unchecked_key_compare final
+{
+public:
+	bool operator() (oslo::unchecked_key const & lhs, oslo::unchecked_key const & rhs) const
+	{
+		return lhs.previous < rhs.previous || (lhs.previous == rhs.previous && lhs.hash < rhs.hash);
+	}
+};
+
+/**
+ * Blocks waiting for their previous or source block, keyed by that dependency.
+ * Entries are kept in memory up to a budget. Once it is exceeded the entries with the earliest modified time
+ * are moved to the unchecked table, or dropped when running memory only. The unchecked table is only read
+ * while it holds entries, so out of order blocks do not cost database writes and deletes, and processed
+ * blocks do not cost a read, as long as the backlog fits in memory.
+ */
+class unchecked_map final
+{
+public:
+	unchecked_map (oslo::block_store &, oslo::ledger_cache &, size_t, bool);
+	/** Adds or replaces an entry */
+	void put (oslo::write_transaction const &, oslo::unchecked_key const &, oslo::unchecked_info const &);
+	bool exists (oslo::transaction const &, oslo::unchecked_key const &);
+	void del (oslo::write_transaction const &, oslo::unchecked_key const &);
+	/** Entries waiting for the block \p hash_a */
+	std::vector<oslo::unchecked_info> get (oslo::transaction const &, oslo::block_hash const & hash_a);
+	void clear (oslo::write_transaction const &);
+	size_t count (oslo::transaction const &);
+	/** Calls \p action_a with entries in key order starting at \p key_a until it returns false */
+	void for_each (oslo::transaction const &, oslo::unchecked_key const & key_a, std::function<bool(oslo::unchecked_key const &, oslo::unchecked_info const &)> const & action_a);
+	/** Removes memory entries modified before \p cutoff_a seconds since epoch and returns their blocks */
+	std::vector<std::shared_ptr<oslo::block>> erase_expired (uint64_t cutoff_a);
+	/** Moves all memory entries to the unchecked table, unless running memory only */
+	void flush (oslo::write_transaction const &);
+	size_t memory_size ();
+	/** Number of entries in the unchecked table */
+	uint64_t table_size () const;
+
+private:
+	void put_table (oslo::write_transaction const &, oslo::unchecked_key const &, oslo::unchecked_info const &);
+	bool exists_table (oslo::transaction const &, oslo::unchecked_key const &);
+	oslo::block_store & store;
+	oslo::ledger_cache & cache;
+	size_t const max_memory;
+	bool const memory_only;
+	std::atomic<uint64_t> table_count{ 0 };
+	// clang-format off
+	class tag_key {};
+	class tag_modified {};
+	boost::multi_index_container<oslo::unchecked_map_entry,
+	boost::multi_index::indexed_by<
+		boost::multi_index::ordered_unique<boost::multi_index::tag<tag_key>,
+			boost::multi_index::member<oslo::unchecked_map_entry, oslo::unchecked_key, &oslo::unchecked_map_entry::key>, oslo::unchecked_key_compare>,
+		boost::multi_index::ordered_non_unique<boost::multi_index::tag<tag_modified>,
+			boost::multi_index::const_mem_fun<oslo::unchecked_map_entry, uint64_t, &oslo::unchecked_map_entry::modified>>>>
+	entries;
+	// clang-format on
+	std::mutex mutex;
+
+	friend std::unique_ptr<container_info_component> collect_container_info (unchecked_map & unchecked_map, const std::string & name);
+};
+
+std::unique_ptr<container_info_component> collect_container_info (unchecked_map & unchecked_map, const std::string & name);
+}
@@ -0,0 +1,163 @@
+#include <oslo/lib/threading.hpp>
+#include <oslo/node/transport/transport.hpp>
+#include <oslo/node/vote_batcher.hpp>
+#include <oslo/secure/common.hpp>
+
+constexpr size_t oslo::vote_batcher::max_votes;
+
+oslo::vote_batcher::vote_batcher (oslo::stat & stats_a, std::chrono::milliseconds const & delay_a) :
+stats (stats_a),
+delay (delay_a),
+thread ([this]() { run (); })
+{
+}
+
+oslo::vote_batcher::~vote_batcher ()
+{
+	stop ();
+}
+
+void oslo::vote_batcher::add (std::shared_ptr<oslo::transport::channel> const & channel_a, std::shared_ptr<oslo::vote> const & vote_a, oslo::buffer_drop_policy drop_policy_a)
+{
+	auto message (std::make_shared<oslo::confirm_ack> (vote_a));
+	if (delay.count () > 0 && channel_a->get_type () == oslo::transport::transport_type::tcp)
+	{
+		pending full;
+		auto notify (false);
+		{
+			auto endpoint (oslo::transport::map_endpoint_to_v6 (channel_a->get_endpoint ()));
+			oslo::lock_guard<std::mutex> guard (mutex);
+			if (!stopped)
+			{
+				auto existing (channels.find (endpoint));
+				if (existing == channels.end ())
+				{
+					auto deadline (std::chrono::steady_clock::now () + delay);
+					existing = channels.emplace (endpoint, pending{ channel_a, {}, deadline, drop_policy_a }).first;
+					// Deadlines only increase, the thread needs waking only when it has nothing to wait for
+					notify = deadlines.empty ();
+					deadlines.emplace_back (deadline, endpoint);
+				}
+				// Only the newest channel to an endpoint is kept
+				existing->second.channel = channel_a;
+				existing->second.messages.push_back (message);
+				existing->second.drop_policy = std::max (existing->second.drop_policy, drop_policy_a);
+				if (existing->second.messages.size () >= max_votes)
+				{
+					full = std::move (existing->second);
+					channels.erase (existing);
+				}
+			}
+		}
+		if (full.channel != nullptr)
+		{
+			send (full, oslo::stat::detail::batch_full);
+		}
+		else if (notify)
+		{
+			condition.notify_all ();
+		}
+	}
+	else
+	{
+		channel_a->send (*message, nullptr, drop_policy_a);
+	}
+}
+
+void oslo::vote_batcher::send (oslo::vote_batcher::pending const & pending_a, oslo::stat::detail reason_a)
+{
+	debug_assert (!pending_a.messages.empty ());
+	stats.inc (oslo::stat::type::vote_batcher, reason_a, oslo::stat::dir::out);
+	stats.add (oslo::stat::type::vote_batcher, oslo::stat::detail::batch_votes, oslo::stat::dir::out, pending_a.messages.size ());
+	if (pending_a.messages.size () == 1)
+	{
+		pending_a.channel->send (*pending_a.messages.front (), nullptr, pending_a.drop_policy);
+	}
+	else
+	{
+		pending_a.channel->send_many (pending_a.messages, pending_a.drop_policy);
+	}
+}
+
+void oslo::vote_batcher::run ()
+{
+	oslo::thread_role::set (oslo::thread_role::name::vote_batching);
+	oslo::unique_lock<std::mutex> lock (mutex);
+	while (!stopped)
+	{
+		if (!deadlines.empty ())
+		{
+			auto front (deadlines.front ());
+			if (front.first <= std::chrono::steady_clock::now ())
+			{
+				deadlines.pop_front ();
+				auto existing (channels.find (front.second));
+				// Channels flushed early for being full may have a newer entry with a later deadline
+				if (existing != channels.end () && existing->second.deadline == front.first)
+				{
+					auto pending_l (std::move (existing->second));
+					channels.erase (existing);
+					lock.unlock ();
+					send (pending_l, oslo::stat::detail::batch_deadline);
+					lock.lock ();
+				}
+			}
+			else
+			{
+				condition.wait_until (lock, front.first);
+			}
+		}
+		else
+		{
+			condition.wait (lock);
+		}
+	}
+}
+
+void oslo::vote_batcher::flush ()
+{
+	decltype (channels) channels_l;
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		channels_l.swap (channels);
+		deadlines.clear ();
+	}
+	for (auto const & pending_l : channels_l)
+	{
+		send (pending_l.second, oslo::stat::detail::batch_deadline);
+	}
+}
+
+void oslo::vote_batcher::stop ()
+{
+	{
+		oslo::lock_guard<std::mutex> guard (mutex);
+		stopped = true;
+	}
+	condition.notify_all ();
+	if (thread.joinable ())
+	{
+		thread.join ();
+	}
+}
+
+size_t oslo::vote_batcher::size ()
+{
+	oslo::lock_guard<std::mutex> guard (mutex);
+	return channels.size ();
+}
+
+std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (vote_batcher & vote_batcher, const std::string & name)
+{
+	size_t channels_count;
+	size_t deadlines_count;
+	{
+		oslo::lock_guard<std::mutex> guard (vote_batcher.mutex);
+		channels_count = vote_batcher.channels.size ();
+		deadlines_count = vote_batcher.deadlines.size ();
+	}
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "channels", channels_count, sizeof (decltype (vote_batcher.channels)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "deadlines", deadlines_count, sizeof (decltype (vote_batcher.deadlines)::value_type) }));
+	return composite;
+}
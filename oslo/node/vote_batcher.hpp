@@ -0,0 +1,71 @@
+#pragma once
+
+#include <oslo/lib/locks.hpp>
+#include <oslo/lib/stats.hpp>
+#include <oslo/lib/utility.hpp>
+#include <oslo/node/common.hpp>
+#include <oslo/node/socket.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace oslo
+{
+class vote;
+namespace transport
+{
+	class channel;
+}
+/**
+ * Holds outgoing votes for each TCP channel for up to a short delay and writes them to the socket together,
+ * so a burst of generated votes reaches a peer in one write instead of one write per confirm_ack.
+ * A channel is flushed early once max_votes votes are pending. UDP channels, and every channel when the delay is zero, are sent to directly.
+ */
+class vote_batcher final
+{
+public:
+	vote_batcher (oslo::stat &, std::chrono::milliseconds const &);
+	~vote_batcher ();
+	/**
+	 * Sends \p vote_a to \p channel_a in a confirm_ack, possibly together with other votes for the same channel.
+	 * A batch is written with the strictest drop policy of its votes.
+	 */
+	void add (std::shared_ptr<oslo::transport::channel> const & channel_a, std::shared_ptr<oslo::vote> const & vote_a, oslo::buffer_drop_policy = oslo::buffer_drop_policy::limiter);
+	/** Sends all pending votes */
+	void flush ();
+	void stop ();
+	/** Number of channels with pending votes */
+	size_t size ();
+	/** Most votes sent in one write */
+	static size_t constexpr max_votes = 32;
+
+private:
+	class pending final
+	{
+	public:
+		std::shared_ptr<oslo::transport::channel> channel;
+		std::vector<std::shared_ptr<oslo::message>> messages;
+		std::chrono::steady_clock::time_point deadline;
+		oslo::buffer_drop_policy drop_policy{ oslo::buffer_drop_policy::limiter };
+	};
+	void run ();
+	void send (oslo::vote_batcher::pending const &, oslo::stat::detail);
+	oslo::stat & stats;
+	std::chrono::milliseconds const delay;
+	std::unordered_map<oslo::endpoint, pending> channels;
+	/** Flush deadlines in the order they were set, all channels wait for the same delay */
+	std::deque<std::pair<std::chrono::steady_clock::time_point, oslo::endpoint>> deadlines;
+	bool stopped{ false };
+	oslo::condition_variable condition;
+	std::mutex mutex;
+	std::thread thread;
+
+	friend std::unique_ptr<container_info_component> collect_container_info (vote_batcher &, const std::string &);
+};
+std::unique_ptr<container_info_component> collect_container_info (vote_batcher &, const std::string &);
+}
@@ -1,5 +1,7 @@
 #include "transport/udp.hpp"
 
+#include <oslo/boost/asio/post.hpp>
+#include <oslo/lib/stats.hpp>
 #include <oslo/lib/threading.hpp>
 #include <oslo/node/network.hpp>
 #include <oslo/node/nodeconfig.hpp>
@@ -12,14 +14,17 @@
 #include <boost/variant/get.hpp>
 
 #include <chrono>
+#include <future>
 
-oslo::vote_generator::vote_generator (oslo::node_config const & config_a, oslo::ledger & ledger_a, oslo::wallets & wallets_a, oslo::vote_processor & vote_processor_a, oslo::votes_cache & votes_cache_a, oslo::network & network_a) :
+oslo::vote_generator::vote_generator (oslo::node_config const & config_a, oslo::ledger & ledger_a, oslo::wallets & wallets_a, oslo::vote_processor & vote_processor_a, oslo::votes_cache & votes_cache_a, oslo::network & network_a, oslo::stat & stats_a) :
 config (config_a),
 ledger (ledger_a),
 wallets (wallets_a),
 vote_processor (vote_processor_a),
 votes_cache (votes_cache_a),
 network (network_a),
+stats (stats_a),
+signing_pool (config_a.vote_generator_threads),
 thread ([this]() { run (); })
 {
 	oslo::unique_lock<std::mutex> lock (mutex);
@@ -54,27 +59,96 @@ void oslo::vote_generator::stop ()
 	{
 		thread.join ();
 	}
+	signing_pool.join ();
+}
+
+void oslo::vote_generator::sign (size_t count_a, std::function<void(size_t)> const & sign_a)
+{
+	std::atomic<size_t> next{ 0 };
+	auto sign_next = [&next, count_a, &sign_a]() {
+		for (auto i (next++); i < count_a; i = next++)
+		{
+			sign_a (i);
+		}
+	};
+	auto helpers (std::min<size_t> (config.vote_generator_threads, count_a - 1));
+	std::vector<std::future<void>> helpers_done;
+	helpers_done.reserve (helpers);
+	for (size_t i (0); i < helpers; ++i)
+	{
+		auto promise (std::make_shared<std::promise<void>> ());
+		helpers_done.push_back (promise->get_future ());
+		boost::asio::post (signing_pool, [promise, &sign_next]() {
+			if (oslo::thread_role::get () != oslo::thread_role::name::voting)
+			{
+				oslo::thread_role::set (oslo::thread_role::name::voting);
+			}
+			sign_next ();
+			promise->set_value ();
+		});
+	}
+	sign_next ();
+	for (auto & done : helpers_done)
+	{
+		done.wait ();
+	}
 }
 
 void oslo::vote_generator::send (oslo::unique_lock<std::mutex> & lock_a)
 {
-	std::vector<oslo::block_hash> hashes_l;
-	hashes_l.reserve (oslo::network::confirm_ack_hashes_max);
-	while (!hashes.empty () && hashes_l.size () < oslo::network::confirm_ack_hashes_max)
+	std::vector<std::vector<oslo::block_hash>> batches_l;
+	while (!hashes.empty () && batches_l.size () < batches_max)
 	{
-		hashes_l.push_back (hashes.front ());
-		hashes.pop_front ();
+		batches_l.emplace_back ();
+		auto & hashes_l (batches_l.back ());
+		hashes_l.reserve (oslo::network::confirm_ack_hashes_max);
+		while (!hashes.empty () && hashes_l.size () < oslo::network::confirm_ack_hashes_max)
+		{
+			hashes_l.push_back (hashes.front ());
+			hashes.pop_front ();
+		}
 	}
 	lock_a.unlock ();
 	{
-		auto transaction (ledger.store.tx_begin_read ());
-		wallets.foreach_representative ([this, &hashes_l, &transaction](oslo::public_key const & pub_a, oslo::raw_key const & prv_a) {
-			auto vote (this->ledger.store.vote_generate (transaction, pub_a, prv_a, hashes_l));
-			this->votes_cache.add (vote);
-			this->network.flood_vote_pr (vote);
-			this->network.flood_vote (vote, 2.0f);
-			this->vote_processor.vote (vote, std::make_shared<oslo::transport::channel_udp> (this->network.udp_channels, this->network.endpoint (), this->network_params.protocol.protocol_version));
+		std::vector<std::pair<oslo::public_key, oslo::raw_key>> representatives_l;
+		wallets.foreach_representative ([&representatives_l](oslo::public_key const & pub_a, oslo::raw_key const & prv_a) {
+			representatives_l.emplace_back (pub_a, prv_a);
 		});
+		if (!representatives_l.empty ())
+		{
+			auto transaction (ledger.store.tx_begin_read ());
+			// Sequence numbers are reserved for all batches at once so votes can be signed concurrently
+			std::vector<uint64_t> sequences_l;
+			sequences_l.reserve (representatives_l.size ());
+			for (auto const & representative : representatives_l)
+			{
+				sequences_l.push_back (ledger.store.vote_sequence_reserve (transaction, representative.first, batches_l.size ()));
+			}
+			std::vector<std::shared_ptr<oslo::vote>> votes_l (representatives_l.size () * batches_l.size ());
+			auto signing_start (std::chrono::steady_clock::now ());
+			sign (votes_l.size (), [&votes_l, &representatives_l, &sequences_l, &batches_l](size_t index_a) {
+				auto representative_index (index_a / batches_l.size ());
+				auto batch_index (index_a % batches_l.size ());
+				auto const & representative (representatives_l[representative_index]);
+				votes_l[index_a] = std::make_shared<oslo::vote> (representative.first, representative.second, sequences_l[representative_index] + batch_index, batches_l[batch_index]);
+			});
+			auto signing_time (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - signing_start));
+			stats.add (oslo::stat::type::vote_generator, oslo::stat::detail::generator_signed, oslo::stat::dir::out, votes_l.size ());
+			stats.add (oslo::stat::type::vote_generator, oslo::stat::detail::generator_signing_time, oslo::stat::dir::out, signing_time.count ());
+			for (auto i (batches_l.size () - 1); i < votes_l.size (); i += batches_l.size ())
+			{
+				// Releases the reserved sequence numbers once the highest signed vote is stored
+				ledger.store.vote_max (transaction, votes_l[i]);
+			}
+			auto channel (std::make_shared<oslo::transport::channel_udp> (network.udp_channels, network.endpoint (), network_params.protocol.protocol_version));
+			for (auto const & vote : votes_l)
+			{
+				votes_cache.add (vote);
+				network.flood_vote_pr (vote);
+				network.flood_vote (vote, 2.0f);
+				vote_processor.vote (vote, channel);
+			}
+		}
 	}
 	lock_a.lock ();
 }
@@ -128,7 +202,8 @@ void oslo::vote_generator_session::flush ()
 	}
 }
 
-oslo::votes_cache::votes_cache (oslo::wallets & wallets_a) :
+oslo::votes_cache::votes_cache (oslo::wallets & wallets_a, size_t max_bytes_a) :
+max_bytes (max_bytes_a),
 wallets (wallets_a)
 {
 }
@@ -141,55 +216,73 @@ void oslo::votes_cache::add (std::shared_ptr<oslo::vote> const & vote_a)
 		return;
 	}
 	oslo::lock_guard<std::mutex> lock (cache_mutex);
-	auto const max_cache_size (network_params.voting.max_cache / std::max (voting, static_cast<decltype (voting)> (1)));
+	// The slot is held for the duration of the insertion so eviction cannot free it
+	auto const slot (slot_acquire (vote_a));
 	for (auto & block : vote_a->blocks)
 	{
 		auto hash (boost::get<oslo::block_hash> (block));
-		auto existing (cache.get<tag_hash> ().find (hash));
-		if (existing == cache.get<tag_hash> ().end ())
+		auto existing (entries.find (hash));
+		if (existing == entries.end ())
 		{
-			// Clean old votes
-			if (cache.size () >= max_cache_size)
-			{
-				cache.get<tag_sequence> ().pop_front ();
-			}
 			// Insert new votes (new hash)
-			auto inserted (cache.get<tag_sequence> ().emplace_back (oslo::cached_votes{ hash, std::vector<std::shared_ptr<oslo::vote>> (1, vote_a) }));
-			(void)inserted;
-			debug_assert (inserted.second);
+			entry entry_l{ {}, 0, false };
+			entry_l.votes.push_back (slot);
+			auto const bytes_l (entry_bytes (entry_l));
+			// Clean old votes
+			evict (max_bytes > bytes_l ? max_bytes - bytes_l : 0);
+			entry_l.position = static_cast<uint32_t> (ring.size ());
+			++slab[slot].references;
+			total_bytes += bytes_l;
+			auto inserted (entries.emplace (hash, std::move (entry_l)));
+			ring.push_back (&*inserted.first);
 		}
 		else
 		{
 			// Insert new votes (old hash)
-			cache.get<tag_hash> ().modify (existing, [vote_a](oslo::cached_votes & cache_a) {
-				// Replace old vote for same representative & hash
-				bool replaced (false);
-				for (auto i (cache_a.votes.begin ()), n (cache_a.votes.end ()); i != n && !replaced; ++i)
+			auto & entry_l (existing->second);
+			total_bytes -= entry_bytes (entry_l);
+			// Replace old vote for same representative & hash
+			bool replaced (false);
+			for (auto i (entry_l.votes.begin ()), n (entry_l.votes.end ()); i != n && !replaced; ++i)
+			{
+				if (slab[*i].vote->account == vote_a->account)
 				{
-					if ((*i)->account == vote_a->account)
+					if (*i != slot)
 					{
-						*i = vote_a;
-						replaced = true;
+						++slab[slot].references;
+						slot_release (*i);
+						*i = slot;
 					}
+					replaced = true;
 				}
-				// Insert new vote
-				if (!replaced)
-				{
-					cache_a.votes.push_back (vote_a);
-				}
-			});
+			}
+			// Insert new vote
+			if (!replaced)
+			{
+				++slab[slot].references;
+				entry_l.votes.push_back (slot);
+			}
+			entry_l.referenced = true;
+			total_bytes += entry_bytes (entry_l);
 		}
 	}
+	slot_release (slot);
+	evict (max_bytes);
 }
 
 std::vector<std::shared_ptr<oslo::vote>> oslo::votes_cache::find (oslo::block_hash const & hash_a)
 {
 	std::vector<std::shared_ptr<oslo::vote>> result;
 	oslo::lock_guard<std::mutex> lock (cache_mutex);
-	auto existing (cache.get<tag_hash> ().find (hash_a));
-	if (existing != cache.get<tag_hash> ().end ())
+	auto existing (entries.find (hash_a));
+	if (existing != entries.end ())
 	{
-		result = existing->votes;
+		existing->second.referenced = true;
+		result.reserve (existing->second.votes.size ());
+		for (auto index : existing->second.votes)
+		{
+			result.push_back (slab[index].vote);
+		}
 	}
 	return result;
 }
@@ -197,7 +290,128 @@ std::vector<std::shared_ptr<oslo::vote>> oslo::votes_cache::find (oslo::block_ha
 void oslo::votes_cache::remove (oslo::block_hash const & hash_a)
 {
 	oslo::lock_guard<std::mutex> lock (cache_mutex);
-	cache.get<tag_hash> ().erase (hash_a);
+	auto existing (entries.find (hash_a));
+	if (existing != entries.end ())
+	{
+		erase (existing);
+	}
+}
+
+size_t oslo::votes_cache::size ()
+{
+	oslo::lock_guard<std::mutex> lock (cache_mutex);
+	return entries.size ();
+}
+
+size_t oslo::votes_cache::votes_size ()
+{
+	oslo::lock_guard<std::mutex> lock (cache_mutex);
+	return slab.size () - free_slots.size ();
+}
+
+size_t oslo::votes_cache::bytes ()
+{
+	oslo::lock_guard<std::mutex> lock (cache_mutex);
+	return total_bytes;
+}
+
+size_t oslo::votes_cache::entry_bytes_estimate ()
+{
+	// One hash entry plus a vote for a single hash
+	entry entry_l{ {}, 0, false };
+	entry_l.votes.push_back (0);
+	oslo::vote vote_l;
+	vote_l.blocks.emplace_back (oslo::block_hash (0));
+	return entry_bytes (entry_l) + vote_bytes (vote_l);
+}
+
+uint32_t oslo::votes_cache::slot_acquire (std::shared_ptr<oslo::vote> const & vote_a)
+{
+	uint32_t result;
+	if (!free_slots.empty ())
+	{
+		result = free_slots.back ();
+		free_slots.pop_back ();
+	}
+	else
+	{
+		result = static_cast<uint32_t> (slab.size ());
+		slab.emplace_back ();
+	}
+	slab[result].vote = vote_a;
+	slab[result].references = 1;
+	total_bytes += vote_bytes (*vote_a);
+	return result;
+}
+
+void oslo::votes_cache::slot_release (uint32_t index_a)
+{
+	auto & slot_l (slab[index_a]);
+	debug_assert (slot_l.references > 0);
+	if (--slot_l.references == 0)
+	{
+		total_bytes -= vote_bytes (*slot_l.vote);
+		slot_l.vote.reset ();
+		free_slots.push_back (index_a);
+	}
+}
+
+void oslo::votes_cache::erase (entries_t::iterator existing_a)
+{
+	auto & entry_l (existing_a->second);
+	total_bytes -= entry_bytes (entry_l);
+	for (auto index : entry_l.votes)
+	{
+		slot_release (index);
+	}
+	// Swap-remove from the clock ring
+	auto const position (entry_l.position);
+	if (position != ring.size () - 1)
+	{
+		ring[position] = ring.back ();
+		ring[position]->second.position = position;
+	}
+	ring.pop_back ();
+	entries.erase (existing_a);
+	if (hand >= ring.size ())
+	{
+		hand = 0;
+	}
+}
+
+void oslo::votes_cache::evict (size_t max_bytes_a)
+{
+	while (total_bytes > max_bytes_a && !ring.empty ())
+	{
+		auto & value (*ring[hand]);
+		if (value.second.referenced)
+		{
+			// Second chance
+			value.second.referenced = false;
+			hand = (hand + 1) % ring.size ();
+		}
+		else
+		{
+			erase (entries.find (value.first));
+		}
+	}
+}
+
+size_t oslo::votes_cache::vote_bytes (oslo::vote const & vote_a)
+{
+	// Votes are usually created with make_shared, the control block shares their allocation
+	return sizeof (vote_slot) + sizeof (oslo::vote) + 2 * sizeof (void *) + vote_a.blocks.size () * sizeof (decltype (vote_a.blocks)::value_type);
+}
+
+size_t oslo::votes_cache::entry_bytes (entry const & entry_a)
+{
+	// Map node with its link and bucket pointers, plus the clock ring pointer
+	auto result (sizeof (entries_t::value_type) + 3 * sizeof (void *));
+	if (entry_a.votes.capacity () > inline_votes)
+	{
+		result += entry_a.votes.capacity () * sizeof (uint32_t);
+	}
+	return result;
 }
 
 std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (vote_generator & vote_generator, const std::string & name)
@@ -216,15 +430,16 @@ std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (vo
 
 std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (votes_cache & votes_cache, const std::string & name)
 {
-	size_t cache_count;
+	size_t entries_count;
+	size_t votes_count;
 
 	{
 		oslo::lock_guard<std::mutex> guard (votes_cache.cache_mutex);
-		cache_count = votes_cache.cache.size ();
+		entries_count = votes_cache.entries.size ();
+		votes_count = votes_cache.slab.size () - votes_cache.free_slots.size ();
 	}
-	auto sizeof_element = sizeof (decltype (votes_cache.cache)::value_type);
 	auto composite = std::make_unique<container_info_composite> (name);
-	/* This does not currently loop over each element inside the cache to get the sizes of the votes inside cached_votes */
-	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "cache", cache_count, sizeof_element }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "entries", entries_count, sizeof (oslo::votes_cache::entries_t::value_type) + 3 * sizeof (void *) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "votes", votes_count, sizeof (oslo::votes_cache::vote_slot) + sizeof (oslo::vote) }));
 	return composite;
 }
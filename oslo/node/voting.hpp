@@ -1,11 +1,13 @@
 #pragma once
 
+#include <oslo/boost/asio/thread_pool.hpp>
 #include <oslo/lib/locks.hpp>
 #include <oslo/lib/numbers.hpp>
 #include <oslo/lib/utility.hpp>
 #include <oslo/node/wallet.hpp>
 #include <oslo/secure/common.hpp>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
@@ -16,12 +18,14 @@
 #include <deque>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 
 namespace oslo
 {
 class ledger;
 class network;
 class node_config;
+class stat;
 class vote_processor;
 class votes_cache;
 class wallets;
@@ -29,25 +33,32 @@ class wallets;
 class vote_generator final
 {
 public:
-	vote_generator (oslo::node_config const & config_a, oslo::ledger &, oslo::wallets & wallets_a, oslo::vote_processor & vote_processor_a, oslo::votes_cache & votes_cache_a, oslo::network & network_a);
+	vote_generator (oslo::node_config const & config_a, oslo::ledger &, oslo::wallets & wallets_a, oslo::vote_processor & vote_processor_a, oslo::votes_cache & votes_cache_a, oslo::network & network_a, oslo::stat & stats_a);
 	void add (oslo::block_hash const &);
 	void stop ();
 
+	/** Maximum number of confirm_ack sized batches of hashes signed together for each representative */
+	static size_t constexpr batches_max = 8;
+
 private:
 	void run ();
 	void send (oslo::unique_lock<std::mutex> &);
+	/** Calls \p sign_a for every index in [0, \p count_a), spread over the signing threads and the calling thread */
+	void sign (size_t count_a, std::function<void(size_t)> const & sign_a);
 	oslo::node_config const & config;
 	oslo::ledger & ledger;
 	oslo::wallets & wallets;
 	oslo::vote_processor & vote_processor;
 	oslo::votes_cache & votes_cache;
 	oslo::network & network;
+	oslo::stat & stats;
 	std::mutex mutex;
 	oslo::condition_variable condition;
 	std::deque<oslo::block_hash> hashes;
 	oslo::network_params network_params;
 	bool stopped{ false };
 	bool started{ false };
+	boost::asio::thread_pool signing_pool;
 	std::thread thread;
 
 	friend std::unique_ptr<container_info_component> collect_container_info (vote_generator & vote_generator, const std::string & name);
@@ -66,33 +77,59 @@ private:
 };
 
 std::unique_ptr<container_info_component> collect_container_info (vote_generator & vote_generator, const std::string & name);
-class cached_votes final
-{
-public:
-	oslo::block_hash hash;
-	std::vector<std::shared_ptr<oslo::vote>> votes;
-};
+/**
+ * Cache of recently generated votes, keyed by block hash.
+ * Each vote is stored once in a slab and referenced by index from every hash it covers, so a
+ * multi-hash vote costs one allocation regardless of how many hashes it contains.
+ * Entries are evicted in clock order until the accounted memory fits within the byte budget.
+ */
 class votes_cache final
 {
 public:
-	votes_cache (oslo::wallets & wallets_a);
+	votes_cache (oslo::wallets & wallets_a, size_t max_bytes_a);
 	void add (std::shared_ptr<oslo::vote> const &);
 	std::vector<std::shared_ptr<oslo::vote>> find (oslo::block_hash const &);
 	void remove (oslo::block_hash const &);
+	size_t size ();
+	size_t votes_size ();
+	/** Approximate number of bytes held by the cache */
+	size_t bytes ();
+	/** Approximate cost of a hash entry referencing a single-hash vote */
+	static size_t entry_bytes_estimate ();
 
 private:
+	class vote_slot final
+	{
+	public:
+		std::shared_ptr<oslo::vote> vote;
+		uint32_t references{ 0 };
+	};
+	/** Votes per hash stored without a separate allocation, one per voting representative is typical */
+	static size_t constexpr inline_votes = 2;
+	class entry final
+	{
+	public:
+		boost::container::small_vector<uint32_t, inline_votes> votes;
+		uint32_t position;
+		bool referenced;
+	};
+	using entries_t = std::unordered_map<oslo::block_hash, entry>;
+	uint32_t slot_acquire (std::shared_ptr<oslo::vote> const &);
+	void slot_release (uint32_t);
+	void erase (entries_t::iterator);
+	void evict (size_t);
+	static size_t vote_bytes (oslo::vote const &);
+	static size_t entry_bytes (entry const &);
 	std::mutex cache_mutex;
-	// clang-format off
-	class tag_sequence {};
-	class tag_hash {};
-	boost::multi_index_container<oslo::cached_votes,
-	boost::multi_index::indexed_by<
-		boost::multi_index::sequenced<boost::multi_index::tag<tag_sequence>>,
-		boost::multi_index::hashed_unique<boost::multi_index::tag<tag_hash>,
-			boost::multi_index::member<oslo::cached_votes, oslo::block_hash, &oslo::cached_votes::hash>>>>
-	cache;
-	// clang-format on
-	oslo::network_params network_params;
+	std::vector<vote_slot> slab;
+	std::vector<uint32_t> free_slots;
+	entries_t entries;
+	/** Clock ring of pointers to the map nodes, which are stable, entries store their position for swap-removal */
+	std::vector<entries_t::value_type *> ring;
+	size_t hand{ 0 };
+	size_t total_bytes{ 0 };
+	/** Budget covering the votes of all local voting representatives, each one adds its votes to the cost of a hash */
+	size_t const max_bytes;
 	oslo::wallets & wallets;
 	friend std::unique_ptr<container_info_component> collect_container_info (votes_cache & votes_cache, const std::string & name);
 };
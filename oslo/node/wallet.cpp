@@ -241,6 +241,7 @@ void oslo::fan::value_set (oslo::raw_key const & value_a)
 	value_get (value_l);
 	*(values[0]) ^= value_l.data;
 	*(values[0]) ^= value_a.data;
+	++generation;
 }
 
 // Wallet version number
@@ -824,8 +825,11 @@ oslo::public_key oslo::wallet::deterministic_insert (oslo::transaction const & t
 		auto half_principal_weight (wallets.node.minimum_principal_weight () / 2);
 		if (wallets.check_rep (key, half_principal_weight))
 		{
-			oslo::lock_guard<std::mutex> lock (representatives_mutex);
-			representatives.insert (key);
+			{
+				oslo::lock_guard<std::mutex> lock (representatives_mutex);
+				representatives.insert (key);
+			}
+			wallets.voting_keys_invalidate ();
 		}
 	}
 	return key;
@@ -867,8 +871,11 @@ oslo::public_key oslo::wallet::insert_adhoc (oslo::transaction const & transacti
 		auto half_principal_weight (wallets.node.minimum_principal_weight () / 2);
 		if (wallets.check_rep (key, half_principal_weight))
 		{
-			oslo::lock_guard<std::mutex> lock (representatives_mutex);
-			representatives.insert (key);
+			{
+				oslo::lock_guard<std::mutex> lock (representatives_mutex);
+				representatives.insert (key);
+			}
+			wallets.voting_keys_invalidate ();
 		}
 	}
 	return key;
@@ -892,6 +899,21 @@ bool oslo::wallet::exists (oslo::public_key const & account_a)
 	return store.exists (transaction, account_a);
 }
 
+void oslo::wallet::erase (oslo::transaction const & transaction_a, oslo::account const & account_a)
+{
+	store.erase (transaction_a, account_a);
+	auto representative (false);
+	{
+		oslo::lock_guard<std::mutex> lock (representatives_mutex);
+		representative = representatives.erase (account_a) > 0;
+	}
+	if (representative)
+	{
+		// The cached private key would otherwise keep signing votes until the next compute_reps
+		wallets.voting_keys_invalidate ();
+	}
+}
+
 bool oslo::wallet::import (std::string const & json_a, std::string const & password_a)
 {
 	auto error (false);
@@ -1692,6 +1714,7 @@ void oslo::wallets::destroy (oslo::wallet_id const & id_a)
 	auto wallet (existing->second);
 	items.erase (existing);
 	wallet->store.destroy (transaction);
+	voting_keys_invalidate ();
 }
 
 void oslo::wallets::reload ()
@@ -1735,6 +1758,10 @@ void oslo::wallets::reload ()
 		debug_assert (items.find (i) == items.end ());
 		items.erase (i);
 	}
+	if (!deleted_items.empty ())
+	{
+		voting_keys_invalidate ();
+	}
 }
 
 void oslo::wallets::queue_wallet_action (oslo::uint128_t const & amount_a, std::shared_ptr<oslo::wallet> wallet_a, std::function<void(oslo::wallet &)> const & action_a)
@@ -1752,50 +1779,72 @@ void oslo::wallets::foreach_representative (std::function<void(oslo::public_key
 	{
 		std::vector<std::pair<oslo::public_key const, oslo::raw_key const>> action_accounts_l;
 		{
-			auto transaction_l (tx_begin_read ());
-			oslo::lock_guard<std::mutex> lock (mutex);
-			for (auto i (items.begin ()), n (items.end ()); i != n; ++i)
+			oslo::lock_guard<std::mutex> voting_keys_lock (voting_keys_mutex);
+			if (voting_keys.stale ())
 			{
-				auto & wallet (*i->second);
-				oslo::lock_guard<std::recursive_mutex> store_lock (wallet.store.mutex);
-				decltype (wallet.representatives) representatives_l;
+				voting_keys_refresh ();
+			}
+			for (auto const & representative : voting_keys.keys)
+			{
+				if (!node.ledger.weight (representative.first).is_zero ())
 				{
-					oslo::lock_guard<std::mutex> representatives_lock (wallet.representatives_mutex);
-					representatives_l = wallet.representatives;
+					action_accounts_l.emplace_back (representative.first, representative.second);
 				}
+			}
+		}
+		for (auto const & representative : action_accounts_l)
+		{
+			action_a (representative.first, representative.second);
+		}
+	}
+}
+
+void oslo::wallets::voting_keys_invalidate ()
+{
+	voting_keys.invalidate ();
+}
+
+void oslo::wallets::voting_keys_refresh ()
+{
+	debug_assert (!voting_keys_mutex.try_lock ());
+	std::vector<std::pair<oslo::public_key, oslo::raw_key>> keys_l;
+	std::vector<std::pair<std::shared_ptr<oslo::wallet>, uint64_t>> sources_l;
+	auto transaction_l (tx_begin_read ());
+	oslo::lock_guard<std::mutex> lock (mutex);
+	for (auto i (items.begin ()), n (items.end ()); i != n; ++i)
+	{
+		auto & wallet (*i->second);
+		oslo::lock_guard<std::recursive_mutex> store_lock (wallet.store.mutex);
+		decltype (wallet.representatives) representatives_l;
+		{
+			oslo::lock_guard<std::mutex> representatives_lock (wallet.representatives_mutex);
+			representatives_l = wallet.representatives;
+		}
+		if (!representatives_l.empty ())
+		{
+			// Read the generation before validating, a concurrent password change then always leaves the cache stale
+			sources_l.emplace_back (i->second, wallet.store.password.generation.load ());
+			if (wallet.store.valid_password (transaction_l))
+			{
 				for (auto const & account : representatives_l)
 				{
 					if (wallet.store.exists (transaction_l, account))
 					{
-						if (!node.ledger.weight (account).is_zero ())
-						{
-							if (wallet.store.valid_password (transaction_l))
-							{
-								oslo::raw_key prv;
-								auto error (wallet.store.fetch (transaction_l, account, prv));
-								(void)error;
-								debug_assert (!error);
-								action_accounts_l.emplace_back (account, prv);
-							}
-							else
-							{
-								static auto last_log = std::chrono::steady_clock::time_point ();
-								if (last_log < std::chrono::steady_clock::now () - std::chrono::seconds (60))
-								{
-									last_log = std::chrono::steady_clock::now ();
-									node.logger.always_log (boost::str (boost::format ("Representative locked inside wallet %1%") % i->first.to_string ()));
-								}
-							}
-						}
+						oslo::raw_key prv;
+						auto error (wallet.store.fetch (transaction_l, account, prv));
+						(void)error;
+						debug_assert (!error);
+						keys_l.emplace_back (account, prv);
 					}
 				}
 			}
-		}
-		for (auto const & representative : action_accounts_l)
-		{
-			action_a (representative.first, representative.second);
+			else
+			{
+				node.logger.always_log (boost::str (boost::format ("Representative locked inside wallet %1%") % i->first.to_string ()));
+			}
 		}
 	}
+	voting_keys.set (std::move (keys_l), sources_l);
 }
 
 bool oslo::wallets::exists (oslo::transaction const & transaction_a, oslo::account const & account_a)
@@ -1891,6 +1940,7 @@ void oslo::wallets::compute_reps ()
 		oslo::lock_guard<std::mutex> representatives_guard (wallet.representatives_mutex);
 		wallet.representatives.swap (representatives_l);
 	}
+	voting_keys_invalidate ();
 }
 
 void oslo::wallets::ongoing_compute_reps ()
@@ -2033,6 +2083,62 @@ MDB_txn * oslo::wallet_store::tx (oslo::transaction const & transaction_a) const
 	return static_cast<MDB_txn *> (transaction_a.get_handle ());
 }
 
+oslo::voting_keys::~voting_keys ()
+{
+	clear ();
+}
+
+void oslo::voting_keys::set (std::vector<std::pair<oslo::public_key, oslo::raw_key>> && keys_a, std::vector<std::pair<std::shared_ptr<oslo::wallet>, uint64_t>> const & sources_a)
+{
+	clear ();
+	keys = std::move (keys_a);
+	if (!keys.empty ())
+	{
+		// Best effort, the keys remain usable if the process is not allowed to lock more pages
+		oslo::lock_memory (keys.data (), keys.size () * sizeof (decltype (keys)::value_type));
+	}
+	for (auto const & source : sources_a)
+	{
+		sources.emplace_back (source.first, source.second);
+	}
+	invalidated = false;
+}
+
+void oslo::voting_keys::invalidate ()
+{
+	invalidated = true;
+}
+
+bool oslo::voting_keys::stale () const
+{
+	auto result (invalidated.load ());
+	for (auto i (sources.begin ()), n (sources.end ()); !result && i != n; ++i)
+	{
+		auto wallet (i->first.lock ());
+		result = wallet == nullptr || wallet->store.password.generation != i->second;
+	}
+	return result;
+}
+
+size_t oslo::voting_keys::size () const
+{
+	return keys.size ();
+}
+
+void oslo::voting_keys::clear ()
+{
+	if (!keys.empty ())
+	{
+		for (auto & key : keys)
+		{
+			key.second.data.clear ();
+		}
+		oslo::unlock_memory (keys.data (), keys.size () * sizeof (decltype (keys)::value_type));
+	}
+	keys.clear ();
+	sources.clear ();
+}
+
 std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (wallets & wallets, const std::string & name)
 {
 	size_t items_count;
@@ -2050,5 +2156,11 @@ std::unique_ptr<oslo::container_info_component> oslo::collect_container_info (wa
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "items", items_count, sizeof_item_element }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "actions", actions_count, sizeof_actions_element }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "work_watcher", wallets.watcher->size (), sizeof_watcher_element }));
+	size_t voting_keys_count;
+	{
+		oslo::lock_guard<std::mutex> guard (wallets.voting_keys_mutex);
+		voting_keys_count = wallets.voting_keys.size ();
+	}
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "voting_keys", voting_keys_count, sizeof (decltype (wallets.voting_keys.keys)::value_type) }));
 	return composite;
 }
@@ -26,6 +26,8 @@ public:
 	void value (oslo::raw_key &);
 	void value_set (oslo::raw_key const &);
 	std::vector<std::unique_ptr<oslo::uint256_union>> values;
+	/** Incremented on every value_set, allowing copies of secrets derived from the value to be discarded when it changes */
+	std::atomic<uint64_t> generation{ 0 };
 
 private:
 	std::mutex mutex;
@@ -137,6 +139,8 @@ public:
 	oslo::public_key deterministic_insert (uint32_t, bool = true);
 	oslo::public_key deterministic_insert (bool = true);
 	bool exists (oslo::public_key const &);
+	/** Removes \p account_a from the store, a representative also stops voting immediately */
+	void erase (oslo::transaction const &, oslo::account const &);
 	bool import (std::string const &, std::string const &);
 	void serialize (std::string &);
 	bool change_sync (oslo::account const &, oslo::account const &);
@@ -205,6 +209,28 @@ public:
 	}
 };
 
+/**
+ * Decrypted private keys of the representatives voting from this node's wallets, kept in memory locked against paging.
+ * The cache becomes stale when the password of any source wallet changes (including locking) or when it is invalidated
+ * because the set of representatives changed.
+ */
+class voting_keys final
+{
+public:
+	~voting_keys ();
+	/** Replaces the cached keys, recording the password generation of every wallet they were decrypted from */
+	void set (std::vector<std::pair<oslo::public_key, oslo::raw_key>> &&, std::vector<std::pair<std::shared_ptr<oslo::wallet>, uint64_t>> const &);
+	void invalidate ();
+	bool stale () const;
+	size_t size () const;
+	std::vector<std::pair<oslo::public_key, oslo::raw_key>> keys;
+
+private:
+	void clear ();
+	std::vector<std::pair<std::weak_ptr<oslo::wallet>, uint64_t>> sources;
+	std::atomic<bool> invalidated{ true };
+};
+
 /**
  * The wallets set is all the wallets a node controls.
  * A node may contain multiple wallets independently encrypted and operated.
@@ -223,6 +249,8 @@ public:
 	void do_wallet_actions ();
 	void queue_wallet_action (oslo::uint128_t const &, std::shared_ptr<oslo::wallet>, std::function<void(oslo::wallet &)> const &);
 	void foreach_representative (std::function<void(oslo::public_key const &, oslo::raw_key const &)> const &);
+	/** Drops the cached voting keys, forcing them to be decrypted again from the wallet store on next use */
+	void voting_keys_invalidate ();
 	bool exists (oslo::transaction const &, oslo::account const &);
 	void stop ();
 	void clear_send_ids (oslo::transaction const &);
@@ -257,8 +285,13 @@ public:
 	oslo::read_transaction tx_begin_read ();
 
 private:
+	void voting_keys_refresh ();
 	mutable std::mutex reps_cache_mutex;
 	oslo::wallet_representatives representatives;
+	std::mutex voting_keys_mutex;
+	oslo::voting_keys voting_keys;
+
+	friend std::unique_ptr<container_info_component> collect_container_info (wallets & wallets, const std::string & name);
 };
 
 std::unique_ptr<container_info_component> collect_container_info (wallets & wallets, const std::string & name);
@@ -2959,6 +2959,7 @@ TEST (rpc, version)
 	auto genesis_open (node1->latest (oslo::test_genesis_key.pub));
 	ASSERT_EQ (genesis_open.to_string (), response1.json.get<std::string> ("network_identifier"));
 	ASSERT_EQ (BUILD_INFO, response1.json.get<std::string> ("build_info"));
+	ASSERT_EQ (NETWORK_IO_BACKEND, response1.json.get<std::string> ("network_io_backend"));
 	auto headers (response1.resp.base ());
 	auto allow (headers.at ("Allow"));
 	auto content_type (headers.at ("Content-Type"));
@@ -7293,7 +7294,7 @@ TEST (rpc, unchecked_clear)
 	ASSERT_EQ (node.ledger.cache.unchecked_count, 1);
 	{
 		auto transaction = node.store.tx_begin_read ();
-		ASSERT_EQ (node.store.unchecked_count (transaction), 1);
+		ASSERT_EQ (node.unchecked.count (transaction), 1);
 	}
 	request.put ("action", "unchecked_clear");
 	test_response response (request, rpc.config.port, system.io_ctx);
@@ -7308,7 +7309,7 @@ TEST (rpc, unchecked_clear)
 	while (true)
 	{
 		auto transaction = node.store.tx_begin_read ();
-		if (node.store.unchecked_count (transaction) == 0)
+		if (node.unchecked.count (transaction) == 0)
 		{
 			break;
 		}
@@ -101,6 +101,12 @@ public:
 		static_assert (std::is_standard_layout<oslo::unchecked_key>::value, "Standard layout is required");
 	}
 
+	db_val (oslo::unchecked_modified_key const & val_a) :
+	db_val (sizeof (val_a), const_cast<oslo::unchecked_modified_key *> (&val_a))
+	{
+		static_assert (std::is_standard_layout<oslo::unchecked_modified_key>::value, "Standard layout is required");
+	}
+
 	db_val (oslo::confirmation_height_info const & val_a) :
 	buffer (std::make_shared<std::vector<uint8_t>> ())
 	{
@@ -111,6 +117,16 @@ public:
 		convert_buffer_to_value ();
 	}
 
+	db_val (oslo::bootstrap_peer_info const & val_a) :
+	buffer (std::make_shared<std::vector<uint8_t>> ())
+	{
+		{
+			oslo::vectorstream stream (*buffer);
+			val_a.serialize (stream);
+		}
+		convert_buffer_to_value ();
+	}
+
 	db_val (oslo::block_info const & val_a) :
 	db_val (sizeof (val_a), const_cast<oslo::block_info *> (&val_a))
 	{
@@ -212,6 +228,16 @@ public:
 		return result;
 	}
 
+	explicit operator oslo::bootstrap_peer_info () const
+	{
+		oslo::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
+		oslo::bootstrap_peer_info result;
+		bool error (result.deserialize (stream));
+		(void)error;
+		debug_assert (!error);
+		return result;
+	}
+
 	explicit operator oslo::unchecked_info () const
 	{
 		oslo::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
@@ -231,6 +257,15 @@ public:
 		return result;
 	}
 
+	explicit operator oslo::unchecked_modified_key () const
+	{
+		oslo::unchecked_modified_key result;
+		debug_assert (size () == sizeof (result));
+		static_assert (sizeof (uint64_t) + sizeof (oslo::unchecked_key) == sizeof (result), "Packed class");
+		std::copy (reinterpret_cast<uint8_t const *> (data ()), reinterpret_cast<uint8_t const *> (data ()) + sizeof (result), reinterpret_cast<uint8_t *> (&result));
+		return result;
+	}
+
 	explicit operator oslo::uint128_union () const
 	{
 		return convert<oslo::uint128_union> ();
@@ -573,6 +608,7 @@ enum class tables
 {
 	accounts,
 	blocks_info, // LMDB only
+	bootstrap_peers,
 	cached_counts, // RocksDB only
 	change_blocks,
 	confirmation_height,
@@ -587,6 +623,7 @@ enum class tables
 	send_blocks,
 	state_blocks,
 	unchecked,
+	unchecked_modified,
 	vote
 };
 
@@ -664,10 +701,14 @@ public:
 	virtual ~block_store () = default;
 	virtual void initialize (oslo::write_transaction const &, oslo::genesis const &, oslo::ledger_cache &) = 0;
 	virtual void block_put (oslo::write_transaction const &, oslo::block_hash const &, oslo::block const &) = 0;
+	/** Stores a block already serialized with its sideband, the successor of its predecessor is not updated */
+	virtual void block_raw_put (oslo::write_transaction const &, std::vector<uint8_t> const &, oslo::block_type, oslo::block_hash const &) = 0;
 	virtual oslo::block_hash block_successor (oslo::transaction const &, oslo::block_hash const &) const = 0;
 	virtual void block_successor_clear (oslo::write_transaction const &, oslo::block_hash const &) = 0;
 	virtual std::shared_ptr<oslo::block> block_get (oslo::transaction const &, oslo::block_hash const &) const = 0;
 	virtual std::shared_ptr<oslo::block> block_get_no_sideband (oslo::transaction const &, oslo::block_hash const &) const = 0;
+	/** Appends the network serialization of a block, including its type, directly from the stored bytes and retrieves its previous hash. Returns true if the block does not exist */
+	virtual bool block_serialized_get (oslo::transaction const &, oslo::block_hash const &, std::vector<uint8_t> &, oslo::block_hash &) const = 0;
 	virtual std::shared_ptr<oslo::block> block_get_v14 (oslo::transaction const &, oslo::block_hash const &, oslo::block_sideband_v14 * = nullptr, bool * = nullptr) const = 0;
 	virtual std::shared_ptr<oslo::block> block_random (oslo::transaction const &) = 0;
 	virtual void block_del (oslo::write_transaction const &, oslo::block_hash const &, oslo::block_type) = 0;
@@ -711,6 +752,8 @@ public:
 	virtual void unchecked_clear (oslo::write_transaction const &) = 0;
 	virtual void unchecked_put (oslo::write_transaction const &, oslo::unchecked_key const &, oslo::unchecked_info const &) = 0;
 	virtual void unchecked_put (oslo::write_transaction const &, oslo::block_hash const &, std::shared_ptr<oslo::block> const &) = 0;
+	/** Same as unchecked_put for a key known to be absent, skips looking up a replaced entry */
+	virtual void unchecked_put_new (oslo::write_transaction const &, oslo::unchecked_key const &, oslo::unchecked_info const &) = 0;
 	virtual std::vector<oslo::unchecked_info> unchecked_get (oslo::transaction const &, oslo::block_hash const &) = 0;
 	virtual bool unchecked_exists (oslo::transaction const & transaction_a, oslo::unchecked_key const & unchecked_key_a) = 0;
 	virtual void unchecked_del (oslo::write_transaction const &, oslo::unchecked_key const &) = 0;
@@ -718,12 +761,17 @@ public:
 	virtual oslo::store_iterator<oslo::unchecked_key, oslo::unchecked_info> unchecked_begin (oslo::transaction const &, oslo::unchecked_key const &) const = 0;
 	virtual oslo::store_iterator<oslo::unchecked_key, oslo::unchecked_info> unchecked_end () const = 0;
 	virtual size_t unchecked_count (oslo::transaction const &) = 0;
+	/** Unchecked keys ordered by modified time, maintained by unchecked_put, unchecked_put_new and unchecked_del */
+	virtual oslo::store_iterator<oslo::unchecked_modified_key, oslo::no_value> unchecked_modified_begin (oslo::transaction const &) const = 0;
+	virtual oslo::store_iterator<oslo::unchecked_modified_key, oslo::no_value> unchecked_modified_end () const = 0;
 
 	// Return latest vote for an account from store
 	virtual std::shared_ptr<oslo::vote> vote_get (oslo::transaction const &, oslo::account const &) = 0;
 	// Populate vote with the next sequence number
 	virtual std::shared_ptr<oslo::vote> vote_generate (oslo::transaction const &, oslo::account const &, oslo::raw_key const &, std::shared_ptr<oslo::block>) = 0;
 	virtual std::shared_ptr<oslo::vote> vote_generate (oslo::transaction const &, oslo::account const &, oslo::raw_key const &, std::vector<oslo::block_hash>) = 0;
+	// Reserve a range of consecutive sequence numbers for votes signed outside the store, returning the first one. The highest signed vote must be passed to vote_max afterwards
+	virtual uint64_t vote_sequence_reserve (oslo::transaction const &, oslo::account const &, uint64_t) = 0;
 	// Return either vote or the stored vote with a higher sequence number
 	virtual std::shared_ptr<oslo::vote> vote_max (oslo::transaction const &, std::shared_ptr<oslo::vote>) = 0;
 	// Return latest vote for an account considering the vote cache
@@ -750,6 +798,12 @@ public:
 	virtual oslo::store_iterator<oslo::endpoint_key, oslo::no_value> peers_begin (oslo::transaction const & transaction_a) const = 0;
 	virtual oslo::store_iterator<oslo::endpoint_key, oslo::no_value> peers_end () const = 0;
 
+	virtual void bootstrap_peer_put (oslo::write_transaction const & transaction_a, oslo::endpoint_key const & endpoint_a, oslo::bootstrap_peer_info const & bootstrap_peer_info_a) = 0;
+	virtual size_t bootstrap_peer_count (oslo::transaction const & transaction_a) const = 0;
+	virtual void bootstrap_peer_clear (oslo::write_transaction const & transaction_a) = 0;
+	virtual oslo::store_iterator<oslo::endpoint_key, oslo::bootstrap_peer_info> bootstrap_peers_begin (oslo::transaction const & transaction_a) const = 0;
+	virtual oslo::store_iterator<oslo::endpoint_key, oslo::bootstrap_peer_info> bootstrap_peers_end () const = 0;
+
 	virtual void confirmation_height_put (oslo::write_transaction const & transaction_a, oslo::account const & account_a, oslo::confirmation_height_info const & confirmation_height_info_a) = 0;
 	virtual bool confirmation_height_get (oslo::transaction const & transaction_a, oslo::account const & account_a, oslo::confirmation_height_info & confirmation_height_info_a) = 0;
 	virtual bool confirmation_height_exists (oslo::transaction const & transaction_a, oslo::account const & account_a) const = 0;
@@ -171,6 +171,37 @@ public:
 		return result;
 	}
 
+	bool block_serialized_get (oslo::transaction const & transaction_a, oslo::block_hash const & hash_a, std::vector<uint8_t> & buffer_a, oslo::block_hash & previous_a) const override
+	{
+		oslo::block_type type;
+		auto value (block_raw_get (transaction_a, hash_a, type));
+		auto error (value.size () == 0);
+		if (!error)
+		{
+			// Stored entries begin with the block serialized as it is sent on the network
+			auto const size (oslo::block::size (type));
+			debug_assert (value.size () >= size);
+			auto data (reinterpret_cast<uint8_t const *> (value.data ()));
+			buffer_a.push_back (static_cast<uint8_t> (type));
+			buffer_a.insert (buffer_a.end (), data, data + size);
+			previous_a.clear ();
+			switch (type)
+			{
+				case oslo::block_type::send:
+				case oslo::block_type::receive:
+				case oslo::block_type::change:
+					std::copy (data, data + sizeof (previous_a.bytes), previous_a.bytes.begin ());
+					break;
+				case oslo::block_type::state:
+					std::copy (data + sizeof (oslo::account), data + sizeof (oslo::account) + sizeof (previous_a.bytes), previous_a.bytes.begin ());
+					break;
+				default:
+					break;
+			}
+		}
+		return error;
+	}
+
 	bool block_exists (oslo::transaction const & transaction_a, oslo::block_type type, oslo::block_hash const & hash_a) override
 	{
 		auto junk = block_raw_get_by_type (transaction_a, hash_a, type);
@@ -313,9 +344,7 @@ public:
 	std::shared_ptr<oslo::vote> vote_generate (oslo::transaction const & transaction_a, oslo::account const & account_a, oslo::raw_key const & key_a, std::shared_ptr<oslo::block> block_a) override
 	{
 		oslo::lock_guard<std::mutex> lock (cache_mutex);
-		auto result (vote_current (transaction_a, account_a));
-		uint64_t sequence ((result ? result->sequence : 0) + 1);
-		result = std::make_shared<oslo::vote> (account_a, key_a, sequence, block_a);
+		auto result (std::make_shared<oslo::vote> (account_a, key_a, vote_sequence_next (transaction_a, account_a), block_a));
 		vote_cache_l1[account_a] = result;
 		return result;
 	}
@@ -323,13 +352,21 @@ public:
 	std::shared_ptr<oslo::vote> vote_generate (oslo::transaction const & transaction_a, oslo::account const & account_a, oslo::raw_key const & key_a, std::vector<oslo::block_hash> blocks_a) override
 	{
 		oslo::lock_guard<std::mutex> lock (cache_mutex);
-		auto result (vote_current (transaction_a, account_a));
-		uint64_t sequence ((result ? result->sequence : 0) + 1);
-		result = std::make_shared<oslo::vote> (account_a, key_a, sequence, blocks_a);
+		auto result (std::make_shared<oslo::vote> (account_a, key_a, vote_sequence_next (transaction_a, account_a), blocks_a));
 		vote_cache_l1[account_a] = result;
 		return result;
 	}
 
+	uint64_t vote_sequence_reserve (oslo::transaction const & transaction_a, oslo::account const & account_a, uint64_t count_a) override
+	{
+		debug_assert (count_a > 0);
+		oslo::lock_guard<std::mutex> lock (cache_mutex);
+		auto first (vote_sequence_next (transaction_a, account_a));
+		// Only the counter is kept, the vote cache holds signed votes exclusively
+		vote_sequence_reserved[account_a] = first + count_a - 1;
+		return first;
+	}
+
 	std::shared_ptr<oslo::vote> vote_max (oslo::transaction const & transaction_a, std::shared_ptr<oslo::vote> vote_a) override
 	{
 		oslo::lock_guard<std::mutex> lock (cache_mutex);
@@ -340,6 +377,11 @@ public:
 			result = current;
 		}
 		vote_cache_l1[vote_a->account] = result;
+		auto reserved (vote_sequence_reserved.find (vote_a->account));
+		if (reserved != vote_sequence_reserved.end () && reserved->second <= result->sequence)
+		{
+			vote_sequence_reserved.erase (reserved);
+		}
 		return result;
 	}
 
@@ -348,6 +390,11 @@ public:
 		return oslo::store_iterator<oslo::unchecked_key, oslo::unchecked_info> (nullptr);
 	}
 
+	oslo::store_iterator<oslo::unchecked_modified_key, oslo::no_value> unchecked_modified_end () const override
+	{
+		return oslo::store_iterator<oslo::unchecked_modified_key, oslo::no_value> (nullptr);
+	}
+
 	oslo::store_iterator<oslo::account, std::shared_ptr<oslo::vote>> vote_end () override
 	{
 		return oslo::store_iterator<oslo::account, std::shared_ptr<oslo::vote>> (nullptr);
@@ -358,6 +405,11 @@ public:
 		return oslo::store_iterator<oslo::endpoint_key, oslo::no_value> (nullptr);
 	}
 
+	oslo::store_iterator<oslo::endpoint_key, oslo::bootstrap_peer_info> bootstrap_peers_end () const override
+	{
+		return oslo::store_iterator<oslo::endpoint_key, oslo::bootstrap_peer_info> (nullptr);
+	}
+
 	oslo::store_iterator<oslo::pending_key, oslo::pending_info> pending_end () override
 	{
 		return oslo::store_iterator<oslo::pending_key, oslo::pending_info> (nullptr);
@@ -438,7 +490,7 @@ public:
 		return oslo::epoch::epoch_0;
 	}
 
-	void block_raw_put (oslo::write_transaction const & transaction_a, std::vector<uint8_t> const & data, oslo::block_type block_type_a, oslo::block_hash const & hash_a)
+	void block_raw_put (oslo::write_transaction const & transaction_a, std::vector<uint8_t> const & data, oslo::block_type block_type_a, oslo::block_hash const & hash_a) override
 	{
 		auto database_a = block_database (block_type_a);
 		oslo::db_val<Val> value{ data.size (), (void *)data.data () };
@@ -501,15 +553,41 @@ public:
 	}
 
 	void unchecked_put (oslo::write_transaction const & transaction_a, oslo::unchecked_key const & key_a, oslo::unchecked_info const & info_a) override
+	{
+		// A replaced entry keeps a single unchecked_modified key
+		oslo::db_val<Val> existing;
+		auto status (get (transaction_a, tables::unchecked, oslo::db_val<Val> (key_a), existing));
+		release_assert (success (status) || not_found (status));
+		if (success (status))
+		{
+			auto modified_existing (static_cast<oslo::unchecked_info> (existing).modified);
+			if (modified_existing != info_a.modified)
+			{
+				status = del (transaction_a, tables::unchecked_modified, oslo::unchecked_modified_key (modified_existing, key_a));
+				release_assert (success (status));
+			}
+		}
+		unchecked_put_new (transaction_a, key_a, info_a);
+	}
+
+	void unchecked_put_new (oslo::write_transaction const & transaction_a, oslo::unchecked_key const & key_a, oslo::unchecked_info const & info_a) override
 	{
 		oslo::db_val<Val> info (info_a);
 		auto status (put (transaction_a, tables::unchecked, key_a, info));
 		release_assert (success (status));
+		oslo::db_val<Val> zero (static_cast<uint64_t> (0));
+		status = put (transaction_a, tables::unchecked_modified, oslo::unchecked_modified_key (info_a.modified, key_a), zero);
+		release_assert (success (status));
 	}
 
 	void unchecked_del (oslo::write_transaction const & transaction_a, oslo::unchecked_key const & key_a) override
 	{
-		auto status (del (transaction_a, tables::unchecked, key_a));
+		oslo::db_val<Val> existing;
+		auto status (get (transaction_a, tables::unchecked, oslo::db_val<Val> (key_a), existing));
+		release_assert (success (status));
+		status = del (transaction_a, tables::unchecked_modified, oslo::unchecked_modified_key (static_cast<oslo::unchecked_info> (existing).modified, key_a));
+		release_assert (success (status));
+		status = del (transaction_a, tables::unchecked, key_a);
 		release_assert (success (status));
 	}
 
@@ -594,6 +672,8 @@ public:
 	{
 		auto status = drop (transaction_a, tables::unchecked);
 		release_assert (success (status));
+		status = drop (transaction_a, tables::unchecked_modified);
+		release_assert (success (status));
 	}
 
 	size_t online_weight_count (oslo::transaction const & transaction_a) const override
@@ -636,6 +716,24 @@ public:
 		release_assert (success (status));
 	}
 
+	void bootstrap_peer_put (oslo::write_transaction const & transaction_a, oslo::endpoint_key const & endpoint_a, oslo::bootstrap_peer_info const & bootstrap_peer_info_a) override
+	{
+		oslo::db_val<Val> value (bootstrap_peer_info_a);
+		auto status (put (transaction_a, tables::bootstrap_peers, endpoint_a, value));
+		release_assert (success (status));
+	}
+
+	size_t bootstrap_peer_count (oslo::transaction const & transaction_a) const override
+	{
+		return count (transaction_a, tables::bootstrap_peers);
+	}
+
+	void bootstrap_peer_clear (oslo::write_transaction const & transaction_a) override
+	{
+		auto status (drop (transaction_a, tables::bootstrap_peers));
+		release_assert (success (status));
+	}
+
 	bool exists (oslo::transaction const & transaction_a, tables table_a, oslo::db_val<Val> const & key_a) const
 	{
 		return static_cast<const Derived_Store &> (*this).exists (transaction_a, table_a, key_a);
@@ -767,6 +865,11 @@ public:
 		return make_iterator<oslo::unchecked_key, oslo::unchecked_info> (transaction_a, tables::unchecked, oslo::db_val<Val> (key_a));
 	}
 
+	oslo::store_iterator<oslo::unchecked_modified_key, oslo::no_value> unchecked_modified_begin (oslo::transaction const & transaction_a) const override
+	{
+		return make_iterator<oslo::unchecked_modified_key, oslo::no_value> (transaction_a, tables::unchecked_modified);
+	}
+
 	oslo::store_iterator<oslo::account, std::shared_ptr<oslo::vote>> vote_begin (oslo::transaction const & transaction_a) override
 	{
 		return make_iterator<oslo::account, std::shared_ptr<oslo::vote>> (transaction_a, tables::vote);
@@ -782,6 +885,11 @@ public:
 		return make_iterator<oslo::endpoint_key, oslo::no_value> (transaction_a, tables::peers);
 	}
 
+	oslo::store_iterator<oslo::endpoint_key, oslo::bootstrap_peer_info> bootstrap_peers_begin (oslo::transaction const & transaction_a) const override
+	{
+		return make_iterator<oslo::endpoint_key, oslo::bootstrap_peer_info> (transaction_a, tables::bootstrap_peers);
+	}
+
 	oslo::store_iterator<oslo::account, oslo::confirmation_height_info> confirmation_height_begin (oslo::transaction const & transaction_a, oslo::account const & account_a) override
 	{
 		return make_iterator<oslo::account, oslo::confirmation_height_info> (transaction_a, tables::confirmation_height, oslo::db_val<Val> (account_a));
@@ -801,7 +909,22 @@ protected:
 	oslo::network_params network_params;
 	std::unordered_map<oslo::account, std::shared_ptr<oslo::vote>> vote_cache_l1;
 	std::unordered_map<oslo::account, std::shared_ptr<oslo::vote>> vote_cache_l2;
-	static int constexpr version{ 18 };
+	/** Highest sequence number handed out by vote_sequence_reserve per account, until a vote at least as high reaches vote_max */
+	std::unordered_map<oslo::account, uint64_t> vote_sequence_reserved;
+	static int constexpr version{ 20 };
+
+	uint64_t vote_sequence_next (oslo::transaction const & transaction_a, oslo::account const & account_a)
+	{
+		debug_assert (!cache_mutex.try_lock ());
+		auto current (vote_current (transaction_a, account_a));
+		uint64_t result (current ? current->sequence : 0);
+		auto reserved (vote_sequence_reserved.find (account_a));
+		if (reserved != vote_sequence_reserved.end ())
+		{
+			result = std::max (result, reserved->second);
+		}
+		return result + 1;
+	}
 
 	template <typename T>
 	std::shared_ptr<oslo::block> block_random (oslo::transaction const & transaction_a, tables table_a)
@@ -73,7 +73,7 @@ network_params (network_constants::active_network)
 }
 
 oslo::network_params::network_params (oslo::oslo_networks network_a) :
-network (network_a), ledger (network), voting (network), node (network), portmapping (network), bootstrap (network)
+network (network_a), ledger (network), node (network), portmapping (network), bootstrap (network)
 {
 	unsigned constexpr kdf_full_work = 64 * 1024;
 	unsigned constexpr kdf_test_work = 8;
@@ -144,11 +144,6 @@ oslo::node_constants::node_constants (oslo::network_constants & network_constant
 	weight_period = 5 * 60; // 5 minutes
 }
 
-oslo::voting_constants::voting_constants (oslo::network_constants & network_constants)
-{
-	max_cache = network_constants.is_test_network () ? 2 : 64 * 1024;
-}
-
 oslo::portmapping_constants::portmapping_constants (oslo::network_constants & network_constants)
 {
 	mapping_timeout = network_constants.is_test_network () ? 53 : 3593;
@@ -420,6 +415,39 @@ bool oslo::confirmation_height_info::deserialize (oslo::stream & stream_a)
 	return error;
 }
 
+oslo::bootstrap_peer_info::bootstrap_peer_info (double throughput_a, double error_rate_a, double rtt_a, uint64_t samples_a) :
+throughput (throughput_a),
+error_rate (error_rate_a),
+rtt (rtt_a),
+samples (samples_a)
+{
+}
+
+void oslo::bootstrap_peer_info::serialize (oslo::stream & stream_a) const
+{
+	oslo::write (stream_a, throughput);
+	oslo::write (stream_a, error_rate);
+	oslo::write (stream_a, rtt);
+	oslo::write (stream_a, samples);
+}
+
+bool oslo::bootstrap_peer_info::deserialize (oslo::stream & stream_a)
+{
+	auto error (false);
+	try
+	{
+		oslo::read (stream_a, throughput);
+		oslo::read (stream_a, error_rate);
+		oslo::read (stream_a, rtt);
+		oslo::read (stream_a, samples);
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+	return error;
+}
+
 oslo::block_info::block_info (oslo::account const & account_a, oslo::amount const & balance_a) :
 account (account_a),
 balance (balance_a)
@@ -861,6 +889,22 @@ oslo::block_hash const & oslo::unchecked_key::key () const
 	return previous;
 }
 
+oslo::unchecked_modified_key::unchecked_modified_key (uint64_t modified_a, oslo::unchecked_key const & key_a) :
+modified_big_endian (boost::endian::native_to_big (modified_a)),
+unchecked (key_a)
+{
+}
+
+uint64_t oslo::unchecked_modified_key::modified () const
+{
+	return boost::endian::big_to_native (modified_big_endian);
+}
+
+oslo::unchecked_key const & oslo::unchecked_modified_key::key () const
+{
+	return unchecked;
+}
+
 void oslo::generate_cache::enable_all ()
 {
 	reps = true;
@@ -171,6 +171,22 @@ public:
 	oslo::block_hash hash{ 0 };
 };
 
+/**
+ * Key of the unchecked_modified table, the modified time is stored big endian so keys are ordered by time
+ */
+class unchecked_modified_key final
+{
+public:
+	unchecked_modified_key () = default;
+	unchecked_modified_key (uint64_t, oslo::unchecked_key const &);
+	uint64_t modified () const;
+	oslo::unchecked_key const & key () const;
+
+private:
+	uint64_t modified_big_endian{ 0 };
+	oslo::unchecked_key unchecked;
+};
+
 /**
  * Tag for block signature verification result
  */
@@ -230,6 +246,25 @@ public:
 	oslo::block_hash frontier;
 };
 
+/**
+ * Bootstrap performance of a peer, averaged over its bootstrap connections
+ */
+class bootstrap_peer_info final
+{
+public:
+	bootstrap_peer_info () = default;
+	bootstrap_peer_info (double, double, double, uint64_t);
+	void serialize (oslo::stream &) const;
+	bool deserialize (oslo::stream &);
+	/** Blocks per second */
+	double throughput{ 0.0 };
+	/** Share of failed pulls, between 0 and 1 */
+	double error_rate{ 0.0 };
+	/** Connection round trip time in milliseconds */
+	double rtt{ 0.0 };
+	uint64_t samples{ 0 };
+};
+
 namespace confirmation_height
 {
 	/** When the uncemented count (block count - cemented count) is less than this use the unbounded processor */
@@ -353,7 +388,7 @@ class protocol_constants
 {
 public:
 	/** Current protocol version */
-	uint8_t const protocol_version = 0x12;
+	uint8_t const protocol_version = 0x14;
 
 	/** Minimum accepted protocol version */
 	uint8_t protocol_version_min (bool epoch_2_started) const;
@@ -361,6 +396,15 @@ public:
 	/** Do not request telemetry metrics to nodes older than this version */
 	uint8_t const telemetry_protocol_version_min = 0x12;
 
+	/** Peers at or above this version serve several outstanding bulk_pull requests on one bootstrap connection */
+	uint8_t const bulk_pull_pipelining_version_min = 0x13;
+
+	/** Peers at or above this version understand the compact state block encoding in bulk_pull responses */
+	uint8_t const bulk_pull_compact_version_min = 0x13;
+
+	/** Peers at or above this version understand publish_batch messages */
+	uint8_t const publish_batch_version_min = 0x14;
+
 private:
 	/* Minimum protocol version before an epoch 2 block is seen */
 	uint8_t const protocol_version_min_pre_epoch_2 = 0x11;
@@ -426,14 +470,6 @@ public:
 	uint64_t weight_period;
 };
 
-/** Voting related constants whose value depends on the active network */
-class voting_constants
-{
-public:
-	voting_constants (oslo::network_constants & network_constants);
-	size_t max_cache;
-};
-
 /** Port-mapping related constants whose value depends on the active network */
 class portmapping_constants
 {
@@ -473,7 +509,6 @@ public:
 	protocol_constants protocol;
 	ledger_constants ledger;
 	random_constants random;
-	voting_constants voting;
 	node_constants node;
 	portmapping_constants portmapping;
 	bootstrap_constants bootstrap;
@@ -483,7 +518,9 @@ enum class confirmation_height_mode
 {
 	automatic,
 	unbounded,
-	bounded
+	bounded,
+	/** Always cement queued hashes with independent account chains concurrently */
+	parallel
 };
 
 /* Holds flags for various cacheable data. For most CLI operations caching is unnecessary
@@ -4,9 +4,19 @@
 #include <oslo/secure/common.hpp>
 #include <oslo/secure/network_filter.hpp>
 
-oslo::network_filter::network_filter (size_t size_a) :
-items (size_a, oslo::uint128_t{ 0 })
+#include <algorithm>
+
+constexpr size_t oslo::network_filter::default_shards;
+
+oslo::network_filter::network_filter (size_t size_a, size_t shards_a) :
+shards (std::max<size_t> (1, std::min (size_a, shards_a)))
 {
+	debug_assert (size_a > 0);
+	auto shard_size ((size_a + shards.size () - 1) / shards.size ());
+	for (auto & shard : shards)
+	{
+		shard.items.assign (shard_size, oslo::uint128_t{ 0 });
+	}
 	oslo::random_pool::generate_block (key, key.size ());
 }
 
@@ -15,8 +25,9 @@ bool oslo::network_filter::apply (uint8_t const * bytes_a, size_t count_a, oslo:
 	// Get hash before locking
 	auto digest (hash (bytes_a, count_a));
 
-	oslo::lock_guard<std::mutex> lock (mutex);
-	auto & element (get_element (digest));
+	auto & shard (shards[shard_index (digest)]);
+	oslo::lock_guard<std::mutex> lock (shard.mutex);
+	auto & element (get_element (shard, digest));
 	bool existed (element == digest);
 	if (!existed)
 	{
@@ -30,10 +41,22 @@ bool oslo::network_filter::apply (uint8_t const * bytes_a, size_t count_a, oslo:
 	return existed;
 }
 
+std::vector<bool> oslo::network_filter::apply (std::vector<oslo::uint128_t> const & digests_a)
+{
+	std::vector<bool> result (digests_a.size (), false);
+	for_each_shard (digests_a, [&result, &digests_a](oslo::uint128_t & element_a, size_t index_a) {
+		auto const & digest (digests_a[index_a]);
+		result[index_a] = element_a == digest;
+		element_a = digest;
+	});
+	return result;
+}
+
 void oslo::network_filter::clear (oslo::uint128_t const & digest_a)
 {
-	oslo::lock_guard<std::mutex> lock (mutex);
-	auto & element (get_element (digest_a));
+	auto & shard (shards[shard_index (digest_a)]);
+	oslo::lock_guard<std::mutex> lock (shard.mutex);
+	auto & element (get_element (shard, digest_a));
 	if (element == digest_a)
 	{
 		element = oslo::uint128_t{ 0 };
@@ -42,15 +65,12 @@ void oslo::network_filter::clear (oslo::uint128_t const & digest_a)
 
 void oslo::network_filter::clear (std::vector<oslo::uint128_t> const & digests_a)
 {
-	oslo::lock_guard<std::mutex> lock (mutex);
-	for (auto const & digest : digests_a)
-	{
-		auto & element (get_element (digest));
-		if (element == digest)
+	for_each_shard (digests_a, [&digests_a](oslo::uint128_t & element_a, size_t index_a) {
+		if (element_a == digests_a[index_a])
 		{
-			element = oslo::uint128_t{ 0 };
+			element_a = oslo::uint128_t{ 0 };
 		}
-	}
+	});
 }
 
 void oslo::network_filter::clear (uint8_t const * bytes_a, size_t count_a)
@@ -66,8 +86,11 @@ void oslo::network_filter::clear (OBJECT const & object_a)
 
 void oslo::network_filter::clear ()
 {
-	oslo::lock_guard<std::mutex> lock (mutex);
-	items.assign (items.size (), oslo::uint128_t{ 0 });
+	for (auto & shard : shards)
+	{
+		oslo::lock_guard<std::mutex> lock (shard.mutex);
+		shard.items.assign (shard.items.size (), oslo::uint128_t{ 0 });
+	}
 }
 
 template <typename OBJECT>
@@ -81,12 +104,46 @@ oslo::uint128_t oslo::network_filter::hash (OBJECT const & object_a) const
 	return hash (bytes.data (), bytes.size ());
 }
 
-oslo::uint128_t & oslo::network_filter::get_element (oslo::uint128_t const & hash_a)
+size_t oslo::network_filter::shard_count () const
+{
+	return shards.size ();
+}
+
+size_t oslo::network_filter::shard_index (oslo::uint128_t const & hash_a) const
+{
+	// The lower half of the digest selects the element within the shard
+	size_t index ((hash_a >> 64) % shards.size ());
+	return index;
+}
+
+oslo::uint128_t & oslo::network_filter::get_element (oslo::network_filter::shard & shard_a, oslo::uint128_t const & hash_a)
+{
+	debug_assert (!shard_a.mutex.try_lock ());
+	debug_assert (shard_a.items.size () > 0);
+	size_t index (hash_a % shard_a.items.size ());
+	return shard_a.items[index];
+}
+
+void oslo::network_filter::for_each_shard (std::vector<oslo::uint128_t> const & digests_a, std::function<void(oslo::uint128_t &, size_t)> const & action_a)
 {
-	debug_assert (!mutex.try_lock ());
-	debug_assert (items.size () > 0);
-	size_t index (hash_a % items.size ());
-	return items[index];
+	// Visit digests grouped by shard, in their original order within a shard, so each shard is locked once
+	std::vector<std::pair<size_t, size_t>> order;
+	order.reserve (digests_a.size ());
+	for (size_t i (0), n (digests_a.size ()); i < n; ++i)
+	{
+		order.emplace_back (shard_index (digests_a[i]), i);
+	}
+	std::sort (order.begin (), order.end ());
+	for (auto i (order.begin ()), n (order.end ()); i != n;)
+	{
+		auto current (i->first);
+		auto & shard (shards[current]);
+		oslo::lock_guard<std::mutex> lock (shard.mutex);
+		for (; i != n && i->first == current; ++i)
+		{
+			action_a (get_element (shard, digests_a[i->second]), i->second);
+		}
+	}
 }
 
 oslo::uint128_t oslo::network_filter::hash (uint8_t const * bytes_a, size_t count_a) const
@@ -6,7 +6,9 @@
 #include <crypto/cryptopp/seckey.h>
 #include <crypto/cryptopp/siphash.h>
 
+#include <functional>
 #include <mutex>
+#include <vector>
 
 namespace oslo
 {
@@ -14,13 +16,16 @@ namespace oslo
  * A probabilistic duplicate filter based on directed map caches, using SipHash 2/4/128
  * The probability of false negatives (unique packet marked as duplicate) is the probability of a 128-bit SipHash collision.
  * The probability of false positives (duplicate packet marked as unique) shrinks with a larger filter.
+ * The filter is split into shards selected by the upper half of the digest, each with its own lock, so that
+ * network threads applying different digests rarely contend.
  * @note This class is thread-safe.
  */
 class network_filter final
 {
 public:
 	network_filter () = delete;
-	network_filter (size_t size_a);
+	/** Creates a filter of \p size_a elements split in up to \p shards_a shards */
+	network_filter (size_t size_a, size_t shards_a = default_shards);
 	/**
 	 * Reads \p count_a bytes starting from \p bytes_a and inserts the siphash digest in the filter.
 	 * @param \p digest_a if given, will be set to the resulting siphash digest
@@ -29,6 +34,12 @@ public:
 	 **/
 	bool apply (uint8_t const * bytes_a, size_t count_a, oslo::uint128_t * digest_a = nullptr);
 
+	/**
+	 * Inserts each of \p digests_a in the filter, locking every shard involved once.
+	 * @return for each digest, a boolean representing its previous existence in the filter.
+	 **/
+	std::vector<bool> apply (std::vector<oslo::uint128_t> const & digests_a);
+
 	/**
 	 * Sets the corresponding element in the filter to zero, if it matches \p digest_a exactly.
 	 **/
@@ -62,24 +73,39 @@ public:
 	template <typename OBJECT>
 	oslo::uint128_t hash (OBJECT const & object_a) const;
 
+	/**
+	 * Hashes \p count_a bytes starting from \p bytes_a .
+	 * @return the siphash digest of the contents in \p bytes_a .
+	 **/
+	oslo::uint128_t hash (uint8_t const * bytes_a, size_t count_a) const;
+
+	size_t shard_count () const;
+
+	static size_t constexpr default_shards = 64;
+
 private:
 	using siphash_t = CryptoPP::SipHash<2, 4, true>;
 
+	class shard final
+	{
+	public:
+		std::vector<oslo::uint128_t> items;
+		std::mutex mutex;
+	};
+
+	size_t shard_index (oslo::uint128_t const & hash_a) const;
+
 	/**
 	 * Get element from digest.
-	 * @note must have a lock on mutex
+	 * @note must have a lock on the shard mutex
 	 * @return a reference to the element with key \p hash_a
 	 **/
-	oslo::uint128_t & get_element (oslo::uint128_t const & hash_a);
+	oslo::uint128_t & get_element (oslo::network_filter::shard & shard_a, oslo::uint128_t const & hash_a);
 
-	/**
-	 * Hashes \p count_a bytes starting from \p bytes_a .
-	 * @return the siphash digest of the contents in \p bytes_a .
-	 **/
-	oslo::uint128_t hash (uint8_t const * bytes_a, size_t count_a) const;
+	/** Calls \p action_a with the element and index of each of \p digests_a, with a lock on its shard */
+	void for_each_shard (std::vector<oslo::uint128_t> const & digests_a, std::function<void(oslo::uint128_t &, size_t)> const & action_a);
 
-	std::vector<oslo::uint128_t> items;
+	std::vector<shard> shards;
 	CryptoPP::SecByteBlock key{ siphash_t::KEYLENGTH };
-	std::mutex mutex;
 };
 }
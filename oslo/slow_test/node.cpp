@@ -2,16 +2,20 @@
 #include <oslo/core_test/testutil.hpp>
 #include <oslo/crypto_lib/random_pool.hpp>
 #include <oslo/lib/threading.hpp>
+#include <oslo/lib/timer.hpp>
 #include <oslo/node/election.hpp>
 #include <oslo/node/testing.hpp>
 #include <oslo/node/transport/udp.hpp>
+#include <oslo/secure/network_filter.hpp>
 
 #include <gtest/gtest.h>
 
 #include <boost/format.hpp>
 
+#include <array>
 #include <numeric>
 #include <random>
+#include <thread>
 
 using namespace std::chrono_literals;
 
@@ -1861,3 +1865,92 @@ TEST (node, mass_block_new)
 	process_all (receive_blocks);
 	std::cout << "Receive blocks time: " << timer.stop ().count () << " " << timer.unit () << "\n\n";
 }
+
+// Compares a single locked table with the sharded publish filter while many network threads apply publishes
+TEST (network_filter, multithreaded_apply)
+{
+	auto const thread_count (std::max (8u, std::thread::hardware_concurrency ()));
+	auto const per_thread (200000);
+	std::vector<std::vector<std::array<uint8_t, 32>>> packets (thread_count);
+	for (auto & thread_packets : packets)
+	{
+		thread_packets.resize (per_thread);
+		for (auto & packet : thread_packets)
+		{
+			oslo::random_pool::generate_block (packet.data (), packet.size ());
+		}
+	}
+	auto run = [&packets](oslo::network_filter & filter_a) {
+		std::vector<std::thread> threads;
+		oslo::timer<std::chrono::milliseconds> timer (oslo::timer_state::started);
+		for (auto const & thread_packets : packets)
+		{
+			threads.emplace_back ([&filter_a, &thread_packets]() {
+				for (auto const & packet : thread_packets)
+				{
+					filter_a.apply (packet.data (), packet.size ());
+				}
+			});
+		}
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		return timer.stop ();
+	};
+	oslo::network_filter single (256 * 1024, 1);
+	oslo::network_filter sharded (256 * 1024);
+	auto single_time (run (single));
+	auto sharded_time (run (sharded));
+	std::cout << thread_count << " threads x " << per_thread << " publishes, single lock: " << single_time.count () << " ms, " << sharded.shard_count () << " shards: " << sharded_time.count () << " ms" << std::endl;
+}
+
+// Throughput of the realtime message buffers with one producer per IO thread and 1 to 16 packet processing threads
+TEST (message_buffer_manager, throughput)
+{
+	auto const producer_count (4);
+	auto const per_producer (250000);
+	for (auto consumer_count : { 1, 2, 4, 8, 16 })
+	{
+		oslo::stat stats;
+		oslo::message_buffer_manager buffers (stats, 512, 4096);
+		std::atomic<size_t> serviced (0);
+		std::vector<std::thread> threads;
+		oslo::timer<std::chrono::milliseconds> timer (oslo::timer_state::started);
+		for (auto i (0); i < consumer_count; ++i)
+		{
+			threads.emplace_back ([&buffers, &serviced]() {
+				while (auto data = buffers.dequeue ())
+				{
+					buffers.release (data);
+					++serviced;
+				}
+			});
+		}
+		std::vector<std::thread> producers;
+		for (auto i (0); i < producer_count; ++i)
+		{
+			producers.emplace_back ([&buffers, per_producer]() {
+				for (auto j (0); j < per_producer; ++j)
+				{
+					auto data (buffers.allocate ());
+					data->size = 1;
+					buffers.enqueue (data);
+				}
+			});
+		}
+		for (auto & producer : producers)
+		{
+			producer.join ();
+		}
+		buffers.stop ();
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		auto elapsed (std::max<int64_t> (1, timer.stop ().count ()));
+		auto overflow (stats.count (oslo::stat::type::udp, oslo::stat::detail::overflow));
+		ASSERT_EQ (producer_count * per_producer, serviced + overflow);
+		std::cout << consumer_count << " processing threads: " << serviced * 1000 / elapsed << " buffers/s, " << overflow << " dropped" << std::endl;
+	}
+}